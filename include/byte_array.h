@@ -39,6 +39,7 @@ typedef struct {
 typedef struct {
     ByteBuffer* buffers;
     int count;
+    int used;   /**< Reflects the number of `buffers` populated (e.g. with keys) */
 } ByteBufferArray;
 
 /** @brief Convenience macro to represent an empty buffer with no data */
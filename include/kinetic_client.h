@@ -47,6 +47,9 @@ void KineticClient_Shutdown(void);
  *  .clusterVersion   Cluster version to use for the session
  *  .identity         Identity to use for the session
  *  .hmacKey          Key to use for HMAC calculations (NULL-terminated string)
+ *  .outstandingOperationsMax  Maximum operations in flight (0 for no limit)
+ *  .failOnFullWindow Return KINETIC_STATUS_WOULD_BLOCK instead of blocking
+ *                    when outstandingOperationsMax operations are in flight
  * @param handle    Pointer to KineticSessionHandle (populated upon successful connection)
  *
  * @return          Returns the resulting KineticStatus
@@ -63,6 +66,20 @@ KineticStatus KineticClient_Connect(const KineticSession* config,
  */
 KineticStatus KineticClient_Disconnect(KineticSessionHandle* const handle);
 
+/**
+ * @brief Blocks until the session has room in its in-flight window for
+ * another operation (for a pooled session, until any of its connections has
+ * room, since each has its own window). Intended for use with `failOnFullWindow`, after a
+ * request returned KINETIC_STATUS_WOULD_BLOCK. Must not be called from a
+ * completion closure, since those run on the thread that frees up the window.
+ *
+ * @param handle        KineticSessionHandle for a connected session.
+ *
+ * @return              Returns KINETIC_STATUS_SUCCESS once a slot is free, or
+ *                      KINETIC_STATUS_CONNECTION_ERROR if the session fails
+ */
+KineticStatus KineticClient_WaitUntilWindowAvailable(KineticSessionHandle handle);
+
 /**
  * @brief Executes a NOOP command to test whether the Kinetic Device is operational.
  *
@@ -89,6 +106,33 @@ KineticStatus KineticClient_Put(KineticSessionHandle handle,
                                 KineticEntry* const entry,
                                 KineticCompletionClosure* closure);
 
+/**
+ * @brief Executes a PUT command for each of several entries, packing as many
+ * requests as possible into each socket write instead of one write per entry.
+ * Requests are admitted to the in-flight window as they are packed, and a
+ * full window flushes the requests packed so far.
+ *
+ * @param handle        KineticSessionHandle for a connected session.
+ * @param entries       Array of key/value entries to store. 'value' of each
+ *                      must specify the data to be stored.
+ * @param count         Number of entries in the array.
+ * @param statuses      Array of count statuses, populated with the resulting
+ *                      status of each entry, if executing in synchronous mode.
+ * @param closures      Optional array of count closures, one per entry. If
+ *                      specified, the batch will be executed in asynchronous
+ *                      mode, and each entry's closure callback will be called
+ *                      upon its completion (statuses may be NULL).
+ *
+ * @return              Returns KINETIC_STATUS_SUCCESS if all entries were
+ *                      stored (synchronous) or submitted (asynchronous),
+ *                      otherwise the first failing status
+ */
+KineticStatus KineticClient_PutBatch(KineticSessionHandle handle,
+                                     KineticEntry* const entries,
+                                     int count,
+                                     KineticStatus* statuses,
+                                     KineticCompletionClosure* closures);
+
 /**
  * @brief Executes a GET command to retrieve and entry from the Kinetic Device.
  *
@@ -105,6 +149,113 @@ KineticStatus KineticClient_Get(KineticSessionHandle handle,
                                 KineticEntry* const entry,
                                 KineticCompletionClosure* closure);
 
+/**
+ * @brief Executes a GETNEXT command to retrieve the entry following the
+ * specified key from the Kinetic Device.
+ *
+ * @param handle        KineticSessionHandle for a connected session.
+ * @param entry         Key/value entry, whose 'key' specifies the key to
+ *                      retrieve the entry following. 'key' will be replaced
+ *                      by the key retrieved, and 'value' will be populated
+ *                      unless 'metadataOnly' is set to 'true'.
+ * @param closure       Optional closure. If specified, operation will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called upon completion.
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_GetNext(KineticSessionHandle handle,
+                                    KineticEntry* const entry,
+                                    KineticCompletionClosure* closure);
+
+/**
+ * @brief Executes a GETPREVIOUS command to retrieve the entry preceding the
+ * specified key from the Kinetic Device.
+ *
+ * @param handle        KineticSessionHandle for a connected session.
+ * @param entry         Key/value entry, whose 'key' specifies the key to
+ *                      retrieve the entry preceding. 'key' will be replaced
+ *                      by the key retrieved, and 'value' will be populated
+ *                      unless 'metadataOnly' is set to 'true'.
+ * @param closure       Optional closure. If specified, operation will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called upon completion.
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_GetPrevious(KineticSessionHandle handle,
+                                        KineticEntry* const entry,
+                                        KineticCompletionClosure* closure);
+
+/**
+ * @brief Executes a GET command for each of several entries, pipelining all
+ * of the requests on the session instead of waiting on each in turn.
+ *
+ * @param handle        KineticSessionHandle for a connected session.
+ * @param entries       Array of key/value entries to retrieve. 'value' of
+ *                      each will be populated unless its 'metadataOnly' is
+ *                      set to 'true' (e.g. for existence/version checks).
+ * @param count         Number of entries in the array.
+ * @param statuses      Optional array of count statuses, populated with the
+ *                      resulting status of each entry upon completion.
+ * @param closure       Optional closure. If specified, the batch will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called once, after all entries complete, with
+ *                      the status of the first failed entry, if any. Entries
+ *                      and statuses must remain valid until then.
+ *
+ * @return              Returns KINETIC_STATUS_SUCCESS if all entries were
+ *                      retrieved (synchronous) or submitted (asynchronous),
+ *                      otherwise the first failing status
+ */
+KineticStatus KineticClient_GetMany(KineticSessionHandle handle,
+                                    KineticEntry* const entries,
+                                    int count,
+                                    KineticStatus* statuses,
+                                    KineticCompletionClosure* closure);
+
+/**
+ * @brief Stores an object larger than KINETIC_OBJ_SIZE, by splitting it into
+ * chunk objects, and keeping several chunk PUTs in flight at once, spread
+ * across the specified sessions. A manifest describing the chunks is stored
+ * at the object key once all chunks have been stored. Each PUT stores its
+ * chunks under a new generation, so readers see either the object replaced
+ * or the new one, and the chunks of the object replaced are deleted once
+ * the manifest has been replaced.
+ *
+ * @param handles       Array of KineticSessionHandle's for connected sessions
+ *                      to the same Kinetic Device.
+ * @param count         Number of sessions (up to KINETIC_STREAM_SESSIONS_MAX).
+ * @param stream        Stream specifying the object key and data.
+ *
+ * @return              Returns the status of the first failed chunk, if any,
+ *                      otherwise the status of the manifest PUT
+ */
+KineticStatus KineticClient_PutStream(const KineticSessionHandle* handles,
+                                      int count,
+                                      KineticStream* const stream);
+
+/**
+ * @brief Retrieves an object stored with KineticClient_PutStream, by reading
+ * its manifest, and then keeping several chunk GETs in flight at once, spread
+ * across the specified sessions, reassembling the chunks in 'stream->value'.
+ * If the object is replaced meanwhile, and its chunks deleted, the GET fails
+ * with KINETIC_STATUS_NOT_FOUND, rather than returning a mix of the two.
+ *
+ * @param handles       Array of KineticSessionHandle's for connected sessions
+ *                      to the same Kinetic Device.
+ * @param count         Number of sessions (up to KINETIC_STREAM_SESSIONS_MAX).
+ * @param stream        Stream specifying the object key and buffer to
+ *                      populate with the object data.
+ *
+ * @return              Returns the resulting KineticStatus (with
+ *                      KINETIC_STATUS_BUFFER_OVERRUN, and 'value.bytesUsed'
+ *                      set to the object length, if the buffer is too small)
+ */
+KineticStatus KineticClient_GetStream(const KineticSessionHandle* handles,
+                                      int count,
+                                      KineticStream* const stream);
+
 /**
  * @brief Executes a DELETE command to delete an entry from the Kinetic Device
  *
@@ -140,4 +291,517 @@ KineticStatus KineticClient_GetKeyRange(KineticSessionHandle handle,
                                         KineticKeyRange* range, ByteBufferArray* keys,
                                         KineticCompletionClosure* closure);
 
+/**
+ * @brief Opens an iterator over all keys in the specified range, however
+ * many there are. Keys are retrieved in pages of 'maxReturned' keys, and the
+ * following page is always requested while the current one is consumed.
+ *
+ * @param handle        KineticSessionHandle for a connected session
+ * @param range         KineticKeyRange specifying keys to iterate over, and
+ *                      the number of keys to retrieve per page. It is copied,
+ *                      so need not remain valid.
+ * @param iterator      Populated with the new iterator, which must be closed
+ *                      with KineticClient_CloseKeyIterator()
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_OpenKeyIterator(KineticSessionHandle handle,
+                                            const KineticKeyRange* range,
+                                            KineticKeyIterator** iterator);
+
+/**
+ * @brief Retrieves the next key from a key range iterator, waiting for the
+ * next page of keys, if it has not yet arrived. An iterator must only be used
+ * by one thread at a time.
+ *
+ * @param iterator      Iterator opened with KineticClient_OpenKeyIterator()
+ * @param key           ByteBuffer to store the key
+ *
+ * @return              Returns KINETIC_STATUS_SUCCESS if a key was retrieved,
+ *                      KINETIC_STATUS_NOT_FOUND once the range is exhausted,
+ *                      or the status of the failed page request
+ */
+KineticStatus KineticClient_NextKey(KineticKeyIterator* iterator, ByteBuffer* key);
+
+/**
+ * @brief Closes a key range iterator, waiting for any page still in flight.
+ *
+ * @param iterator      Iterator opened with KineticClient_OpenKeyIterator()
+ */
+void KineticClient_CloseKeyIterator(KineticKeyIterator* iterator);
+
+/**
+ * @brief Scans every key in a range, by splitting the range into partitions
+ * on the bytes following the prefix common to the start and end keys, and
+ * paging through all partitions concurrently, spread across the specified
+ * sessions. Keys are reported to the scan callback from the calling thread.
+ *
+ * @param handles       Array of KineticSessionHandle's for connected sessions
+ *                      to the same Kinetic Device.
+ * @param count         Number of sessions (up to
+ *                      KINETIC_KEY_SCAN_PARTITIONS_MAX).
+ * @param scan          Scan specifying the range, number of partitions, key
+ *                      order and callback.
+ *
+ * @return              Returns KINETIC_STATUS_SUCCESS once every key has been
+ *                      reported, otherwise the status of the failed request
+ */
+KineticStatus KineticClient_ScanKeyRange(const KineticSessionHandle* handles,
+                                         int count,
+                                         KineticKeyScan* const scan);
+
+/**
+ * @brief Retrieves every entry in a key range, by paging through the keys in
+ * the range, and keeping GETs in flight for the keys listed so far. Each entry
+ * is reported to the callback as it arrives, so entries may be reported out
+ * of key order.
+ *
+ * @param handle        KineticSessionHandle for a connected session
+ * @param range         KineticKeyRange specifying keys to retrieve, and the
+ *                      number of keys to list per page
+ * @param getsInFlight  Maximum number of GETs in flight (0 selects
+ *                      KINETIC_VALUE_SCAN_GETS_IN_FLIGHT)
+ * @param callback      Callback called with each entry retrieved. It is
+ *                      called from the thread servicing the session, so must
+ *                      not block, and the entry is only valid until it returns.
+ * @param clientData    Optional data passed to the callback
+ *
+ * @return              Returns KINETIC_STATUS_SUCCESS once every entry has
+ *                      been reported (skipping keys deleted during the scan),
+ *                      otherwise the status of the first failed request
+ */
+KineticStatus KineticClient_ScanValues(KineticSessionHandle handle,
+                                       const KineticKeyRange* range,
+                                       int getsInFlight,
+                                       KineticValueScanCallback callback,
+                                       void* clientData);
+
+/**
+ * @brief Opens a cursor, which retrieves entries one after another in key
+ * order. The cursor steps with GETNEXT (or GETPREVIOUS) requests, until it has
+ * been used sequentially, then keeps 'readAhead' GET requests in flight ahead
+ * of the caller, for the keys listed by a key range iterator.
+ *
+ * @param handle        KineticSessionHandle for a connected session
+ * @param startKey      Key to start from, which is itself excluded
+ * @param reverse       Set to true to retrieve entries in descending order
+ * @param readAhead     Maximum number of entries to retrieve ahead of the
+ *                      caller (0 selects KINETIC_CURSOR_READ_AHEAD, and 1
+ *                      disables reading ahead)
+ * @param cursor        Populated with the new cursor, which must be closed
+ *                      with KineticClient_CloseCursor()
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_OpenCursor(KineticSessionHandle handle,
+                                       const ByteBuffer* startKey,
+                                       bool reverse,
+                                       int readAhead,
+                                       KineticCursor** cursor);
+
+/**
+ * @brief Retrieves the entry following the cursor position, and moves the
+ * cursor to it. A cursor must only be used by one thread at a time.
+ *
+ * @param cursor        Cursor opened with KineticClient_OpenCursor()
+ * @param entry         Key/value entry to populate with the key, value,
+ *                      dbVersion, tag and algorithm retrieved
+ *
+ * @return              Returns KINETIC_STATUS_SUCCESS if an entry was
+ *                      retrieved, KINETIC_STATUS_NOT_FOUND once there are no
+ *                      more entries, or KINETIC_STATUS_BUFFER_OVERRUN if the
+ *                      entry did not fit (without moving the cursor)
+ */
+KineticStatus KineticClient_NextEntry(KineticCursor* cursor, KineticEntry* const entry);
+
+/**
+ * @brief Moves a cursor to the specified key, discarding any entries read
+ * ahead. The cursor steps again until it is used sequentially.
+ *
+ * @param cursor        Cursor opened with KineticClient_OpenCursor()
+ * @param key           Key to continue from, which is itself excluded
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_SeekCursor(KineticCursor* cursor, const ByteBuffer* key);
+
+/**
+ * @brief Closes a cursor, waiting for any entries still in flight.
+ *
+ * @param cursor        Cursor opened with KineticClient_OpenCursor()
+ */
+void KineticClient_CloseCursor(KineticCursor* cursor);
+
+/**
+ * @brief Executes a GETLOG command to retrieve device information, such as
+ * utilizations, temperatures, capacity, per-operation statistics and limits.
+ *
+ * @param handle        KineticSessionHandle for a connected session
+ * @param types         KineticLogType flags for the information to retrieve
+ * @param log           KineticDeviceLog to populate with the information
+ *                      retrieved (entries beyond the capacity of its arrays
+ *                      are dropped)
+ * @param closure       Optional closure. If specified, operation will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called upon completion.
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_GetLog(KineticSessionHandle handle,
+                                   int types,
+                                   KineticDeviceLog* log,
+                                   KineticCompletionClosure* closure);
+
+/**
+ * @brief Starts polling the device log in the background, on the session's
+ * existing connection. A poll is skipped while the previous one is still in
+ * flight, or while the session has its maximum operations in flight.
+ *
+ * @param handle          KineticSessionHandle for a connected session
+ * @param types           KineticLogType flags for the information to poll
+ * @param intervalMillis  Delay between polls, in milliseconds (0 selects
+ *                        KINETIC_LOG_POLL_INTERVAL_MS)
+ *
+ * @return                Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_StartLogPolling(KineticSessionHandle handle,
+                                            int types,
+                                            int intervalMillis);
+
+/**
+ * @brief Retrieves the most recent device log received by the poller,
+ * without any communication with the device.
+ *
+ * @param handle        KineticSessionHandle with log polling started
+ * @param log           KineticDeviceLog to populate with the snapshot
+ *
+ * @return              Returns KINETIC_STATUS_SUCCESS if a snapshot was
+ *                      available, otherwise the status of the latest poll
+ *                      (KINETIC_STATUS_NOT_ATTEMPTED if none has completed)
+ */
+KineticStatus KineticClient_GetLogSnapshot(KineticSessionHandle handle,
+                                           KineticDeviceLog* log);
+
+/**
+ * @brief Stops polling the device log, waiting for any poll in flight.
+ * Polling is also stopped upon KineticClient_Disconnect().
+ *
+ * @param handle        KineticSessionHandle with log polling started
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_StopLogPolling(KineticSessionHandle handle);
+
+/**
+ * @brief Executes a FLUSHALLDATA command, making all data previously written
+ * to the Kinetic Device durable. If group commit has been started on the
+ * session, the flush is shared with the writes awaiting group commit.
+ *
+ * @param handle        KineticSessionHandle for a connected session.
+ * @param closure       Optional closure. If specified, operation will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called upon completion.
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_Flush(KineticSessionHandle handle,
+                                  KineticCompletionClosure* closure);
+
+/**
+ * @brief Starts group commit on a session. Durable puts are then sent
+ * WRITEBACK, and complete once a FLUSHALLDATA sent after they were
+ * acknowledged has succeeded. Only a single flush is in flight at a time,
+ * and it is sent once enough writes are waiting, or the oldest has waited
+ * for the maximum delay.
+ *
+ * @param handle          KineticSessionHandle for a connected session
+ * @param writesPerFlush  Number of writes waiting which triggers a flush
+ *                        (0 selects KINETIC_GROUP_COMMIT_WRITES)
+ * @param delayMillis     Maximum delay, in milliseconds, before a write
+ *                        waiting is flushed (0 selects
+ *                        KINETIC_GROUP_COMMIT_DELAY_MS)
+ *
+ * @return                Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_StartGroupCommit(KineticSessionHandle handle,
+                                             int writesPerFlush,
+                                             int delayMillis);
+
+/**
+ * @brief Executes a PUT command with WRITEBACK synchronization, which
+ * completes once the entry is durable via the session's group commit.
+ *
+ * @param handle        KineticSessionHandle with group commit started
+ * @param entry         Key/value entry for object to store. 'value' must
+ *                      specify the data to be stored, and 'synchronization'
+ *                      is set to KINETIC_SYNCHRONIZATION_WRITEBACK.
+ * @param closure       Optional closure. If specified, operation will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called once the entry is durable.
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_PutDurable(KineticSessionHandle handle,
+                                       KineticEntry* const entry,
+                                       KineticCompletionClosure* closure);
+
+/**
+ * @brief Stops group commit on a session, flushing any writes waiting.
+ * Group commit is also stopped upon KineticClient_Disconnect().
+ *
+ * @param handle        KineticSessionHandle with group commit started
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_StopGroupCommit(KineticSessionHandle handle);
+
+/**
+ * @brief Executes a PEER2PEERPUSH command, having the Kinetic Device copy a
+ * batch of entries directly to a peer device, without the data passing
+ * through the client.
+ *
+ * @param handle        KineticSessionHandle for a connected session.
+ * @param p2pOp         KineticP2P_Operation specifying the peer and the
+ *                      entries to copy. The 'resultStatus' of each entry is
+ *                      populated with its outcome, even if the operation as
+ *                      a whole fails.
+ * @param closure       Optional closure. If specified, operation will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called upon completion.
+ *
+ * @return              Returns the resulting KineticStatus, which is
+ *                      KINETIC_STATUS_OPERATION_FAILED if any entry failed
+ */
+KineticStatus KineticClient_P2POperation(KineticSessionHandle handle,
+                                         KineticP2P_Operation* const p2pOp,
+                                         KineticCompletionClosure* closure);
+
+/**
+ * @brief Connects to each of the specified drives, and combines them into a
+ * cluster, which routes each entry to one of the drives by consistent hashing
+ * of its key. Each drive owns KINETIC_CLUSTER_VIRTUAL_NODES points on a hash
+ * ring, placed by its host and port alone, so that adding or removing a drive
+ * only moves the keys of the points it gains or loses.
+ *
+ * @param configs       Array of KineticSession configurations, one per drive
+ * @param count         Number of drives (up to KINETIC_CLUSTER_DRIVES_MAX)
+ * @param cluster       Pointer to the cluster to populate, which must be
+ *                      released with KineticClient_DisconnectCluster()
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_ConnectCluster(const KineticSession* configs,
+                                           int count,
+                                           KineticCluster** cluster);
+
+/**
+ * @brief Connects to a drive and adds it to a cluster, which then routes the
+ * keys of the points it owns on the hash ring to it. Entries already stored
+ * under those keys are not moved by the library.
+ *
+ * @param cluster       Cluster connected with KineticClient_ConnectCluster()
+ * @param config        KineticSession configuration of the drive
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_AddClusterDrive(KineticCluster* cluster,
+                                            const KineticSession* config);
+
+/**
+ * @brief Removes a drive from a cluster, once responses to requests routed to
+ * it have arrived, and disconnects from it. Its keys are routed to the drives
+ * owning the next points on the hash ring.
+ *
+ * @param cluster       Cluster connected with KineticClient_ConnectCluster()
+ * @param host          Host name/IP address of the drive
+ * @param port          Port of the drive
+ *
+ * @return              Returns the resulting KineticStatus
+ *                      (KINETIC_STATUS_INVALID_REQUEST if not in the cluster)
+ */
+KineticStatus KineticClient_RemoveClusterDrive(KineticCluster* cluster,
+                                               const char* host,
+                                               int port);
+
+/**
+ * @brief Executes a PUT command on the cluster drive owning the entry key.
+ *
+ * @param cluster       Cluster connected with KineticClient_ConnectCluster()
+ * @param entry         Key/value entry for object to store, as for
+ *                      KineticClient_Put()
+ * @param closure       Optional closure. If specified, operation will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called upon completion.
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_ClusterPut(KineticCluster* cluster,
+                                       KineticEntry* const entry,
+                                       KineticCompletionClosure* closure);
+
+/**
+ * @brief Executes a GET command on the cluster drive owning the entry key.
+ *
+ * @param cluster       Cluster connected with KineticClient_ConnectCluster()
+ * @param entry         Key/value entry for object to retrieve, as for
+ *                      KineticClient_Get()
+ * @param closure       Optional closure. If specified, operation will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called upon completion.
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_ClusterGet(KineticCluster* cluster,
+                                       KineticEntry* const entry,
+                                       KineticCompletionClosure* closure);
+
+/**
+ * @brief Executes a DELETE command on the cluster drive owning the entry key.
+ *
+ * @param cluster       Cluster connected with KineticClient_ConnectCluster()
+ * @param entry         Key/value entry for object to delete, as for
+ *                      KineticClient_Delete()
+ * @param closure       Optional closure. If specified, operation will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called upon completion.
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_ClusterDelete(KineticCluster* cluster,
+                                          KineticEntry* const entry,
+                                          KineticCompletionClosure* closure);
+
+/**
+ * @brief Disconnects from each drive of a cluster, and releases the cluster.
+ *
+ * @param cluster       Pointer to the cluster, which is set to NULL
+ *
+ * @return              Returns the first failing status, if any
+ */
+KineticStatus KineticClient_DisconnectCluster(KineticCluster** const cluster);
+
+/**
+ * @brief Executes a PUT command on each of a set of replica sessions,
+ * completing once a quorum of them has stored the entry.
+ *
+ * @param handles       Handles of the sessions holding the replicas
+ * @param count         Number of replicas (up to KINETIC_REPLICAS_MAX)
+ * @param writeQuorum   Number of replicas which must succeed (1 to count)
+ * @param entry         Key/value entry for object to store, as for
+ *                      KineticClient_Put()
+ * @param closure       Optional closure. If specified, operation will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called upon completion.
+ *
+ * @return              Returns the resulting KineticStatus, which is the
+ *                      first replica failure if the quorum is not reached
+ */
+KineticStatus KineticClient_ReplicatedPut(const KineticSessionHandle* handles,
+                                          int count,
+                                          int writeQuorum,
+                                          KineticEntry* const entry,
+                                          KineticCompletionClosure* closure);
+
+/**
+ * @brief Executes a GET command on each of a set of replica sessions,
+ * completing with the newest version once a quorum of them has responded.
+ * Replicas found holding an older version, or no entry, are rewritten in
+ * the background with the newest version (read-repair). Repairs are
+ * conditional on the version each replica reported, so never overwrite a
+ * write made meanwhile.
+ *
+ * @param handles       Handles of the sessions holding the replicas
+ * @param count         Number of replicas (up to KINETIC_REPLICAS_MAX)
+ * @param readQuorum    Number of replicas which must respond (1 to count)
+ * @param entry         Key/value entry for object to retrieve, as for
+ *                      KineticClient_Get(). Versions are compared as
+ *                      unsigned big-endian numbers.
+ * @param closure       Optional closure. If specified, operation will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called upon completion.
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_ReplicatedGet(const KineticSessionHandle* handles,
+                                          int count,
+                                          int readQuorum,
+                                          KineticEntry* const entry,
+                                          KineticCompletionClosure* closure);
+
+/**
+ * @brief Executes a GET command on the preferred one of a set of replica
+ * sessions (or, if it is busier, by smoothed response latency and operations
+ * in flight, than another picked at random, on that one instead), hedging it
+ * with the next replica each time the last one asked has not
+ * responded within KINETIC_HEDGE_PERCENTILE of its recent GET latencies
+ * (KINETIC_HEDGE_DELAY_MS, until enough GETs have been seen). The first
+ * response completes the GET, and later ones are discarded. A replica which
+ * fails is followed by the next one at once.
+ *
+ * @param handles       Handles of the sessions holding the replicas, the
+ *                      preferred replica first
+ * @param count         Number of replicas (up to KINETIC_REPLICAS_MAX)
+ * @param entry         Key/value entry for object to retrieve, as for
+ *                      KineticClient_Get()
+ * @param closure       Optional closure. If specified, operation will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called upon completion.
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_HedgedGet(const KineticSessionHandle* handles,
+                                      int count,
+                                      KineticEntry* const entry,
+                                      KineticCompletionClosure* closure);
+
+/**
+ * @brief Stores an entry erasure coded across a set of sessions. The value is
+ * split into dataFragments fragments, and parityFragments Reed-Solomon parity
+ * fragments are computed from them, so that any dataFragments of the
+ * fragments suffice to retrieve the entry. Each fragment is stored under the
+ * entry key, with a PUT to its own session, and all are in flight at once.
+ *
+ * @param handles       Handles of the sessions holding the fragments, data
+ *                      fragments first (dataFragments + parityFragments of
+ *                      them, up to KINETIC_ERASURE_FRAGMENTS_MAX)
+ * @param dataFragments Number of fragments the value is split into
+ * @param parityFragments Number of fragments which may be lost
+ * @param entry         Key/value entry for object to store, as for
+ *                      KineticClient_Put()
+ * @param closure       Optional closure. If specified, operation will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called upon completion.
+ *
+ * @return              Returns the resulting KineticStatus, which is only
+ *                      successful once every fragment has been stored
+ */
+KineticStatus KineticClient_ErasurePut(const KineticSessionHandle* handles,
+                                       int dataFragments,
+                                       int parityFragments,
+                                       KineticEntry* const entry,
+                                       KineticCompletionClosure* closure);
+
+/**
+ * @brief Retrieves an entry stored with KineticClient_ErasurePut(), by
+ * requesting every fragment, and decoding the value from the first
+ * dataFragments of them to arrive.
+ *
+ * @param handles       Handles of the sessions holding the fragments, in the
+ *                      order specified when stored
+ * @param dataFragments Number of fragments the value was split into
+ * @param parityFragments Number of parity fragments stored
+ * @param entry         Key/value entry for object to retrieve, as for
+ *                      KineticClient_Get()
+ * @param closure       Optional closure. If specified, operation will be
+ *                      executed in asynchronous mode, and closure callback
+ *                      will be called upon completion.
+ *
+ * @return              Returns the resulting KineticStatus
+ */
+KineticStatus KineticClient_ErasureGet(const KineticSessionHandle* handles,
+                                       int dataFragments,
+                                       int parityFragments,
+                                       KineticEntry* const entry,
+                                       KineticCompletionClosure* closure);
+
 #endif // _KINETIC_CLIENT_H
@@ -45,6 +45,25 @@
 #define KINETIC_MAX_KEY_LEN     (4096)
 #define KINETIC_MAX_VERSION_LEN (256)
 #define KINETIC_OBJ_SIZE        (1024 * 1024)
+#define KINETIC_STREAM_CHUNKS_IN_FLIGHT (8)
+#define KINETIC_STREAM_SESSIONS_MAX     (16)
+#define KINETIC_CURSOR_READ_AHEAD       (4)
+#define KINETIC_KEY_SCAN_PARTITIONS_MAX (64)
+#define KINETIC_VALUE_SCAN_GETS_IN_FLIGHT (8)
+#define KINETIC_LOG_NAME_LEN            (32)
+#define KINETIC_LOG_UTILIZATIONS_MAX    (16)
+#define KINETIC_LOG_TEMPERATURES_MAX    (16)
+#define KINETIC_LOG_STATISTICS_MAX      (32)
+#define KINETIC_LOG_POLL_INTERVAL_MS    (1000)
+#define KINETIC_GROUP_COMMIT_WRITES     (32)
+#define KINETIC_GROUP_COMMIT_DELAY_MS   (10)
+#define KINETIC_SESSION_CONNECTIONS_MAX (16)
+#define KINETIC_CLUSTER_DRIVES_MAX      (64)
+#define KINETIC_CLUSTER_VIRTUAL_NODES   (128)
+#define KINETIC_REPLICAS_MAX            (8)
+#define KINETIC_ERASURE_FRAGMENTS_MAX   (16)
+#define KINETIC_HEDGE_DELAY_MS          (10)
+#define KINETIC_HEDGE_PERCENTILE        (95)
 
 // Define max host name length
 // Some Linux environments require this, although not all, but it's benign.
@@ -93,6 +112,20 @@ typedef enum _KineticSynchronization {
 typedef int KineticSessionHandle;
 
 
+/**
+ * @brief Policy for spreading the operations of a session across its
+ * connections, when more than one is opened to the device.
+ */
+typedef enum _KineticPoolPolicy {
+    // Use the connection with the fewest operations in flight
+    KINETIC_POOL_POLICY_LEAST_OUTSTANDING = 0,
+    // Use each connection in turn
+    KINETIC_POOL_POLICY_ROUND_ROBIN,
+    // Use the less loaded, by smoothed response latency and operations in
+    // flight, of the next connection in turn and another picked at random
+    KINETIC_POOL_POLICY_LEAST_LATENCY,
+} KineticPoolPolicy;
+
 /**
  * @brief Structure used to specify the configuration of a session.
  */
@@ -106,6 +139,30 @@ typedef struct _KineticSession {
     // Set to true to enable non-blocking/asynchronous I/O
     bool    nonBlocking;
 
+    // Set to true to service this session from the shared reactor threads
+    // instead of a dedicated worker thread (recommended for many sessions)
+    bool    useReactor;
+
+    // Number of operations to preallocate for this session, so that steady
+    // state requests do not touch the heap (0 selects the default depth)
+    int     poolDepth;
+
+    // Maximum number of operations allowed in flight on each connection of
+    // this session (0 for no limit), so a pooled session allows this many per
+    // connection. Once reached, new requests on a connection block until one
+    // of its responses arrives
+    int     outstandingOperationsMax;
+
+    // Set to true to have requests return KINETIC_STATUS_WOULD_BLOCK instead
+    // of blocking, while outstandingOperationsMax operations are in flight
+    bool    failOnFullWindow;
+
+    // Number of connections to open to the device (0 or 1 for a single
+    // connection, up to KINETIC_SESSION_CONNECTIONS_MAX). The operations of
+    // the session are spread across them according to poolPolicy
+    int     connections;
+    KineticPoolPolicy poolPolicy;
+
     // The version number of this cluster definition. If this is not equal to
     // the value on the Kinetic Device, the request is rejected and will return
     // `KINETIC_STATUS_VERSION_FAILURE`
@@ -156,6 +213,7 @@ typedef enum {
     KINETIC_STATUS_MEMORY_ERROR,        // Failed allocating/deallocating memory
     KINETIC_STATUS_SOCKET_TIMEOUT,      // A timeout occurred while waiting for a socket operation
     KINETIC_STATUS_SOCKET_ERROR,        // An I/O error occurred during a socket operation
+    KINETIC_STATUS_WOULD_BLOCK,         // Session has the maximum operations in flight (retry later)
     KINETIC_STATUS_COUNT                // Number of status codes in KineticStatusDescriptor
 } KineticStatus;
 
@@ -202,4 +260,167 @@ typedef struct _KineticKeyRange {
     bool reverse;
 } KineticKeyRange;
 
+// Kinetic key range iterator, which pages through a key range of any size
+// (opaque, since it is managed by the library)
+typedef struct _KineticKeyIterator KineticKeyIterator;
+
+// Callback reporting each key found by a key range scan
+typedef void (*KineticKeyScanCallback)(int partition, const ByteBuffer* key,
+                                       void* clientData);
+
+// Kinetic parallel key range scan structure. The range is split into
+// partitions by key prefix, which are scanned concurrently over the sessions
+// supplied.
+typedef struct _KineticKeyScan {
+    // Range of keys to scan. Both the start and end keys must be specified,
+    // and 'maxReturned' specifies the number of keys per page requested.
+    KineticKeyRange range;
+
+    // Number of partitions to split the range into (0 selects one for each
+    // session, up to KINETIC_KEY_SCAN_PARTITIONS_MAX)
+    int partitions;
+
+    // Set to true to report keys in key order (reversed, if the range is),
+    // otherwise keys are reported from each partition as they arrive
+    bool ordered;
+
+    // Callback called for each key found, from the calling thread
+    KineticKeyScanCallback callback;
+    void* clientData;
+} KineticKeyScan;
+
+// Callback reporting each entry retrieved by a value scan
+typedef void (*KineticValueScanCallback)(const KineticEntry* entry, void* clientData);
+
+// Kinetic cursor, which walks entries in key order, reading ahead once it is
+// used sequentially (opaque, since it is managed by the library)
+typedef struct _KineticCursor KineticCursor;
+
+// Kinetic cluster, which routes entries to its drives by consistent hashing of
+// their keys (opaque, since it is managed by the library)
+typedef struct _KineticCluster KineticCluster;
+
+// Callback reporting the completion of each chunk of a streamed object
+typedef void (*KineticStreamCallback)(int64_t chunk, int64_t chunkCount,
+                                      KineticStatus status, void* clientData);
+
+// Kinetic large object stream structure. The object is stored as a series of
+// chunk objects, keyed by the object key plus a generation and chunk index
+// suffix, and a manifest stored at the object key itself.
+typedef struct _KineticStream {
+    // Key of the object (up to KINETIC_MAX_KEY_LEN - 26 bytes long, since
+    // chunk keys are suffixed w/'.', a 16 digit hex generation, '.' and an
+    // 8 digit hex index)
+    ByteBuffer key;
+
+    // Object data. For a PUT, 'bytesUsed' specifies the object length. For a
+    // GET, the array must be large enough to hold the whole object, and
+    // 'bytesUsed' will be set to the object length.
+    ByteBuffer value;
+
+    // Size of each chunk (0 selects KINETIC_OBJ_SIZE, which is the maximum).
+    // Ignored for a GET, since it is read from the manifest.
+    size_t chunkSize;
+
+    // Maximum number of chunk operations in flight for this stream (0 selects
+    // KINETIC_STREAM_CHUNKS_IN_FLIGHT)
+    int chunksInFlight;
+
+    // Synchronization for each chunk and the manifest of a PUT
+    KineticSynchronization synchronization;
+
+    // Optional callback called as each chunk completes. It is called from
+    // the thread servicing the session, so must not block.
+    KineticStreamCallback progress;
+    void* clientData;
+} KineticStream;
+
+// Types of device log information, which may be combined to request several
+typedef enum _KineticLogType {
+    KINETIC_LOG_TYPE_UTILIZATIONS = 0x01,
+    KINETIC_LOG_TYPE_TEMPERATURES = 0x02,
+    KINETIC_LOG_TYPE_CAPACITIES = 0x04,
+    KINETIC_LOG_TYPE_STATISTICS = 0x08,
+    KINETIC_LOG_TYPE_LIMITS = 0x10,
+    KINETIC_LOG_TYPE_ALL = 0x1F,
+} KineticLogType;
+
+// Utilization of a device resource (e.g. "HDA" or "CPU"), from 0.0 to 1.0
+typedef struct _KineticLogUtilization {
+    char name[KINETIC_LOG_NAME_LEN];
+    float value;
+} KineticLogUtilization;
+
+// Temperatures of a device component, in degrees Celsius
+typedef struct _KineticLogTemperature {
+    char name[KINETIC_LOG_NAME_LEN];
+    float current;
+    float minimum;
+    float maximum;
+    float target;
+} KineticLogTemperature;
+
+// Capacity of the device
+typedef struct _KineticLogCapacity {
+    uint64_t nominalCapacityInBytes;
+    float portionFull;
+} KineticLogCapacity;
+
+// Count of operations, and bytes transferred, for a message type (e.g. "GET")
+typedef struct _KineticLogStatistic {
+    char messageType[KINETIC_LOG_NAME_LEN];
+    uint64_t count;
+    uint64_t bytes;
+} KineticLogStatistic;
+
+// Limits of the device
+typedef struct _KineticLogLimits {
+    uint32_t maxKeySize;
+    uint32_t maxValueSize;
+    uint32_t maxVersionSize;
+    uint32_t maxTagSize;
+    uint32_t maxConnections;
+    uint32_t maxOutstandingReadRequests;
+    uint32_t maxOutstandingWriteRequests;
+    uint32_t maxMessageSize;
+    uint32_t maxKeyRangeCount;
+} KineticLogLimits;
+
+// Kinetic device log, decoded from a GETLOG response. Only the information
+// of the types flagged in 'types' is valid.
+typedef struct _KineticDeviceLog {
+    int types;  // KineticLogType flags for the information populated
+    int utilizationCount;
+    KineticLogUtilization utilizations[KINETIC_LOG_UTILIZATIONS_MAX];
+    int temperatureCount;
+    KineticLogTemperature temperatures[KINETIC_LOG_TEMPERATURES_MAX];
+    KineticLogCapacity capacity;
+    int statisticCount;
+    KineticLogStatistic statistics[KINETIC_LOG_STATISTICS_MAX];
+    KineticLogLimits limits;
+} KineticDeviceLog;
+
+// Operation of a peer-to-peer push, copying a single entry to the peer
+typedef struct _KineticP2P_OperationData {
+    ByteBuffer key;             // key of the entry to copy
+    ByteBuffer version;         // optional version the entry must have
+    ByteBuffer newKey;          // optional key to store the entry at on the
+                                // peer (the entry key is used, if not specified)
+    bool force;                 // set to true to overwrite the entry on the
+                                // peer regardless of its version
+    KineticStatus resultStatus; // outcome of copying this entry
+} KineticP2P_OperationData;
+
+// Peer-to-peer push, which has the device copy entries directly to a peer
+// device, without the data passing through the client
+typedef struct _KineticP2P_Operation {
+    struct {
+        char hostname[HOST_NAME_MAX];
+        int port;
+        bool tls;
+    } peer;
+    size_t numOperations;
+    KineticP2P_OperationData* operations;
+} KineticP2P_Operation;
+
 #endif // _KINETIC_TYPES_H
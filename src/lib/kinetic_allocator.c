@@ -19,6 +19,7 @@
 */
 
 #include "kinetic_allocator.h"
+#include "kinetic_arena.h"
 #include "kinetic_logger.h"
 #include <stdlib.h>
 #include <pthread.h>
@@ -77,20 +78,56 @@ static void* KineticAllocator_GetNextListItem(KineticList* list, void* item_data
     return nextData;
 }
 
-static void* KineticAllocator_NewItem(KineticList* const list, size_t size)
+static inline KineticListItem* KineticAllocator_ItemFromData(void* data)
 {
-    KineticListItem* newItem = (KineticListItem*)malloc(sizeof(KineticListItem));
-    if (newItem == NULL) {
+    return (KineticListItem*)((uint8_t*)data - KINETIC_LIST_ITEM_HEADER_SIZE);
+}
+
+static KineticListItem* KineticAllocator_AllocateItem(size_t size)
+{
+    KineticListItem* item = (KineticListItem*)calloc(1, KINETIC_LIST_ITEM_HEADER_SIZE + size);
+    if (item == NULL) {
         LOG0("  Failed allocating new list item!");
         return NULL;
     }
-    memset(newItem, 0, sizeof(KineticListItem));
-    newItem->data = malloc(size);
-    if (newItem->data == NULL) {
-        LOG0("  Failed allocating data for list item!");
-        return NULL;
+    item->data = (uint8_t*)item + KINETIC_LIST_ITEM_HEADER_SIZE;
+    return item;
+}
+
+static void KineticAllocator_Preallocate(KineticList* const list, size_t size, size_t count)
+{
+    KINETIC_LIST_LOCK(list);
+    while (list->freeCount < count) {
+        KineticListItem* item = KineticAllocator_AllocateItem(size);
+        if (item == NULL) {
+            break;
+        }
+        item->next = list->free;
+        list->free = item;
+        list->freeCount++;
     }
-    memset(newItem->data, 0, size);
+    KINETIC_LIST_UNLOCK(list);
+}
+
+static void* KineticAllocator_NewItem(KineticList* const list, size_t size)
+{
+    // Reuse a pooled item, if available, otherwise fall back to the heap
+    KINETIC_LIST_LOCK(list);
+    KineticListItem* newItem = list->free;
+    if (newItem != NULL) {
+        list->free = newItem->next;
+        list->freeCount--;
+    }
+    KINETIC_LIST_UNLOCK(list);
+    if (newItem == NULL) {
+        newItem = KineticAllocator_AllocateItem(size);
+        if (newItem == NULL) {
+            return NULL;
+        }
+    }
+    newItem->next = NULL;
+    newItem->previous = NULL;
+    newItem->inUse = true;
 
     // Add the new item to the list
     KINETIC_LIST_LOCK(list);
@@ -112,65 +149,35 @@ static void* KineticAllocator_NewItem(KineticList* const list, size_t size)
 
 static void KineticAllocator_FreeItem(KineticList* const list, void* item)
 {
+    KineticListItem* cur = KineticAllocator_ItemFromData(item);
     KINETIC_LIST_LOCK(list);
-    KineticListItem* cur = list->start;
-    while (cur->data != item) {
-        if (cur->next == NULL) {
-            LOG1("  Reached end of list before finding item to free!");
-            KINETIC_LIST_UNLOCK(list);
-            return;
-        }
-        else {
-            cur = cur->next;
-        }
+    if (!cur->inUse) {
+        LOG1("  Item to free has already been released!");
+        KINETIC_LIST_UNLOCK(list);
+        return;
     }
-    LOG3("  Done searching for item list item");
-
-    if ((cur != NULL) && (cur->data == item)) {
-        LOG3("  item found! freeing it.");
-
-        // Handle PDU list emptied
-        if (cur->previous == NULL) {
-            LOG3("  At start of list.");
-            if (cur->next == NULL) {
-                LOG3("  Making it empty, since all deallocated!");
-                list->start = NULL;
-                list->last = NULL;
-            }
-            else {
-                LOG3("  Moving current item to head, since head deallocated!");
-                list->start = cur->next;
-                list->start->previous = NULL;
-            }
-        }
-        else {
-            // Relink from previous to next, if avaliable
-            LOG3("  Not at list start, so relinking list to free item.");
-            if (cur->previous->next != NULL) {
-                LOG3("  Relinking previous to next");
-                if (cur->next != NULL) {
-                    LOG3("    Next being reset!");
-                    cur->previous->next = cur->next;
-                }
-                else {
-                    list->last = cur->previous;
-                    list->last->next = NULL;
-                    LOGF3("    Next is NULL. End of list now @ 0x%0llX",
-                         (long long)list->last);
-                }
-            }
-            else {
-                LOG1("  This shouldn't happen!");
-                list->last = cur->previous;
-            }
-        }
 
-        LOGF3("  Freeing item (0x%0llX) w/data (0x%0llX)", cur, &cur->data);
-        free(cur->data);
-        cur->data = NULL;
-        free(cur);
-        cur = NULL;
+    // Unlink from the list of allocated items
+    if (cur->previous == NULL) {
+        list->start = cur->next;
+    }
+    else {
+        cur->previous->next = cur->next;
+    }
+    if (cur->next == NULL) {
+        list->last = cur->previous;
     }
+    else {
+        cur->next->previous = cur->previous;
+    }
+
+    // Return it to the pool for reuse
+    LOGF3("  Releasing item (0x%0llX) w/data (0x%0llX)", cur, cur->data);
+    cur->inUse = false;
+    cur->previous = NULL;
+    cur->next = list->free;
+    list->free = cur;
+    list->freeCount++;
     KINETIC_LIST_UNLOCK(list);
 }
 
@@ -180,32 +187,27 @@ static void KineticAllocator_FreeList(KineticList* const list)
         LOGF3("  Freeing list (0x%0llX) of all items...", list);
         KINETIC_LIST_LOCK(list);
         KineticListItem* current = list->start;
-
-        while (current->next != NULL) {
-            LOG3("  Advancing to next list item...");
-            current = current->next;
+        while (current != NULL) {
+            KineticListItem* next = current->next;
+            LOGF3("  Freeing list item (0x%0llX) w/ data (0x%llX)",
+                (long long)current, (long long)current->data);
+            free(current);
+            current = next;
         }
 
+        // Release the pooled items as well
+        current = list->free;
         while (current != NULL) {
-            KineticListItem* curItem = current;
-            KineticListItem* prevItem = current->previous;
-            if (curItem != NULL) {
-                LOGF3("  Freeing list item (0x%0llX) w/ data (0x%llX)",
-                    (long long)current,
-                    (long long)&current->data,
-                    (long long)current->previous);
-                if (curItem->data != NULL) {
-                    free(curItem->data);
-                }
-                free(curItem);
-            }
-            current = prevItem;
-            LOGF3("  on to previous list item (0x%llX)...", current);
+            KineticListItem* next = current->next;
+            free(current);
+            current = next;
         }
 
         // Make list empty, but leave mutex alone so the state is retained!
         list->start = NULL;
         list->last = NULL;
+        list->free = NULL;
+        list->freeCount = 0;
         KINETIC_LIST_UNLOCK(list);
     }
     else {
@@ -213,6 +215,19 @@ static void KineticAllocator_FreeList(KineticList* const list)
     }
 }
 
+void KineticAllocator_InitPools(KineticConnection* connection, int depth)
+{
+    assert(connection != NULL);
+    if (depth <= 0) {
+        depth = KINETIC_POOL_DEPTH_DEFAULT;
+    }
+    LOGF2("Preallocating %d operations on connection (0x%0llX)", depth, connection);
+
+    // Each operation carries a request PDU, and a response PDU once received
+    KineticAllocator_Preallocate(&connection->operations, sizeof(KineticOperation), depth);
+    KineticAllocator_Preallocate(&connection->pdus, sizeof(KineticPDU), depth * 2);
+}
+
 
 //==============================================================================
 // PDU List Support
@@ -229,7 +244,11 @@ KineticPDU* KineticAllocator_NewPDU(KineticConnection* connection)
         return NULL;
     }
     assert(newPDU->proto == NULL);
+
+    // Retain the arena of a pooled PDU, so its memory is reused
+    KineticArena arena = newPDU->arena;
     KINETIC_PDU_INIT(newPDU, connection);
+    newPDU->arena = arena;
     LOGF3("Allocated new PDU (0x%0llX) on connection", newPDU, connection);
     return newPDU;
 }
@@ -239,9 +258,18 @@ void KineticAllocator_FreePDU(KineticConnection* connection, KineticPDU* pdu)
     LOGF3("Freeing PDU (0x%0llX) on connection (0x%0llX)", pdu, connection);
     KINETIC_LIST_LOCK(&connection->pdus);
     if ((pdu->proto != NULL) && pdu->protobufDynamicallyExtracted) {
-        LOG3("Freeing dynamically allocated protobuf");
-        KineticProto_Message__free_unpacked(pdu->proto, NULL);
-    };
+        LOG3("Releasing unpacked protobuf");
+        KineticArena_Reset(&pdu->arena);
+        pdu->proto = NULL;
+        pdu->command = NULL;
+        pdu->protobufDynamicallyExtracted = false;
+    }
+    else {
+        // Request protobufs are embedded in the PDU, so just drop the
+        // reference, and release any variable sized parts built in the arena
+        KineticArena_Reset(&pdu->arena);
+        pdu->proto = NULL;
+    }
     KINETIC_LIST_UNLOCK(&connection->pdus);
     KineticAllocator_FreeItem(&connection->pdus, (void*)pdu);
     LOGF3("Freed PDU (0x%0llX) on connection (0x%0llX)", pdu, connection);
@@ -262,24 +290,30 @@ KineticPDU* KineticAllocator_GetNextPDU(KineticConnection* connection, KineticPD
 void KineticAllocator_FreeAllPDUs(KineticConnection* connection)
 {
     assert(connection != NULL);
-    if (connection->pdus.start != NULL) {
+    if (connection->pdus.start != NULL || connection->pdus.free != NULL) {
         LOG3("Freeing all PDUs...");
         KINETIC_LIST_LOCK(&connection->pdus);
-        KineticListItem* current = connection->pdus.start;
-        while (current != NULL) {
-            KineticPDU* pdu = (KineticPDU*)current->data;
-            if (pdu != NULL && pdu->proto != NULL
-                && pdu->protobufDynamicallyExtracted) {
-                KineticProto_Message__free_unpacked(pdu->proto, NULL);
+
+        // Release the unpacking arenas of both live and pooled PDUs
+        KineticListItem* lists[] = {connection->pdus.start, connection->pdus.free};
+        for (size_t i = 0; i < sizeof(lists) / sizeof(lists[0]); i++) {
+            KineticListItem* current = lists[i];
+            while (current != NULL) {
+                KineticPDU* pdu = (KineticPDU*)current->data;
+                if (pdu != NULL) {
+                    KineticArena_Free(&pdu->arena);
+                    pdu->proto = NULL;
+                    pdu->protobufDynamicallyExtracted = false;
+                }
+                current = current->next;
             }
-            current = current->next;
         }
         KINETIC_LIST_UNLOCK(&connection->pdus);
-        KineticAllocator_FreeList(&connection->pdus);
     }
     else {
         LOG1("  Nothing to free!");
     }
+    KineticAllocator_FreeList(&connection->pdus);
 }
 
 
@@ -366,6 +400,7 @@ void KineticAllocator_FreeAllOperations(KineticConnection* const connection)
     else {
         LOG1("  Nothing to free!");
     }
+    KineticAllocator_FreeList(&connection->operations);
 }
 
 bool KineticAllocator_ValidateAllMemoryFreed(KineticConnection* const connection)
@@ -24,6 +24,7 @@
 #include "kinetic_types_internal.h"
 
 void KineticAllocator_InitLists(KineticConnection* connection);
+void KineticAllocator_InitPools(KineticConnection* connection, int depth);
 
 KineticPDU* KineticAllocator_NewPDU(KineticConnection* connection);
 void KineticAllocator_FreePDU(KineticConnection* connection, KineticPDU* pdu);
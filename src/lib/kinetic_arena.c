@@ -0,0 +1,133 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_arena.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+
+#define KINETIC_ARENA_ALIGN(_size) \
+    (((_size) + (KINETIC_ARENA_ALIGNMENT - 1)) & ~(size_t)(KINETIC_ARENA_ALIGNMENT - 1))
+
+// Overflow chunk header, padded so the data following it stays aligned
+typedef union _KineticArenaChunk {
+    union _KineticArenaChunk* next;
+    uint8_t padding[KINETIC_ARENA_ALIGNMENT];
+} KineticArenaChunk;
+
+void* KineticArena_Alloc(KineticArena* const arena, size_t size)
+{
+    assert(arena != NULL);
+    size = KINETIC_ARENA_ALIGN(size);
+
+    if (arena->data == NULL) {
+        size_t initial = KINETIC_ARENA_SIZE_DEFAULT;
+        while (initial < size) {
+            initial *= 2;
+        }
+        arena->data = (uint8_t*)malloc(initial);
+        if (arena->data == NULL) {
+            LOG0("Failed allocating arena memory!");
+            return NULL;
+        }
+        arena->size = initial;
+        arena->used = 0;
+    }
+
+    // Bump allocate from the primary block, if there is room
+    if (arena->size - arena->used >= size) {
+        void* ptr = &arena->data[arena->used];
+        arena->used += size;
+        return ptr;
+    }
+
+    // Otherwise, spill into a dedicated chunk until the next reset
+    KineticArenaChunk* chunk = (KineticArenaChunk*)malloc(sizeof(KineticArenaChunk) + size);
+    if (chunk == NULL) {
+        LOG0("Failed allocating arena overflow memory!");
+        return NULL;
+    }
+    chunk->next = arena->overflow;
+    arena->overflow = chunk;
+    arena->overflowSize += size;
+    return &chunk[1];
+}
+
+static void* KineticArena_ProtobufAlloc(void* allocator_data, size_t size)
+{
+    return KineticArena_Alloc((KineticArena*)allocator_data, size);
+}
+
+static void KineticArena_ProtobufFree(void* allocator_data, void* pointer)
+{
+    // Arena memory is only released in bulk by KineticArena_Reset()
+    (void)allocator_data;
+    (void)pointer;
+}
+
+ProtobufCAllocator KineticArena_GetAllocator(KineticArena* const arena)
+{
+    assert(arena != NULL);
+    return (ProtobufCAllocator) {
+        .alloc = KineticArena_ProtobufAlloc,
+        .free = KineticArena_ProtobufFree,
+        .allocator_data = arena,
+    };
+}
+
+static void KineticArena_FreeOverflow(KineticArena* const arena)
+{
+    KineticArenaChunk* chunk = arena->overflow;
+    while (chunk != NULL) {
+        KineticArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->overflow = NULL;
+    arena->overflowSize = 0;
+}
+
+void KineticArena_Reset(KineticArena* const arena)
+{
+    assert(arena != NULL);
+
+    // Grow the primary block to hold everything the last use needed, so
+    // that similarly sized messages fit without spilling next time
+    if (arena->overflowSize > 0) {
+        size_t needed = arena->used + arena->overflowSize;
+        size_t newSize = arena->size;
+        while (newSize < needed) {
+            newSize *= 2;
+        }
+        LOGF3("Growing arena from %zu to %zu bytes", arena->size, newSize);
+        KineticArena_FreeOverflow(arena);
+        free(arena->data);
+        arena->data = (uint8_t*)malloc(newSize);
+        arena->size = (arena->data != NULL) ? newSize : 0;
+    }
+    arena->used = 0;
+}
+
+void KineticArena_Free(KineticArena* const arena)
+{
+    assert(arena != NULL);
+    KineticArena_FreeOverflow(arena);
+    free(arena->data);
+    *arena = (KineticArena) {.data = NULL};
+}
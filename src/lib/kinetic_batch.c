@@ -0,0 +1,295 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_batch.h"
+#include "kinetic_connection.h"
+#include "kinetic_allocator.h"
+#include "kinetic_operation.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+// Completion tracking for a batch without per-entry closures. Synchronous
+// batches are released by the caller, after waiting on them; asynchronous
+// ones by whichever thread finishes the last entry, which then calls closure.
+typedef struct _KineticBatchItem {
+    struct _KineticBatch* batch;
+    int index;
+    KineticOperation* operation;
+    KineticStatus status;
+    bool done;
+} KineticBatchItem;
+
+typedef struct _KineticBatch {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int count;
+    int remaining;
+    KineticStatus* statuses;
+    KineticCompletionClosure closure;
+    KineticBatchItem items[];
+} KineticBatch;
+
+static KineticBatch* KineticBatch_Create(int count, KineticStatus* statuses,
+    KineticCompletionClosure* closure)
+{
+    KineticBatch* batch = (KineticBatch*)calloc(1,
+        sizeof(KineticBatch) + count * sizeof(KineticBatchItem));
+    if (batch == NULL) {
+        LOG0("Failed allocating batch tracking items!");
+        return NULL;
+    }
+    pthread_mutex_init(&batch->mutex, NULL);
+    Kinetic_InitCondition(&batch->cond);
+    batch->count = count;
+    batch->remaining = count;
+    batch->statuses = statuses;
+    if (closure != NULL) {
+        batch->closure = *closure;
+    }
+    for (int i = 0; i < count; i++) {
+        batch->items[i].batch = batch;
+        batch->items[i].index = i;
+        batch->items[i].status = KINETIC_STATUS_INVALID;
+    }
+    return batch;
+}
+
+// Reports the status of each entry, and releases the batch, returning the
+// status of the first entry that failed, if any
+static KineticStatus KineticBatch_Destroy(KineticBatch* const batch)
+{
+    KineticStatus status = KINETIC_STATUS_SUCCESS;
+    for (int i = 0; i < batch->count; i++) {
+        if (batch->statuses != NULL) {
+            batch->statuses[i] = batch->items[i].status;
+        }
+        if (status == KINETIC_STATUS_SUCCESS) {
+            status = batch->items[i].status;
+        }
+    }
+    pthread_cond_destroy(&batch->cond);
+    pthread_mutex_destroy(&batch->mutex);
+    free(batch);
+    return status;
+}
+
+// Records the final status of an entry (batch mutex must be held)
+static void KineticBatch_Finish(KineticBatchItem* const item, KineticStatus status)
+{
+    item->status = status;
+    item->done = true;
+    item->batch->remaining--;
+    pthread_cond_broadcast(&item->batch->cond);
+}
+
+static void KineticBatch_Completed(KineticCompletionData* kinetic_data, void* client_data)
+{
+    KineticBatchItem* item = (KineticBatchItem*)client_data;
+    KineticBatch* batch = item->batch;
+    pthread_mutex_lock(&batch->mutex);
+    KineticBatch_Finish(item, kinetic_data->status);
+    bool complete = (batch->remaining == 0 && batch->closure.callback != NULL);
+    pthread_mutex_unlock(&batch->mutex);
+
+    if (complete) {
+        KineticCompletionClosure closure = batch->closure;
+        KineticCompletionData completionData = {.status = KineticBatch_Destroy(batch)};
+        closure.callback(&completionData, closure.clientData);
+    }
+}
+
+// Reports an entry that never made it onto the wire
+static void KineticBatch_Fail(KineticBatch* const batch,
+    KineticCompletionClosure* const closures, int index, KineticStatus status)
+{
+    KineticCompletionData completionData = {.status = status};
+    if (closures != NULL) {
+        closures[index].callback(&completionData, closures[index].clientData);
+    }
+    else {
+        KineticBatch_Completed(&completionData, &batch->items[index]);
+    }
+}
+
+// Submits up to KINETIC_BATCH_OPERATIONS_MAX requests with a single write.
+// Only the first is allowed to wait on the in-flight window, so that a full
+// window flushes what has been built so far, rather than holding it back.
+static KineticStatus KineticBatch_SubmitChunk(KineticConnection* const connection,
+    KineticEntry* const entries, int count, KineticBatchBuilder build,
+    KineticBatch* const batch, KineticCompletionClosure* const closures,
+    int* next)
+{
+    KineticOperation* operations[KINETIC_BATCH_OPERATIONS_MAX];
+    KineticStatus status = KINETIC_STATUS_SUCCESS;
+    const int first = *next;
+    int built = 0;
+
+    while (*next < count && built < KINETIC_BATCH_OPERATIONS_MAX) {
+        if (built == 0) {
+            status = KineticConnection_AcquireWindow(connection);
+        }
+        else {
+            status = KineticConnection_TryAcquireWindow(connection);
+            if (status == KINETIC_STATUS_WOULD_BLOCK) {
+                status = KINETIC_STATUS_SUCCESS;
+                break;
+            }
+        }
+        if (status != KINETIC_STATUS_SUCCESS) {
+            break;
+        }
+
+        KineticOperation* operation = KineticAllocator_NewOperation(connection);
+        if (operation == NULL || operation->request == NULL) {
+            status = (operation == NULL) ?
+                KINETIC_STATUS_MEMORY_ERROR : KINETIC_STATUS_NO_PDUS_AVAVILABLE;
+            if (operation != NULL) {
+                KineticAllocator_FreeOperation(connection, operation);
+            }
+            KineticConnection_ReleaseWindow(connection);
+            break;
+        }
+
+        build(operation, &entries[*next]);
+        if (closures != NULL) {
+            operation->closure = closures[*next];
+        }
+        else {
+            batch->items[*next].operation = operation;
+            operation->closure = (KineticCompletionClosure) {
+                .callback = KineticBatch_Completed,
+                .clientData = &batch->items[*next],
+            };
+        }
+        operations[built++] = operation;
+        (*next)++;
+    }
+
+    // Send whatever was built, even if building the rest failed
+    if (built > 0) {
+        LOGF1("Submitting batch entries %d-%d", first, first + built - 1);
+        KineticStatus sendStatus = KineticOperation_SendRequests(operations, built);
+        if (sendStatus != KINETIC_STATUS_SUCCESS) {
+            for (int i = 0; i < built; i++) {
+                // Requests already claimed by the receiver will complete there
+                if (operations[i] != NULL) {
+                    KineticAllocator_FreeOperation(connection, operations[i]);
+                    KineticConnection_ReleaseWindow(connection);
+                    KineticBatch_Fail(batch, closures, first + i, sendStatus);
+                }
+            }
+            status = sendStatus;
+        }
+    }
+
+    return status;
+}
+
+// Waits for all entries of a synchronous batch to complete. Operations which
+// see no progress for KINETIC_PDU_RECEIVE_TIMEOUT_SECS are abandoned.
+static void KineticBatch_Wait(KineticBatch* const batch)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+
+    pthread_mutex_lock(&batch->mutex);
+    int remaining = batch->remaining;
+    while (batch->remaining > 0) {
+        int waitStatus = pthread_cond_timedwait(&batch->cond, &batch->mutex, &deadline);
+        if (batch->remaining < remaining) {
+            remaining = batch->remaining;
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+            deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+        }
+        else if (waitStatus == ETIMEDOUT) {
+            LOGF0("Timed out waiting on %d batch response(s)!", batch->remaining);
+            for (int i = 0; i < batch->count; i++) {
+                // If the response was already claimed by the receiver, it is
+                // still using the operation, so wait for it to finish
+                KineticBatchItem* item = &batch->items[i];
+                if (!item->done && KineticOperation_Abandon(item->operation)) {
+                    KineticBatch_Finish(item, KINETIC_STATUS_SOCKET_TIMEOUT);
+                }
+            }
+            remaining = batch->remaining;
+            deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+        }
+    }
+    pthread_mutex_unlock(&batch->mutex);
+}
+
+KineticStatus KineticBatch_Execute(KineticConnection* const connection,
+    KineticEntry* const entries, int count, KineticBatchBuilder build,
+    KineticStatus* statuses, KineticCompletionClosure* closures,
+    KineticCompletionClosure* closure)
+{
+    assert(connection != NULL);
+    assert(entries != NULL);
+    assert(build != NULL);
+    assert(count >= 0);
+    assert(closures == NULL || closure == NULL);
+    if (count == 0) {
+        if (closure != NULL) {
+            KineticCompletionData completionData = {.status = KINETIC_STATUS_SUCCESS};
+            closure->callback(&completionData, closure->clientData);
+        }
+        return KINETIC_STATUS_SUCCESS;
+    }
+
+    KineticBatch* batch = NULL;
+    if (closures != NULL) {
+        for (int i = 0; i < count; i++) {
+            assert(closures[i].callback != NULL);
+        }
+    }
+    else {
+        assert(closure == NULL || closure->callback != NULL);
+        batch = KineticBatch_Create(count, statuses, closure);
+        if (batch == NULL) {
+            return KINETIC_STATUS_MEMORY_ERROR;
+        }
+    }
+
+    // An asynchronous batch may complete, and be released, as soon as its
+    // last entry is reported, so it must not be touched after that point
+    const bool synchronous = (closures == NULL && closure == NULL);
+    KineticStatus status = KINETIC_STATUS_SUCCESS;
+    int next = 0;
+    while (next < count && status == KINETIC_STATUS_SUCCESS) {
+        status = KineticBatch_SubmitChunk(connection, entries, count, build,
+            batch, closures, &next);
+    }
+
+    // Fail any entries left unsubmitted
+    for (; next < count; next++) {
+        KineticBatch_Fail(batch, closures, next, status);
+    }
+
+    if (!synchronous) {
+        return status;
+    }
+
+    KineticBatch_Wait(batch);
+    return KineticBatch_Destroy(batch);
+}
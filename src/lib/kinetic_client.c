@@ -26,34 +26,93 @@
 #include "kinetic_message.h"
 #include "kinetic_pdu.h"
 #include "kinetic_allocator.h"
+#include "kinetic_batch.h"
+#include "kinetic_stream.h"
+#include "kinetic_key_iterator.h"
+#include "kinetic_cursor.h"
+#include "kinetic_key_scan.h"
+#include "kinetic_value_scan.h"
+#include "kinetic_log_poller.h"
+#include "kinetic_group_commit.h"
+#include "kinetic_session_pool.h"
+#include "kinetic_cluster.h"
+#include "kinetic_replication.h"
+#include "kinetic_erasure.h"
+#include "kinetic_hedge.h"
 #include "kinetic_logger.h"
 #include <stdlib.h>
 #include <sys/time.h>
 
-static KineticStatus KineticClient_CreateOperation(
-    KineticOperation** operation,
-    KineticSessionHandle handle)
+// Resolves the connections of a set of sessions. Unless the request relies
+// on state kept by the session itself (log polling or group commit), the
+// requests of a pooled session are spread across its connections.
+static KineticStatus KineticClient_GetConnections(
+    KineticConnection** connections,
+    const KineticSessionHandle* handles,
+    int count,
+    int max,
+    bool pooled)
 {
-    if (handle == KINETIC_HANDLE_INVALID) {
-        LOG0("Specified session has invalid handle value");
+    if (count < 1 || count > max) {
+        LOGF0("Invalid number of sessions specified (%d of up to %d)!", count, max);
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+    if (handles == NULL) {
+        LOG0("No sessions specified");
         return KINETIC_STATUS_SESSION_EMPTY;
     }
+    for (int i = 0; i < count; i++) {
+        if (handles[i] == KINETIC_HANDLE_INVALID) {
+            LOG0("Specified session has invalid handle value");
+            return KINETIC_STATUS_SESSION_EMPTY;
+        }
+        connections[i] = KineticConnection_FromHandle(handles[i]);
+        if (connections[i] == NULL) {
+            LOG0("Specified session is not associated with a connection");
+            return KINETIC_STATUS_SESSION_INVALID;
+        }
+        if (pooled && connections[i]->pool != NULL) {
+            connections[i] = KineticSessionPool_Select(connections[i]->pool);
+        }
+    }
+    return KINETIC_STATUS_SUCCESS;
+}
 
-    KineticConnection* connection = KineticConnection_FromHandle(handle);
-    if (connection == NULL) {
-        LOG0("Specified session is not associated with a connection");
-        return KINETIC_STATUS_SESSION_INVALID;
+static KineticStatus KineticClient_GetConnection(
+    KineticConnection** connection,
+    KineticSessionHandle handle,
+    bool pooled)
+{
+    return KineticClient_GetConnections(connection, &handle, 1, 1, pooled);
+}
+
+static KineticStatus KineticClient_CreateOperation(
+    KineticOperation** operation,
+    KineticSessionHandle handle)
+{
+    KineticConnection* connection;
+    KineticStatus status = KineticClient_GetConnection(&connection, handle, true);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        return status;
     }
 
     LOGF1("\n"
          "--------------------------------------------------\n"
          "Building new operation on connection @ 0x%llX", connection);
 
+    // Admit the operation into the session in-flight window
+    status = KineticConnection_AcquireWindow(connection);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        return status;
+    }
+
     *operation = KineticAllocator_NewOperation(connection);
     if (*operation == NULL) {
+        KineticConnection_ReleaseWindow(connection);
         return KINETIC_STATUS_MEMORY_ERROR;
     }
     if ((*operation)->request == NULL) {
+        KineticConnection_ReleaseWindow(connection);
         return KINETIC_STATUS_NO_PDUS_AVAVILABLE;
     }
 
@@ -80,6 +139,9 @@ static KineticStatus KineticClient_ExecuteOperation(KineticOperation* operation)
     // Send the request
     status = KineticOperation_SendRequest(operation);
     if (status != KINETIC_STATUS_SUCCESS) {
+        KineticConnection* connection = operation->connection;
+        KineticAllocator_FreeOperation(connection, operation);
+        KineticConnection_ReleaseWindow(connection);
         return status;
     }
 
@@ -93,6 +155,7 @@ void KineticClient_Init(const char* log_file, int log_level)
 
 void KineticClient_Shutdown(void)
 {
+    KineticHedge_Shutdown();
     KineticLogger_Close();
 }
 
@@ -144,6 +207,18 @@ KineticStatus KineticClient_Connect(const KineticSession* config,
     // Wait for initial unsolicited status to be received in order to obtain connectionID
     while(connection->connectionID == 0) {sleep(1);}
 
+    // Open the other connections of a pooled session
+    if (config->connections > 1) {
+        status = KineticSessionPool_Connect(connection);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            LOGF0("Failed creating pooled connections to %s:%d", config->host, config->port);
+            KineticConnection_Disconnect(connection);
+            KineticConnection_FreeConnection(handle);
+            *handle = KINETIC_HANDLE_INVALID;
+            return status;
+        }
+    }
+
     return status;
 }
 
@@ -159,6 +234,15 @@ KineticStatus KineticClient_Disconnect(KineticSessionHandle* const handle)
         return KINETIC_STATUS_CONNECTION_ERROR;
     }
 
+    // Stop background polling and group commit, since they use the connection
+    KineticLogPoller_Stop(connection);
+    KineticGroupCommit_Stop(connection);
+
+    // Close the other connections of a pooled session
+    if (connection->pool != NULL) {
+        KineticSessionPool_Disconnect(connection);
+    }
+
     // Disconnect
     KineticStatus status = KineticConnection_Disconnect(connection);
     if (status != KINETIC_STATUS_SUCCESS) {LOG0("Disconnection failed!");}
@@ -168,6 +252,20 @@ KineticStatus KineticClient_Disconnect(KineticSessionHandle* const handle)
     return status;
 }
 
+KineticStatus KineticClient_WaitUntilWindowAvailable(KineticSessionHandle handle)
+{
+    KineticConnection* connection;
+    KineticStatus status = KineticClient_GetConnection(&connection, handle, false);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    // Requests are spread across the connections of a pooled session, each
+    // w/its own window, so room in any of them will do
+    if (connection->pool != NULL) {
+        return KineticSessionPool_WaitForWindow(connection->pool);
+    }
+    return KineticConnection_WaitForWindow(connection);
+}
+
 KineticStatus KineticClient_NoOp(KineticSessionHandle handle)
 {
     KineticStatus status;
@@ -203,6 +301,25 @@ KineticStatus KineticClient_Put(KineticSessionHandle handle,
     return KineticClient_ExecuteOperation(operation);
 }
 
+KineticStatus KineticClient_PutBatch(KineticSessionHandle handle,
+                                     KineticEntry* const entries,
+                                     int count,
+                                     KineticStatus* statuses,
+                                     KineticCompletionClosure* closures)
+{
+    assert(entries != NULL || count == 0);
+    for (int i = 0; i < count; i++) {
+        assert(entries[i].value.array.data != NULL);
+    }
+    KineticConnection* connection;
+    KineticStatus status = KineticClient_GetConnection(&connection, handle, true);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    LOGF1("Executing batch of %d PUT operation(s)", count);
+    return KineticBatch_Execute(connection, entries, count,
+        KineticOperation_BuildPut, statuses, closures, NULL);
+}
+
 KineticStatus KineticClient_Get(KineticSessionHandle handle,
                                 KineticEntry* const entry,
                                 KineticCompletionClosure* closure)
@@ -222,6 +339,93 @@ KineticStatus KineticClient_Get(KineticSessionHandle handle,
     return KineticClient_ExecuteOperation(operation);
 }
 
+KineticStatus KineticClient_GetNext(KineticSessionHandle handle,
+                                    KineticEntry* const entry,
+                                    KineticCompletionClosure* closure)
+{
+    assert(entry != NULL);
+    if (!entry->metadataOnly) {assert(entry->value.array.data != NULL);}
+    KineticStatus status;
+    KineticOperation* operation;
+    status = KineticClient_CreateOperation(&operation, handle);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    // Initialize request
+    KineticOperation_BuildGetNext(operation, entry);
+    if (closure != NULL) {operation->closure = *closure;}
+
+    // Execute the operation
+    return KineticClient_ExecuteOperation(operation);
+}
+
+KineticStatus KineticClient_GetPrevious(KineticSessionHandle handle,
+                                        KineticEntry* const entry,
+                                        KineticCompletionClosure* closure)
+{
+    assert(entry != NULL);
+    if (!entry->metadataOnly) {assert(entry->value.array.data != NULL);}
+    KineticStatus status;
+    KineticOperation* operation;
+    status = KineticClient_CreateOperation(&operation, handle);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    // Initialize request
+    KineticOperation_BuildGetPrevious(operation, entry);
+    if (closure != NULL) {operation->closure = *closure;}
+
+    // Execute the operation
+    return KineticClient_ExecuteOperation(operation);
+}
+
+KineticStatus KineticClient_GetMany(KineticSessionHandle handle,
+                                    KineticEntry* const entries,
+                                    int count,
+                                    KineticStatus* statuses,
+                                    KineticCompletionClosure* closure)
+{
+    assert(entries != NULL || count == 0);
+    for (int i = 0; i < count; i++) {
+        if (!entries[i].metadataOnly) {assert(entries[i].value.array.data != NULL);}
+    }
+    KineticConnection* connection;
+    KineticStatus status = KineticClient_GetConnection(&connection, handle, true);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    LOGF1("Executing batch of %d GET operation(s)", count);
+    return KineticBatch_Execute(connection, entries, count,
+        KineticOperation_BuildGet, statuses, NULL, closure);
+}
+
+KineticStatus KineticClient_PutStream(const KineticSessionHandle* handles,
+                                      int count,
+                                      KineticStream* const stream)
+{
+    assert(stream != NULL);
+    KineticConnection* connections[KINETIC_STREAM_SESSIONS_MAX];
+    KineticStatus status = KineticClient_GetConnections(connections, handles, count,
+        KINETIC_STREAM_SESSIONS_MAX, true);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    LOGF1("Executing streamed PUT of %zu bytes on %d session(s)",
+        stream->value.bytesUsed, count);
+    return KineticStream_Put(connections, count, stream);
+}
+
+KineticStatus KineticClient_GetStream(const KineticSessionHandle* handles,
+                                      int count,
+                                      KineticStream* const stream)
+{
+    assert(stream != NULL);
+    assert(stream->value.array.data != NULL);
+    KineticConnection* connections[KINETIC_STREAM_SESSIONS_MAX];
+    KineticStatus status = KineticClient_GetConnections(connections, handles, count,
+        KINETIC_STREAM_SESSIONS_MAX, true);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    LOGF1("Executing streamed GET on %d session(s)", count);
+    return KineticStream_Get(connections, count, stream);
+}
+
 KineticStatus KineticClient_Delete(KineticSessionHandle handle,
                                    KineticEntry* const entry,
                                    KineticCompletionClosure* closure)
@@ -266,3 +470,450 @@ KineticStatus KineticClient_GetKeyRange(KineticSessionHandle handle,
     // Execute the operation
     return KineticClient_ExecuteOperation(operation);
 }
+
+KineticStatus KineticClient_OpenKeyIterator(KineticSessionHandle handle,
+                                            const KineticKeyRange* range,
+                                            KineticKeyIterator** iterator)
+{
+    assert(range != NULL);
+    assert(iterator != NULL);
+    KineticConnection* connection;
+    KineticStatus status = KineticClient_GetConnection(&connection, handle, true);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    LOGF1("Opening key iterator w/%d keys per page", range->maxReturned);
+    return KineticKeyIterator_Open(connection, range, iterator);
+}
+
+KineticStatus KineticClient_NextKey(KineticKeyIterator* iterator, ByteBuffer* key)
+{
+    assert(iterator != NULL);
+    assert(key != NULL);
+    return KineticKeyIterator_Next(iterator, key);
+}
+
+void KineticClient_CloseKeyIterator(KineticKeyIterator* iterator)
+{
+    KineticKeyIterator_Close(iterator);
+}
+
+KineticStatus KineticClient_ScanKeyRange(const KineticSessionHandle* handles,
+                                         int count,
+                                         KineticKeyScan* const scan)
+{
+    assert(scan != NULL);
+    KineticConnection* connections[KINETIC_KEY_SCAN_PARTITIONS_MAX];
+    KineticStatus status = KineticClient_GetConnections(connections, handles, count,
+        KINETIC_KEY_SCAN_PARTITIONS_MAX, true);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    LOGF1("Executing %s key range scan on %d session(s)",
+        scan->ordered ? "ordered" : "unordered", count);
+    return KineticKeyScan_Execute(connections, count, scan);
+}
+
+KineticStatus KineticClient_ScanValues(KineticSessionHandle handle,
+                                       const KineticKeyRange* range,
+                                       int getsInFlight,
+                                       KineticValueScanCallback callback,
+                                       void* clientData)
+{
+    assert(range != NULL);
+    assert(callback != NULL);
+    KineticConnection* connection;
+    KineticStatus status = KineticClient_GetConnection(&connection, handle, true);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    LOGF1("Executing value scan w/%d GETs in flight", getsInFlight);
+    return KineticValueScan_Execute(connection, range, getsInFlight, callback, clientData);
+}
+
+KineticStatus KineticClient_OpenCursor(KineticSessionHandle handle,
+                                       const ByteBuffer* startKey,
+                                       bool reverse,
+                                       int readAhead,
+                                       KineticCursor** cursor)
+{
+    assert(startKey != NULL);
+    assert(cursor != NULL);
+    KineticConnection* connection;
+    KineticStatus status = KineticClient_GetConnection(&connection, handle, true);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    LOGF1("Opening %s cursor w/%d entries read ahead",
+        reverse ? "reverse" : "forward", readAhead);
+    return KineticCursor_Open(connection, startKey, reverse, readAhead, cursor);
+}
+
+KineticStatus KineticClient_NextEntry(KineticCursor* cursor, KineticEntry* const entry)
+{
+    assert(cursor != NULL);
+    assert(entry != NULL);
+    return KineticCursor_Next(cursor, entry);
+}
+
+KineticStatus KineticClient_SeekCursor(KineticCursor* cursor, const ByteBuffer* key)
+{
+    assert(cursor != NULL);
+    assert(key != NULL);
+    return KineticCursor_Seek(cursor, key);
+}
+
+void KineticClient_CloseCursor(KineticCursor* cursor)
+{
+    KineticCursor_Close(cursor);
+}
+
+KineticStatus KineticClient_GetLog(KineticSessionHandle handle,
+                                   int types,
+                                   KineticDeviceLog* log,
+                                   KineticCompletionClosure* closure)
+{
+    assert(handle != KINETIC_HANDLE_INVALID);
+    assert(log != NULL);
+    if ((types & KINETIC_LOG_TYPE_ALL) == 0 || (types & ~KINETIC_LOG_TYPE_ALL) != 0) {
+        LOG0("Invalid device log types specified!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    KineticStatus status;
+    KineticOperation* operation;
+
+    status = KineticClient_CreateOperation(&operation, handle);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        return status;
+    }
+
+    // Initialize request
+    KineticOperation_BuildGetLog(operation, types, log);
+    if (closure != NULL) {operation->closure = *closure;}
+
+    // Execute the operation
+    return KineticClient_ExecuteOperation(operation);
+}
+
+KineticStatus KineticClient_StartLogPolling(KineticSessionHandle handle,
+                                            int types,
+                                            int intervalMillis)
+{
+    KineticConnection* connection;
+    KineticStatus status = KineticClient_GetConnection(&connection, handle, false);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    LOGF1("Starting device log polling every %dms", intervalMillis);
+    return KineticLogPoller_Start(connection, types, intervalMillis);
+}
+
+KineticStatus KineticClient_GetLogSnapshot(KineticSessionHandle handle,
+                                           KineticDeviceLog* log)
+{
+    assert(log != NULL);
+    KineticConnection* connection;
+    KineticStatus status = KineticClient_GetConnection(&connection, handle, false);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    return KineticLogPoller_GetSnapshot(connection, log);
+}
+
+KineticStatus KineticClient_StopLogPolling(KineticSessionHandle handle)
+{
+    KineticConnection* connection;
+    KineticStatus status = KineticClient_GetConnection(&connection, handle, false);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    KineticLogPoller_Stop(connection);
+    return KINETIC_STATUS_SUCCESS;
+}
+
+KineticStatus KineticClient_Flush(KineticSessionHandle handle,
+                                  KineticCompletionClosure* closure)
+{
+    KineticConnection* connection;
+    KineticStatus status = KineticClient_GetConnection(&connection, handle, false);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    // Share the flush with writes awaiting group commit, if started
+    if (connection->groupCommit != NULL) {
+        return KineticGroupCommit_Flush(connection, closure);
+    }
+
+    KineticOperation* operation;
+    status = KineticClient_CreateOperation(&operation, handle);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    // Initialize request
+    KineticOperation_BuildFlush(operation);
+    if (closure != NULL) {operation->closure = *closure;}
+
+    // Execute the operation
+    return KineticClient_ExecuteOperation(operation);
+}
+
+KineticStatus KineticClient_StartGroupCommit(KineticSessionHandle handle,
+                                             int writesPerFlush,
+                                             int delayMillis)
+{
+    KineticConnection* connection;
+    KineticStatus status = KineticClient_GetConnection(&connection, handle, false);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    LOGF1("Starting group commit every %d writes or %dms", writesPerFlush, delayMillis);
+    return KineticGroupCommit_Start(connection, writesPerFlush, delayMillis);
+}
+
+KineticStatus KineticClient_PutDurable(KineticSessionHandle handle,
+                                       KineticEntry* const entry,
+                                       KineticCompletionClosure* closure)
+{
+    assert(entry != NULL);
+    assert(entry->value.array.data != NULL);
+    KineticConnection* connection;
+    KineticStatus status = KineticClient_GetConnection(&connection, handle, false);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    return KineticGroupCommit_Put(connection, entry, closure);
+}
+
+KineticStatus KineticClient_StopGroupCommit(KineticSessionHandle handle)
+{
+    KineticConnection* connection;
+    KineticStatus status = KineticClient_GetConnection(&connection, handle, false);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    KineticGroupCommit_Stop(connection);
+    return KINETIC_STATUS_SUCCESS;
+}
+
+KineticStatus KineticClient_P2POperation(KineticSessionHandle handle,
+                                         KineticP2P_Operation* const p2pOp,
+                                         KineticCompletionClosure* closure)
+{
+    assert(handle != KINETIC_HANDLE_INVALID);
+    assert(p2pOp != NULL);
+    if (p2pOp->numOperations == 0 || p2pOp->operations == NULL ||
+        p2pOp->peer.hostname[0] == '\0')
+    {
+        LOG0("Invalid peer-to-peer operation specified!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    KineticStatus status;
+    KineticOperation* operation;
+    status = KineticClient_CreateOperation(&operation, handle);
+    if (status != KINETIC_STATUS_SUCCESS) {return status;}
+
+    // Initialize request
+    status = KineticOperation_BuildP2POperation(operation, p2pOp);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        KineticConnection* connection = operation->connection;
+        KineticAllocator_FreeOperation(connection, operation);
+        KineticConnection_ReleaseWindow(connection);
+        return status;
+    }
+    if (closure != NULL) {operation->closure = *closure;}
+
+    // Execute the operation
+    return KineticClient_ExecuteOperation(operation);
+}
+
+KineticStatus KineticClient_AddClusterDrive(KineticCluster* cluster,
+                                            const KineticSession* config)
+{
+    assert(cluster != NULL);
+    KineticSessionHandle handle;
+    KineticStatus status = KineticClient_Connect(config, &handle);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        return status;
+    }
+
+    status = KineticCluster_AddDrive(cluster, handle, KineticConnection_FromHandle(handle));
+    if (status != KINETIC_STATUS_SUCCESS) {
+        KineticClient_Disconnect(&handle);
+    }
+    return status;
+}
+
+KineticStatus KineticClient_ConnectCluster(const KineticSession* configs,
+                                           int count,
+                                           KineticCluster** cluster)
+{
+    assert(configs != NULL);
+    assert(cluster != NULL);
+    *cluster = NULL;
+    if (count < 1 || count > KINETIC_CLUSTER_DRIVES_MAX) {
+        LOGF0("Invalid number of cluster drives specified (%d)!", count);
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    KineticCluster* newCluster = KineticCluster_Create();
+    if (newCluster == NULL) {
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    for (int i = 0; i < count; i++) {
+        KineticStatus status = KineticClient_AddClusterDrive(newCluster, &configs[i]);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            LOGF0("Failed adding drive %s:%d to the cluster", configs[i].host, configs[i].port);
+            KineticClient_DisconnectCluster(&newCluster);
+            return status;
+        }
+    }
+
+    *cluster = newCluster;
+    return KINETIC_STATUS_SUCCESS;
+}
+
+KineticStatus KineticClient_RemoveClusterDrive(KineticCluster* cluster,
+                                               const char* host,
+                                               int port)
+{
+    assert(cluster != NULL);
+    assert(host != NULL);
+    KineticSessionHandle handle = KineticCluster_RemoveDrive(cluster, host, port);
+    if (handle == KINETIC_HANDLE_INVALID) {
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+    return KineticClient_Disconnect(&handle);
+}
+
+KineticStatus KineticClient_ClusterPut(KineticCluster* cluster,
+                                       KineticEntry* const entry,
+                                       KineticCompletionClosure* closure)
+{
+    assert(cluster != NULL);
+    assert(entry != NULL);
+    assert(entry->value.array.data != NULL);
+    return KineticCluster_Execute(cluster, entry, KineticOperation_BuildPut, closure);
+}
+
+KineticStatus KineticClient_ClusterGet(KineticCluster* cluster,
+                                       KineticEntry* const entry,
+                                       KineticCompletionClosure* closure)
+{
+    assert(cluster != NULL);
+    assert(entry != NULL);
+    if (!entry->metadataOnly) {assert(entry->value.array.data != NULL);}
+    return KineticCluster_Execute(cluster, entry, KineticOperation_BuildGet, closure);
+}
+
+KineticStatus KineticClient_ClusterDelete(KineticCluster* cluster,
+                                          KineticEntry* const entry,
+                                          KineticCompletionClosure* closure)
+{
+    assert(cluster != NULL);
+    assert(entry != NULL);
+    return KineticCluster_Execute(cluster, entry, KineticOperation_BuildDelete, closure);
+}
+
+KineticStatus KineticClient_DisconnectCluster(KineticCluster** const cluster)
+{
+    assert(cluster != NULL);
+    if (*cluster == NULL) {
+        return KINETIC_STATUS_SESSION_EMPTY;
+    }
+
+    // Report the first failure, but disconnect from every drive regardless
+    KineticStatus status = KINETIC_STATUS_SUCCESS;
+    for (int i = 0; i < (*cluster)->count; i++) {
+        KineticStatus driveStatus = KineticClient_Disconnect(&(*cluster)->drives[i].handle);
+        if (status == KINETIC_STATUS_SUCCESS) {
+            status = driveStatus;
+        }
+    }
+    KineticCluster_Destroy(*cluster);
+    *cluster = NULL;
+    return status;
+}
+
+KineticStatus KineticClient_ReplicatedPut(const KineticSessionHandle* handles,
+                                          int count,
+                                          int writeQuorum,
+                                          KineticEntry* const entry,
+                                          KineticCompletionClosure* closure)
+{
+    assert(handles != NULL);
+    assert(entry != NULL);
+    assert(entry->value.array.data != NULL);
+
+    KineticConnection* connections[KINETIC_REPLICAS_MAX];
+    KineticStatus status = KineticClient_GetConnections(connections, handles, count,
+        KINETIC_REPLICAS_MAX, true);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        return status;
+    }
+    return KineticReplication_Put(connections, count, writeQuorum, entry, closure);
+}
+
+KineticStatus KineticClient_ReplicatedGet(const KineticSessionHandle* handles,
+                                          int count,
+                                          int readQuorum,
+                                          KineticEntry* const entry,
+                                          KineticCompletionClosure* closure)
+{
+    assert(handles != NULL);
+    assert(entry != NULL);
+    if (!entry->metadataOnly) {assert(entry->value.array.data != NULL);}
+
+    KineticConnection* connections[KINETIC_REPLICAS_MAX];
+    KineticStatus status = KineticClient_GetConnections(connections, handles, count,
+        KINETIC_REPLICAS_MAX, true);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        return status;
+    }
+    return KineticReplication_Get(connections, count, readQuorum, entry, closure);
+}
+
+KineticStatus KineticClient_HedgedGet(const KineticSessionHandle* handles,
+                                      int count,
+                                      KineticEntry* const entry,
+                                      KineticCompletionClosure* closure)
+{
+    assert(handles != NULL);
+    assert(entry != NULL);
+    if (!entry->metadataOnly) {assert(entry->value.array.data != NULL);}
+
+    KineticConnection* connections[KINETIC_REPLICAS_MAX];
+    KineticStatus status = KineticClient_GetConnections(connections, handles, count,
+        KINETIC_REPLICAS_MAX, true);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        return status;
+    }
+    return KineticHedge_Get(connections, count, entry, closure);
+}
+
+KineticStatus KineticClient_ErasurePut(const KineticSessionHandle* handles,
+                                       int dataFragments,
+                                       int parityFragments,
+                                       KineticEntry* const entry,
+                                       KineticCompletionClosure* closure)
+{
+    assert(handles != NULL);
+    assert(entry != NULL);
+    assert(entry->value.array.data != NULL);
+
+    KineticConnection* connections[KINETIC_ERASURE_FRAGMENTS_MAX];
+    KineticStatus status = KineticClient_GetConnections(connections, handles,
+        dataFragments + parityFragments, KINETIC_ERASURE_FRAGMENTS_MAX, true);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        return status;
+    }
+    return KineticErasure_Put(connections, dataFragments, parityFragments, entry, closure);
+}
+
+KineticStatus KineticClient_ErasureGet(const KineticSessionHandle* handles,
+                                       int dataFragments,
+                                       int parityFragments,
+                                       KineticEntry* const entry,
+                                       KineticCompletionClosure* closure)
+{
+    assert(handles != NULL);
+    assert(entry != NULL);
+    if (!entry->metadataOnly) {assert(entry->value.array.data != NULL);}
+
+    KineticConnection* connections[KINETIC_ERASURE_FRAGMENTS_MAX];
+    KineticStatus status = KineticClient_GetConnections(connections, handles,
+        dataFragments + parityFragments, KINETIC_ERASURE_FRAGMENTS_MAX, true);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        return status;
+    }
+    return KineticErasure_Get(connections, dataFragments, parityFragments, entry, closure);
+}
@@ -0,0 +1,340 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_cluster.h"
+#include "kinetic_session_pool.h"
+#include "kinetic_operation.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <pthread.h>
+
+// An asynchronous request routed to a drive, which keeps the drive in use
+// until the caller's closure has been run
+typedef struct _KineticClusterRequest {
+    KineticCluster* cluster;
+    uint64_t id;
+    KineticEntry* entry;
+    KineticBatchBuilder build;
+    KineticCompletionClosure closure;
+    KineticOperation* operation;
+} KineticClusterRequest;
+
+// Final mix of MurmurHash3, which spreads FNV-1a hashes of similar keys, and
+// the consecutive point seeds of a drive, evenly around the ring
+static uint64_t KineticCluster_Mix(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+static uint64_t KineticCluster_Hash(const uint8_t* data, size_t len)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001B3ull;
+    }
+    return KineticCluster_Mix(hash);
+}
+
+static uint64_t KineticCluster_DriveID(const KineticSession* const session)
+{
+    char name[HOST_NAME_MAX + 16];
+    int len = snprintf(name, sizeof(name), "%s:%d", session->host, session->port);
+    return KineticCluster_Hash((const uint8_t*)name, (size_t)len);
+}
+
+// Finds a drive by its identity (the mutex must be held)
+static int KineticCluster_Find(KineticCluster* const cluster, uint64_t id)
+{
+    for (int i = 0; i < cluster->count; i++) {
+        if (cluster->drives[i].id == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int KineticCluster_ComparePoints(const void* a, const void* b)
+{
+    uint64_t hashA = ((const KineticClusterPoint*)a)->hash;
+    uint64_t hashB = ((const KineticClusterPoint*)b)->hash;
+    return (hashA > hashB) - (hashA < hashB);
+}
+
+// Rebuilds the ring for the current drives (the mutex must be held)
+static KineticStatus KineticCluster_BuildRing(KineticCluster* const cluster)
+{
+    int pointCount = cluster->count * KINETIC_CLUSTER_VIRTUAL_NODES;
+    KineticClusterPoint* points = NULL;
+    if (pointCount > 0) {
+        points = (KineticClusterPoint*)malloc(pointCount * sizeof(KineticClusterPoint));
+        if (points == NULL) {
+            LOG0("Failed allocating cluster hash ring!");
+            return KINETIC_STATUS_MEMORY_ERROR;
+        }
+    }
+    for (int drive = 0; drive < cluster->count; drive++) {
+        uint64_t id = cluster->drives[drive].id;
+        for (int i = 0; i < KINETIC_CLUSTER_VIRTUAL_NODES; i++) {
+            KineticClusterPoint* point = &points[drive * KINETIC_CLUSTER_VIRTUAL_NODES + i];
+            point->hash = KineticCluster_Mix(id + (uint64_t)(i + 1) * 0x9E3779B97F4A7C15ull);
+            point->drive = drive;
+        }
+    }
+    if (pointCount > 0) {
+        qsort(points, pointCount, sizeof(KineticClusterPoint), KineticCluster_ComparePoints);
+    }
+
+    free(cluster->points);
+    cluster->points = points;
+    cluster->pointCount = pointCount;
+    return KINETIC_STATUS_SUCCESS;
+}
+
+// Finds the drive owning a key (the mutex must be held)
+static int KineticCluster_Route(KineticCluster* const cluster, const ByteBuffer key)
+{
+    if (cluster->pointCount == 0) {
+        return -1;
+    }
+    uint64_t hash = KineticCluster_Hash(key.array.data, key.bytesUsed);
+    int low = 0;
+    int high = cluster->pointCount;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (cluster->points[mid].hash < hash) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return cluster->points[low % cluster->pointCount].drive;
+}
+
+KineticCluster* KineticCluster_Create(void)
+{
+    KineticCluster* cluster = (KineticCluster*)calloc(1, sizeof(KineticCluster));
+    if (cluster == NULL) {
+        LOG0("Failed allocating cluster!");
+        return NULL;
+    }
+    pthread_mutex_init(&cluster->mutex, NULL);
+    pthread_cond_init(&cluster->cond, NULL);
+    return cluster;
+}
+
+KineticStatus KineticCluster_AddDrive(KineticCluster* const cluster,
+    KineticSessionHandle handle, KineticConnection* const connection)
+{
+    assert(cluster != NULL);
+    assert(connection != NULL);
+    uint64_t id = KineticCluster_DriveID(&connection->session);
+    KineticStatus status = KINETIC_STATUS_SUCCESS;
+
+    pthread_mutex_lock(&cluster->mutex);
+    if (cluster->count >= KINETIC_CLUSTER_DRIVES_MAX) {
+        LOG0("Cluster already has the maximum number of drives!");
+        status = KINETIC_STATUS_INVALID_REQUEST;
+    }
+    else if (KineticCluster_Find(cluster, id) >= 0) {
+        LOGF0("Drive %s:%d is already in the cluster!",
+            connection->session.host, connection->session.port);
+        status = KINETIC_STATUS_INVALID_REQUEST;
+    }
+    if (status == KINETIC_STATUS_SUCCESS) {
+        cluster->drives[cluster->count++] = (KineticClusterDrive) {
+            .handle = handle,
+            .connection = connection,
+            .id = id,
+        };
+        status = KineticCluster_BuildRing(cluster);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            cluster->count--;
+        }
+    }
+    pthread_mutex_unlock(&cluster->mutex);
+
+    return status;
+}
+
+KineticSessionHandle KineticCluster_RemoveDrive(KineticCluster* const cluster,
+    const char* host, int port)
+{
+    assert(cluster != NULL);
+    assert(host != NULL);
+    KineticSession session = {.port = port};
+    strncpy(session.host, host, sizeof(session.host) - 1);
+    uint64_t id = KineticCluster_DriveID(&session);
+    KineticSessionHandle handle = KINETIC_HANDLE_INVALID;
+
+    // Wait for requests routed to the drive, until their responses arrive
+    pthread_mutex_lock(&cluster->mutex);
+    int i = KineticCluster_Find(cluster, id);
+    while (i >= 0 && cluster->drives[i].users > 0) {
+        pthread_cond_wait(&cluster->cond, &cluster->mutex);
+        i = KineticCluster_Find(cluster, id);
+    }
+    if (i >= 0) {
+        KineticClusterDrive removed = cluster->drives[i];
+        memmove(&cluster->drives[i], &cluster->drives[i + 1],
+            (cluster->count - i - 1) * sizeof(KineticClusterDrive));
+        cluster->count--;
+
+        // Keep the drive, should the smaller ring not fit
+        if (KineticCluster_BuildRing(cluster) != KINETIC_STATUS_SUCCESS) {
+            memmove(&cluster->drives[i + 1], &cluster->drives[i],
+                (cluster->count - i) * sizeof(KineticClusterDrive));
+            cluster->drives[i] = removed;
+            cluster->count++;
+        }
+        else {
+            handle = removed.handle;
+        }
+    }
+    pthread_mutex_unlock(&cluster->mutex);
+
+    if (handle == KINETIC_HANDLE_INVALID) {
+        LOGF0("Failed removing drive %s:%d from the cluster!", host, port);
+    }
+    return handle;
+}
+
+int KineticCluster_Locate(KineticCluster* const cluster, const ByteBuffer key)
+{
+    assert(cluster != NULL);
+    pthread_mutex_lock(&cluster->mutex);
+    int drive = KineticCluster_Route(cluster, key);
+    pthread_mutex_unlock(&cluster->mutex);
+    return drive;
+}
+
+// Lets a drive be removed again, once nothing routed to it is outstanding
+static void KineticCluster_Release(KineticCluster* const cluster, uint64_t id)
+{
+    // Other drives may have been removed meanwhile, but not this one
+    pthread_mutex_lock(&cluster->mutex);
+    cluster->drives[KineticCluster_Find(cluster, id)].users--;
+    pthread_cond_broadcast(&cluster->cond);
+    pthread_mutex_unlock(&cluster->mutex);
+}
+
+static void KineticCluster_Build(KineticOperation* const operation, void* context)
+{
+    KineticClusterRequest* request = (KineticClusterRequest*)context;
+    request->build(operation, request->entry);
+}
+
+static void KineticCluster_Completed(KineticCompletionData* kinetic_data, void* client_data)
+{
+    KineticClusterRequest* request = (KineticClusterRequest*)client_data;
+    pthread_mutex_lock(&request->cluster->mutex);
+    request->operation = NULL;
+    pthread_mutex_unlock(&request->cluster->mutex);
+
+    if (request->closure.callback != NULL) {
+        request->closure.callback(kinetic_data, request->closure.clientData);
+    }
+    KineticCluster_Release(request->cluster, request->id);
+    free(request);
+}
+
+KineticStatus KineticCluster_Execute(KineticCluster* const cluster,
+    KineticEntry* const entry, KineticBatchBuilder build,
+    KineticCompletionClosure* closure)
+{
+    assert(cluster != NULL);
+    assert(entry != NULL);
+    assert(build != NULL);
+
+    // The drive is kept in the cluster until the request has completed, so
+    // that it is not disconnected with the response outstanding
+    pthread_mutex_lock(&cluster->mutex);
+    int drive = KineticCluster_Route(cluster, entry->key);
+    if (drive < 0) {
+        pthread_mutex_unlock(&cluster->mutex);
+        LOG0("Cluster has no drives!");
+        return KINETIC_STATUS_SESSION_EMPTY;
+    }
+    cluster->drives[drive].users++;
+    uint64_t id = cluster->drives[drive].id;
+    KineticConnection* connection = cluster->drives[drive].connection;
+    pthread_mutex_unlock(&cluster->mutex);
+
+    if (connection->pool != NULL) {
+        connection = KineticSessionPool_Select(connection->pool);
+    }
+    LOGF2("Routing entry to cluster drive %d (%s:%d)", drive,
+        connection->session.host, connection->session.port);
+
+    if (closure == NULL) {
+        KineticStatus status = KineticBatch_Execute(connection, entry, 1, build,
+            NULL, NULL, NULL);
+        KineticCluster_Release(cluster, id);
+        return status;
+    }
+
+    // Asynchronous requests release the drive once their closure has run
+    KineticClusterRequest* request =
+        (KineticClusterRequest*)calloc(1, sizeof(KineticClusterRequest));
+    if (request == NULL) {
+        LOG0("Failed allocating cluster request!");
+        KineticCluster_Release(cluster, id);
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    *request = (KineticClusterRequest) {
+        .cluster = cluster,
+        .id = id,
+        .entry = entry,
+        .build = build,
+        .closure = *closure,
+    };
+    KineticStatus status = KineticOperation_Submit(connection, true,
+        KineticCluster_Build, request,
+        (KineticCompletionClosure) {
+            .callback = KineticCluster_Completed,
+            .clientData = request,
+        },
+        &cluster->mutex, &request->operation);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        // The closure is not run for a request that was never sent
+        free(request);
+        KineticCluster_Release(cluster, id);
+    }
+    return status;
+}
+
+void KineticCluster_Destroy(KineticCluster* const cluster)
+{
+    if (cluster == NULL) {
+        return;
+    }
+    pthread_cond_destroy(&cluster->cond);
+    pthread_mutex_destroy(&cluster->mutex);
+    free(cluster->points);
+    free(cluster);
+}
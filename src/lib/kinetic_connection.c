@@ -24,12 +24,16 @@
 #include "kinetic_pdu.h"
 #include "kinetic_operation.h"
 #include "kinetic_allocator.h"
+#include "kinetic_reactor.h"
+#include "kinetic_hmac.h"
+#include "kinetic_nbo.h"
 #include "kinetic_logger.h"
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
 #include <errno.h>
 #include <sys/time.h>
+#include <time.h>
 
 STATIC KineticConnection ConnectionInstances[KINETIC_SESSIONS_MAX];
 STATIC KineticConnection* Connections[KINETIC_SESSIONS_MAX];
@@ -38,12 +42,153 @@ STATIC KineticConnection* Connections[KINETIC_SESSIONS_MAX];
 void KineticConnection_Pause(KineticConnection* const connection, bool pause)
 {
     assert(connection != NULL);
-    connection->thread.paused = pause;
+    if (connection->reactor != NULL) {
+        KineticReactor_Pause(connection, pause);
+    }
+    else {
+        connection->thread.paused = pause;
+    }
 }
 
-static void* KineticConnection_Worker(void* thread_arg)
+KineticStatus KineticConnection_ReceivePDU(KineticConnection* const connection)
 {
+    assert(connection != NULL);
     KineticStatus status;
+
+    KineticPDU* response = KineticAllocator_NewPDU(connection);
+    status = KineticPDU_ReceiveMain(response);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        LOGF0("ERROR: PDU receive reported an error: %s", Kinetic_GetStatusDescription(status));
+    }
+    else {
+        status = KineticPDU_GetStatus(response);
+    }
+
+    if (response->proto != NULL && response->proto->has_authType) {
+
+        // Handle unsolicited status PDUs
+        if (response->proto->authType == KINETIC_PROTO_MESSAGE_AUTH_TYPE_UNSOLICITEDSTATUS) {
+            response->type = KINETIC_PDU_TYPE_UNSOLICITED;
+            if (response->command != NULL &&
+                response->command->header != NULL &&
+                response->command->header->has_connectionID)
+            {
+                // Extract connectionID from unsolicited status message
+                response->connection->connectionID = response->command->header->connectionID;
+                LOGF2("Extracted connection ID from unsolicited status PDU (id=%lld)",
+                    response->connection->connectionID);
+            }
+            else {
+                LOG0("WARNING: Unsolicited PDU is not recognized!");
+            }
+            KineticAllocator_FreePDU(connection, response);
+        }
+
+        // Associate solicited response PDUs with their requests
+        else {
+            response->type = KINETIC_PDU_TYPE_RESPONSE;
+            KineticOperation* op = KineticOperation_AssociateResponseWithOperation(response);
+            if (op == NULL) {
+                LOG0("Failed to find request matching received response PDU!");
+
+                // Discard any value payload, which would otherwise be taken
+                // for the start of the next PDU
+                size_t valueLength = KineticPDU_GetValueLength(response);
+                if (valueLength > 0) {
+                    uint8_t discarded[1];
+                    ByteBuffer value = ByteBuffer_Create(discarded, sizeof(discarded), 0);
+                    KineticStatus discardStatus = KineticPDU_ReceiveValue(connection,
+                        &value, valueLength);
+                    if (discardStatus != KINETIC_STATUS_SUCCESS &&
+                        discardStatus != KINETIC_STATUS_BUFFER_OVERRUN) {
+                        status = discardStatus;
+                    }
+                }
+                KineticAllocator_FreePDU(connection, response);
+            }
+            else {
+                LOG2("Found associated operation/request for response PDU.");
+                bool responded = (response->command != NULL);
+                size_t valueLength = KineticPDU_GetValueLength(response);
+                if (valueLength > 0) {
+                    status = KineticPDU_ReceiveValue(op->connection,
+                        &op->entry->value, valueLength);
+                    responded = responded && (status == KINETIC_STATUS_SUCCESS);
+                }
+
+                // Call operation-specific callback, if configured (some also
+                // report the details of a failure the device responded with)
+                if (op->callback != NULL && (status == KINETIC_STATUS_SUCCESS ||
+                    (op->callbackOnFailure && responded))) {
+                    status = op->callback(op);
+                }
+
+                // Call client-supplied closure callback, if supplied, once the
+                // operation has left the in-flight window, since the closure
+                // may submit another request (and this thread alone frees
+                // slots in a full window)
+                if (op->closure.callback != NULL) {
+                    KineticCompletionClosure closure = op->closure;
+                    KineticAllocator_FreeOperation(connection, op);
+                    KineticConnection_ReleaseWindow(connection);
+                    KineticCompletionData completionData = {.status = status};
+                    closure.callback(&completionData, closure.clientData);
+                }
+
+                // Otherwise, is a synchronous opearation, so wake the waiter
+                else {
+                    KineticOperation_Complete(op);
+                }
+            }
+        }
+    }
+    else {
+        // Free invalid PDU
+        KineticAllocator_FreePDU(connection, response);
+    }
+
+    return status;
+}
+
+KineticStatus KineticConnection_ReceiveAvailable(KineticConnection* const connection)
+{
+    assert(connection != NULL);
+    KineticReadBuffer* buffer = &connection->readBuffer;
+    KineticStatus status;
+
+    // Receive each PDU only once all of it has arrived, so that a slow peer
+    // never blocks the caller
+    while (true) {
+        status = KineticSocket_ReadAvailable(connection->socket, buffer, PDU_HEADER_LEN);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            break;
+        }
+        KineticPDUHeader header;
+        memcpy(&header, &buffer->data[buffer->start], sizeof(header));
+        size_t protobufLength = KineticNBO_ToHostU32(header.protobufLength);
+        size_t valueLength = KineticNBO_ToHostU32(header.valueLength);
+        if (protobufLength > PDU_PROTO_MAX_LEN || valueLength > KINETIC_OBJ_SIZE) {
+            LOGF0("ERROR: Received PDU is too large (protobuf=%zu, value=%zu)!",
+                protobufLength, valueLength);
+            return KINETIC_STATUS_SOCKET_ERROR;
+        }
+
+        status = KineticSocket_ReadAvailable(connection->socket, buffer,
+            PDU_HEADER_LEN + protobufLength + valueLength);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            break;
+        }
+        status = KineticConnection_ReceivePDU(connection);
+        if (status == KINETIC_STATUS_SOCKET_ERROR) {
+            return status;
+        }
+    }
+
+    return (status == KINETIC_STATUS_WOULD_BLOCK) ? KINETIC_STATUS_SUCCESS : status;
+}
+
+static void* KineticConnection_Worker(void* thread_arg)
+{
     KineticThread* thread = thread_arg;
 
     while(!thread->abortRequested && !thread->fatalError) {
@@ -60,74 +205,14 @@ static void* KineticConnection_Worker(void* thread_arg)
         {
             case KINETIC_WAIT_STATUS_DATA_AVAILABLE:
             {
-                KineticPDU* response = KineticAllocator_NewPDU(thread->connection);
-                status = KineticPDU_ReceiveMain(response);
-                if (status != KINETIC_STATUS_SUCCESS) {
-                    LOGF0("ERROR: PDU receive reported an error: %s", Kinetic_GetStatusDescription(status));
-                }
-                else {
-                    status = KineticPDU_GetStatus(response);
-                }
-
-                if (response->proto != NULL && response->proto->has_authType) {
-
-                    // Handle unsolicited status PDUs
-                    if (response->proto->authType == KINETIC_PROTO_MESSAGE_AUTH_TYPE_UNSOLICITEDSTATUS) {
-                        response->type = KINETIC_PDU_TYPE_UNSOLICITED;
-                        if (response->command != NULL &&
-                            response->command->header != NULL &&
-                            response->command->header->has_connectionID)
-                        {
-                            // Extract connectionID from unsolicited status message
-                            response->connection->connectionID = response->command->header->connectionID;
-                            LOGF2("Extracted connection ID from unsolicited status PDU (id=%lld)",
-                                response->connection->connectionID);
-                        }
-                        else {
-                            LOG0("WARNING: Unsolicited PDU is not recognized!");
-                        }
-                        KineticAllocator_FreePDU(thread->connection, response);
-                    }
-
-                    // Associate solicited response PDUs with their requests
-                    else {
-                        response->type = KINETIC_PDU_TYPE_RESPONSE;
-                        KineticOperation* op = KineticOperation_AssociateResponseWithOperation(response);
-                        if (op == NULL) {
-                            LOG0("Failed to find request matching received response PDU!");
-                            KineticAllocator_FreePDU(thread->connection, response);
-                        }
-                        else {
-                            LOG2("Found associated operation/request for response PDU.");
-                            size_t valueLength = KineticPDU_GetValueLength(response);
-                            if (valueLength > 0) {
-                                status = KineticPDU_ReceiveValue(op->connection->socket,
-                                    &op->entry->value, valueLength);
-                            }
-
-                            // Call operation-specific callback, if configured
-                            if (status == KINETIC_STATUS_SUCCESS && op->callback != NULL) {
-                                status = op->callback(op);
-                            }
-
-                            // Call client-supplied closure callback, if supplied
-                            if (op->closure.callback != NULL) {
-                                KineticCompletionData completionData = {.status = status};
-                                op->closure.callback(&completionData, op->closure.clientData);
-                                KineticAllocator_FreeOperation(thread->connection, op);
-                            }
-
-                            // Otherwise, is a synchronous opearation, so just set a flag
-                            else {
-                                op->receiveComplete = true;
-                            }
-                        }
-                    }
-                }
-                else {
-                    // Free invalid PDU
-                    KineticAllocator_FreePDU(thread->connection, response);
-                }
+                // Parse any further PDUs already pulled into the read buffer,
+                // since the socket will not report them as available
+                KineticConnection* connection = thread->connection;
+                KineticStatus status;
+                do {
+                    status = KineticConnection_ReceivePDU(connection);
+                } while (status != KINETIC_STATUS_SOCKET_ERROR &&
+                    connection->readBuffer.start < connection->readBuffer.end);
             } break;
             case KINETIC_WAIT_STATUS_TIMED_OUT:
             case KINETIC_WAIT_STATUS_RETRYABLE_ERROR:
@@ -160,6 +245,10 @@ KineticSessionHandle KineticConnection_NewConnection(
             Connections[idx] = connection;
             KINETIC_CONNECTION_INIT(connection);
             connection->session = *config;
+            if (config->hmacKey.data != NULL && config->hmacKey.len > 0) {
+                KineticHMAC_PrepareKey(&connection->hmacKey, config->hmacKey);
+            }
+            KineticAllocator_InitPools(connection, config->poolDepth);
             handle = (KineticSessionHandle)(idx + 1);
             return handle;
         }
@@ -173,6 +262,10 @@ void KineticConnection_FreeConnection(KineticSessionHandle* const handle)
     assert(*handle != KINETIC_HANDLE_INVALID);
     KineticConnection* connection = KineticConnection_FromHandle(*handle);
     assert(connection != NULL);
+    KineticAllocator_FreeAllOperations(connection);
+    KineticAllocator_FreeAllPDUs(connection);
+    free(connection->packBuffer);
+    KineticSocket_FreeReadBuffer(&connection->readBuffer);
     *connection = (KineticConnection) {
         .connected = false
     };
@@ -205,8 +298,19 @@ KineticStatus KineticConnection_Connect(KineticConnection* const connection)
         return KINETIC_STATUS_CONNECTION_ERROR;
     }
 
-    // Kick off the worker thread
     connection->thread.connection = connection;
+
+    // Hand the connection off to the shared reactor threads, if requested
+    if (connection->session.useReactor) {
+        KineticStatus status = KineticReactor_AddConnection(connection);
+        if (status == KINETIC_STATUS_SUCCESS) {
+            return KINETIC_STATUS_SUCCESS;
+        }
+        LOGF0("Failed adding connection to reactor (%s), falling back to worker thread",
+            Kinetic_GetStatusDescription(status));
+    }
+
+    // Kick off the worker thread
     int pthreadStatus = pthread_create(&connection->threadID, NULL, KineticConnection_Worker, &connection->thread);
     if (pthreadStatus != 0) {
         char errMsg[256];
@@ -223,16 +327,21 @@ KineticStatus KineticConnection_Disconnect(KineticConnection* const connection)
         return KINETIC_STATUS_SESSION_INVALID;
     }
 
-    // Shutdown the worker thread
+    // Shutdown the worker thread, or detach from the reactor
     KineticStatus status = KINETIC_STATUS_SUCCESS;
-    connection->thread.abortRequested = true;
-    LOG2("\nSent abort request to worker thread!\n");
-    int pthreadStatus = pthread_join(connection->threadID, NULL);
-    if (pthreadStatus != 0) {
-        char errMsg[256];
-        Kinetic_GetErrnoDescription(pthreadStatus, errMsg, sizeof(errMsg));
-        LOGF0("Failed terminating worker thread w/error: %s", errMsg);
-        status = KINETIC_STATUS_CONNECTION_ERROR;
+    if (connection->reactor != NULL) {
+        KineticReactor_RemoveConnection(connection);
+    }
+    else {
+        connection->thread.abortRequested = true;
+        LOG2("\nSent abort request to worker thread!\n");
+        int pthreadStatus = pthread_join(connection->threadID, NULL);
+        if (pthreadStatus != 0) {
+            char errMsg[256];
+            Kinetic_GetErrnoDescription(pthreadStatus, errMsg, sizeof(errMsg));
+            LOGF0("Failed terminating worker thread w/error: %s", errMsg);
+            status = KINETIC_STATUS_CONNECTION_ERROR;
+        }
     }
 
     // Close the connection
@@ -243,8 +352,269 @@ KineticStatus KineticConnection_Disconnect(KineticConnection* const connection)
     return status;
 }
 
-void KineticConnection_IncrementSequence(KineticConnection* const connection)
+static inline KineticOperation** KineticConnection_PendingBucket(
+    KineticConnection* const connection, int64_t sequence)
+{
+    return &connection->pending[(uint64_t)sequence & (KINETIC_PENDING_OPERATIONS_BUCKETS - 1)];
+}
+
+static inline int64_t KineticConnection_PendingSequence(KineticOperation* const operation)
+{
+    return operation->request->command->header->sequence;
+}
+
+// Time an operation has spent in flight, in microseconds
+static int64_t KineticConnection_Elapsed(KineticOperation* const operation,
+    const struct timespec* now)
+{
+    int64_t micros = (int64_t)(now->tv_sec - operation->sent.tv_sec) * 1000000 +
+        (now->tv_nsec - operation->sent.tv_nsec) / 1000;
+    if (micros < 1) {
+        micros = 1;
+    }
+    else if (micros > UINT32_MAX) {
+        micros = UINT32_MAX;
+    }
+    return micros;
+}
+
+// Folds a response time into the smoothed latency of the connection
+// (pendingMutex must be held)
+static void KineticConnection_RecordLatency(KineticConnection* const connection,
+    int64_t micros)
+{
+    if (connection->latency == 0) {
+        connection->latency = (uint32_t)micros;
+    }
+    else {
+        int64_t latency = connection->latency;
+        latency += (micros - latency) / (1 << KINETIC_LATENCY_SMOOTHING_SHIFT);
+        connection->latency = (latency < 1) ? 1 : (uint32_t)latency;
+    }
+}
+
+void KineticConnection_AddPendingOperation(KineticConnection* const connection,
+    KineticOperation* const operation)
+{
+    assert(connection != NULL);
+    assert(operation != NULL);
+    assert(operation->request != NULL);
+    assert(operation->request->command != NULL);
+    assert(operation->request->command->header != NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &operation->sent);
+    pthread_mutex_lock(&connection->pendingMutex);
+    KineticOperation** bucket = KineticConnection_PendingBucket(connection,
+        KineticConnection_PendingSequence(operation));
+    operation->nextPending = *bucket;
+    *bucket = operation;
+    connection->inFlight++;
+    pthread_mutex_unlock(&connection->pendingMutex);
+}
+
+KineticOperation* KineticConnection_TakePendingOperation(KineticConnection* const connection,
+    int64_t sequence)
+{
+    assert(connection != NULL);
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    pthread_mutex_lock(&connection->pendingMutex);
+    KineticOperation** link = KineticConnection_PendingBucket(connection, sequence);
+    KineticOperation* operation = *link;
+    while (operation != NULL && KineticConnection_PendingSequence(operation) != sequence) {
+        link = &operation->nextPending;
+        operation = *link;
+    }
+    if (operation != NULL) {
+        *link = operation->nextPending;
+        operation->nextPending = NULL;
+        connection->inFlight--;
+        KineticConnection_RecordLatency(connection, KineticConnection_Elapsed(operation, &now));
+    }
+    pthread_mutex_unlock(&connection->pendingMutex);
+
+    return operation;
+}
+
+// Unregisters an operation without a response. If given up on once sent, the
+// response has taken at least as long as the operation has been in flight,
+// so that time is folded into the smoothed latency whenever it exceeds it,
+// which keeps a connection that stops responding from looking idle.
+bool KineticConnection_RemovePendingOperation(KineticConnection* const connection,
+    KineticOperation* const operation, bool abandoned)
+{
+    assert(connection != NULL);
+    assert(operation != NULL);
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    pthread_mutex_lock(&connection->pendingMutex);
+    KineticOperation** link = KineticConnection_PendingBucket(connection,
+        KineticConnection_PendingSequence(operation));
+    while (*link != NULL && *link != operation) {
+        link = &(*link)->nextPending;
+    }
+    bool removed = (*link != NULL);
+    if (removed) {
+        *link = operation->nextPending;
+        operation->nextPending = NULL;
+        connection->inFlight--;
+        int64_t micros = KineticConnection_Elapsed(operation, &now);
+        if (abandoned && micros > connection->latency) {
+            KineticConnection_RecordLatency(connection, micros);
+        }
+    }
+    pthread_mutex_unlock(&connection->pendingMutex);
+
+    return removed;
+}
+
+// Expected wait for a response on a connection: its smoothed latency, for
+// each of the requests already in flight and one more (a connection not yet
+// measured counts as idle, so it gets tried; a failed one is never preferred)
+static uint64_t KineticConnection_Load(KineticConnection* const connection)
+{
+    if (!connection->connected || connection->thread.fatalError) {
+        return UINT64_MAX;
+    }
+    pthread_mutex_lock(&connection->pendingMutex);
+    uint64_t load = ((uint64_t)connection->latency + 1) * (uint64_t)(connection->inFlight + 1);
+    pthread_mutex_unlock(&connection->pendingMutex);
+    return load;
+}
+
+static uint32_t KineticConnection_Random(void)
+{
+    static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    static uint32_t state = 0;
+
+    pthread_mutex_lock(&mutex);
+    if (state == 0) {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        state = (uint32_t)now.tv_nsec ^ (uint32_t)now.tv_sec;
+        if (state == 0) {
+            state = 1;
+        }
+    }
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    uint32_t value = state;
+    pthread_mutex_unlock(&mutex);
+
+    return value;
+}
+
+int KineticConnection_SelectLeastLoaded(KineticConnection** const connections, int count,
+    int first)
+{
+    assert(connections != NULL);
+    assert(first >= 0 && first < count);
+    if (count < 2) {
+        return first;
+    }
+
+    // Power of two choices: weighing the first against one other picked at
+    // random steers away from congested connections, without the herding
+    // onto a single one that always taking the least loaded would cause
+    int other = (first + 1 + (int)(KineticConnection_Random() % (uint32_t)(count - 1))) % count;
+    if (KineticConnection_Load(connections[other]) < KineticConnection_Load(connections[first])) {
+        LOGF2("Preferring connection %d over busier connection %d", other, first);
+        return other;
+    }
+    return first;
+}
+
+static inline bool KineticConnection_WindowFull(KineticConnection* const connection)
+{
+    int max = connection->session.outstandingOperationsMax;
+    return (max > 0 && connection->outstanding >= max);
+}
+
+// Waits for an operation to leave the window (windowMutex must be held)
+static KineticStatus KineticConnection_WaitOnWindow(KineticConnection* const connection)
+{
+    if (!connection->connected || connection->thread.fatalError) {
+        LOG0("Connection failed while waiting for in-flight window!");
+        return KINETIC_STATUS_CONNECTION_ERROR;
+    }
+
+    // Wake periodically, in order to notice a failed connection
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += 1;
+    pthread_cond_timedwait(&connection->windowCond, &connection->windowMutex, &deadline);
+    return KINETIC_STATUS_SUCCESS;
+}
+
+static KineticStatus KineticConnection_AdmitToWindow(KineticConnection* const connection,
+    bool wait)
+{
+    assert(connection != NULL);
+    KineticStatus status = KINETIC_STATUS_SUCCESS;
+
+    pthread_mutex_lock(&connection->windowMutex);
+    while (status == KINETIC_STATUS_SUCCESS && KineticConnection_WindowFull(connection)) {
+        if (!wait) {
+            LOGF2("In-flight window full (%d operations)", connection->outstanding);
+            status = KINETIC_STATUS_WOULD_BLOCK;
+        }
+        else {
+            status = KineticConnection_WaitOnWindow(connection);
+        }
+    }
+    if (status == KINETIC_STATUS_SUCCESS) {
+        connection->outstanding++;
+    }
+    pthread_mutex_unlock(&connection->windowMutex);
+
+    return status;
+}
+
+KineticStatus KineticConnection_AcquireWindow(KineticConnection* const connection)
+{
+    assert(connection != NULL);
+    return KineticConnection_AdmitToWindow(connection,
+        !connection->session.failOnFullWindow);
+}
+
+KineticStatus KineticConnection_TryAcquireWindow(KineticConnection* const connection)
+{
+    return KineticConnection_AdmitToWindow(connection, false);
+}
+
+void KineticConnection_ReleaseWindow(KineticConnection* const connection)
+{
+    assert(connection != NULL);
+
+    pthread_mutex_lock(&connection->windowMutex);
+    assert(connection->outstanding > 0);
+    connection->outstanding--;
+    pthread_cond_broadcast(&connection->windowCond);
+
+    // Also wake those waiting for room on any connection of a pooled session
+    KineticSessionPool* pool = connection->memberOf;
+    if (pool != NULL) {
+        pthread_mutex_lock(&pool->mutex);
+        pool->released++;
+        pthread_cond_broadcast(&pool->windowCond);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+    pthread_mutex_unlock(&connection->windowMutex);
+}
+
+KineticStatus KineticConnection_WaitForWindow(KineticConnection* const connection)
 {
     assert(connection != NULL);
-    connection->sequence++;
+    KineticStatus status = KINETIC_STATUS_SUCCESS;
+
+    pthread_mutex_lock(&connection->windowMutex);
+    while (status == KINETIC_STATUS_SUCCESS && KineticConnection_WindowFull(connection)) {
+        status = KineticConnection_WaitOnWindow(connection);
+    }
+    pthread_mutex_unlock(&connection->windowMutex);
+
+    return status;
 }
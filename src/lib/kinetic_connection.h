@@ -29,6 +29,21 @@ KineticConnection* KineticConnection_FromHandle(KineticSessionHandle handle);
 KineticStatus KineticConnection_Connect(KineticConnection* const connection);
 void KineticConnection_Pause(KineticConnection* const connection, bool pause);
 KineticStatus KineticConnection_Disconnect(KineticConnection* const connection);
-void KineticConnection_IncrementSequence(KineticConnection* const connection);
+KineticStatus KineticConnection_ReceivePDU(KineticConnection* const connection);
+KineticStatus KineticConnection_ReceiveAvailable(KineticConnection* const connection);
+
+void KineticConnection_AddPendingOperation(KineticConnection* const connection,
+    KineticOperation* const operation);
+KineticOperation* KineticConnection_TakePendingOperation(KineticConnection* const connection,
+    int64_t sequence);
+bool KineticConnection_RemovePendingOperation(KineticConnection* const connection,
+    KineticOperation* const operation, bool abandoned);
+int KineticConnection_SelectLeastLoaded(KineticConnection** const connections, int count,
+    int first);
+
+KineticStatus KineticConnection_AcquireWindow(KineticConnection* const connection);
+KineticStatus KineticConnection_TryAcquireWindow(KineticConnection* const connection);
+void KineticConnection_ReleaseWindow(KineticConnection* const connection);
+KineticStatus KineticConnection_WaitForWindow(KineticConnection* const connection);
 
 #endif // _KINETIC_CONNECTION_H
@@ -0,0 +1,398 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_cursor.h"
+#include "kinetic_key_iterator.h"
+#include "kinetic_operation.h"
+#include "kinetic_entry.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+static void KineticCursor_EntryReceived(KineticCompletionData* kinetic_data, void* client_data)
+{
+    KineticCursorSlot* slot = (KineticCursorSlot*)client_data;
+    KineticCursor* cursor = (KineticCursor*)slot->owner;
+    pthread_mutex_lock(&cursor->mutex);
+    slot->status = kinetic_data->status;
+    slot->operation = NULL;
+    pthread_cond_broadcast(&cursor->cond);
+    pthread_mutex_unlock(&cursor->mutex);
+}
+
+// Prepares a slot to receive an entry, allocating its value buffer upon
+// first use, since only the first slot is needed until reading ahead
+bool KineticCursor_ResetSlot(KineticCursorSlot* const slot)
+{
+    if (slot->valueData == NULL) {
+        slot->valueData = (uint8_t*)malloc(KINETIC_OBJ_SIZE);
+        if (slot->valueData == NULL) {
+            LOG0("Failed allocating slot value buffer!");
+            slot->status = KINETIC_STATUS_MEMORY_ERROR;
+            return false;
+        }
+    }
+    slot->entry = (KineticEntry) {
+        .key = ByteBuffer_Create(slot->keyData, sizeof(slot->keyData), 0),
+        .value = ByteBuffer_Create(slot->valueData, KINETIC_OBJ_SIZE, 0),
+        .dbVersion = ByteBuffer_Create(slot->versionData, sizeof(slot->versionData), 0),
+        .tag = ByteBuffer_Create(slot->tagData, sizeof(slot->tagData), 0),
+    };
+    slot->status = KINETIC_STATUS_SUCCESS;
+    return true;
+}
+
+static void KineticCursor_BuildGet(KineticOperation* const operation, void* context)
+{
+    KineticOperation_BuildGet(operation, &((KineticCursorSlot*)context)->entry);
+}
+
+static void KineticCursor_BuildGetNext(KineticOperation* const operation, void* context)
+{
+    KineticOperation_BuildGetNext(operation, &((KineticCursorSlot*)context)->entry);
+}
+
+static void KineticCursor_BuildGetPrevious(KineticOperation* const operation, void* context)
+{
+    KineticOperation_BuildGetPrevious(operation, &((KineticCursorSlot*)context)->entry);
+}
+
+// Issues the request for a slot, built from its entry, recording a failure
+// to submit as the slot status
+static KineticStatus KineticCursor_Request(KineticConnection* const connection,
+    KineticCursorSlot* const slot, KineticOperationBuilder build,
+    KineticCompletionClosure closure, pthread_mutex_t* const mutex)
+{
+    KineticStatus status = KineticOperation_Submit(connection, true,
+        build, slot, closure, mutex, &slot->operation);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        slot->status = status;
+    }
+    return status;
+}
+
+// Lists the following key into a slot, and issues the GET for it. Returns
+// KINETIC_STATUS_NOT_FOUND once the keys are exhausted, and records any
+// other failure as the slot status.
+KineticStatus KineticCursor_FillSlot(KineticConnection* const connection,
+    KineticKeyIterator* const keys, KineticCursorSlot* const slot,
+    KineticCompletionClosure closure, pthread_mutex_t* const mutex)
+{
+    if (!KineticCursor_ResetSlot(slot)) {
+        return slot->status;
+    }
+    KineticStatus status = KineticKeyIterator_Next(keys, &slot->entry.key);
+    if (status == KINETIC_STATUS_NOT_FOUND) {
+        return status;
+    }
+    if (status != KINETIC_STATUS_SUCCESS) {
+        slot->status = status;
+        return status;
+    }
+    return KineticCursor_Request(connection, slot, KineticCursor_BuildGet, closure, mutex);
+}
+
+// Gives up on the entry in flight for a slot, recording the timeout as its
+// status. Returns false if there is none, or its response was already
+// claimed, and so must be awaited instead (the owner's mutex is held).
+bool KineticCursor_AbandonSlot(KineticCursorSlot* const slot)
+{
+    if (slot->operation == NULL || !KineticOperation_Abandon(slot->operation)) {
+        return false;
+    }
+    slot->operation = NULL;
+    slot->status = KINETIC_STATUS_SOCKET_TIMEOUT;
+    return true;
+}
+
+// Waits for the entry requested for a slot to arrive, giving up on it if
+// there is no response within KINETIC_PDU_RECEIVE_TIMEOUT_SECS
+static KineticStatus KineticCursor_Await(KineticCursor* const cursor, KineticCursorSlot* const slot)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+
+    pthread_mutex_lock(&cursor->mutex);
+    while (slot->operation != NULL) {
+        int waitStatus = pthread_cond_timedwait(&cursor->cond, &cursor->mutex, &deadline);
+        if (waitStatus == ETIMEDOUT && slot->operation != NULL) {
+            if (KineticCursor_AbandonSlot(slot)) {
+                LOG0("Timed out waiting for cursor entry!");
+            }
+            else {
+                deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+            }
+        }
+    }
+    KineticStatus status = slot->status;
+    pthread_mutex_unlock(&cursor->mutex);
+    return status;
+}
+
+// Hands the entry in a slot to the caller, and moves the cursor to its key
+static KineticStatus KineticCursor_Deliver(KineticCursor* const cursor,
+    const KineticCursorSlot* slot, KineticEntry* const entry)
+{
+    bool copied = KineticEntry_CopyBuffer(&entry->key, &slot->entry.key);
+    copied &= KineticEntry_CopyBuffer(&entry->value, &slot->entry.value);
+    copied &= KineticEntry_CopyBuffer(&entry->dbVersion, &slot->entry.dbVersion);
+    copied &= KineticEntry_CopyBuffer(&entry->tag, &slot->entry.tag);
+    entry->algorithm = slot->entry.algorithm;
+    if (!copied) {
+        LOG1(" BUFFER_OVERRUN: cursor entry");
+        return KINETIC_STATUS_BUFFER_OVERRUN;
+    }
+    ByteBuffer_Reset(&cursor->position);
+    ByteBuffer_Append(&cursor->position, slot->entry.key.array.data, slot->entry.key.bytesUsed);
+    cursor->steps++;
+    return KINETIC_STATUS_SUCCESS;
+}
+
+// Lists the keys beyond the cursor position, so they can be read ahead
+static KineticStatus KineticCursor_StartReadAhead(KineticCursor* const cursor)
+{
+    // Bound the range by the lowest or highest possible key
+    uint8_t boundData[KINETIC_MAX_KEY_LEN];
+    ByteBuffer bound;
+    KineticKeyRange range = {
+        .maxReturned = KINETIC_CURSOR_KEYS_PER_PAGE,
+        .reverse = cursor->reverse,
+    };
+    if (cursor->reverse) {
+        boundData[0] = 0x00;
+        bound = ByteBuffer_Create(boundData, 1, 1);
+        range.startKey = bound;
+        range.startKeyInclusive = true;
+        range.endKey = cursor->position;
+        range.endKeyInclusive = false;
+    }
+    else {
+        memset(boundData, 0xFF, sizeof(boundData));
+        bound = ByteBuffer_Create(boundData, sizeof(boundData), sizeof(boundData));
+        range.startKey = cursor->position;
+        range.startKeyInclusive = false;
+        range.endKey = bound;
+        range.endKeyInclusive = true;
+    }
+
+    LOGF2("Cursor reading ahead %d entries", cursor->readAhead);
+    cursor->head = 0;
+    cursor->used = 0;
+    cursor->keysExhausted = false;
+    return KineticKeyIterator_Open(cursor->connection, &range, &cursor->keys);
+}
+
+// Retires all entries read ahead, and returns to stepping
+static void KineticCursor_StopReadAhead(KineticCursor* const cursor)
+{
+    for (; cursor->used > 0; cursor->used--) {
+        KineticCursor_Await(cursor, &cursor->slots[cursor->head]);
+        cursor->head = (cursor->head + 1) % cursor->readAhead;
+    }
+    KineticKeyIterator_Close(cursor->keys);
+    cursor->keys = NULL;
+    cursor->head = 0;
+}
+
+// Fills the free slots with requests for the following keys
+static void KineticCursor_ReadAhead(KineticCursor* const cursor)
+{
+    while (cursor->used < cursor->readAhead && !cursor->keysExhausted) {
+        KineticCursorSlot* slot =
+            &cursor->slots[(cursor->head + cursor->used) % cursor->readAhead];
+        cursor->used++;
+        KineticCompletionClosure closure = {
+            .callback = KineticCursor_EntryReceived,
+            .clientData = slot,
+        };
+        KineticStatus status = KineticCursor_FillSlot(cursor->connection,
+            cursor->keys, slot, closure, &cursor->mutex);
+        if (status == KINETIC_STATUS_NOT_FOUND) {
+            cursor->used--;
+            cursor->keysExhausted = true;
+            break;
+        }
+        if (status != KINETIC_STATUS_SUCCESS) {
+            // Report the failure once the consumer reaches this slot
+            cursor->keysExhausted = true;
+            break;
+        }
+    }
+}
+
+static void KineticCursor_ReleaseSlot(KineticCursor* const cursor)
+{
+    cursor->head = (cursor->head + 1) % cursor->readAhead;
+    cursor->used--;
+}
+
+void KineticCursor_Close(KineticCursor* const cursor)
+{
+    if (cursor == NULL) {
+        return;
+    }
+
+    // Responses still in flight reference the slots, so must be retired
+    if (cursor->keys != NULL) {
+        KineticCursor_StopReadAhead(cursor);
+    }
+    if (cursor->slots != NULL) {
+        for (int i = 0; i < cursor->readAhead; i++) {
+            free(cursor->slots[i].valueData);
+        }
+        free(cursor->slots);
+    }
+    pthread_cond_destroy(&cursor->cond);
+    pthread_mutex_destroy(&cursor->mutex);
+    free(cursor);
+}
+
+KineticStatus KineticCursor_Open(KineticConnection* const connection,
+    const ByteBuffer* startKey, bool reverse, int readAhead, KineticCursor** cursor)
+{
+    assert(connection != NULL);
+    assert(startKey != NULL);
+    assert(cursor != NULL);
+    *cursor = NULL;
+    if (readAhead == 0) {
+        readAhead = KINETIC_CURSOR_READ_AHEAD;
+    }
+    if (readAhead < 0 || readAhead > KINETIC_CURSOR_READ_AHEAD_MAX ||
+        startKey->bytesUsed > KINETIC_MAX_KEY_LEN ||
+        (startKey->bytesUsed > 0 && startKey->array.data == NULL)) {
+        LOG0("Invalid start key or read ahead specified for cursor!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    KineticCursor* c = (KineticCursor*)calloc(1, sizeof(KineticCursor));
+    if (c == NULL) {
+        LOG0("Failed allocating cursor!");
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    c->connection = connection;
+    c->reverse = reverse;
+    c->readAhead = readAhead;
+    pthread_mutex_init(&c->mutex, NULL);
+    Kinetic_InitCondition(&c->cond);
+    c->slots = (KineticCursorSlot*)calloc(readAhead, sizeof(KineticCursorSlot));
+    if (c->slots == NULL) {
+        LOG0("Failed allocating cursor slots!");
+        KineticCursor_Close(c);
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    for (int i = 0; i < readAhead; i++) {
+        c->slots[i].owner = c;
+    }
+
+    c->position = ByteBuffer_Create(c->positionData, sizeof(c->positionData), 0);
+    if (startKey->bytesUsed > 0) {
+        ByteBuffer_Append(&c->position, startKey->array.data, startKey->bytesUsed);
+    }
+    *cursor = c;
+    return KINETIC_STATUS_SUCCESS;
+}
+
+KineticStatus KineticCursor_Seek(KineticCursor* const cursor, const ByteBuffer* key)
+{
+    assert(cursor != NULL);
+    assert(key != NULL);
+    if (key->bytesUsed > KINETIC_MAX_KEY_LEN ||
+        (key->bytesUsed > 0 && key->array.data == NULL)) {
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    // Entries read ahead are of no use once the cursor has moved
+    if (cursor->keys != NULL) {
+        KineticCursor_StopReadAhead(cursor);
+    }
+    ByteBuffer_Reset(&cursor->position);
+    if (key->bytesUsed > 0) {
+        ByteBuffer_Append(&cursor->position, key->array.data, key->bytesUsed);
+    }
+    cursor->steps = 0;
+    return KINETIC_STATUS_SUCCESS;
+}
+
+KineticStatus KineticCursor_Next(KineticCursor* const cursor, KineticEntry* const entry)
+{
+    assert(cursor != NULL);
+    assert(entry != NULL);
+    KineticStatus status;
+
+    // Switch to reading ahead, once the cursor is being used sequentially
+    if (cursor->keys == NULL && cursor->readAhead > 1 &&
+        cursor->steps >= KINETIC_CURSOR_SEQUENTIAL_THRESHOLD) {
+        status = KineticCursor_StartReadAhead(cursor);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            return status;
+        }
+    }
+
+    // Step to the following entry, until access is seen to be sequential
+    if (cursor->keys == NULL) {
+        KineticCursorSlot* slot = &cursor->slots[0];
+        if (!KineticCursor_ResetSlot(slot)) {
+            return slot->status;
+        }
+        ByteBuffer_Append(&slot->entry.key, cursor->position.array.data, cursor->position.bytesUsed);
+        KineticCompletionClosure closure = {
+            .callback = KineticCursor_EntryReceived,
+            .clientData = slot,
+        };
+        KineticCursor_Request(cursor->connection, slot, cursor->reverse ?
+            KineticCursor_BuildGetPrevious : KineticCursor_BuildGetNext,
+            closure, &cursor->mutex);
+        status = KineticCursor_Await(cursor, slot);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            return status;
+        }
+        return KineticCursor_Deliver(cursor, slot, entry);
+    }
+
+    while (true) {
+        KineticCursor_ReadAhead(cursor);
+        if (cursor->used == 0) {
+            return KINETIC_STATUS_NOT_FOUND;
+        }
+        KineticCursorSlot* slot = &cursor->slots[cursor->head];
+        status = KineticCursor_Await(cursor, slot);
+
+        // Skip keys deleted since they were listed
+        if (status == KINETIC_STATUS_NOT_FOUND) {
+            KineticCursor_ReleaseSlot(cursor);
+            continue;
+        }
+        if (status != KINETIC_STATUS_SUCCESS) {
+            KineticCursor_ReleaseSlot(cursor);
+            return status;
+        }
+
+        // Leave the entry in place if it did not fit, so it may be retried
+        status = KineticCursor_Deliver(cursor, slot, entry);
+        if (status == KINETIC_STATUS_SUCCESS) {
+            KineticCursor_ReleaseSlot(cursor);
+            KineticCursor_ReadAhead(cursor);
+        }
+        return status;
+    }
+}
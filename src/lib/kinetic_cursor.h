@@ -0,0 +1,39 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#ifndef _KINETIC_CURSOR_H
+#define _KINETIC_CURSOR_H
+
+#include "kinetic_types_internal.h"
+
+KineticStatus KineticCursor_Open(KineticConnection* const connection,
+    const ByteBuffer* startKey, bool reverse, int readAhead, KineticCursor** cursor);
+KineticStatus KineticCursor_Next(KineticCursor* const cursor, KineticEntry* const entry);
+KineticStatus KineticCursor_Seek(KineticCursor* const cursor, const ByteBuffer* key);
+void KineticCursor_Close(KineticCursor* const cursor);
+
+// Slots reading ahead, shared with value scans
+bool KineticCursor_ResetSlot(KineticCursorSlot* const slot);
+KineticStatus KineticCursor_FillSlot(KineticConnection* const connection,
+    KineticKeyIterator* const keys, KineticCursorSlot* const slot,
+    KineticCompletionClosure closure, pthread_mutex_t* const mutex);
+bool KineticCursor_AbandonSlot(KineticCursorSlot* const slot);
+
+#endif // _KINETIC_CURSOR_H
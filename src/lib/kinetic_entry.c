@@ -82,3 +82,59 @@ void KineticEntry_SetAlgorithm(KineticEntry* entry, KineticAlgorithm algorithm)
     assert(entry != NULL);
     entry->algorithm = algorithm;
 }
+
+// Copies a retrieved field into the caller's buffer, reporting the length
+// required if it does not fit
+bool KineticEntry_CopyBuffer(ByteBuffer* const dest, const ByteBuffer* src)
+{
+    assert(dest != NULL);
+    assert(src != NULL);
+    ByteBuffer_Reset(dest);
+    if (src->bytesUsed == 0) {
+        return true;
+    }
+    if (dest->array.data == NULL || dest->array.len < src->bytesUsed) {
+        dest->bytesUsed = src->bytesUsed;
+        return false;
+    }
+    ByteBuffer_Append(dest, src->array.data, src->bytesUsed);
+    return true;
+}
+
+// Copies an entry retrieved into a buffer of its own into the caller's
+// entry, leaving the value alone if only metadata was asked for
+KineticStatus KineticEntry_CopyRetrieved(KineticEntry* const dest, const KineticEntry* src)
+{
+    assert(dest != NULL);
+    assert(src != NULL);
+    bool copied = true;
+    if (!dest->metadataOnly) {
+        copied &= KineticEntry_CopyBuffer(&dest->value, &src->value);
+    }
+    copied &= KineticEntry_CopyBuffer(&dest->dbVersion, &src->dbVersion);
+    copied &= KineticEntry_CopyBuffer(&dest->tag, &src->tag);
+    dest->algorithm = src->algorithm;
+    return copied ? KINETIC_STATUS_SUCCESS : KINETIC_STATUS_BUFFER_OVERRUN;
+}
+
+// Propagates newVersion to dbVersion, once a PUT specifying newVersion has
+// succeeded
+void KineticEntry_PromoteVersion(KineticEntry* const entry)
+{
+    assert(entry != NULL);
+    if (entry->newVersion.array.data != NULL && entry->newVersion.array.len > 0) {
+        // If both buffers supplied, copy newVersion into dbVersion, and clear newVersion
+        if (entry->dbVersion.array.data != NULL && entry->dbVersion.array.len > 0) {
+            ByteBuffer_Reset(&entry->dbVersion);
+            ByteBuffer_Append(&entry->dbVersion, entry->newVersion.array.data, entry->newVersion.bytesUsed);
+            ByteBuffer_Reset(&entry->newVersion);
+        }
+
+        // If only newVersion buffer supplied, move newVersion buffer into dbVersion,
+        // and set newVersion to NULL buffer
+        else {
+            entry->dbVersion = entry->newVersion;
+            entry->newVersion = BYTE_BUFFER_NONE;
+        }
+    }
+}
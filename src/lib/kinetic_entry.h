@@ -30,5 +30,8 @@ ByteBuffer* KineticEntry_GetTag(KineticEntry* entry);
 void KineticEntry_SetTag(KineticEntry* entry, ByteBuffer tag);
 KineticAlgorithm KineticEntry_GetAlgorithm(KineticEntry* entry);
 void KineticEntry_SetAlgorithm(KineticEntry* entry, KineticAlgorithm algorithm);
+bool KineticEntry_CopyBuffer(ByteBuffer* const dest, const ByteBuffer* src);
+KineticStatus KineticEntry_CopyRetrieved(KineticEntry* const dest, const KineticEntry* src);
+void KineticEntry_PromoteVersion(KineticEntry* const entry);
 
 #endif // _KINETIC_ENTRY_H
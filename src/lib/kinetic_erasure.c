@@ -0,0 +1,341 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_erasure.h"
+#include "kinetic_reed_solomon.h"
+#include "kinetic_fan_out.h"
+#include "kinetic_operation.h"
+#include "kinetic_entry.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Each fragment starts with its index, the fragment counts, and the length
+// of the entry value (big-endian), so that a GET can check what it decodes
+#define KINETIC_ERASURE_HEADER_LEN (8)
+
+static void KineticErasure_Destroy(KineticErasure* const erasure)
+{
+    free(erasure->buffer);
+    KineticFanOut_Destroy(&erasure->fanOut);
+}
+
+static uint8_t* KineticErasure_Fragment(KineticErasure* const erasure, int index)
+{
+    return &erasure->buffer[erasure->fragmentSize * index];
+}
+
+static void KineticErasure_WriteHeader(KineticErasure* const erasure, int index)
+{
+    uint8_t* header = KineticErasure_Fragment(erasure, index);
+    header[0] = (uint8_t)index;
+    header[1] = (uint8_t)erasure->dataFragments;
+    header[2] = (uint8_t)erasure->parityFragments;
+    header[3] = 0;
+    header[4] = (uint8_t)(erasure->length >> 24);
+    header[5] = (uint8_t)(erasure->length >> 16);
+    header[6] = (uint8_t)(erasure->length >> 8);
+    header[7] = (uint8_t)erasure->length;
+}
+
+// Checks a fragment retrieved was stored for its index and this coding, and
+// records the value length it holds (the mutex is held)
+static KineticStatus KineticErasure_Validate(KineticErasure* const erasure,
+    KineticErasureFragment* const fragment)
+{
+    int index = (int)(fragment - erasure->fragments);
+    const KineticEntry* entry = &fragment->member.entry;
+    fragment->length = 0;
+    if (entry->metadataOnly) {
+        return KINETIC_STATUS_SUCCESS;
+    }
+
+    const uint8_t* header = entry->value.array.data;
+    if (entry->value.bytesUsed < KINETIC_ERASURE_HEADER_LEN ||
+        header[0] != index ||
+        header[1] != erasure->dataFragments ||
+        header[2] != erasure->parityFragments) {
+        return KINETIC_STATUS_DATA_ERROR;
+    }
+    uint32_t length = ((uint32_t)header[4] << 24) | ((uint32_t)header[5] << 16) |
+        ((uint32_t)header[6] << 8) | header[7];
+    size_t share = (length + erasure->dataFragments - 1) / erasure->dataFragments;
+    if (entry->value.bytesUsed != KINETIC_ERASURE_HEADER_LEN + share) {
+        return KINETIC_STATUS_DATA_ERROR;
+    }
+    fragment->length = length;
+    return KINETIC_STATUS_SUCCESS;
+}
+
+// Checks two valid fragments hold the same version of the entry, since
+// fragments of different versions are never combined
+static bool KineticErasure_SameVersion(const KineticErasureFragment* a,
+    const KineticErasureFragment* b)
+{
+    return a->length == b->length &&
+        a->member.entry.dbVersion.bytesUsed == b->member.entry.dbVersion.bytesUsed &&
+        memcmp(a->member.versionData, b->member.versionData,
+            a->member.entry.dbVersion.bytesUsed) == 0;
+}
+
+// Settles on the version of a valid fragment to decode, once dataFragments
+// of that version have arrived (the mutex is held)
+static void KineticErasure_Group(KineticErasure* const erasure,
+    KineticErasureFragment* const fragment)
+{
+    int n = erasure->dataFragments + erasure->parityFragments;
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        if (erasure->fragments[i].valid &&
+            KineticErasure_SameVersion(&erasure->fragments[i], fragment)) {
+            count++;
+        }
+    }
+    if (count >= erasure->dataFragments) {
+        erasure->reference = fragment;
+        erasure->length = fragment->length;
+    }
+}
+
+// Decodes the entry value from the fragments retrieved into the caller's
+// entry (the mutex is held)
+static KineticStatus KineticErasure_Deliver(KineticErasure* const erasure)
+{
+    KineticEntry* entry = erasure->fanOut.entry;
+    KineticErasureFragment* reference = erasure->reference;
+    bool copied = KineticEntry_CopyBuffer(&entry->dbVersion, &reference->member.entry.dbVersion);
+    copied &= KineticEntry_CopyBuffer(&entry->tag, &reference->member.entry.tag);
+    entry->algorithm = reference->member.entry.algorithm;
+    if (entry->metadataOnly) {
+        return copied ? KINETIC_STATUS_SUCCESS : KINETIC_STATUS_BUFFER_OVERRUN;
+    }
+
+    ByteBuffer_Reset(&entry->value);
+    if (entry->value.array.len < erasure->length) {
+        entry->value.bytesUsed = erasure->length;
+        return KINETIC_STATUS_BUFFER_OVERRUN;
+    }
+
+    // Missing data fragments are decoded apart from the fragment buffers,
+    // since late responses may still be arriving into those
+    int k = erasure->dataFragments;
+    int n = k + erasure->parityFragments;
+    size_t share = (erasure->length + k - 1) / k;
+    uint8_t* shares[KINETIC_ERASURE_FRAGMENTS_MAX];
+    bool present[KINETIC_ERASURE_FRAGMENTS_MAX];
+    int missing = 0;
+    for (int i = 0; i < n; i++) {
+        present[i] = erasure->fragments[i].valid &&
+            KineticErasure_SameVersion(&erasure->fragments[i], reference);
+        shares[i] = KineticErasure_Fragment(erasure, i) + KINETIC_ERASURE_HEADER_LEN;
+        if (i < k && !present[i]) {
+            missing++;
+        }
+    }
+    uint8_t* decoded = NULL;
+    if (missing > 0 && share > 0) {
+        decoded = (uint8_t*)malloc(share * missing);
+        if (decoded == NULL) {
+            LOG0("Failed allocating erasure decode buffer!");
+            return KINETIC_STATUS_MEMORY_ERROR;
+        }
+        for (int i = 0, next = 0; i < k; i++) {
+            if (!present[i]) {
+                shares[i] = &decoded[share * next++];
+            }
+        }
+    }
+    if (missing > 0) {
+        LOGF1("Decoding %d missing data fragments", missing);
+    }
+    if (!KineticReedSolomon_Decode(k, erasure->parityFragments, share, shares, present)) {
+        free(decoded);
+        return KINETIC_STATUS_DATA_ERROR;
+    }
+
+    size_t remaining = erasure->length;
+    for (int i = 0; i < k && remaining > 0; i++) {
+        size_t len = (remaining < share) ? remaining : share;
+        ByteBuffer_Append(&entry->value, shares[i], len);
+        remaining -= len;
+    }
+    free(decoded);
+    return copied ? KINETIC_STATUS_SUCCESS : KINETIC_STATUS_BUFFER_OVERRUN;
+}
+
+// Counts fragments stored, or retrieved and valid, settling on the version
+// to decode as they arrive
+static bool KineticErasure_Check(KineticFanOutMember* const member,
+    KineticStatus* const status)
+{
+    KineticErasure* erasure = (KineticErasure*)member->fanOut;
+    KineticErasureFragment* fragment = (KineticErasureFragment*)member;
+
+    // Fragments arriving once the caller has been completed are not needed
+    if (erasure->fanOut.reading && !erasure->fanOut.completed &&
+        *status == KINETIC_STATUS_SUCCESS) {
+        *status = KineticErasure_Validate(erasure, fragment);
+        fragment->valid = (*status == KINETIC_STATUS_SUCCESS);
+        if (fragment->valid && erasure->reference == NULL) {
+            KineticErasure_Group(erasure, fragment);
+        }
+    }
+    return *status == KINETIC_STATUS_SUCCESS;
+}
+
+// Completes the caller once enough fragments are done, or too many have
+// failed. A PUT needs every fragment stored, so that the entry keeps its
+// full redundancy, and a GET needs dataFragments of one version.
+static bool KineticErasure_Decide(KineticFanOut* const fanOut, KineticStatus* const status)
+{
+    KineticErasure* erasure = (KineticErasure*)fanOut;
+    int n = fanOut->count;
+    int tolerated = fanOut->reading ? erasure->parityFragments : 0;
+    bool done = fanOut->reading ? (erasure->reference != NULL) : (fanOut->succeeded == n);
+    if (!done && fanOut->failed <= tolerated && fanOut->succeeded + fanOut->failed < n) {
+        return false;
+    }
+
+    if (!done) {
+        LOGF0("Erasure coded %s failed (%d fragments failed)",
+            fanOut->reading ? "GET" : "PUT", fanOut->failed);
+
+        // Otherwise too few fragments of any one version were retrieved
+        *status = (fanOut->failed > tolerated) ?
+            fanOut->failure : KINETIC_STATUS_VERSION_MISMATCH;
+    }
+    else if (fanOut->reading) {
+        *status = KineticErasure_Deliver(erasure);
+    }
+    else {
+        KineticEntry_PromoteVersion(fanOut->entry);
+        *status = KINETIC_STATUS_SUCCESS;
+    }
+    return true;
+}
+
+static void KineticErasure_Release(KineticFanOut* const fanOut)
+{
+    KineticErasure_Destroy((KineticErasure*)fanOut);
+}
+
+static const KineticFanOutPolicy KineticErasure_Policy = {
+    .member = "Fragment",
+    .check = KineticErasure_Check,
+    .decide = KineticErasure_Decide,
+    .release = KineticErasure_Release,
+};
+
+// Splits the caller's value into data fragments, and encodes the parity
+// fragments from them
+static void KineticErasure_Encode(KineticErasure* const erasure, const ByteBuffer* value)
+{
+    int k = erasure->dataFragments;
+    int n = k + erasure->parityFragments;
+    size_t share = erasure->fragmentSize - KINETIC_ERASURE_HEADER_LEN;
+    uint8_t* shares[KINETIC_ERASURE_FRAGMENTS_MAX];
+
+    memset(erasure->buffer, 0, erasure->fragmentSize * n);
+    size_t offset = 0;
+    for (int i = 0; i < n; i++) {
+        KineticErasure_WriteHeader(erasure, i);
+        shares[i] = KineticErasure_Fragment(erasure, i) + KINETIC_ERASURE_HEADER_LEN;
+        if (i < k && offset < value->bytesUsed) {
+            size_t len = value->bytesUsed - offset;
+            len = (len < share) ? len : share;
+            memcpy(shares[i], &value->array.data[offset], len);
+            offset += len;
+        }
+    }
+    KineticReedSolomon_Encode(k, erasure->parityFragments, share, shares);
+}
+
+static KineticStatus KineticErasure_Execute(KineticConnection** const connections,
+    int dataFragments, int parityFragments, KineticEntry* const entry,
+    KineticCompletionClosure* closure, bool reading)
+{
+    assert(connections != NULL);
+    assert(entry != NULL);
+    int n = dataFragments + parityFragments;
+    if (dataFragments < 1 || parityFragments < 0 || n > KINETIC_ERASURE_FRAGMENTS_MAX) {
+        LOGF0("Invalid erasure coding specified (%d data + %d parity fragments)!",
+            dataFragments, parityFragments);
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+    if (!KineticFanOut_CheckEntry(entry)) {
+        LOG0("Erasure coded entry key, version or tag is too long!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+    size_t length = reading ? entry->value.array.len : entry->value.bytesUsed;
+    if (length > UINT32_MAX) {
+        LOG0("Erasure coded entry value is too long!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    KineticErasure* erasure = (KineticErasure*)calloc(1, sizeof(KineticErasure));
+    if (erasure == NULL) {
+        LOG0("Failed allocating erasure coding!");
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    erasure->dataFragments = dataFragments;
+    erasure->parityFragments = parityFragments;
+    erasure->length = (uint32_t)length;
+    erasure->fragmentSize = KINETIC_ERASURE_HEADER_LEN +
+        (length + dataFragments - 1) / dataFragments;
+    if (!(reading && entry->metadataOnly)) {
+        erasure->buffer = (uint8_t*)malloc(erasure->fragmentSize * n);
+        if (erasure->buffer == NULL) {
+            LOG0("Failed allocating erasure fragment buffers!");
+            free(erasure);
+            return KINETIC_STATUS_MEMORY_ERROR;
+        }
+    }
+    KineticFanOut_Init(&erasure->fanOut, &KineticErasure_Policy, n, reading, entry, closure);
+    if (!reading) {
+        KineticErasure_Encode(erasure, &entry->value);
+    }
+    for (int i = 0; i < n; i++) {
+        KineticErasureFragment* fragment = &erasure->fragments[i];
+        KineticFanOut_AddMember(&erasure->fanOut, i, &fragment->member, connections[i]);
+        fragment->member.entry.value = (erasure->buffer == NULL) ? BYTE_BUFFER_NONE :
+            ByteBuffer_Create(KineticErasure_Fragment(erasure, i), erasure->fragmentSize,
+                reading ? 0 : erasure->fragmentSize);
+    }
+
+    LOGF1("Erasure coded %s of %d data + %d parity fragments (%zu bytes each)",
+        reading ? "GET" : "PUT", dataFragments, parityFragments, erasure->fragmentSize);
+    return KineticFanOut_Execute(&erasure->fanOut);
+}
+
+KineticStatus KineticErasure_Put(KineticConnection** const connections,
+    int dataFragments, int parityFragments, KineticEntry* const entry,
+    KineticCompletionClosure* closure)
+{
+    return KineticErasure_Execute(connections, dataFragments, parityFragments,
+        entry, closure, false);
+}
+
+KineticStatus KineticErasure_Get(KineticConnection** const connections,
+    int dataFragments, int parityFragments, KineticEntry* const entry,
+    KineticCompletionClosure* closure)
+{
+    return KineticErasure_Execute(connections, dataFragments, parityFragments,
+        entry, closure, true);
+}
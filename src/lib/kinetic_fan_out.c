@@ -0,0 +1,263 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_fan_out.h"
+#include "kinetic_entry.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+// Checks the fields of an entry fit the buffers members have of their own
+bool KineticFanOut_CheckEntry(const KineticEntry* entry)
+{
+    assert(entry != NULL);
+    return entry->key.bytesUsed <= KINETIC_MAX_KEY_LEN &&
+        entry->dbVersion.bytesUsed <= KINETIC_MAX_VERSION_LEN &&
+        entry->newVersion.bytesUsed <= KINETIC_MAX_VERSION_LEN &&
+        entry->tag.bytesUsed <= KINETIC_MAX_VERSION_LEN;
+}
+
+void KineticFanOut_Init(KineticFanOut* const fanOut, const KineticFanOutPolicy* policy,
+    int count, bool reading, KineticEntry* const entry, KineticCompletionClosure* closure)
+{
+    assert(fanOut != NULL);
+    assert(policy != NULL);
+    assert(entry != NULL);
+    assert(count > 0 && count <= KINETIC_FAN_OUT_MAX);
+    pthread_mutex_init(&fanOut->mutex, NULL);
+    Kinetic_InitCondition(&fanOut->cond);
+    fanOut->policy = policy;
+    fanOut->reading = reading;
+    fanOut->count = count;
+    fanOut->references = count + 1;
+    fanOut->entry = entry;
+    if (closure != NULL) {
+        fanOut->closure = *closure;
+    }
+    if (entry->key.bytesUsed > 0) {
+        memcpy(fanOut->keyData, entry->key.array.data, entry->key.bytesUsed);
+    }
+}
+
+// Members outlive the caller's entry, so share a copy of the key, and have
+// buffers of their own for anything updated upon completion. The value is
+// the caller's, unless replaced.
+void KineticFanOut_AddMember(KineticFanOut* const fanOut, int index,
+    KineticFanOutMember* const member, KineticConnection* const connection)
+{
+    assert(fanOut != NULL);
+    assert(index >= 0 && index < fanOut->count);
+    assert(member != NULL);
+    assert(connection != NULL);
+    KineticEntry* entry = fanOut->entry;
+    fanOut->members[index] = member;
+    member->fanOut = fanOut;
+    member->connection = connection;
+    member->entry = *entry;
+    member->entry.key = ByteBuffer_Create(fanOut->keyData,
+        sizeof(fanOut->keyData), entry->key.bytesUsed);
+    member->entry.dbVersion = ByteBuffer_Create(member->versionData,
+        sizeof(member->versionData), 0);
+    member->entry.tag = ByteBuffer_Create(member->tagData, sizeof(member->tagData), 0);
+    if (fanOut->reading || entry->newVersion.array.data == NULL) {
+        member->entry.newVersion = BYTE_BUFFER_NONE;
+    }
+    else {
+        member->entry.newVersion = ByteBuffer_Create(member->newVersionData,
+            sizeof(member->newVersionData), 0);
+        KineticEntry_CopyBuffer(&member->entry.newVersion, &entry->newVersion);
+    }
+    if (!fanOut->reading) {
+        KineticEntry_CopyBuffer(&member->entry.dbVersion, &entry->dbVersion);
+        KineticEntry_CopyBuffer(&member->entry.tag, &entry->tag);
+    }
+}
+
+// Fan-outs are the first field of whatever was allocated for them
+void KineticFanOut_Destroy(KineticFanOut* const fanOut)
+{
+    pthread_cond_destroy(&fanOut->cond);
+    pthread_mutex_destroy(&fanOut->mutex);
+    free(fanOut);
+}
+
+static void KineticFanOut_BuildGet(KineticOperation* const operation, void* context)
+{
+    KineticOperation_BuildGet(operation, &((KineticFanOutMember*)context)->entry);
+}
+
+void KineticFanOut_BuildPut(KineticOperation* const operation, void* context)
+{
+    KineticOperation_BuildPut(operation, &((KineticFanOutMember*)context)->entry);
+}
+
+// Issues the request for a member. Upon failure to submit, the closure is
+// not called, and the status is returned instead. Unless waiting, a full
+// in-flight window fails the request rather than blocking.
+KineticStatus KineticFanOut_Request(KineticFanOutMember* const member,
+    KineticOperationBuilder build, KineticCompletionCallback callback, bool wait)
+{
+    KineticCompletionClosure closure = {
+        .callback = callback,
+        .clientData = member,
+    };
+    return KineticOperation_Submit(member->connection, wait, build, member, closure,
+        &member->fanOut->mutex, &member->operation);
+}
+
+// Completes the caller once the policy decides, returning true if so (the
+// mutex is held)
+static bool KineticFanOut_Decide(KineticFanOut* const fanOut)
+{
+    if (fanOut->completed || !fanOut->submitted) {
+        return false;
+    }
+    KineticStatus status = KINETIC_STATUS_SUCCESS;
+    if (!fanOut->policy->decide(fanOut, &status)) {
+        return false;
+    }
+    fanOut->completed = true;
+    fanOut->status = status;
+    fanOut->entry = NULL;
+    pthread_cond_broadcast(&fanOut->cond);
+    return true;
+}
+
+// Records the outcome of a member (the mutex is held)
+static void KineticFanOut_Finish(KineticFanOutMember* const member, KineticStatus status)
+{
+    KineticFanOut* fanOut = member->fanOut;
+    member->done = true;
+    member->operation = NULL;
+    fanOut->references--;
+    if (fanOut->policy->check(member, &status)) {
+        fanOut->succeeded++;
+    }
+    else {
+        if (fanOut->failed++ == 0) {
+            fanOut->failure = status;
+        }
+        int index = 0;
+        while (fanOut->members[index] != member) {
+            index++;
+        }
+        LOGF1("%s %d on %s:%d failed w/status: %s", fanOut->policy->member, index,
+            member->connection->session.host, member->connection->session.port,
+            Kinetic_GetStatusDescription(status));
+    }
+    member->status = status;
+}
+
+static void KineticFanOut_Completed(KineticCompletionData* kinetic_data, void* client_data)
+{
+    KineticFanOutMember* member = (KineticFanOutMember*)client_data;
+    KineticFanOut* fanOut = member->fanOut;
+
+    pthread_mutex_lock(&fanOut->mutex);
+    KineticFanOut_Finish(member, kinetic_data->status);
+    bool complete = KineticFanOut_Decide(fanOut);
+    KineticCompletionClosure closure = fanOut->closure;
+    KineticStatus status = fanOut->status;
+    bool last = (fanOut->references == 0);
+    pthread_mutex_unlock(&fanOut->mutex);
+
+    if (complete && closure.callback != NULL) {
+        KineticCompletionData completionData = {.status = status};
+        closure.callback(&completionData, closure.clientData);
+    }
+    if (last) {
+        fanOut->policy->release(fanOut);
+    }
+}
+
+// Waits for the caller to be completed. Members which see no response
+// within KINETIC_PDU_RECEIVE_TIMEOUT_SECS are abandoned (the mutex is held).
+static void KineticFanOut_Wait(KineticFanOut* const fanOut)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+
+    while (!fanOut->completed) {
+        int waitStatus = pthread_cond_timedwait(&fanOut->cond, &fanOut->mutex, &deadline);
+        if (waitStatus == ETIMEDOUT && !fanOut->completed) {
+            for (int i = 0; i < fanOut->count; i++) {
+                KineticFanOutMember* member = fanOut->members[i];
+                if (member->operation != NULL && KineticOperation_Abandon(member->operation)) {
+                    KineticFanOut_Finish(member, KINETIC_STATUS_SOCKET_TIMEOUT);
+                }
+            }
+            KineticFanOut_Decide(fanOut);
+            deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+        }
+    }
+}
+
+// Sends the entry to every member, then waits for the caller to be
+// completed if it has no closure of its own, and drops the caller's
+// reference. Each session has its own sequence, connection ID and HMAC key,
+// so the request is encoded for each member, and failures to submit are
+// reported like any other member failure.
+KineticStatus KineticFanOut_Execute(KineticFanOut* const fanOut)
+{
+    assert(fanOut != NULL);
+    for (int i = 0; i < fanOut->count; i++) {
+        KineticFanOutMember* member = fanOut->members[i];
+        KineticStatus status = KineticFanOut_Request(member,
+            fanOut->reading ? KineticFanOut_BuildGet : KineticFanOut_BuildPut,
+            KineticFanOut_Completed, true);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            pthread_mutex_lock(&fanOut->mutex);
+            KineticFanOut_Finish(member, status);
+            pthread_mutex_unlock(&fanOut->mutex);
+        }
+    }
+
+    // The caller is only completed once all requests have been sent, since
+    // they refer to its buffers
+    KineticCompletionClosure closure = fanOut->closure;
+    pthread_mutex_lock(&fanOut->mutex);
+    fanOut->submitted = true;
+    bool complete = KineticFanOut_Decide(fanOut);
+    KineticStatus status = KINETIC_STATUS_SUCCESS;
+    if (closure.callback == NULL) {
+        KineticFanOut_Wait(fanOut);
+        status = fanOut->status;
+        complete = false;
+    }
+    else if (complete) {
+        status = fanOut->status;
+    }
+    bool last = (--fanOut->references == 0);
+    pthread_mutex_unlock(&fanOut->mutex);
+
+    if (complete) {
+        KineticCompletionData completionData = {.status = status};
+        closure.callback(&completionData, closure.clientData);
+        status = KINETIC_STATUS_SUCCESS;
+    }
+    if (last) {
+        fanOut->policy->release(fanOut);
+    }
+    return status;
+}
@@ -0,0 +1,38 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#ifndef _KINETIC_FAN_OUT_H
+#define _KINETIC_FAN_OUT_H
+
+#include "kinetic_types_internal.h"
+#include "kinetic_operation.h"
+
+bool KineticFanOut_CheckEntry(const KineticEntry* entry);
+void KineticFanOut_Init(KineticFanOut* const fanOut, const KineticFanOutPolicy* policy,
+    int count, bool reading, KineticEntry* const entry, KineticCompletionClosure* closure);
+void KineticFanOut_AddMember(KineticFanOut* const fanOut, int index,
+    KineticFanOutMember* const member, KineticConnection* const connection);
+KineticStatus KineticFanOut_Execute(KineticFanOut* const fanOut);
+KineticStatus KineticFanOut_Request(KineticFanOutMember* const member,
+    KineticOperationBuilder build, KineticCompletionCallback callback, bool wait);
+void KineticFanOut_BuildPut(KineticOperation* const operation, void* context);
+void KineticFanOut_Destroy(KineticFanOut* const fanOut);
+
+#endif // _KINETIC_FAN_OUT_H
@@ -0,0 +1,518 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_group_commit.h"
+#include "kinetic_connection.h"
+#include "kinetic_operation.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+static void KineticGroupCommit_AddMillis(struct timespec* const time, int millis)
+{
+    time->tv_sec += millis / 1000;
+    time->tv_nsec += (long)(millis % 1000) * 1000000;
+    if (time->tv_nsec >= 1000000000) {
+        time->tv_sec++;
+        time->tv_nsec -= 1000000000;
+    }
+}
+
+static bool KineticGroupCommit_Before(const struct timespec* a, const struct timespec* b)
+{
+    return (a->tv_sec < b->tv_sec) ||
+        (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
+
+static KineticGroupCommitWrite* KineticGroupCommit_NewWrite(KineticGroupCommit* const groupCommit,
+    KineticCompletionClosure* closure)
+{
+    pthread_mutex_lock(&groupCommit->mutex);
+    KineticGroupCommitWrite* write = groupCommit->free;
+    if (write != NULL) {
+        groupCommit->free = write->next;
+    }
+    else {
+        write = (KineticGroupCommitWrite*)calloc(1, sizeof(KineticGroupCommitWrite));
+    }
+    if (write != NULL) {
+        *write = (KineticGroupCommitWrite) {
+            .groupCommit = groupCommit,
+            .status = KINETIC_STATUS_INVALID,
+        };
+        if (closure != NULL) {
+            write->closure = *closure;
+        }
+        groupCommit->active++;
+    }
+    pthread_mutex_unlock(&groupCommit->mutex);
+
+    if (write == NULL) {
+        LOG0("Failed allocating group commit write!");
+    }
+    return write;
+}
+
+// Keeps a write for reuse (the group commit mutex must be held)
+static void KineticGroupCommit_ReleaseWrite(KineticGroupCommitWrite* const write)
+{
+    KineticGroupCommit* groupCommit = write->groupCommit;
+    write->next = groupCommit->free;
+    groupCommit->free = write;
+    groupCommit->active--;
+    pthread_cond_broadcast(&groupCommit->cond);
+}
+
+// Unlinks a PUT from those in flight (the group commit mutex must be held)
+static void KineticGroupCommit_Unlink(KineticGroupCommitWrite* const write)
+{
+    KineticGroupCommit* groupCommit = write->groupCommit;
+    if (write->previous != NULL) {
+        write->previous->next = write->next;
+    }
+    else {
+        groupCommit->writing = write->next;
+    }
+    if (write->next != NULL) {
+        write->next->previous = write->previous;
+    }
+    write->next = NULL;
+    write->previous = NULL;
+    write->operation = NULL;
+}
+
+// Reports the outcome of each of a list of writes. Synchronous callers are
+// woken to release their own writes, while closures are called from here.
+static void KineticGroupCommit_Finish(KineticGroupCommitWrite* write, KineticStatus status)
+{
+    while (write != NULL) {
+        KineticGroupCommitWrite* next = write->next;
+        KineticGroupCommit* groupCommit = write->groupCommit;
+        KineticCompletionClosure closure = write->closure;
+
+        pthread_mutex_lock(&groupCommit->mutex);
+        write->status = status;
+        if (closure.callback != NULL) {
+            KineticGroupCommit_ReleaseWrite(write);
+        }
+        else {
+            write->done = true;
+            pthread_cond_broadcast(&groupCommit->cond);
+        }
+        pthread_mutex_unlock(&groupCommit->mutex);
+
+        if (closure.callback != NULL) {
+            KineticCompletionData completionData = {.status = status};
+            closure.callback(&completionData, closure.clientData);
+        }
+        write = next;
+    }
+}
+
+// Waits for a synchronous write to be reported, and releases it
+static KineticStatus KineticGroupCommit_Wait(KineticGroupCommitWrite* const write)
+{
+    KineticGroupCommit* groupCommit = write->groupCommit;
+    pthread_mutex_lock(&groupCommit->mutex);
+    while (!write->done) {
+        pthread_cond_wait(&groupCommit->cond, &groupCommit->mutex);
+    }
+    KineticStatus status = write->status;
+    KineticGroupCommit_ReleaseWrite(write);
+    pthread_mutex_unlock(&groupCommit->mutex);
+    return status;
+}
+
+// Queues a write (or barrier) for the next FLUSHALLDATA to be sent (the
+// group commit mutex must be held)
+static void KineticGroupCommit_Enqueue(KineticGroupCommitWrite* const write)
+{
+    KineticGroupCommit* groupCommit = write->groupCommit;
+    if (groupCommit->waiting == NULL) {
+        clock_gettime(CLOCK_MONOTONIC, &groupCommit->waitingSince);
+    }
+    write->next = groupCommit->waiting;
+    groupCommit->waiting = write;
+    groupCommit->waitingCount++;
+    pthread_cond_broadcast(&groupCommit->cond);
+}
+
+static void KineticGroupCommit_Written(KineticCompletionData* kinetic_data, void* client_data)
+{
+    KineticGroupCommitWrite* write = (KineticGroupCommitWrite*)client_data;
+    KineticGroupCommit* groupCommit = write->groupCommit;
+
+    // Only a flush sent after the PUT was acknowledged is sure to cover it,
+    // so the write joins those awaiting the next flush
+    pthread_mutex_lock(&groupCommit->mutex);
+    KineticGroupCommit_Unlink(write);
+    if (kinetic_data->status == KINETIC_STATUS_SUCCESS) {
+        KineticGroupCommit_Enqueue(write);
+        write = NULL;
+    }
+    pthread_mutex_unlock(&groupCommit->mutex);
+
+    if (write != NULL) {
+        KineticGroupCommit_Finish(write, kinetic_data->status);
+    }
+}
+
+// Builds the PUT of a write, which is timed from now, since the window may
+// have been full until now
+static void KineticGroupCommit_BuildPut(KineticOperation* const operation, void* context)
+{
+    KineticGroupCommitWrite* write = (KineticGroupCommitWrite*)context;
+    KineticOperation_BuildPut(operation, write->entry);
+    pthread_mutex_lock(&write->groupCommit->mutex);
+    clock_gettime(CLOCK_MONOTONIC, &write->sent);
+    pthread_mutex_unlock(&write->groupCommit->mutex);
+}
+
+static void KineticGroupCommit_Flushed(KineticCompletionData* kinetic_data, void* client_data)
+{
+    KineticGroupCommit* groupCommit = (KineticGroupCommit*)client_data;
+
+    pthread_mutex_lock(&groupCommit->mutex);
+    KineticGroupCommitWrite* flushed = groupCommit->flushing;
+    groupCommit->flushing = NULL;
+    groupCommit->operation = NULL;
+    pthread_cond_broadcast(&groupCommit->cond);
+    pthread_mutex_unlock(&groupCommit->mutex);
+
+    if (kinetic_data->status != KINETIC_STATUS_SUCCESS) {
+        LOGF0("Group commit flush failed w/status: %s",
+            Kinetic_GetStatusDescription(kinetic_data->status));
+    }
+    KineticGroupCommit_Finish(flushed, kinetic_data->status);
+}
+
+// Gives up on requests in flight, once no response has arrived within
+// KINETIC_PDU_RECEIVE_TIMEOUT_SECS of sending them, returning the writes
+// abandoned (the group commit mutex is held)
+static KineticGroupCommitWrite* KineticGroupCommit_Timeout(KineticGroupCommit* const groupCommit)
+{
+    KineticGroupCommitWrite* expired = NULL;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    // Writes still being submitted have yet to be sent
+    KineticGroupCommitWrite* write = groupCommit->writing;
+    while (write != NULL) {
+        KineticGroupCommitWrite* next = write->next;
+        if (write->operation != NULL &&
+            now.tv_sec >= write->sent.tv_sec + KINETIC_PDU_RECEIVE_TIMEOUT_SECS) {
+            if (KineticOperation_Abandon(write->operation)) {
+                LOG0("Timed out waiting for group commit write!");
+                KineticGroupCommit_Unlink(write);
+                write->next = expired;
+                expired = write;
+            }
+            else {
+                write->sent = now;
+            }
+        }
+        write = next;
+    }
+
+    if (groupCommit->operation != NULL &&
+        now.tv_sec >= groupCommit->sent.tv_sec + KINETIC_PDU_RECEIVE_TIMEOUT_SECS) {
+        if (KineticOperation_Abandon(groupCommit->operation)) {
+            LOG0("Timed out waiting for group commit flush!");
+            groupCommit->operation = NULL;
+            while (groupCommit->flushing != NULL) {
+                write = groupCommit->flushing;
+                groupCommit->flushing = write->next;
+                write->next = expired;
+                expired = write;
+            }
+        }
+        else {
+            groupCommit->sent = now;
+        }
+    }
+
+    return expired;
+}
+
+// Takes the writes waiting for the next flush (the group commit mutex is held)
+static KineticGroupCommitWrite* KineticGroupCommit_Claim(KineticGroupCommit* const groupCommit)
+{
+    KineticGroupCommitWrite* claimed = groupCommit->waiting;
+    groupCommit->waiting = NULL;
+    groupCommit->waitingCount = 0;
+    groupCommit->barrierRequested = false;
+    return claimed;
+}
+
+// Builds a FLUSHALLDATA once there is room in the window, claiming the writes
+// waiting for it first, since the response may arrive before it is sent
+static void KineticGroupCommit_BuildFlush(KineticOperation* const operation, void* context)
+{
+    KineticGroupCommit* groupCommit = (KineticGroupCommit*)context;
+    KineticOperation_BuildFlush(operation);
+    pthread_mutex_lock(&groupCommit->mutex);
+    groupCommit->flushing = KineticGroupCommit_Claim(groupCommit);
+    clock_gettime(CLOCK_MONOTONIC, &groupCommit->sent);
+    pthread_mutex_unlock(&groupCommit->mutex);
+}
+
+// Issues a FLUSHALLDATA covering all writes waiting. It waits for room in
+// the in-flight window, since writes are left waiting until it is sent.
+static void KineticGroupCommit_Request(KineticGroupCommit* const groupCommit)
+{
+    KineticConnection* connection = groupCommit->connection;
+    KineticCompletionClosure closure = {
+        .callback = KineticGroupCommit_Flushed,
+        .clientData = groupCommit,
+    };
+    LOG2("Sending group commit flush");
+    KineticStatus status = KineticOperation_Submit(connection, false,
+        KineticGroupCommit_BuildFlush, groupCommit, closure,
+        &groupCommit->mutex, &groupCommit->operation);
+    while (status == KINETIC_STATUS_WOULD_BLOCK) {
+        status = KineticConnection_WaitForWindow(connection);
+        if (status == KINETIC_STATUS_SUCCESS) {
+            status = KineticOperation_Submit(connection, false,
+                KineticGroupCommit_BuildFlush, groupCommit, closure,
+                &groupCommit->mutex, &groupCommit->operation);
+        }
+    }
+    if (status == KINETIC_STATUS_SUCCESS) {
+        return;
+    }
+
+    // The writes were claimed, unless the flush failed before being built
+    pthread_mutex_lock(&groupCommit->mutex);
+    KineticGroupCommitWrite* claimed = groupCommit->flushing;
+    groupCommit->flushing = NULL;
+    if (claimed == NULL) {
+        claimed = KineticGroupCommit_Claim(groupCommit);
+    }
+    pthread_mutex_unlock(&groupCommit->mutex);
+
+    LOGF0("Failed sending group commit flush w/status: %s",
+        Kinetic_GetStatusDescription(status));
+    KineticGroupCommit_Finish(claimed, status);
+}
+
+static void* KineticGroupCommit_Worker(void* arg)
+{
+    KineticGroupCommit* groupCommit = (KineticGroupCommit*)arg;
+
+    // Once stopped, keep going until every write has been made durable
+    pthread_mutex_lock(&groupCommit->mutex);
+    while (groupCommit->running || groupCommit->writing != NULL ||
+        groupCommit->waiting != NULL || groupCommit->operation != NULL) {
+        KineticGroupCommitWrite* expired = KineticGroupCommit_Timeout(groupCommit);
+        if (expired != NULL) {
+            pthread_mutex_unlock(&groupCommit->mutex);
+            KineticGroupCommit_Finish(expired, KINETIC_STATUS_SOCKET_TIMEOUT);
+            pthread_mutex_lock(&groupCommit->mutex);
+        }
+
+        // Wake periodically, in order to notice requests which time out
+        struct timespec now, deadline;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        deadline = now;
+        deadline.tv_sec += 1;
+
+        // Only a single flush is ever in flight, so writes acknowledged
+        // meanwhile are covered by the next, along with any that follow
+        if (groupCommit->operation == NULL && groupCommit->waiting != NULL) {
+            struct timespec due = groupCommit->waitingSince;
+            KineticGroupCommit_AddMillis(&due, groupCommit->delayMillis);
+            if (!groupCommit->running || groupCommit->barrierRequested ||
+                groupCommit->waitingCount >= groupCommit->writesPerFlush ||
+                !KineticGroupCommit_Before(&now, &due)) {
+                pthread_mutex_unlock(&groupCommit->mutex);
+                KineticGroupCommit_Request(groupCommit);
+                pthread_mutex_lock(&groupCommit->mutex);
+                continue;
+            }
+            if (KineticGroupCommit_Before(&due, &deadline)) {
+                deadline = due;
+            }
+        }
+        pthread_cond_timedwait(&groupCommit->cond, &groupCommit->mutex, &deadline);
+    }
+    pthread_mutex_unlock(&groupCommit->mutex);
+    return NULL;
+}
+
+KineticStatus KineticGroupCommit_Start(KineticConnection* const connection,
+    int writesPerFlush, int delayMillis)
+{
+    assert(connection != NULL);
+    if (writesPerFlush == 0) {
+        writesPerFlush = KINETIC_GROUP_COMMIT_WRITES;
+    }
+    if (delayMillis == 0) {
+        delayMillis = KINETIC_GROUP_COMMIT_DELAY_MS;
+    }
+    if (writesPerFlush < 0 || delayMillis < 0) {
+        LOG0("Invalid group commit specified!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+    if (connection->groupCommit != NULL) {
+        LOG0("Group commit already started on connection!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    KineticGroupCommit* groupCommit = (KineticGroupCommit*)calloc(1, sizeof(KineticGroupCommit));
+    if (groupCommit == NULL) {
+        LOG0("Failed allocating group commit!");
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    groupCommit->connection = connection;
+    groupCommit->running = true;
+    groupCommit->writesPerFlush = writesPerFlush;
+    groupCommit->delayMillis = delayMillis;
+    pthread_mutex_init(&groupCommit->mutex, NULL);
+    Kinetic_InitCondition(&groupCommit->cond);
+
+    int pthreadStatus = pthread_create(&groupCommit->thread, NULL,
+        KineticGroupCommit_Worker, groupCommit);
+    if (pthreadStatus != 0) {
+        char errMsg[256];
+        Kinetic_GetErrnoDescription(pthreadStatus, errMsg, sizeof(errMsg));
+        LOGF0("Failed creating group commit thread w/error: %s", errMsg);
+        pthread_cond_destroy(&groupCommit->cond);
+        pthread_mutex_destroy(&groupCommit->mutex);
+        free(groupCommit);
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    connection->groupCommit = groupCommit;
+    return KINETIC_STATUS_SUCCESS;
+}
+
+KineticStatus KineticGroupCommit_Put(KineticConnection* const connection,
+    KineticEntry* const entry, KineticCompletionClosure* closure)
+{
+    assert(connection != NULL);
+    assert(entry != NULL);
+    assert(closure == NULL || closure->callback != NULL);
+    KineticGroupCommit* groupCommit = connection->groupCommit;
+    if (groupCommit == NULL) {
+        LOG0("Group commit not started on connection!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    KineticGroupCommitWrite* write = KineticGroupCommit_NewWrite(groupCommit, closure);
+    if (write == NULL) {
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+
+    // Durability comes from the flush, so the PUT itself need not wait on media
+    entry->synchronization = KINETIC_SYNCHRONIZATION_WRITEBACK;
+    write->entry = entry;
+
+    // Track the write first, since the response may arrive before the
+    // request has been sent
+    pthread_mutex_lock(&groupCommit->mutex);
+    write->next = groupCommit->writing;
+    if (groupCommit->writing != NULL) {
+        groupCommit->writing->previous = write;
+    }
+    groupCommit->writing = write;
+    pthread_mutex_unlock(&groupCommit->mutex);
+
+    KineticCompletionClosure written = {
+        .callback = KineticGroupCommit_Written,
+        .clientData = write,
+    };
+    KineticStatus status = KineticOperation_Submit(connection, true,
+        KineticGroupCommit_BuildPut, write, written, &groupCommit->mutex, &write->operation);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        pthread_mutex_lock(&groupCommit->mutex);
+        KineticGroupCommit_Unlink(write);
+        KineticGroupCommit_ReleaseWrite(write);
+        pthread_mutex_unlock(&groupCommit->mutex);
+        return status;
+    }
+
+    if (closure != NULL) {
+        return KINETIC_STATUS_SUCCESS;
+    }
+    return KineticGroupCommit_Wait(write);
+}
+
+KineticStatus KineticGroupCommit_Flush(KineticConnection* const connection,
+    KineticCompletionClosure* closure)
+{
+    assert(connection != NULL);
+    assert(closure == NULL || closure->callback != NULL);
+    KineticGroupCommit* groupCommit = connection->groupCommit;
+    if (groupCommit == NULL) {
+        LOG0("Group commit not started on connection!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    KineticGroupCommitWrite* barrier = KineticGroupCommit_NewWrite(groupCommit, closure);
+    if (barrier == NULL) {
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+
+    // The barrier joins the writes awaiting the next flush, and has it sent
+    // right away, rather than once enough writes have gathered
+    pthread_mutex_lock(&groupCommit->mutex);
+    KineticGroupCommit_Enqueue(barrier);
+    groupCommit->barrierRequested = true;
+    pthread_mutex_unlock(&groupCommit->mutex);
+
+    if (closure != NULL) {
+        return KINETIC_STATUS_SUCCESS;
+    }
+    return KineticGroupCommit_Wait(barrier);
+}
+
+void KineticGroupCommit_Stop(KineticConnection* const connection)
+{
+    assert(connection != NULL);
+    KineticGroupCommit* groupCommit = connection->groupCommit;
+    if (groupCommit == NULL) {
+        return;
+    }
+
+    // The worker flushes any writes still waiting before it exits
+    pthread_mutex_lock(&groupCommit->mutex);
+    groupCommit->running = false;
+    pthread_cond_broadcast(&groupCommit->cond);
+    pthread_mutex_unlock(&groupCommit->mutex);
+    pthread_join(groupCommit->thread, NULL);
+
+    // Writes still being reported reference the group commit
+    pthread_mutex_lock(&groupCommit->mutex);
+    while (groupCommit->active > 0) {
+        pthread_cond_wait(&groupCommit->cond, &groupCommit->mutex);
+    }
+    pthread_mutex_unlock(&groupCommit->mutex);
+
+    connection->groupCommit = NULL;
+    while (groupCommit->free != NULL) {
+        KineticGroupCommitWrite* write = groupCommit->free;
+        groupCommit->free = write->next;
+        free(write);
+    }
+    pthread_cond_destroy(&groupCommit->cond);
+    pthread_mutex_destroy(&groupCommit->mutex);
+    free(groupCommit);
+}
@@ -0,0 +1,515 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_hedge.h"
+#include "kinetic_connection.h"
+#include "kinetic_operation.h"
+#include "kinetic_entry.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+// Timer which hedges asynchronous GETs once due, started upon first use
+typedef struct _KineticHedgeTimer {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;            // signalled as hedges are scheduled (initialized upon start)
+    pthread_t thread;
+    bool started;
+    bool stopping;
+    KineticHedge* due;              // hedges scheduled, soonest first
+} KineticHedgeTimer;
+
+STATIC KineticHedgeTimer HedgeTimer = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static void KineticHedge_AddMicros(struct timespec* const time, uint32_t micros)
+{
+    time->tv_sec += micros / 1000000;
+    time->tv_nsec += (long)(micros % 1000000) * 1000;
+    if (time->tv_nsec >= 1000000000) {
+        time->tv_sec++;
+        time->tv_nsec -= 1000000000;
+    }
+}
+
+static bool KineticHedge_Before(const struct timespec* a, const struct timespec* b)
+{
+    return (a->tv_sec < b->tv_sec) ||
+        (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
+
+static uint32_t KineticHedge_MicrosSince(const struct timespec* start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t micros = (int64_t)(now.tv_sec - start->tv_sec) * 1000000 +
+        (now.tv_nsec - start->tv_nsec) / 1000;
+    return (micros < 0) ? 0 : (micros > UINT32_MAX) ? UINT32_MAX : (uint32_t)micros;
+}
+
+void KineticHedge_RecordLatency(KineticConnection* const connection, uint32_t micros)
+{
+    assert(connection != NULL);
+    KineticLatencyHistory* history = &connection->getLatency;
+    pthread_mutex_lock(&history->mutex);
+    history->samples[history->next] = micros;
+    history->next = (history->next + 1) % KINETIC_HEDGE_SAMPLES;
+    if (history->count < KINETIC_HEDGE_SAMPLES) {
+        history->count++;
+    }
+    pthread_mutex_unlock(&history->mutex);
+}
+
+// The KINETIC_HEDGE_PERCENTILE of recent GET latencies of a connection, so
+// that only the slowest GETs are hedged, or KINETIC_HEDGE_DELAY_MS until
+// enough GETs have been seen
+uint32_t KineticHedge_Delay(KineticConnection* const connection)
+{
+    assert(connection != NULL);
+    KineticLatencyHistory* history = &connection->getLatency;
+    uint32_t samples[KINETIC_HEDGE_SAMPLES];
+    pthread_mutex_lock(&history->mutex);
+    int count = history->count;
+    memcpy(samples, history->samples, sizeof(samples));
+    pthread_mutex_unlock(&history->mutex);
+
+    if (count < KINETIC_HEDGE_SAMPLES_MIN) {
+        return KINETIC_HEDGE_DELAY_MS * 1000;
+    }
+    for (int i = 1; i < count; i++) {
+        uint32_t sample = samples[i];
+        int j = i;
+        for (; j > 0 && samples[j - 1] > sample; j--) {
+            samples[j] = samples[j - 1];
+        }
+        samples[j] = sample;
+    }
+    int rank = (count * KINETIC_HEDGE_PERCENTILE + 99) / 100;
+    return samples[(rank > 0) ? rank - 1 : 0];
+}
+
+static void KineticHedge_Destroy(KineticHedge* const hedge)
+{
+    for (int i = 0; i < hedge->count; i++) {
+        free(hedge->requests[i].valueData);
+    }
+    pthread_cond_destroy(&hedge->cond);
+    pthread_mutex_destroy(&hedge->mutex);
+    free(hedge);
+}
+
+static void KineticHedge_Release(KineticHedge* const hedge)
+{
+    pthread_mutex_lock(&hedge->mutex);
+    bool last = (--hedge->references == 0);
+    pthread_mutex_unlock(&hedge->mutex);
+    if (last) {
+        KineticHedge_Destroy(hedge);
+    }
+}
+
+static bool KineticHedge_Schedule(KineticHedge* const hedge);
+static bool KineticHedge_Unschedule(KineticHedge* const hedge);
+static void KineticHedge_Issue(KineticHedge* const hedge, bool wait);
+
+static void KineticHedge_Completed(KineticCompletionData* kinetic_data, void* client_data)
+{
+    KineticHedgeRequest* request = (KineticHedgeRequest*)client_data;
+    KineticHedge* hedge = request->hedge;
+    KineticStatus status = kinetic_data->status;
+
+    bool responded = (status == KINETIC_STATUS_SUCCESS || status == KINETIC_STATUS_NOT_FOUND);
+
+    pthread_mutex_lock(&hedge->mutex);
+    uint32_t latency = KineticHedge_MicrosSince(&request->sent);
+    request->operation = NULL;
+    bool complete = false;
+    bool issueNext = false;
+    if (!hedge->completed) {
+        if (responded) {
+            LOGF1("Hedged GET answered by replica %d of %d on %s:%d",
+                (int)(request - hedge->requests) + 1, hedge->issued,
+                request->connection->session.host, request->connection->session.port);
+            hedge->status = (status == KINETIC_STATUS_SUCCESS) ?
+                KineticEntry_CopyRetrieved(hedge->entry, &request->entry) : status;
+            complete = true;
+        }
+        else {
+            if (hedge->failed++ == 0) {
+                hedge->failure = status;
+            }
+            LOGF1("Hedged GET on %s:%d failed w/status: %s",
+                request->connection->session.host, request->connection->session.port,
+                Kinetic_GetStatusDescription(status));
+
+            // Once every request issued has failed, ask the next replica at
+            // once, rather than waiting for the hedging delay
+            if (hedge->failed == hedge->issued) {
+                if (hedge->issued < hedge->count) {
+                    issueNext = true;
+                }
+                else {
+                    hedge->status = hedge->failure;
+                    complete = true;
+                }
+            }
+        }
+        if (complete) {
+            hedge->completed = true;
+            hedge->entry = NULL;
+            pthread_cond_broadcast(&hedge->cond);
+        }
+    }
+    KineticCompletionClosure closure = hedge->closure;
+    KineticStatus hedgeStatus = hedge->status;
+    pthread_mutex_unlock(&hedge->mutex);
+
+    // Requests which lose the race still count towards the latency seen
+    if (responded) {
+        KineticHedge_RecordLatency(request->connection, latency);
+    }
+    if (complete && closure.callback != NULL) {
+        KineticCompletionData completionData = {.status = hedgeStatus};
+        closure.callback(&completionData, closure.clientData);
+    }
+    if (complete && KineticHedge_Unschedule(hedge)) {
+        KineticHedge_Release(hedge);
+    }
+    if (issueNext) {
+        KineticHedge_Issue(hedge, false);
+    }
+    KineticHedge_Release(hedge);
+}
+
+// Builds the GET for a replica, stamping the time it is sent, since the
+// response may arrive before the request has been sent
+static void KineticHedge_Build(KineticOperation* const operation, void* context)
+{
+    KineticHedgeRequest* request = (KineticHedgeRequest*)context;
+    KineticOperation_BuildGet(operation, &request->entry);
+    pthread_mutex_lock(&request->hedge->mutex);
+    clock_gettime(CLOCK_MONOTONIC, &request->sent);
+    pthread_mutex_unlock(&request->hedge->mutex);
+}
+
+// Issues the request for a replica. Upon failure to submit, the closure is
+// not called, and the status is returned instead. Unless waiting, a full
+// in-flight window fails the request rather than blocking.
+static KineticStatus KineticHedge_Request(KineticHedgeRequest* const request, bool wait)
+{
+    KineticCompletionClosure closure = {
+        .callback = KineticHedge_Completed,
+        .clientData = request,
+    };
+    return KineticOperation_Submit(request->connection, wait, KineticHedge_Build, request,
+        closure, &request->hedge->mutex, &request->operation);
+}
+
+// Sends the GET to the next replica, unless the caller has been completed
+static void KineticHedge_Issue(KineticHedge* const hedge, bool wait)
+{
+    pthread_mutex_lock(&hedge->mutex);
+    if (hedge->completed || hedge->issued == hedge->count) {
+        pthread_mutex_unlock(&hedge->mutex);
+        return;
+    }
+    KineticHedgeRequest* request = &hedge->requests[hedge->issued++];
+    hedge->references++;
+    pthread_mutex_unlock(&hedge->mutex);
+
+    if (request != hedge->requests) {
+        LOGF1("Hedging GET with replica %d on %s:%d", (int)(request - hedge->requests) + 1,
+            request->connection->session.host, request->connection->session.port);
+    }
+    KineticStatus status = KineticHedge_Request(request, wait);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        KineticCompletionData completionData = {.status = status};
+        KineticHedge_Completed(&completionData, request);
+    }
+}
+
+static void* KineticHedge_Timer(void* arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&HedgeTimer.mutex);
+    while (!HedgeTimer.stopping) {
+        KineticHedge* hedge = HedgeTimer.due;
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (hedge == NULL) {
+            pthread_cond_wait(&HedgeTimer.cond, &HedgeTimer.mutex);
+        }
+        else if (KineticHedge_Before(&now, &hedge->deadline)) {
+            pthread_cond_timedwait(&HedgeTimer.cond, &HedgeTimer.mutex, &hedge->deadline);
+        }
+        else {
+            HedgeTimer.due = hedge->next;
+            hedge->next = NULL;
+            pthread_mutex_unlock(&HedgeTimer.mutex);
+
+            // The timer's reference carries over if there are more replicas
+            // to hedge with
+            KineticHedge_Issue(hedge, false);
+            pthread_mutex_lock(&hedge->mutex);
+            bool again = !hedge->completed && hedge->issued < hedge->count;
+            if (again) {
+                clock_gettime(CLOCK_MONOTONIC, &hedge->deadline);
+                KineticHedge_AddMicros(&hedge->deadline,
+                    KineticHedge_Delay(hedge->requests[hedge->issued - 1].connection));
+            }
+            pthread_mutex_unlock(&hedge->mutex);
+            if (!again || !KineticHedge_Schedule(hedge)) {
+                KineticHedge_Release(hedge);
+            }
+            pthread_mutex_lock(&HedgeTimer.mutex);
+        }
+    }
+    pthread_mutex_unlock(&HedgeTimer.mutex);
+    return NULL;
+}
+
+// Hands a hedge to the timer until its deadline, starting the timer if need
+// be. The timer holds a reference to the hedge while it is scheduled.
+static bool KineticHedge_Schedule(KineticHedge* const hedge)
+{
+    pthread_mutex_lock(&HedgeTimer.mutex);
+    if (!HedgeTimer.started && !HedgeTimer.stopping) {
+        // Deadlines are CLOCK_MONOTONIC, which a static condition can't wait on
+        Kinetic_InitCondition(&HedgeTimer.cond);
+        int pthreadStatus = pthread_create(&HedgeTimer.thread, NULL, KineticHedge_Timer, NULL);
+        if (pthreadStatus != 0) {
+            char errMsg[256];
+            Kinetic_GetErrnoDescription(pthreadStatus, errMsg, sizeof(errMsg));
+            LOGF0("Failed creating hedge timer thread w/error: %s", errMsg);
+        }
+        else {
+            HedgeTimer.started = true;
+        }
+    }
+    bool scheduled = HedgeTimer.started && !HedgeTimer.stopping;
+    if (scheduled) {
+        KineticHedge** link = &HedgeTimer.due;
+        while (*link != NULL && !KineticHedge_Before(&hedge->deadline, &(*link)->deadline)) {
+            link = &(*link)->next;
+        }
+        hedge->next = *link;
+        *link = hedge;
+        pthread_cond_signal(&HedgeTimer.cond);
+    }
+    pthread_mutex_unlock(&HedgeTimer.mutex);
+    return scheduled;
+}
+
+// Takes a hedge back from the timer, returning true if it was scheduled
+static bool KineticHedge_Unschedule(KineticHedge* const hedge)
+{
+    bool unscheduled = false;
+    pthread_mutex_lock(&HedgeTimer.mutex);
+    for (KineticHedge** link = &HedgeTimer.due; *link != NULL; link = &(*link)->next) {
+        if (*link == hedge) {
+            *link = hedge->next;
+            hedge->next = NULL;
+            unscheduled = true;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&HedgeTimer.mutex);
+    return unscheduled;
+}
+
+void KineticHedge_Shutdown(void)
+{
+    pthread_mutex_lock(&HedgeTimer.mutex);
+    if (!HedgeTimer.started) {
+        pthread_mutex_unlock(&HedgeTimer.mutex);
+        return;
+    }
+    HedgeTimer.stopping = true;
+    pthread_cond_signal(&HedgeTimer.cond);
+    pthread_mutex_unlock(&HedgeTimer.mutex);
+    pthread_join(HedgeTimer.thread, NULL);
+
+    // Hedges still scheduled just wait for the requests already issued
+    pthread_mutex_lock(&HedgeTimer.mutex);
+    KineticHedge* hedge = HedgeTimer.due;
+    HedgeTimer.due = NULL;
+    HedgeTimer.started = false;
+    HedgeTimer.stopping = false;
+    pthread_cond_destroy(&HedgeTimer.cond);
+    pthread_mutex_unlock(&HedgeTimer.mutex);
+    while (hedge != NULL) {
+        KineticHedge* next = hedge->next;
+        hedge->next = NULL;
+        KineticHedge_Release(hedge);
+        hedge = next;
+    }
+}
+
+// Abandons requests which have seen no response, which completes them with
+// KINETIC_STATUS_SOCKET_TIMEOUT (the mutex is not held). Operations are
+// abandoned with the mutex held, since one which has completed may be reused.
+static void KineticHedge_Abandon(KineticHedge* const hedge)
+{
+    KineticHedgeRequest* abandoned[KINETIC_REPLICAS_MAX];
+    int count = 0;
+    pthread_mutex_lock(&hedge->mutex);
+    for (int i = 0; i < hedge->issued; i++) {
+        KineticHedgeRequest* request = &hedge->requests[i];
+        if (request->operation != NULL && KineticOperation_Abandon(request->operation)) {
+            request->operation = NULL;
+            abandoned[count++] = request;
+        }
+    }
+    pthread_mutex_unlock(&hedge->mutex);
+    for (int i = 0; i < count; i++) {
+        KineticCompletionData completionData = {.status = KINETIC_STATUS_SOCKET_TIMEOUT};
+        KineticHedge_Completed(&completionData, abandoned[i]);
+    }
+}
+
+// Waits for the first response, hedging with the next replica whenever the
+// last one issued has not responded within its usual latency. Requests which
+// see no response within KINETIC_PDU_RECEIVE_TIMEOUT_SECS are abandoned.
+static KineticStatus KineticHedge_Wait(KineticHedge* const hedge)
+{
+    struct timespec abandon;
+    clock_gettime(CLOCK_MONOTONIC, &abandon);
+    abandon.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+
+    pthread_mutex_lock(&hedge->mutex);
+    while (!hedge->completed) {
+        bool hedging = hedge->issued < hedge->count &&
+            KineticHedge_Before(&hedge->deadline, &abandon);
+        int waitStatus = pthread_cond_timedwait(&hedge->cond, &hedge->mutex,
+            hedging ? &hedge->deadline : &abandon);
+        if (waitStatus != ETIMEDOUT || hedge->completed) {
+            continue;
+        }
+        pthread_mutex_unlock(&hedge->mutex);
+        if (hedging) {
+            KineticHedge_Issue(hedge, true);
+        }
+        else {
+            KineticHedge_Abandon(hedge);
+        }
+        pthread_mutex_lock(&hedge->mutex);
+        if (hedging) {
+            clock_gettime(CLOCK_MONOTONIC, &hedge->deadline);
+            KineticHedge_AddMicros(&hedge->deadline,
+                KineticHedge_Delay(hedge->requests[hedge->issued - 1].connection));
+        }
+        else {
+            abandon.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+        }
+    }
+    KineticStatus status = hedge->status;
+    pthread_mutex_unlock(&hedge->mutex);
+    return status;
+}
+
+KineticStatus KineticHedge_Get(KineticConnection** const connections, int count,
+    KineticEntry* const entry, KineticCompletionClosure* closure)
+{
+    assert(connections != NULL);
+    assert(entry != NULL);
+    if (count < 1 || count > KINETIC_REPLICAS_MAX) {
+        LOGF0("Invalid number of replicas specified (%d)!", count);
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+    if (entry->key.bytesUsed > KINETIC_MAX_KEY_LEN) {
+        LOG0("Hedged entry key is too long!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    KineticHedge* hedge = (KineticHedge*)calloc(1, sizeof(KineticHedge));
+    if (hedge == NULL) {
+        LOG0("Failed allocating hedged GET!");
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    pthread_mutex_init(&hedge->mutex, NULL);
+    Kinetic_InitCondition(&hedge->cond);
+    hedge->count = count;
+    hedge->references = 1;
+    hedge->entry = entry;
+    if (closure != NULL) {
+        hedge->closure = *closure;
+    }
+
+    // Requests outlive the caller's entry, so have their own copy of the key,
+    // and buffers of their own for the entry retrieved
+    if (entry->key.bytesUsed > 0) {
+        memcpy(hedge->keyData, entry->key.array.data, entry->key.bytesUsed);
+    }
+    ByteBuffer key = ByteBuffer_Create(hedge->keyData,
+        sizeof(hedge->keyData), entry->key.bytesUsed);
+
+    // Ask the preferred replica first, unless it is busier than another, and
+    // then the rest in turn
+    int first = KineticConnection_SelectLeastLoaded(connections, count, 0);
+    for (int i = 0; i < count; i++) {
+        KineticHedgeRequest* request = &hedge->requests[i];
+        request->hedge = hedge;
+        request->connection = connections[(i == 0) ? first : ((i <= first) ? i - 1 : i)];
+        request->entry = *entry;
+        request->entry.key = key;
+        request->entry.newVersion = BYTE_BUFFER_NONE;
+        request->entry.dbVersion = ByteBuffer_Create(request->versionData,
+            sizeof(request->versionData), 0);
+        request->entry.tag = ByteBuffer_Create(request->tagData, sizeof(request->tagData), 0);
+        if (!entry->metadataOnly) {
+            request->valueData = (uint8_t*)malloc(entry->value.array.len);
+            if (request->valueData == NULL) {
+                LOG0("Failed allocating hedged GET value buffer!");
+                KineticHedge_Destroy(hedge);
+                return KINETIC_STATUS_MEMORY_ERROR;
+            }
+        }
+        request->entry.value = ByteBuffer_Create(request->valueData,
+            (request->valueData != NULL) ? entry->value.array.len : 0, 0);
+    }
+
+    LOGF1("Hedged GET across %d replicas", count);
+    clock_gettime(CLOCK_MONOTONIC, &hedge->deadline);
+    KineticHedge_AddMicros(&hedge->deadline, KineticHedge_Delay(connections[first]));
+    KineticHedge_Issue(hedge, true);
+
+    KineticStatus status = KINETIC_STATUS_SUCCESS;
+    if (closure == NULL) {
+        status = KineticHedge_Wait(hedge);
+    }
+    else {
+        // The timer hedges asynchronous GETs, holding a reference meanwhile
+        pthread_mutex_lock(&hedge->mutex);
+        bool hedging = !hedge->completed && hedge->issued < hedge->count;
+        if (hedging) {
+            hedge->references++;
+        }
+        pthread_mutex_unlock(&hedge->mutex);
+        if (hedging && !KineticHedge_Schedule(hedge)) {
+            KineticHedge_Release(hedge);
+        }
+    }
+    KineticHedge_Release(hedge);
+    return status;
+}
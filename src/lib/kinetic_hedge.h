@@ -0,0 +1,32 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#ifndef _KINETIC_HEDGE_H
+#define _KINETIC_HEDGE_H
+
+#include "kinetic_types_internal.h"
+
+KineticStatus KineticHedge_Get(KineticConnection** const connections, int count,
+    KineticEntry* const entry, KineticCompletionClosure* closure);
+void KineticHedge_RecordLatency(KineticConnection* const connection, uint32_t micros);
+uint32_t KineticHedge_Delay(KineticConnection* const connection);
+void KineticHedge_Shutdown(void);
+
+#endif // _KINETIC_HEDGE_H
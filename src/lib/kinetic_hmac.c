@@ -22,11 +22,11 @@
 #include "kinetic_nbo.h"
 #include "kinetic_logger.h"
 #include <string.h>
-#include <openssl/hmac.h>
+#include <openssl/sha.h>
 
 static void KineticHMAC_Compute(KineticHMAC* hmac,
                                 const KineticProto_Message* proto,
-                                const ByteArray key);
+                                const KineticHMACKey* key);
 
 void KineticHMAC_Init(KineticHMAC* hmac,
                       KineticProto_Command_Security_ACL_HMACAlgorithm algorithm)
@@ -46,12 +46,12 @@ void KineticHMAC_Init(KineticHMAC* hmac,
 
 void KineticHMAC_Populate(KineticHMAC* hmac,
                           KineticProto_Message* msg,
-                          const ByteArray key)
+                          const KineticHMACKey* key)
 {
     assert(hmac != NULL);
     assert(msg != NULL);
-    assert(key.data != NULL);
-    assert(key.len > 0);
+    assert(key != NULL);
+    assert(key->prepared);
 
     KineticHMAC_Init(hmac, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
     KineticHMAC_Compute(hmac, msg, key);
@@ -63,11 +63,11 @@ void KineticHMAC_Populate(KineticHMAC* hmac,
 }
 
 bool KineticHMAC_Validate(const KineticProto_Message* msg,
-                          const ByteArray key)
+                          const KineticHMACKey* key)
 {
     assert(msg != NULL);
-    assert(key.data != NULL);
-    assert(key.len > 0);
+    assert(key != NULL);
+    assert(key->prepared);
 
     bool success = false;
     size_t i;
@@ -105,9 +105,43 @@ bool KineticHMAC_Validate(const KineticProto_Message* msg,
 
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 
+void KineticHMAC_PrepareKey(KineticHMACKey* prepared,
+                            const ByteArray key)
+{
+    assert(prepared != NULL);
+    assert(key.data != NULL);
+    assert(key.len > 0);
+
+    // Keys longer than a block are hashed first (RFC 2104)
+    uint8_t block[SHA_CBLOCK];
+    memset(block, 0, sizeof(block));
+    if (key.len > SHA_CBLOCK) {
+        SHA1(key.data, key.len, block);
+    }
+    else {
+        memcpy(block, key.data, key.len);
+    }
+
+    uint8_t pad[SHA_CBLOCK];
+    for (size_t i = 0; i < SHA_CBLOCK; i++) {
+        pad[i] = block[i] ^ 0x36;
+    }
+    SHA1_Init(&prepared->inner);
+    SHA1_Update(&prepared->inner, pad, sizeof(pad));
+    for (size_t i = 0; i < SHA_CBLOCK; i++) {
+        pad[i] = block[i] ^ 0x5C;
+    }
+    SHA1_Init(&prepared->outer);
+    SHA1_Update(&prepared->outer, pad, sizeof(pad));
+    prepared->prepared = true;
+
+    memset(block, 0, sizeof(block));
+    memset(pad, 0, sizeof(pad));
+}
+
 static void KineticHMAC_Compute(KineticHMAC* hmac,
                                 const KineticProto_Message* msg,
-                                const ByteArray key)
+                                const KineticHMACKey* key)
 {
     assert(hmac != NULL);
     assert(hmac->data != NULL);
@@ -119,11 +153,15 @@ static void KineticHMAC_Compute(KineticHMAC* hmac,
 
     uint32_t lenNBO = KineticNBO_FromHostU32(msg->commandBytes.len);
 
-    HMAC_CTX ctx;
-    HMAC_CTX_init(&ctx);
-    HMAC_Init_ex(&ctx, key.data, key.len, EVP_sha1(), NULL);
-    HMAC_Update(&ctx, (uint8_t*)&lenNBO, sizeof(uint32_t));
-    HMAC_Update(&ctx, msg->commandBytes.data, msg->commandBytes.len);
-    HMAC_Final(&ctx, hmac->data, &hmac->len);
-    HMAC_CTX_cleanup(&ctx);
+    // Resume from the prepared key states, rather than redoing key setup
+    uint8_t innerDigest[SHA_DIGEST_LENGTH];
+    SHA_CTX ctx = key->inner;
+    SHA1_Update(&ctx, (uint8_t*)&lenNBO, sizeof(uint32_t));
+    SHA1_Update(&ctx, msg->commandBytes.data, msg->commandBytes.len);
+    SHA1_Final(innerDigest, &ctx);
+
+    ctx = key->outer;
+    SHA1_Update(&ctx, innerDigest, sizeof(innerDigest));
+    SHA1_Final(hmac->data, &ctx);
+    hmac->len = SHA_DIGEST_LENGTH;
 }
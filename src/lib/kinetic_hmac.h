@@ -27,11 +27,14 @@
 void KineticHMAC_Init(KineticHMAC* hmac,
                       KineticProto_Command_Security_ACL_HMACAlgorithm algorithm);
 
+void KineticHMAC_PrepareKey(KineticHMACKey* prepared,
+                            const ByteArray key);
+
 void KineticHMAC_Populate(KineticHMAC* hmac,
                           KineticProto_Message* msg,
-                          const ByteArray key);
+                          const KineticHMACKey* key);
 
 bool KineticHMAC_Validate(const KineticProto_Message* msg,
-                          const ByteArray key);
+                          const KineticHMACKey* key);
 
 #endif  // _KINETIC_HMAC_H
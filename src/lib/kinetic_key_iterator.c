@@ -0,0 +1,242 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_key_iterator.h"
+#include "kinetic_operation.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+static void KineticKeyIterator_PageReceived(KineticCompletionData* kinetic_data, void* client_data)
+{
+    KineticKeyPage* page = (KineticKeyPage*)client_data;
+    KineticKeyIterator* iterator = page->iterator;
+    pthread_mutex_lock(&iterator->mutex);
+    page->status = kinetic_data->status;
+    page->operation = NULL;
+    pthread_cond_broadcast(&iterator->cond);
+    pthread_mutex_unlock(&iterator->mutex);
+}
+
+// Copies a range into a page, so the page owns its start and end keys
+static void KineticKeyIterator_SetRange(KineticKeyPage* const page, const KineticKeyRange* range)
+{
+    page->range = *range;
+    page->range.startKey = ByteBuffer_Create(page->startKey, sizeof(page->startKey), 0);
+    ByteBuffer_Append(&page->range.startKey, range->startKey.array.data, range->startKey.bytesUsed);
+    if (range->endKey.array.data != NULL) {
+        page->range.endKey = ByteBuffer_Create(page->endKey, sizeof(page->endKey), 0);
+        ByteBuffer_Append(&page->range.endKey, range->endKey.array.data, range->endKey.bytesUsed);
+    }
+}
+
+static void KineticKeyIterator_Build(KineticOperation* const operation, void* context)
+{
+    KineticKeyPage* page = (KineticKeyPage*)context;
+    KineticOperation_BuildGetKeyRange(operation, &page->range, &page->keys);
+}
+
+// Issues the GETKEYRANGE request for a page. A failure to submit is recorded
+// as the page status, and reported once the consumer reaches the page.
+static void KineticKeyIterator_Request(KineticKeyIterator* const iterator, KineticKeyPage* const page)
+{
+    page->keys.used = 0;
+    page->requested = true;
+    page->status = KINETIC_STATUS_SUCCESS;
+
+    KineticCompletionClosure closure = {
+        .callback = KineticKeyIterator_PageReceived,
+        .clientData = page,
+    };
+    KineticStatus status = KineticOperation_Submit(iterator->connection, true,
+        KineticKeyIterator_Build, page, closure, &iterator->mutex, &page->operation);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        page->status = status;
+    }
+}
+
+// Waits for a requested page to arrive, giving up on it if there is no
+// response within KINETIC_PDU_RECEIVE_TIMEOUT_SECS
+static KineticStatus KineticKeyIterator_Await(KineticKeyIterator* const iterator, KineticKeyPage* const page)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+
+    pthread_mutex_lock(&iterator->mutex);
+    while (page->operation != NULL) {
+        int waitStatus = pthread_cond_timedwait(&iterator->cond, &iterator->mutex, &deadline);
+        if (waitStatus == ETIMEDOUT && page->operation != NULL) {
+            if (KineticOperation_Abandon(page->operation)) {
+                LOG0("Timed out waiting for page of keys!");
+                page->operation = NULL;
+                page->status = KINETIC_STATUS_SOCKET_TIMEOUT;
+            }
+            else {
+                deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+            }
+        }
+    }
+    KineticStatus status = page->status;
+    pthread_mutex_unlock(&iterator->mutex);
+    return status;
+}
+
+// Requests the page following the current one, if the current page was full
+// (otherwise the range has been exhausted)
+static void KineticKeyIterator_Prefetch(KineticKeyIterator* const iterator)
+{
+    KineticKeyPage* page = &iterator->pages[iterator->current];
+    KineticKeyPage* following = &iterator->pages[1 - iterator->current];
+    if (page->keys.used < page->range.maxReturned) {
+        return;
+    }
+
+    // Continue from just beyond the last key retrieved
+    ByteBuffer* last = &page->keys.buffers[page->keys.used - 1];
+    KineticKeyIterator_SetRange(following, &page->range);
+    if (page->range.reverse) {
+        following->range.endKey = ByteBuffer_Create(following->endKey, sizeof(following->endKey), 0);
+        ByteBuffer_Append(&following->range.endKey, last->array.data, last->bytesUsed);
+        following->range.endKeyInclusive = false;
+    }
+    else {
+        ByteBuffer_Reset(&following->range.startKey);
+        ByteBuffer_Append(&following->range.startKey, last->array.data, last->bytesUsed);
+        following->range.startKeyInclusive = false;
+    }
+    KineticKeyIterator_Request(iterator, following);
+}
+
+void KineticKeyIterator_Close(KineticKeyIterator* const iterator)
+{
+    if (iterator == NULL) {
+        return;
+    }
+
+    // Responses still in flight reference the pages, so must be retired
+    for (int i = 0; i < 2; i++) {
+        KineticKeyIterator_Await(iterator, &iterator->pages[i]);
+        free(iterator->pages[i].keys.buffers);
+        free(iterator->pages[i].keyData);
+    }
+    pthread_cond_destroy(&iterator->cond);
+    pthread_mutex_destroy(&iterator->mutex);
+    free(iterator);
+}
+
+KineticStatus KineticKeyIterator_Open(KineticConnection* const connection,
+    const KineticKeyRange* range, KineticKeyIterator** iterator)
+{
+    assert(connection != NULL);
+    assert(range != NULL);
+    assert(iterator != NULL);
+    *iterator = NULL;
+    if (range->maxReturned <= 0 ||
+        range->startKey.array.data == NULL || range->startKey.bytesUsed == 0 ||
+        range->startKey.bytesUsed > KINETIC_MAX_KEY_LEN ||
+        range->endKey.bytesUsed > KINETIC_MAX_KEY_LEN) {
+        LOG0("Invalid key range specified for iterator!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    KineticKeyIterator* it = (KineticKeyIterator*)calloc(1, sizeof(KineticKeyIterator));
+    if (it == NULL) {
+        LOG0("Failed allocating key iterator!");
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    it->connection = connection;
+    it->status = KINETIC_STATUS_SUCCESS;
+    pthread_mutex_init(&it->mutex, NULL);
+    Kinetic_InitCondition(&it->cond);
+
+    // Each page holds up to maxReturned keys, of up to KINETIC_MAX_KEY_LEN
+    size_t count = (size_t)range->maxReturned;
+    for (int i = 0; i < 2; i++) {
+        KineticKeyPage* page = &it->pages[i];
+        page->iterator = it;
+        page->keys.buffers = (ByteBuffer*)calloc(count, sizeof(ByteBuffer));
+        page->keys.count = (int)count;
+        page->keyData = (uint8_t*)malloc(count * KINETIC_MAX_KEY_LEN);
+        if (page->keys.buffers == NULL || page->keyData == NULL) {
+            LOG0("Failed allocating key iterator pages!");
+            KineticKeyIterator_Close(it);
+            return KINETIC_STATUS_MEMORY_ERROR;
+        }
+        for (size_t k = 0; k < count; k++) {
+            page->keys.buffers[k] = ByteBuffer_Create(
+                &page->keyData[k * KINETIC_MAX_KEY_LEN], KINETIC_MAX_KEY_LEN, 0);
+        }
+    }
+
+    KineticKeyIterator_SetRange(&it->pages[0], range);
+    KineticKeyIterator_Request(it, &it->pages[0]);
+    pthread_mutex_lock(&it->mutex);
+    KineticStatus status = (it->pages[0].operation != NULL) ?
+        KINETIC_STATUS_SUCCESS : it->pages[0].status;
+    pthread_mutex_unlock(&it->mutex);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        KineticKeyIterator_Close(it);
+        return status;
+    }
+    *iterator = it;
+    return KINETIC_STATUS_SUCCESS;
+}
+
+KineticStatus KineticKeyIterator_Next(KineticKeyIterator* const iterator, ByteBuffer* key)
+{
+    assert(iterator != NULL);
+    assert(key != NULL);
+
+    while (iterator->status == KINETIC_STATUS_SUCCESS) {
+        KineticKeyPage* page = &iterator->pages[iterator->current];
+
+        // Upon reaching a page, wait for it, and request the one following it
+        if (page->requested) {
+            page->requested = false;
+            iterator->status = KineticKeyIterator_Await(iterator, page);
+            if (iterator->status != KINETIC_STATUS_SUCCESS) {
+                break;
+            }
+            KineticKeyIterator_Prefetch(iterator);
+        }
+
+        if (iterator->next < page->keys.used) {
+            ByteBuffer* next = &page->keys.buffers[iterator->next];
+            ByteBuffer_Reset(key);
+            if (ByteBuffer_Append(key, next->array.data, next->bytesUsed) == NULL) {
+                return KINETIC_STATUS_BUFFER_OVERRUN;
+            }
+            iterator->next++;
+            return KINETIC_STATUS_SUCCESS;
+        }
+
+        // Move on to the following page, if there is one
+        if (!iterator->pages[1 - iterator->current].requested) {
+            return KINETIC_STATUS_NOT_FOUND;
+        }
+        iterator->current = 1 - iterator->current;
+        iterator->next = 0;
+    }
+
+    return iterator->status;
+}
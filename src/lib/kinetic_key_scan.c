@@ -0,0 +1,193 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_key_scan.h"
+#include "kinetic_key_iterator.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+
+// Reads 'len' bytes of a key from the specified offset as a big-endian
+// number, treating bytes beyond the end of the key as zero
+static uint64_t KineticKeyScan_KeyValue(const ByteBuffer* key, size_t offset, size_t len)
+{
+    uint64_t value = 0;
+    for (size_t i = offset; i < offset + len; i++) {
+        value <<= 8;
+        if (i < key->bytesUsed) {
+            value |= key->array.data[i];
+        }
+    }
+    return value;
+}
+
+int KineticKeyScan_Split(const KineticKeyRange* range, int partitions,
+    KineticKeyRange* subRanges, uint8_t* splitKeyData)
+{
+    assert(range != NULL);
+    assert(partitions > 0);
+    assert(subRanges != NULL);
+    assert(splitKeyData != NULL);
+
+    // Split on the bytes following the prefix common to both keys
+    const ByteBuffer* start = &range->startKey;
+    const ByteBuffer* end = &range->endKey;
+    size_t prefix = 0;
+    while (prefix < start->bytesUsed && prefix < end->bytesUsed &&
+           start->array.data[prefix] == end->array.data[prefix]) {
+        prefix++;
+    }
+    size_t len = KINETIC_MAX_KEY_LEN - prefix;
+    if (len > KINETIC_KEY_SCAN_SPLIT_LEN) {
+        len = KINETIC_KEY_SCAN_SPLIT_LEN;
+    }
+    uint64_t first = KineticKeyScan_KeyValue(start, prefix, len);
+    uint64_t last = KineticKeyScan_KeyValue(end, prefix, len);
+    uint64_t span = (last > first) ? (last - first) : 0;
+    if (span < (uint64_t)partitions) {
+        partitions = (int)span;
+    }
+    if (partitions <= 1) {
+        subRanges[0] = *range;
+        return 1;
+    }
+
+    // Place split keys evenly between the start and end keys. Each split key
+    // ends one partition (exclusive), and starts the next (inclusive).
+    for (int i = 0; i < partitions; i++) {
+        subRanges[i] = *range;
+    }
+    for (int i = 1; i < partitions; i++) {
+        uint64_t split = first + (span / partitions) * i +
+            ((span % partitions) * i) / partitions;
+        uint8_t* key = &splitKeyData[(i - 1) * KINETIC_MAX_KEY_LEN];
+        memcpy(key, start->array.data, prefix);
+        for (size_t b = 0; b < len; b++) {
+            key[prefix + len - 1 - b] = (uint8_t)(split >> (8 * b));
+        }
+        ByteBuffer splitKey = ByteBuffer_Create(key, prefix + len, prefix + len);
+        subRanges[i - 1].endKey = splitKey;
+        subRanges[i - 1].endKeyInclusive = false;
+        subRanges[i].startKey = splitKey;
+        subRanges[i].startKeyInclusive = true;
+    }
+    return partitions;
+}
+
+// Reports the keys of a partition until its iterator is exhausted, or
+// 'limit' keys have been reported (if positive)
+static KineticStatus KineticKeyScan_Report(KineticKeyScan* const scan,
+    KineticKeyIterator* iterator, int partition, ByteBuffer* key, int limit)
+{
+    KineticStatus status;
+    for (int n = 0; limit <= 0 || n < limit; n++) {
+        status = KineticKeyIterator_Next(iterator, key);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            return status;
+        }
+        scan->callback(partition, key, scan->clientData);
+    }
+    return KINETIC_STATUS_SUCCESS;
+}
+
+// Opens all partitions up front, so that each has its first page in flight,
+// spreading them over the sessions, and then reports their keys
+static KineticStatus KineticKeyScan_Run(KineticKeyScan* const scan,
+    KineticConnection* const * connections, int count,
+    const KineticKeyRange* subRanges, KineticKeyIterator** iterators, int partitions)
+{
+    uint8_t keyData[KINETIC_MAX_KEY_LEN];
+    ByteBuffer key = ByteBuffer_Create(keyData, sizeof(keyData), 0);
+    KineticStatus status;
+    for (int i = 0; i < partitions; i++) {
+        status = KineticKeyIterator_Open(connections[i % count], &subRanges[i], &iterators[i]);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            return status;
+        }
+    }
+
+    // Partitions are ordered by key, so report them one after another
+    if (scan->ordered) {
+        for (int n = 0; n < partitions; n++) {
+            int i = scan->range.reverse ? (partitions - 1 - n) : n;
+            status = KineticKeyScan_Report(scan, iterators[i], i, &key, 0);
+            if (status != KINETIC_STATUS_NOT_FOUND) {
+                return status;
+            }
+        }
+        return KINETIC_STATUS_SUCCESS;
+    }
+
+    // Otherwise, take a page from each partition in turn, so that while one
+    // page is reported, the following pages are in flight for the others
+    bool done[KINETIC_KEY_SCAN_PARTITIONS_MAX] = {false};
+    int active = partitions;
+    for (int i = 0; active > 0; i = (i + 1) % partitions) {
+        if (done[i]) {
+            continue;
+        }
+        status = KineticKeyScan_Report(scan, iterators[i], i, &key, scan->range.maxReturned);
+        if (status == KINETIC_STATUS_NOT_FOUND) {
+            done[i] = true;
+            active--;
+        }
+        else if (status != KINETIC_STATUS_SUCCESS) {
+            return status;
+        }
+    }
+    return KINETIC_STATUS_SUCCESS;
+}
+
+KineticStatus KineticKeyScan_Execute(KineticConnection* const * connections,
+    int count, KineticKeyScan* const scan)
+{
+    assert(connections != NULL);
+    assert(scan != NULL);
+    const KineticKeyRange* range = &scan->range;
+    int partitions = (scan->partitions == 0) ? count : scan->partitions;
+    if (count <= 0 || partitions <= 0 || scan->callback == NULL ||
+        range->maxReturned <= 0 ||
+        range->startKey.bytesUsed == 0 || range->endKey.bytesUsed == 0) {
+        LOG0("Invalid key range scan specified!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+    if (partitions > KINETIC_KEY_SCAN_PARTITIONS_MAX) {
+        partitions = KINETIC_KEY_SCAN_PARTITIONS_MAX;
+    }
+
+    KineticStatus status = KINETIC_STATUS_MEMORY_ERROR;
+    KineticKeyRange* subRanges = (KineticKeyRange*)calloc(partitions, sizeof(KineticKeyRange));
+    KineticKeyIterator** iterators = (KineticKeyIterator**)calloc(partitions, sizeof(KineticKeyIterator*));
+    uint8_t* splitKeyData = (uint8_t*)malloc(partitions * KINETIC_MAX_KEY_LEN);
+    if (subRanges == NULL || iterators == NULL || splitKeyData == NULL) {
+        LOG0("Failed allocating key range scan!");
+    }
+    else {
+        partitions = KineticKeyScan_Split(range, partitions, subRanges, splitKeyData);
+        LOGF1("Scanning key range in %d partition(s) over %d session(s)", partitions, count);
+        status = KineticKeyScan_Run(scan, connections, count, subRanges, iterators, partitions);
+        for (int i = 0; i < partitions; i++) {
+            KineticKeyIterator_Close(iterators[i]);
+        }
+    }
+    free(splitKeyData);
+    free(iterators);
+    free(subRanges);
+    return status;
+}
@@ -0,0 +1,226 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_log_poller.h"
+#include "kinetic_operation.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+static void KineticLogPoller_Completed(KineticCompletionData* kinetic_data, void* client_data)
+{
+    KineticLogPoller* poller = (KineticLogPoller*)client_data;
+
+    // The staging log was populated by the operation callback, and is only
+    // touched by the GETLOG in flight, so publish it as the new snapshot
+    pthread_mutex_lock(&poller->mutex);
+    if (kinetic_data->status == KINETIC_STATUS_SUCCESS) {
+        poller->snapshot = poller->staging;
+        poller->hasSnapshot = true;
+    }
+    else {
+        LOGF1("Device log poll failed w/status: %s",
+            Kinetic_GetStatusDescription(kinetic_data->status));
+    }
+    poller->status = kinetic_data->status;
+    poller->operation = NULL;
+    pthread_cond_broadcast(&poller->cond);
+    pthread_mutex_unlock(&poller->mutex);
+}
+
+// Gives up on the GETLOG in flight, once no response has arrived within
+// KINETIC_PDU_RECEIVE_TIMEOUT_SECS of sending it (the poller mutex is held)
+static void KineticLogPoller_Timeout(KineticLogPoller* const poller)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (poller->operation == NULL ||
+        now.tv_sec < poller->sent.tv_sec + KINETIC_PDU_RECEIVE_TIMEOUT_SECS) {
+        return;
+    }
+
+    if (KineticOperation_Abandon(poller->operation)) {
+        LOG0("Timed out waiting for device log!");
+        poller->operation = NULL;
+        poller->status = KINETIC_STATUS_SOCKET_TIMEOUT;
+    }
+    else {
+        poller->sent = now;
+    }
+}
+
+static void KineticLogPoller_Build(KineticOperation* const operation, void* context)
+{
+    KineticLogPoller* poller = (KineticLogPoller*)context;
+    KineticOperation_BuildGetLog(operation, poller->types, &poller->staging);
+}
+
+// Issues a GETLOG, unless the in-flight window is full, since the poll
+// should never hold up (or be held up by) application requests
+static void KineticLogPoller_Request(KineticLogPoller* const poller)
+{
+    KineticCompletionClosure closure = {
+        .callback = KineticLogPoller_Completed,
+        .clientData = poller,
+    };
+    clock_gettime(CLOCK_MONOTONIC, &poller->sent);
+    KineticStatus status = KineticOperation_Submit(poller->connection, false,
+        KineticLogPoller_Build, poller, closure, &poller->mutex, &poller->operation);
+    if (status == KINETIC_STATUS_WOULD_BLOCK) {
+        LOG2("Skipping device log poll, since in-flight window is full");
+    }
+    else if (status != KINETIC_STATUS_SUCCESS) {
+        pthread_mutex_lock(&poller->mutex);
+        poller->status = status;
+        pthread_mutex_unlock(&poller->mutex);
+    }
+}
+
+static void* KineticLogPoller_Worker(void* arg)
+{
+    KineticLogPoller* poller = (KineticLogPoller*)arg;
+
+    // Poll immediately, so a snapshot is available soon after starting
+    pthread_mutex_lock(&poller->mutex);
+    do {
+        // Only a single GETLOG is ever in flight, so a slow device is
+        // polled less often, rather than being queued up behind
+        KineticLogPoller_Timeout(poller);
+        if (poller->operation == NULL) {
+            pthread_mutex_unlock(&poller->mutex);
+            KineticLogPoller_Request(poller);
+            pthread_mutex_lock(&poller->mutex);
+        }
+
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += poller->intervalMillis / 1000;
+        deadline.tv_nsec += (long)(poller->intervalMillis % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        while (poller->running &&
+            pthread_cond_timedwait(&poller->cond, &poller->mutex, &deadline) != ETIMEDOUT) {
+        }
+    } while (poller->running);
+    pthread_mutex_unlock(&poller->mutex);
+    return NULL;
+}
+
+KineticStatus KineticLogPoller_Start(KineticConnection* const connection,
+    int types, int intervalMillis)
+{
+    assert(connection != NULL);
+    if (intervalMillis == 0) {
+        intervalMillis = KINETIC_LOG_POLL_INTERVAL_MS;
+    }
+    if ((types & KINETIC_LOG_TYPE_ALL) == 0 || (types & ~KINETIC_LOG_TYPE_ALL) != 0 ||
+        intervalMillis < 0) {
+        LOG0("Invalid device log polling specified!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+    if (connection->logPoller != NULL) {
+        LOG0("Device log polling already started on connection!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    KineticLogPoller* poller = (KineticLogPoller*)calloc(1, sizeof(KineticLogPoller));
+    if (poller == NULL) {
+        LOG0("Failed allocating device log poller!");
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    poller->connection = connection;
+    poller->running = true;
+    poller->types = types;
+    poller->intervalMillis = intervalMillis;
+    poller->status = KINETIC_STATUS_NOT_ATTEMPTED;
+    pthread_mutex_init(&poller->mutex, NULL);
+    Kinetic_InitCondition(&poller->cond);
+
+    int pthreadStatus = pthread_create(&poller->thread, NULL, KineticLogPoller_Worker, poller);
+    if (pthreadStatus != 0) {
+        char errMsg[256];
+        Kinetic_GetErrnoDescription(pthreadStatus, errMsg, sizeof(errMsg));
+        LOGF0("Failed creating device log poller thread w/error: %s", errMsg);
+        pthread_cond_destroy(&poller->cond);
+        pthread_mutex_destroy(&poller->mutex);
+        free(poller);
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    connection->logPoller = poller;
+    return KINETIC_STATUS_SUCCESS;
+}
+
+KineticStatus KineticLogPoller_GetSnapshot(KineticConnection* const connection,
+    KineticDeviceLog* log)
+{
+    assert(connection != NULL);
+    assert(log != NULL);
+    KineticLogPoller* poller = connection->logPoller;
+    if (poller == NULL) {
+        LOG0("Device log polling not started on connection!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    // The most recent snapshot is reported even if later polls have failed,
+    // since device statistics remain useful for a while
+    pthread_mutex_lock(&poller->mutex);
+    KineticStatus status = poller->status;
+    if (poller->hasSnapshot) {
+        *log = poller->snapshot;
+        status = KINETIC_STATUS_SUCCESS;
+    }
+    pthread_mutex_unlock(&poller->mutex);
+    return status;
+}
+
+void KineticLogPoller_Stop(KineticConnection* const connection)
+{
+    assert(connection != NULL);
+    KineticLogPoller* poller = connection->logPoller;
+    if (poller == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&poller->mutex);
+    poller->running = false;
+    pthread_cond_broadcast(&poller->cond);
+    pthread_mutex_unlock(&poller->mutex);
+    pthread_join(poller->thread, NULL);
+
+    // A GETLOG still in flight references the poller, so must be retired
+    pthread_mutex_lock(&poller->mutex);
+    while (poller->operation != NULL) {
+        struct timespec deadline = poller->sent;
+        deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+        if (pthread_cond_timedwait(&poller->cond, &poller->mutex, &deadline) == ETIMEDOUT) {
+            KineticLogPoller_Timeout(poller);
+        }
+    }
+    pthread_mutex_unlock(&poller->mutex);
+
+    connection->logPoller = NULL;
+    pthread_cond_destroy(&poller->cond);
+    pthread_mutex_destroy(&poller->mutex);
+    free(poller);
+}
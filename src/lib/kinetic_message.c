@@ -140,3 +140,73 @@ void KineticMessage_ConfigureKeyRange(KineticMessage* const message,
     }
     message->command.body->range->has_reverse = range->reverse;
 }
+
+void KineticMessage_ConfigureGetLog(KineticMessage* const message, int types)
+{
+    assert(message != NULL);
+    assert(types != 0);
+
+    static const struct {
+        int flag;
+        KineticProto_Command_GetLog_Type type;
+    } logTypes[] = {
+        {KINETIC_LOG_TYPE_UTILIZATIONS, KINETIC_PROTO_COMMAND_GET_LOG_TYPE_UTILIZATIONS},
+        {KINETIC_LOG_TYPE_TEMPERATURES, KINETIC_PROTO_COMMAND_GET_LOG_TYPE_TEMPERATURES},
+        {KINETIC_LOG_TYPE_CAPACITIES, KINETIC_PROTO_COMMAND_GET_LOG_TYPE_CAPACITIES},
+        {KINETIC_LOG_TYPE_STATISTICS, KINETIC_PROTO_COMMAND_GET_LOG_TYPE_STATISTICS},
+        {KINETIC_LOG_TYPE_LIMITS, KINETIC_PROTO_COMMAND_GET_LOG_TYPE_LIMITS},
+    };
+
+    // Enable command body and getLog fields by pointing at
+    // pre-allocated elements in message
+    message->command.body = &message->body;
+    message->command.body->getLog = &message->getLog;
+
+    // Populate only the requested log types, so the device skips the rest
+    size_t count = 0;
+    for (size_t i = 0; i < sizeof(logTypes) / sizeof(logTypes[0]); i++) {
+        if (types & logTypes[i].flag) {
+            message->getLogTypes[count++] = logTypes[i].type;
+        }
+    }
+    message->command.body->getLog->n_types = count;
+    message->command.body->getLog->types = message->getLogTypes;
+}
+
+void KineticMessage_ConfigureP2POperation(KineticMessage* const message,
+    const KineticP2P_Operation* p2pOp,
+    KineticProto_Command_P2POperation_Operation** operations)
+{
+    assert(message != NULL);
+    assert(p2pOp != NULL);
+    assert(p2pOp->numOperations > 0);
+    assert(p2pOp->operations != NULL);
+    assert(operations != NULL);
+
+    // Enable command body and p2pOperation fields by pointing at
+    // pre-allocated elements in message
+    message->command.body = &message->body;
+    message->command.body->p2pOperation = &message->p2pOperation;
+
+    // Peer device the entries are pushed to
+    message->p2pPeer.hostname = (char*)p2pOp->peer.hostname;
+    message->p2pPeer.has_port = true;
+    message->p2pPeer.port = p2pOp->peer.port;
+    message->p2pPeer.has_tls = true;
+    message->p2pPeer.tls = p2pOp->peer.tls;
+    message->p2pOperation.peer = &message->p2pPeer;
+
+    // Populate the caller-supplied sub-operations, one per entry
+    for (size_t i = 0; i < p2pOp->numOperations; i++) {
+        const KineticP2P_OperationData* data = &p2pOp->operations[i];
+        KineticProto_Command_P2POperation_Operation* op = operations[i];
+        KineticProto_command_p2_poperation_operation__init(op);
+        CONFIG_FIELD_BYTE_BUFFER(key,     *op, data);
+        CONFIG_FIELD_BYTE_BUFFER(version, *op, data);
+        CONFIG_FIELD_BYTE_BUFFER(newKey,  *op, data);
+        op->has_force = data->force;
+        op->force = data->force;
+    }
+    message->p2pOperation.n_operation = p2pOp->numOperations;
+    message->p2pOperation.operation = operations;
+}
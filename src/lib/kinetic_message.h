@@ -29,5 +29,9 @@ void KineticMessage_ConfigureKeyValue(KineticMessage* const message,
                                       const KineticEntry* entry);
 void KineticMessage_ConfigureKeyRange(KineticMessage* const message,
                                       const KineticKeyRange* range);
+void KineticMessage_ConfigureGetLog(KineticMessage* const message, int types);
+void KineticMessage_ConfigureP2POperation(KineticMessage* const message,
+    const KineticP2P_Operation* p2pOp,
+    KineticProto_Command_P2POperation_Operation** operations);
 
 #endif // _KINETIC_MESSAGE_H
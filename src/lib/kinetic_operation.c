@@ -25,43 +25,68 @@
 #include "kinetic_nbo.h"
 #include "kinetic_socket.h"
 #include "kinetic_allocator.h"
+#include "kinetic_arena.h"
+#include "kinetic_entry.h"
 #include "kinetic_logger.h"
 #include <stdlib.h>
-#include <sys/time.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
 
 static void KineticOperation_ValidateOperation(KineticOperation* operation);
 
-KineticStatus KineticOperation_SendRequest(KineticOperation* const operation)
+static bool KineticOperation_ReservePackBuffer(KineticConnection* const connection, size_t len)
+{
+    if (connection->packBufferSize >= len) {
+        return true;
+    }
+    uint8_t* buffer = (uint8_t*)realloc(connection->packBuffer, len);
+    if (buffer == NULL) {
+        LOG0("Failed allocating memory for packed protocol buffer!");
+        return false;
+    }
+    connection->packBuffer = buffer;
+    connection->packBufferSize = len;
+    return true;
+}
+
+// Packs the request protobuf (w/HMAC) into the connection pack buffer at
+// *used, and advances *used past it (sendMutex must be held)
+static KineticStatus KineticOperation_PackRequest(KineticOperation* const operation,
+    size_t* used, size_t* offset, size_t* length)
 {
     assert(operation != NULL);
     assert(operation->connection != NULL);
     assert(operation->request != NULL);
     assert(operation->request->connection == operation->connection);
-    LOGF1("\nSending PDU via fd=%d", operation->connection->socket);
-    KineticStatus status = KINETIC_STATUS_INVALID;
+    KineticConnection* connection = operation->connection;
     KineticPDU* request = operation->request;
-    request->proto = &operation->request->protoData.message.message;
+    KineticProto_Message* msg = &request->protoData.message.message;
+    request->proto = msg;
+    const size_t start = *used;
 
-    // Pack the command, if available
+    // Pack the command, if available, into the pack buffer
+    size_t commandLen = 0;
     if (request->protoData.message.has_command) {
-        size_t expectedLen = KineticProto_command__get_packed_size(&request->protoData.message.command);
-        request->protoData.message.message.commandBytes.data = (uint8_t*)malloc(expectedLen);
-        assert(request->protoData.message.message.commandBytes.data != NULL);
+        commandLen = KineticProto_command__get_packed_size(&request->protoData.message.command);
+        if (!KineticOperation_ReservePackBuffer(connection, start + commandLen)) {
+            return KINETIC_STATUS_MEMORY_ERROR;
+        }
         size_t packedLen = KineticProto_command__pack(
-            &request->protoData.message.command,
-            request->protoData.message.message.commandBytes.data);
-        assert(packedLen == expectedLen);
-        request->protoData.message.message.commandBytes.len = packedLen;
-        request->protoData.message.message.has_commandBytes = true;
+            &request->protoData.message.command, &connection->packBuffer[start]);
+        assert(packedLen == commandLen);
+        msg->commandBytes.data = &connection->packBuffer[start];
+        msg->commandBytes.len = packedLen;
+        msg->has_commandBytes = true;
         KineticLogger_LogByteArray(2, "commandBytes", (ByteArray){
-            .data = request->protoData.message.message.commandBytes.data,
-            .len = request->protoData.message.message.commandBytes.len,
+            .data = msg->commandBytes.data,
+            .len = msg->commandBytes.len,
         });
     }
 
     // Populate the HMAC for the protobuf
     KineticHMAC_Init(&request->hmac, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
-    KineticHMAC_Populate(&request->hmac, request->proto, request->connection->session.hmacKey);
+    KineticHMAC_Populate(&request->hmac, request->proto, &request->connection->hmacKey);
 
     // Configure PDU header length fields
     request->header.versionPrefix = 'F';
@@ -80,37 +105,176 @@ KineticStatus KineticOperation_SendRequest(KineticOperation* const operation)
     request->headerNBO.protobufLength = KineticNBO_FromHostU32(request->header.protobufLength);
     request->headerNBO.valueLength = KineticNBO_FromHostU32(request->header.valueLength);
 
-    // Pack and send the PDU header
-    ByteBuffer hdr = ByteBuffer_Create(&request->headerNBO, sizeof(KineticPDUHeader), sizeof(KineticPDUHeader));
-    status = KineticSocket_Write(request->connection->socket, &hdr);
-    if (status != KINETIC_STATUS_SUCCESS) {
-        LOG0("Failed to send PDU header!");
-        return status;
+    // Pack the message just after the command bytes it embeds
+    if (!KineticOperation_ReservePackBuffer(connection,
+        start + commandLen + request->header.protobufLength)) {
+        msg->commandBytes = (ProtobufCBinaryData) {.data = NULL, .len = 0};
+        msg->has_commandBytes = false;
+        return KINETIC_STATUS_MEMORY_ERROR;
     }
-
-    // Send the protobuf message
+    if (msg->has_commandBytes) {
+        msg->commandBytes.data = &connection->packBuffer[start];
+    }
+    size_t packedLen = KineticProto_Message__pack(msg, &connection->packBuffer[start + commandLen]);
+    assert(packedLen == request->header.protobufLength);
     LOG1("Sending PDU Protobuf:");
     KineticLogger_LogProtobuf(2, request->proto);
-    status = KineticSocket_WriteProtobuf(request->connection->socket, request);
-    if (status != KINETIC_STATUS_SUCCESS) {
-        LOG0("Failed to send PDU protobuf message!");
-        return status;
-    }
 
-    // Send the value/payload, if specified
-    if (operation->valueEnabled && operation->sendValue) {
-        LOGF1("Sending PDU Value Payload (%zu bytes)", operation->entry->value.bytesUsed);
-        status = KineticSocket_Write(request->connection->socket, &operation->entry->value);
+    // Command bytes referenced the pack buffer, which may move or be reused
+    msg->commandBytes = (ProtobufCBinaryData) {.data = NULL, .len = 0};
+    msg->has_commandBytes = false;
+
+    *offset = start + commandLen;
+    *length = packedLen;
+    *used = start + commandLen + packedLen;
+    return KINETIC_STATUS_SUCCESS;
+}
+
+KineticStatus KineticOperation_SendRequest(KineticOperation* const operation)
+{
+    KineticOperation* operations[] = {operation};
+    return KineticOperation_SendRequests(operations, 1);
+}
+
+KineticStatus KineticOperation_SendRequests(KineticOperation** const operations, int count)
+{
+    assert(operations != NULL);
+    assert(count > 0 && count <= KINETIC_BATCH_OPERATIONS_MAX);
+    KineticConnection* connection = operations[0]->connection;
+    assert(connection != NULL);
+    LOGF1("\nSending %d PDU(s) via fd=%d", count, connection->socket);
+    KineticStatus status = KINETIC_STATUS_INVALID;
+
+    // The connection pack buffer is shared, and the PDUs must go out as a unit
+    pthread_mutex_lock(&connection->sendMutex);
+
+    // Pack the requests back-to-back (offsets are used, since it may move)
+    size_t offsets[KINETIC_BATCH_OPERATIONS_MAX];
+    size_t lengths[KINETIC_BATCH_OPERATIONS_MAX];
+    size_t used = 0;
+    for (int i = 0; i < count; i++) {
+        assert(operations[i]->connection == connection);
+
+        // Sequence in send order, under the send mutex, before the HMAC is
+        // calculated, so that concurrent requests never share a sequence
+        operations[i]->request->command->header->sequence = connection->sequence++;
+        status = KineticOperation_PackRequest(operations[i], &used, &offsets[i], &lengths[i]);
         if (status != KINETIC_STATUS_SUCCESS) {
-            LOG0("Failed to send PDU value payload!");
+            pthread_mutex_unlock(&connection->sendMutex);
             return status;
         }
     }
 
+    // Gather the header, protobuf and value/payload, if specified, of each
+    ByteBuffer buffers[KINETIC_SOCKET_IOV_MAX];
+    int bufferCount = 0;
+    for (int i = 0; i < count; i++) {
+        KineticOperation* operation = operations[i];
+        buffers[bufferCount++] = ByteBuffer_Create(&operation->request->headerNBO,
+            sizeof(KineticPDUHeader), sizeof(KineticPDUHeader));
+        buffers[bufferCount++] = ByteBuffer_Create(&connection->packBuffer[offsets[i]],
+            lengths[i], lengths[i]);
+        if (operation->valueEnabled && operation->sendValue) {
+            LOGF1("Sending PDU Value Payload (%zu bytes)", operation->entry->value.bytesUsed);
+            buffers[bufferCount++] = operation->entry->value;
+        }
+
+        // Register as in-flight before sending, since the response may arrive
+        // before this call returns
+        KineticConnection_AddPendingOperation(connection, operation);
+    }
+
+    // Send all of the PDUs at once
+    status = KineticSocket_WriteV(connection->socket, buffers, bufferCount);
+    pthread_mutex_unlock(&connection->sendMutex);
+
+    if (status != KINETIC_STATUS_SUCCESS) {
+        LOG0("Failed to send PDU!");
+
+        // Unregister the requests, unless a response was already claimed
+        for (int i = 0; i < count; i++) {
+            if (!KineticConnection_RemovePendingOperation(connection, operations[i], false)) {
+                operations[i] = NULL;
+            }
+        }
+        return status;
+    }
+
     LOG2("PDU sent successfully!");
     return KINETIC_STATUS_SUCCESS;
 }
 
+// Submits an asynchronous request within the connection window, admitting it
+// only if there is room unless asked to wait. The operation is stored in
+// *submitted under the mutex before it is sent, since the response may arrive
+// first, and the closure clears it upon completion. It is cleared here if the
+// request could not be sent, and the failure returned.
+KineticStatus KineticOperation_Submit(KineticConnection* const connection, bool wait,
+                                      KineticOperationBuilder build, void* context,
+                                      KineticCompletionClosure closure,
+                                      pthread_mutex_t* const mutex,
+                                      KineticOperation** const submitted)
+{
+    assert(connection != NULL);
+    assert(build != NULL);
+    assert(mutex != NULL);
+    assert(submitted != NULL);
+
+    KineticStatus status = wait ?
+        KineticConnection_AcquireWindow(connection) :
+        KineticConnection_TryAcquireWindow(connection);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        return status;
+    }
+    KineticOperation* operation = KineticAllocator_NewOperation(connection);
+    if (operation == NULL || operation->request == NULL) {
+        status = KINETIC_STATUS_MEMORY_ERROR;
+        if (operation != NULL) {
+            status = KINETIC_STATUS_NO_PDUS_AVAVILABLE;
+            KineticAllocator_FreeOperation(connection, operation);
+        }
+        KineticConnection_ReleaseWindow(connection);
+        return status;
+    }
+    build(operation, context);
+    operation->closure = closure;
+
+    pthread_mutex_lock(mutex);
+    *submitted = operation;
+    pthread_mutex_unlock(mutex);
+
+    KineticOperation* operations[] = {operation};
+    status = KineticOperation_SendRequests(operations, 1);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        if (operations[0] == NULL) {
+            // The response was claimed regardless, so the closure reports it
+            return KINETIC_STATUS_SUCCESS;
+        }
+        pthread_mutex_lock(mutex);
+        *submitted = NULL;
+        pthread_mutex_unlock(mutex);
+        KineticAllocator_FreeOperation(connection, operation);
+        KineticConnection_ReleaseWindow(connection);
+    }
+    return status;
+}
+
+// Gives up on a submitted request, releasing the operation and its window
+// slot. Returns false if the response was already claimed by the receiver,
+// which is still using the operation, in which case the closure must be
+// awaited instead.
+bool KineticOperation_Abandon(KineticOperation* const operation)
+{
+    assert(operation != NULL);
+    KineticConnection* connection = operation->connection;
+    if (!KineticConnection_RemovePendingOperation(connection, operation, true)) {
+        return false;
+    }
+    KineticAllocator_FreeOperation(connection, operation);
+    KineticConnection_ReleaseWindow(connection);
+    return true;
+}
+
 KineticStatus KineticOperation_GetStatus(const KineticOperation* const operation)
 {
     KineticStatus status = KINETIC_STATUS_INVALID;
@@ -133,30 +297,16 @@ KineticOperation* KineticOperation_AssociateResponseWithOperation(KineticPDU* re
     }
 
     const int64_t targetSequence = response->command->header->ackSequence;
-    KineticOperation* operation = KineticAllocator_GetFirstOperation(response->connection);
+    KineticOperation* operation = KineticConnection_TakePendingOperation(
+        response->connection, targetSequence);
     if (operation == NULL) {
-        LOG2("ERROR: No pending operations found!");
+        LOGF2("ERROR: No pending operation found w/ sequence=%lld!", targetSequence);
         return NULL;
     }
 
-    while (operation != NULL) {
-        LOGF2("Comparing received PDU w/ ackSequence=%lld with request with sequence=%lld",
-            targetSequence, operation->request->command->header->sequence);
-        if (operation->request != NULL &&
-            operation->request->type == KINETIC_PDU_TYPE_REQUEST &&
-            operation->request->command != NULL &&
-            operation->request->command->header != NULL &&
-            operation->request->command->header->has_sequence && 
-            operation->request->command->header->sequence == targetSequence)
-        {
-            operation->receiveComplete = false;
-            operation->response = response;
-            return operation;
-        }
-        operation = KineticAllocator_GetNextOperation(response->connection, operation);
-    }
-
-    return NULL;
+    operation->receiveComplete = false;
+    operation->response = response;
+    return operation;
 }
 
 KineticStatus KineticOperation_ReceiveAsync(KineticOperation* const operation)
@@ -178,23 +328,27 @@ KineticStatus KineticOperation_ReceiveAsync(KineticOperation* const operation)
     // Wait for response if no callback supplied (synchronous)
     if (operation->closure.callback == NULL) { 
         bool timeout = false;
-        struct timeval tv;
-        time_t startTime, currentTime;
+        struct timespec deadline;
         status = KINETIC_STATUS_SOCKET_TIMEOUT;
 
-        // Wait for matching response to arrive
-        gettimeofday(&tv, NULL);
-        startTime = tv.tv_sec;
+        // Block until the worker signals the matching response has arrived
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+        pthread_mutex_lock(&operation->receiveMutex);
         while(!operation->receiveComplete && !timeout) {
-            gettimeofday(&tv, NULL);
-            currentTime = tv.tv_sec;
-            if ((currentTime - startTime) >= KINETIC_PDU_RECEIVE_TIMEOUT_SECS) {
-                timeout = true;
-            }
-            else {
-                sleep(0);
+            int waitStatus = pthread_cond_timedwait(&operation->receiveCond,
+                &operation->receiveMutex, &deadline);
+            if (waitStatus == ETIMEDOUT && !operation->receiveComplete) {
+                // If the response was already claimed by the receiver, it is
+                // still using the operation, so wait for it to finish
+                timeout = KineticConnection_RemovePendingOperation(
+                    operation->connection, operation, true);
+                if (!timeout) {
+                    deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+                }
             }
         }
+        pthread_mutex_unlock(&operation->receiveMutex);
 
         if (timeout) {
             LOG0("Timed out waiting to received response PDU!");
@@ -209,7 +363,9 @@ KineticStatus KineticOperation_ReceiveAsync(KineticOperation* const operation)
             status = KINETIC_STATUS_CONNECTION_ERROR;
         }
 
-        KineticAllocator_FreeOperation(operation->connection, operation);
+        KineticConnection* connection = operation->connection;
+        KineticAllocator_FreeOperation(connection, operation);
+        KineticConnection_ReleaseWindow(connection);
     }
 
     return status;
@@ -217,6 +373,15 @@ KineticStatus KineticOperation_ReceiveAsync(KineticOperation* const operation)
 
 
 
+void KineticOperation_Complete(KineticOperation* const operation)
+{
+    assert(operation != NULL);
+    pthread_mutex_lock(&operation->receiveMutex);
+    operation->receiveComplete = true;
+    pthread_cond_signal(&operation->receiveCond);
+    pthread_mutex_unlock(&operation->receiveMutex);
+}
+
 KineticStatus KineticOperation_NoopCallback(KineticOperation* operation)
 {
     assert(operation != NULL);
@@ -229,7 +394,6 @@ KineticStatus KineticOperation_NoopCallback(KineticOperation* operation)
 void KineticOperation_BuildNoop(KineticOperation* const operation)
 {
     KineticOperation_ValidateOperation(operation);
-    KineticConnection_IncrementSequence(operation->connection);
     operation->request->protoData.message.command.header->messageType = KINETIC_PROTO_COMMAND_MESSAGE_TYPE_NOOP;
     operation->request->protoData.message.command.header->has_messageType = true;
     operation->valueEnabled = false;
@@ -246,22 +410,7 @@ KineticStatus KineticOperation_PutCallback(KineticOperation* operation)
     assert(operation->entry != NULL);
 
     // Propagate newVersion to dbVersion in metadata, if newVersion specified
-    KineticEntry* entry = operation->entry;
-    if (entry->newVersion.array.data != NULL && entry->newVersion.array.len > 0) {
-        // If both buffers supplied, copy newVersion into dbVersion, and clear newVersion
-        if (entry->dbVersion.array.data != NULL && entry->dbVersion.array.len > 0) {
-            ByteBuffer_Reset(&entry->dbVersion);
-            ByteBuffer_Append(&entry->dbVersion, entry->newVersion.array.data, entry->newVersion.bytesUsed);
-            ByteBuffer_Reset(&entry->newVersion);
-        }
-
-        // If only newVersion buffer supplied, move newVersion buffer into dbVersion,
-        // and set newVersion to NULL buffer
-        else {
-            entry->dbVersion = entry->newVersion;
-            entry->newVersion = BYTE_BUFFER_NONE;
-        }
-    }
+    KineticEntry_PromoteVersion(operation->entry);
     return KINETIC_STATUS_SUCCESS;
 }
 
@@ -269,7 +418,6 @@ void KineticOperation_BuildPut(KineticOperation* const operation,
                                KineticEntry* const entry)
 {
     KineticOperation_ValidateOperation(operation);
-    KineticConnection_IncrementSequence(operation->connection);
 
     operation->request->protoData.message.command.header->messageType = KINETIC_PROTO_COMMAND_MESSAGE_TYPE_PUT;
     operation->request->protoData.message.command.header->has_messageType = true;
@@ -303,13 +451,14 @@ KineticStatus KineticOperation_GetCallback(KineticOperation* operation)
     return KINETIC_STATUS_SUCCESS;
 }
 
-void KineticOperation_BuildGet(KineticOperation* const operation,
-                               KineticEntry* const entry)
+// Builds a GET, GETNEXT or GETPREVIOUS request, which differ only in whether
+// the key retrieved is the specified key, or the one following/preceding it
+static void KineticOperation_BuildGetRequest(KineticOperation* const operation,
+    KineticEntry* const entry, KineticProto_Command_MessageType messageType)
 {
     KineticOperation_ValidateOperation(operation);
-    KineticConnection_IncrementSequence(operation->connection);
 
-    operation->request->protoData.message.command.header->messageType = KINETIC_PROTO_COMMAND_MESSAGE_TYPE_GET;
+    operation->request->protoData.message.command.header->messageType = messageType;
     operation->request->protoData.message.command.header->has_messageType = true;
     operation->entry = entry;
 
@@ -324,6 +473,27 @@ void KineticOperation_BuildGet(KineticOperation* const operation,
     operation->callback = &KineticOperation_GetCallback;
 }
 
+void KineticOperation_BuildGet(KineticOperation* const operation,
+                               KineticEntry* const entry)
+{
+    KineticOperation_BuildGetRequest(operation, entry,
+        KINETIC_PROTO_COMMAND_MESSAGE_TYPE_GET);
+}
+
+void KineticOperation_BuildGetNext(KineticOperation* const operation,
+                                   KineticEntry* const entry)
+{
+    KineticOperation_BuildGetRequest(operation, entry,
+        KINETIC_PROTO_COMMAND_MESSAGE_TYPE_GETNEXT);
+}
+
+void KineticOperation_BuildGetPrevious(KineticOperation* const operation,
+                                       KineticEntry* const entry)
+{
+    KineticOperation_BuildGetRequest(operation, entry,
+        KINETIC_PROTO_COMMAND_MESSAGE_TYPE_GETPREVIOUS);
+}
+
 KineticStatus KineticOperation_DeleteCallback(KineticOperation* operation)
 {
     assert(operation != NULL);
@@ -338,7 +508,6 @@ void KineticOperation_BuildDelete(KineticOperation* const operation,
                                   KineticEntry* const entry)
 {
     KineticOperation_ValidateOperation(operation);
-    KineticConnection_IncrementSequence(operation->connection);
 
     operation->request->protoData.message.command.header->messageType = KINETIC_PROTO_COMMAND_MESSAGE_TYPE_DELETE;
     operation->request->protoData.message.command.header->has_messageType = true;
@@ -355,6 +524,27 @@ void KineticOperation_BuildDelete(KineticOperation* const operation,
     operation->callback = &KineticOperation_DeleteCallback;
 }
 
+KineticStatus KineticOperation_FlushCallback(KineticOperation* operation)
+{
+    assert(operation != NULL);
+    assert(operation->connection != NULL);
+    LOGF3("FLUSHALLDATA callback w/ operation (0x%0llX) on connection (0x%0llX)",
+        operation, operation->connection);
+    return KINETIC_STATUS_SUCCESS;
+}
+
+void KineticOperation_BuildFlush(KineticOperation* const operation)
+{
+    KineticOperation_ValidateOperation(operation);
+
+    operation->request->protoData.message.command.header->messageType = KINETIC_PROTO_COMMAND_MESSAGE_TYPE_FLUSHALLDATA;
+    operation->request->protoData.message.command.header->has_messageType = true;
+
+    operation->valueEnabled = false;
+    operation->sendValue = false;
+    operation->callback = &KineticOperation_FlushCallback;
+}
+
 KineticStatus KineticOperation_GetKeyRangeCallback(KineticOperation* operation)
 {
     assert(operation != NULL);
@@ -380,7 +570,6 @@ void KineticOperation_BuildGetKeyRange(KineticOperation* const operation,
     assert(operation != NULL);
     assert(operation->connection != NULL);
     KineticOperation_ValidateOperation(operation);
-    KineticConnection_IncrementSequence(operation->connection);
     assert(range != NULL);
     assert(buffers != NULL);
 
@@ -395,6 +584,99 @@ void KineticOperation_BuildGetKeyRange(KineticOperation* const operation,
     operation->callback = &KineticOperation_GetKeyRangeCallback;
 }
 
+KineticStatus KineticOperation_GetLogCallback(KineticOperation* operation)
+{
+    assert(operation != NULL);
+    assert(operation->connection != NULL);
+    assert(operation->deviceLog != NULL);
+    LOGF3("GETLOG callback w/ operation (0x%0llX) on connection (0x%0llX)",
+        operation, operation->connection);
+
+    // Decode the device log straight into the caller's structure, so the
+    // protobuf response can be released with the PDU
+    Copy_KineticProto_Command_GetLog_to_KineticDeviceLog(
+        KineticPDU_GetLog(operation->response), operation->deviceLog);
+    return KINETIC_STATUS_SUCCESS;
+}
+
+void KineticOperation_BuildGetLog(KineticOperation* const operation,
+    int types, KineticDeviceLog* log)
+{
+    assert(operation != NULL);
+    assert(operation->connection != NULL);
+    KineticOperation_ValidateOperation(operation);
+    assert(types != 0);
+    assert(log != NULL);
+
+    operation->request->command->header->messageType = KINETIC_PROTO_COMMAND_MESSAGE_TYPE_GETLOG;
+    operation->request->command->header->has_messageType = true;
+
+    KineticMessage_ConfigureGetLog(&operation->request->protoData.message, types);
+
+    operation->valueEnabled = false;
+    operation->sendValue = false;
+    operation->deviceLog = log;
+    operation->callback = &KineticOperation_GetLogCallback;
+}
+
+KineticStatus KineticOperation_P2POperationCallback(KineticOperation* operation)
+{
+    assert(operation != NULL);
+    assert(operation->connection != NULL);
+    assert(operation->p2pOp != NULL);
+    LOGF3("PEER2PEERPUSH callback w/ operation (0x%0llX) on connection (0x%0llX)",
+        operation, operation->connection);
+
+    // Report the outcome for each entry, even if some failed, in which case
+    // the device reports the request as a whole as having failed
+    KineticStatus status = KineticPDU_GetStatus(operation->response);
+    bool allSucceeded = Copy_KineticProto_Command_P2POperation_to_KineticP2P_Operation(
+        KineticPDU_GetP2POperation(operation->response), operation->p2pOp);
+    if (status == KINETIC_STATUS_SUCCESS && !allSucceeded) {
+        status = KINETIC_STATUS_OPERATION_FAILED;
+    }
+    return status;
+}
+
+KineticStatus KineticOperation_BuildP2POperation(KineticOperation* const operation,
+    KineticP2P_Operation* const p2pOp)
+{
+    KineticOperation_ValidateOperation(operation);
+    assert(p2pOp != NULL);
+    assert(p2pOp->numOperations > 0);
+    assert(p2pOp->operations != NULL);
+
+    // The number of sub-operations varies, so they are built in the arena of
+    // the request PDU, which is reset as the PDU is freed
+    size_t count = p2pOp->numOperations;
+    KineticArena* arena = &operation->request->arena;
+    KineticProto_Command_P2POperation_Operation** operations =
+        KineticArena_Alloc(arena, count * sizeof(*operations));
+    KineticProto_Command_P2POperation_Operation* storage =
+        KineticArena_Alloc(arena, count * sizeof(*storage));
+    if (operations == NULL || storage == NULL) {
+        LOG0("Failed allocating peer-to-peer operations!");
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    for (size_t i = 0; i < count; i++) {
+        operations[i] = &storage[i];
+        p2pOp->operations[i].resultStatus = KINETIC_STATUS_NOT_ATTEMPTED;
+    }
+
+    operation->request->protoData.message.command.header->messageType = KINETIC_PROTO_COMMAND_MESSAGE_TYPE_PEER2PEERPUSH;
+    operation->request->protoData.message.command.header->has_messageType = true;
+
+    KineticMessage_ConfigureP2POperation(&operation->request->protoData.message,
+        p2pOp, operations);
+
+    operation->valueEnabled = false;
+    operation->sendValue = false;
+    operation->p2pOp = p2pOp;
+    operation->callback = &KineticOperation_P2POperationCallback;
+    operation->callbackOnFailure = true;
+    return KINETIC_STATUS_SUCCESS;
+}
+
 
 static void KineticOperation_ValidateOperation(KineticOperation* operation)
 {
@@ -24,7 +24,19 @@
 #include "kinetic_types_internal.h"
 
 KineticStatus KineticOperation_SendRequest(KineticOperation* const operation);
+KineticStatus KineticOperation_SendRequests(KineticOperation** const operations, int count);
+
+/** Builds the request of an operation being submitted, from the context supplied */
+typedef void (*KineticOperationBuilder)(KineticOperation* const operation, void* context);
+
+KineticStatus KineticOperation_Submit(KineticConnection* const connection, bool wait,
+                                      KineticOperationBuilder build, void* context,
+                                      KineticCompletionClosure closure,
+                                      pthread_mutex_t* const mutex,
+                                      KineticOperation** const submitted);
+bool KineticOperation_Abandon(KineticOperation* const operation);
 KineticStatus KineticOperation_ReceiveAsync(KineticOperation* const operation);
+void KineticOperation_Complete(KineticOperation* const operation);
 KineticOperation* KineticOperation_AssociateResponseWithOperation(KineticPDU* response);
 
 KineticStatus KineticOperation_GetStatus(const KineticOperation* const operation);
@@ -34,10 +46,19 @@ void KineticOperation_BuildPut(KineticOperation* const operation,
                                KineticEntry* const entry);
 void KineticOperation_BuildGet(KineticOperation* const operation,
                                KineticEntry* const entry);
+void KineticOperation_BuildGetNext(KineticOperation* const operation,
+                                   KineticEntry* const entry);
+void KineticOperation_BuildGetPrevious(KineticOperation* const operation,
+                                       KineticEntry* const entry);
 void KineticOperation_BuildDelete(KineticOperation* const operation,
                                   KineticEntry* const entry);
+void KineticOperation_BuildFlush(KineticOperation* const operation);
 
 void KineticOperation_BuildGetKeyRange(KineticOperation* const operation,
                                KineticKeyRange* range, ByteBufferArray* buffers);
+void KineticOperation_BuildGetLog(KineticOperation* const operation,
+                                  int types, KineticDeviceLog* log);
+KineticStatus KineticOperation_BuildP2POperation(KineticOperation* const operation,
+                                                 KineticP2P_Operation* const p2pOp);
 
 #endif // _KINETIC_OPERATION_H
@@ -23,6 +23,7 @@
 #include "kinetic_connection.h"
 #include "kinetic_socket.h"
 #include "kinetic_hmac.h"
+#include "kinetic_arena.h"
 #include "kinetic_logger.h"
 #include "kinetic_proto.h"
 
@@ -47,7 +48,8 @@ KineticStatus KineticPDU_ReceiveMain(KineticPDU* const response)
     // Receive the PDU header
     ByteBuffer rawHeader =
         ByteBuffer_Create(&response->headerNBO, sizeof(KineticPDUHeader), 0);
-    status = KineticSocket_Read(fd, &rawHeader, rawHeader.array.len);
+    status = KineticSocket_ReadBuffered(fd, &response->connection->readBuffer,
+        &rawHeader, rawHeader.array.len);
     if (status != KINETIC_STATUS_SUCCESS) {
         LOG0("Failed to receive PDU header!");
         return status;
@@ -64,7 +66,7 @@ KineticStatus KineticPDU_ReceiveMain(KineticPDU* const response)
     }
 
     // Receive the protobuf message
-    status = KineticSocket_ReadProtobuf(fd, response);
+    status = KineticSocket_ReadProtobufBuffered(fd, &response->connection->readBuffer, response);
     if (status != KINETIC_STATUS_SUCCESS) {
         LOG0("Failed to receive PDU protobuf message!");
         return status;
@@ -77,7 +79,7 @@ KineticStatus KineticPDU_ReceiveMain(KineticPDU* const response)
     // Validate the HMAC for the recevied protobuf message
     if (response->proto->authType == KINETIC_PROTO_MESSAGE_AUTH_TYPE_HMACAUTH) {
         if(!KineticHMAC_Validate(
-          response->proto, response->connection->session.hmacKey)) {
+          response->proto, &response->connection->hmacKey)) {
             LOG0("Received PDU protobuf message has invalid HMAC!");
             msg->has_command = true;
             msg->command.status = &msg->status;
@@ -101,8 +103,9 @@ KineticStatus KineticPDU_ReceiveMain(KineticPDU* const response)
     if (pMsg->has_commandBytes &&
       pMsg->commandBytes.data != NULL &&
       pMsg->commandBytes.len > 0) {
+        ProtobufCAllocator allocator = KineticArena_GetAllocator(&response->arena);
         response->command = KineticProto_command__unpack(
-            NULL,
+            &allocator,
             pMsg->commandBytes.len,
             pMsg->commandBytes.data);
     }
@@ -114,16 +117,19 @@ KineticStatus KineticPDU_ReceiveMain(KineticPDU* const response)
     return status;
 }
 
-KineticStatus KineticPDU_ReceiveValue(int socket_desc, ByteBuffer* value, size_t value_length)
+KineticStatus KineticPDU_ReceiveValue(KineticConnection* const connection,
+    ByteBuffer* value, size_t value_length)
 {
-    assert(socket_desc >= 0);
+    assert(connection != NULL);
+    assert(connection->socket >= 0);
     assert(value != NULL);
     assert(value->array.data != NULL);
 
     // Receive value payload
     LOGF1("Receiving value payload (%lld bytes)...", value_length);
     ByteBuffer_Reset(value);
-    KineticStatus status = KineticSocket_Read(socket_desc, value, value_length);
+    KineticStatus status = KineticSocket_ReadBuffered(connection->socket,
+        &connection->readBuffer, value, value_length);
     if (status != KINETIC_STATUS_SUCCESS) {
         LOG0("Failed to receive PDU value payload!");
         return status;
@@ -180,3 +186,29 @@ KineticProto_Command_Range* KineticPDU_GetKeyRange(KineticPDU* pdu)
     }
     return range;
 }
+
+KineticProto_Command_GetLog* KineticPDU_GetLog(KineticPDU* pdu)
+{
+    KineticProto_Command_GetLog* getLog = NULL;
+    if (pdu != NULL &&
+        pdu->proto != NULL &&
+        pdu->command != NULL &&
+        pdu->command->body != NULL)
+    {
+        getLog = pdu->command->body->getLog;
+    }
+    return getLog;
+}
+
+KineticProto_Command_P2POperation* KineticPDU_GetP2POperation(KineticPDU* pdu)
+{
+    KineticProto_Command_P2POperation* p2pOperation = NULL;
+    if (pdu != NULL &&
+        pdu->proto != NULL &&
+        pdu->command != NULL &&
+        pdu->command->body != NULL)
+    {
+        p2pOperation = pdu->command->body->p2pOperation;
+    }
+    return p2pOperation;
+}
@@ -26,10 +26,13 @@
 void KineticPDU_Init(KineticPDU* const pdu, KineticConnection* const connection);
 KineticStatus KineticPDU_Send(KineticPDU* request);
 KineticStatus KineticPDU_ReceiveMain(KineticPDU* response);
-KineticStatus KineticPDU_ReceiveValue(int socket_desc, ByteBuffer* value, size_t value_length);
+KineticStatus KineticPDU_ReceiveValue(KineticConnection* const connection,
+    ByteBuffer* value, size_t value_length);
 size_t KineticPDU_GetValueLength(KineticPDU* const pdu);
 KineticStatus KineticPDU_GetStatus(KineticPDU* pdu);
 KineticProto_Command_KeyValue* KineticPDU_GetKeyValue(KineticPDU* pdu);
 KineticProto_Command_Range* KineticPDU_GetKeyRange(KineticPDU* pdu);
+KineticProto_Command_GetLog* KineticPDU_GetLog(KineticPDU* pdu);
+KineticProto_Command_P2POperation* KineticPDU_GetP2POperation(KineticPDU* pdu);
 
 #endif // _KINETIC_PDU_H
@@ -0,0 +1,331 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_reactor.h"
+#include "kinetic_connection.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <errno.h>
+#include <assert.h>
+
+#ifdef __linux__
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+
+// A reactor services the sockets of many connections from a single thread,
+// using epoll to wait for any of them to become readable
+struct _KineticReactor {
+    int         epollFD;                // epoll instance watching all sockets
+    int         wakeFDs[2];             // pipe used to wake the reactor thread
+    pthread_t   threadID;               // reactor pthread
+    bool        running;                // reactor thread has been started
+    bool        abortRequested;         // reactor thread is being shut down
+    bool        terminated;             // reactor thread has exited
+    bool        batchInvalidated;       // connection removed while dispatching
+    int         connectionCount;        // number of connections being serviced
+    uint64_t    removalsRequested;      // removal tickets issued
+    uint64_t    removalsAcknowledged;   // removal tickets acknowledged by thread
+};
+
+static KineticReactor Reactors[KINETIC_REACTOR_THREADS];
+static pthread_mutex_t ReactorMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ReactorCond = PTHREAD_COND_INITIALIZER;
+
+static void KineticReactor_Wake(KineticReactor* const reactor)
+{
+    uint8_t wake = 1;
+    if (write(reactor->wakeFDs[1], &wake, sizeof(wake)) < 0 && errno != EAGAIN) {
+        LOG0("Failed writing to reactor wake pipe!");
+    }
+}
+
+static void KineticReactor_DrainWakePipe(KineticReactor* const reactor)
+{
+    uint8_t buf[64];
+    while (read(reactor->wakeFDs[0], buf, sizeof(buf)) > 0) {;}
+}
+
+static void KineticReactor_Service(KineticReactor* const reactor,
+    KineticConnection* const connection, uint32_t events)
+{
+    // Paused since the events were collected (its socket is no longer watched)
+    if (connection->thread.paused) {
+        return;
+    }
+
+    // Take only the data which has arrived, so other connections are not
+    // held up waiting on the rest of a PDU
+    KineticStatus status = KINETIC_STATUS_SUCCESS;
+    if (events & EPOLLIN) {
+        status = KineticConnection_ReceiveAvailable(connection);
+    }
+
+    if (status == KINETIC_STATUS_SOCKET_ERROR ||
+        ((events & (EPOLLERR | EPOLLHUP)) && !(events & EPOLLIN)))
+    {
+        LOG0("ERROR: Socket error while waiting for PDU to arrive");
+        connection->thread.fatalError = true;
+        epoll_ctl(reactor->epollFD, EPOLL_CTL_DEL, connection->socket, NULL);
+    }
+}
+
+static void* KineticReactor_Worker(void* arg)
+{
+    KineticReactor* reactor = arg;
+    struct epoll_event events[KINETIC_REACTOR_EVENTS_MAX];
+
+    while(true) {
+
+        // Acknowledge removals, since no events for them can be pending now
+        pthread_mutex_lock(&ReactorMutex);
+        bool abortRequested = reactor->abortRequested;
+        reactor->batchInvalidated = false;
+        if (reactor->removalsAcknowledged != reactor->removalsRequested) {
+            reactor->removalsAcknowledged = reactor->removalsRequested;
+            pthread_cond_broadcast(&ReactorCond);
+        }
+        pthread_mutex_unlock(&ReactorMutex);
+        if (abortRequested) {
+            break;
+        }
+
+        int count = epoll_wait(reactor->epollFD, events, KINETIC_REACTOR_EVENTS_MAX, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            char errMsg[128];
+            Kinetic_GetErrnoDescription(errno, errMsg, sizeof(errMsg));
+            LOGF0("ERROR: Reactor failed waiting for events w/error: %s", errMsg);
+            break;
+        }
+
+        for (int i = 0; i < count && !reactor->batchInvalidated; i++) {
+            KineticConnection* connection = events[i].data.ptr;
+            if (connection == NULL) {
+                KineticReactor_DrainWakePipe(reactor);
+            }
+            else {
+                KineticReactor_Service(reactor, connection, events[i].events);
+            }
+        }
+    }
+
+    // Once failed, the reactor is only restarted after its connections leave
+    pthread_mutex_lock(&ReactorMutex);
+    reactor->terminated = true;
+    pthread_cond_broadcast(&ReactorCond);
+    pthread_mutex_unlock(&ReactorMutex);
+
+    LOG1("Reactor thread terminated!");
+    return (void*)NULL;
+}
+
+static KineticStatus KineticReactor_Start(KineticReactor* const reactor)
+{
+    reactor->epollFD = epoll_create(KINETIC_REACTOR_EVENTS_MAX);
+    if (reactor->epollFD < 0) {
+        LOG0("Failed creating reactor epoll instance!");
+        return KINETIC_STATUS_CONNECTION_ERROR;
+    }
+    if (pipe(reactor->wakeFDs) != 0) {
+        LOG0("Failed creating reactor wake pipe!");
+        close(reactor->epollFD);
+        return KINETIC_STATUS_CONNECTION_ERROR;
+    }
+    fcntl(reactor->wakeFDs[0], F_SETFL, O_NONBLOCK);
+    fcntl(reactor->wakeFDs[1], F_SETFL, O_NONBLOCK);
+
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = NULL};
+    int pthreadStatus = -1;
+    reactor->terminated = false;
+    if (epoll_ctl(reactor->epollFD, EPOLL_CTL_ADD, reactor->wakeFDs[0], &event) == 0) {
+        pthreadStatus = pthread_create(&reactor->threadID, NULL, KineticReactor_Worker, reactor);
+    }
+    if (pthreadStatus != 0) {
+        LOG0("Failed creating reactor thread!");
+        close(reactor->wakeFDs[0]);
+        close(reactor->wakeFDs[1]);
+        close(reactor->epollFD);
+        return KINETIC_STATUS_CONNECTION_ERROR;
+    }
+
+    reactor->running = true;
+    return KINETIC_STATUS_SUCCESS;
+}
+
+// Called with ReactorMutex held; releases it while joining the thread
+static void KineticReactor_Stop(KineticReactor* const reactor)
+{
+    reactor->abortRequested = true;
+    KineticReactor_Wake(reactor);
+    pthread_mutex_unlock(&ReactorMutex);
+    pthread_join(reactor->threadID, NULL);
+    pthread_mutex_lock(&ReactorMutex);
+
+    close(reactor->wakeFDs[0]);
+    close(reactor->wakeFDs[1]);
+    close(reactor->epollFD);
+    reactor->running = false;
+    reactor->abortRequested = false;
+    pthread_cond_broadcast(&ReactorCond);
+}
+
+// A reactor thread which exited on an error (ReactorMutex must be held)
+static inline bool KineticReactor_Failed(KineticReactor* const reactor)
+{
+    return reactor->running && reactor->terminated && !reactor->abortRequested;
+}
+
+KineticStatus KineticReactor_AddConnection(KineticConnection* const connection)
+{
+    assert(connection != NULL);
+    assert(connection->socket >= 0);
+    KineticStatus status = KINETIC_STATUS_SUCCESS;
+
+    pthread_mutex_lock(&ReactorMutex);
+
+    // Balance connections across the reactor threads still servicing events
+    KineticReactor* reactor = NULL;
+    for (int i = 0; i < KINETIC_REACTOR_THREADS; i++) {
+        if (KineticReactor_Failed(&Reactors[i])) {
+            continue;
+        }
+        if (reactor == NULL || Reactors[i].connectionCount < reactor->connectionCount) {
+            reactor = &Reactors[i];
+        }
+    }
+    if (reactor == NULL) {
+        LOG0("All reactor threads have failed!");
+        pthread_mutex_unlock(&ReactorMutex);
+        return KINETIC_STATUS_CONNECTION_ERROR;
+    }
+
+    while (reactor->abortRequested) {
+        pthread_cond_wait(&ReactorCond, &ReactorMutex);
+    }
+    if (!reactor->running) {
+        status = KineticReactor_Start(reactor);
+    }
+
+    if (status == KINETIC_STATUS_SUCCESS) {
+        struct epoll_event event = {.events = EPOLLIN, .data.ptr = connection};
+        connection->reactor = reactor;
+        reactor->connectionCount++;
+        if (epoll_ctl(reactor->epollFD, EPOLL_CTL_ADD, connection->socket, &event) != 0) {
+            char errMsg[128];
+            Kinetic_GetErrnoDescription(errno, errMsg, sizeof(errMsg));
+            LOGF0("Failed adding socket to reactor w/error: %s", errMsg);
+            connection->reactor = NULL;
+            reactor->connectionCount--;
+            status = KINETIC_STATUS_CONNECTION_ERROR;
+        }
+    }
+
+    pthread_mutex_unlock(&ReactorMutex);
+    return status;
+}
+
+void KineticReactor_RemoveConnection(KineticConnection* const connection)
+{
+    assert(connection != NULL);
+    KineticReactor* reactor = connection->reactor;
+    if (reactor == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&ReactorMutex);
+
+    // May already have been removed by the reactor after a socket error
+    epoll_ctl(reactor->epollFD, EPOLL_CTL_DEL, connection->socket, NULL);
+    connection->reactor = NULL;
+    reactor->connectionCount--;
+
+    if (pthread_equal(pthread_self(), reactor->threadID)) {
+        // Removed from within a completion callback, so just drop any
+        // remaining events from the current batch
+        reactor->batchInvalidated = true;
+    }
+    else {
+        // Wait for the reactor to finish dispatching any events which may
+        // still reference this connection
+        uint64_t ticket = ++reactor->removalsRequested;
+        KineticReactor_Wake(reactor);
+        while (!reactor->terminated && reactor->removalsAcknowledged < ticket) {
+            pthread_cond_wait(&ReactorCond, &ReactorMutex);
+        }
+        if (reactor->connectionCount == 0 && reactor->running && !reactor->abortRequested) {
+            KineticReactor_Stop(reactor);
+        }
+    }
+
+    pthread_mutex_unlock(&ReactorMutex);
+}
+
+void KineticReactor_Pause(KineticConnection* const connection, bool pause)
+{
+    assert(connection != NULL);
+    KineticReactor* reactor = connection->reactor;
+    assert(reactor != NULL);
+
+    // Stop watching the socket while paused, since it stays readable
+    pthread_mutex_lock(&ReactorMutex);
+    if (pause != connection->thread.paused) {
+        connection->thread.paused = pause;
+        if (pause) {
+            epoll_ctl(reactor->epollFD, EPOLL_CTL_DEL, connection->socket, NULL);
+        }
+        else if (!connection->thread.fatalError) {
+            struct epoll_event event = {.events = EPOLLIN, .data.ptr = connection};
+            if (epoll_ctl(reactor->epollFD, EPOLL_CTL_ADD, connection->socket, &event) != 0) {
+                LOG0("Failed resuming reactor servicing of connection!");
+                connection->thread.fatalError = true;
+            }
+        }
+    }
+    pthread_mutex_unlock(&ReactorMutex);
+}
+
+#else // __linux__
+
+KineticStatus KineticReactor_AddConnection(KineticConnection* const connection)
+{
+    assert(connection != NULL);
+    LOG0("Reactor is not supported on this platform");
+    return KINETIC_STATUS_CONNECTION_ERROR;
+}
+
+void KineticReactor_RemoveConnection(KineticConnection* const connection)
+{
+    assert(connection != NULL);
+    connection->reactor = NULL;
+}
+
+void KineticReactor_Pause(KineticConnection* const connection, bool pause)
+{
+    assert(connection != NULL);
+    connection->thread.paused = pause;
+}
+
+#endif // __linux__
@@ -0,0 +1,195 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_reed_solomon.h"
+#include <string.h>
+#include <pthread.h>
+
+// Products of every pair of GF(2^8) elements (modulo x^8+x^4+x^3+x^2+1), so
+// that multiplying a fragment by a coefficient is one lookup per byte
+static uint8_t Product[256][256];
+static uint8_t Inverse[256];
+static pthread_once_t ProductsOnce = PTHREAD_ONCE_INIT;
+
+static void KineticReedSolomon_BuildProducts(void)
+{
+    uint8_t exp[255];
+    uint8_t log[256];
+    unsigned x = 1;
+    for (int i = 0; i < 255; i++) {
+        exp[i] = (uint8_t)x;
+        log[x] = (uint8_t)i;
+        x <<= 1;
+        if (x & 0x100) {
+            x ^= 0x11D;
+        }
+    }
+    for (int a = 1; a < 256; a++) {
+        for (int b = 1; b < 256; b++) {
+            Product[a][b] = exp[(log[a] + log[b]) % 255];
+        }
+        Inverse[a] = exp[(255 - log[a]) % 255];
+    }
+}
+
+// Adds the product of a fragment and a coefficient into another fragment
+static void KineticReedSolomon_MultiplyAdd(uint8_t coefficient,
+    const uint8_t* src, uint8_t* dest, size_t size)
+{
+    if (coefficient == 0) {
+        return;
+    }
+    if (coefficient == 1) {
+        for (size_t i = 0; i < size; i++) {
+            dest[i] ^= src[i];
+        }
+        return;
+    }
+    const uint8_t* product = Product[coefficient];
+    for (size_t i = 0; i < size; i++) {
+        dest[i] ^= product[src[i]];
+    }
+}
+
+// Coefficient of a data fragment in a parity fragment. Parity rows form a
+// Cauchy matrix, so any square matrix made of data (identity) and parity
+// rows is invertible, and any k fragments suffice to decode.
+static uint8_t KineticReedSolomon_Coefficient(int dataFragments, int parity, int data)
+{
+    return Inverse[(uint8_t)(dataFragments + parity) ^ (uint8_t)data];
+}
+
+void KineticReedSolomon_Encode(int dataFragments, int parityFragments,
+    size_t size, uint8_t** const fragments)
+{
+    assert(dataFragments > 0 && parityFragments >= 0);
+    assert(dataFragments + parityFragments <= KINETIC_ERASURE_FRAGMENTS_MAX);
+    pthread_once(&ProductsOnce, KineticReedSolomon_BuildProducts);
+
+    for (int i = 0; i < parityFragments; i++) {
+        uint8_t* parity = fragments[dataFragments + i];
+        memset(parity, 0, size);
+        for (int j = 0; j < dataFragments; j++) {
+            KineticReedSolomon_MultiplyAdd(
+                KineticReedSolomon_Coefficient(dataFragments, i, j),
+                fragments[j], parity, size);
+        }
+    }
+}
+
+// Inverts a k x k matrix in place by Gauss-Jordan elimination
+static bool KineticReedSolomon_Invert(int k,
+    uint8_t matrix[KINETIC_ERASURE_FRAGMENTS_MAX][KINETIC_ERASURE_FRAGMENTS_MAX])
+{
+    uint8_t inverse[KINETIC_ERASURE_FRAGMENTS_MAX][KINETIC_ERASURE_FRAGMENTS_MAX];
+    memset(inverse, 0, sizeof(inverse));
+    for (int i = 0; i < k; i++) {
+        inverse[i][i] = 1;
+    }
+
+    for (int col = 0; col < k; col++) {
+        int pivot = col;
+        while (pivot < k && matrix[pivot][col] == 0) {
+            pivot++;
+        }
+        if (pivot == k) {
+            return false;
+        }
+        if (pivot != col) {
+            for (int j = 0; j < k; j++) {
+                uint8_t swap = matrix[col][j];
+                matrix[col][j] = matrix[pivot][j];
+                matrix[pivot][j] = swap;
+                swap = inverse[col][j];
+                inverse[col][j] = inverse[pivot][j];
+                inverse[pivot][j] = swap;
+            }
+        }
+        uint8_t scale = Inverse[matrix[col][col]];
+        for (int j = 0; j < k; j++) {
+            matrix[col][j] = Product[scale][matrix[col][j]];
+            inverse[col][j] = Product[scale][inverse[col][j]];
+        }
+        for (int row = 0; row < k; row++) {
+            uint8_t factor = matrix[row][col];
+            if (row == col || factor == 0) {
+                continue;
+            }
+            for (int j = 0; j < k; j++) {
+                matrix[row][j] ^= Product[factor][matrix[col][j]];
+                inverse[row][j] ^= Product[factor][inverse[col][j]];
+            }
+        }
+    }
+    memcpy(matrix, inverse, sizeof(inverse));
+    return true;
+}
+
+bool KineticReedSolomon_Decode(int dataFragments, int parityFragments,
+    size_t size, uint8_t** const fragments, const bool* present)
+{
+    assert(dataFragments > 0 && parityFragments >= 0);
+    assert(dataFragments + parityFragments <= KINETIC_ERASURE_FRAGMENTS_MAX);
+    pthread_once(&ProductsOnce, KineticReedSolomon_BuildProducts);
+
+    // Decode from the first k fragments present, preferring data fragments,
+    // which need no arithmetic
+    int rows[KINETIC_ERASURE_FRAGMENTS_MAX];
+    int count = 0;
+    bool missing = false;
+    for (int i = 0; i < dataFragments + parityFragments && count < dataFragments; i++) {
+        if (present[i]) {
+            rows[count++] = i;
+        }
+        else if (i < dataFragments) {
+            missing = true;
+        }
+    }
+    if (count < dataFragments) {
+        return false;
+    }
+    if (!missing) {
+        return true;
+    }
+
+    uint8_t matrix[KINETIC_ERASURE_FRAGMENTS_MAX][KINETIC_ERASURE_FRAGMENTS_MAX];
+    memset(matrix, 0, sizeof(matrix));
+    for (int r = 0; r < dataFragments; r++) {
+        for (int j = 0; j < dataFragments; j++) {
+            matrix[r][j] = (rows[r] < dataFragments) ?
+                (uint8_t)(rows[r] == j) :
+                KineticReedSolomon_Coefficient(dataFragments, rows[r] - dataFragments, j);
+        }
+    }
+    if (!KineticReedSolomon_Invert(dataFragments, matrix)) {
+        return false;
+    }
+
+    for (int j = 0; j < dataFragments; j++) {
+        if (present[j]) {
+            continue;
+        }
+        memset(fragments[j], 0, size);
+        for (int r = 0; r < dataFragments; r++) {
+            KineticReedSolomon_MultiplyAdd(matrix[j][r], fragments[rows[r]], fragments[j], size);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,263 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_replication.h"
+#include "kinetic_fan_out.h"
+#include "kinetic_operation.h"
+#include "kinetic_entry.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+static void KineticReplication_Destroy(KineticReplication* const replication)
+{
+    for (int i = 0; i < replication->fanOut.count; i++) {
+        free(replication->replicas[i].valueData);
+    }
+    KineticFanOut_Destroy(&replication->fanOut);
+}
+
+// Versions are opaque to the device, so are ordered as unsigned big-endian
+// numbers, as written by the replicated put of an incrementing counter
+static int KineticReplication_CompareVersions(const ByteBuffer* a, const ByteBuffer* b)
+{
+    if (a->bytesUsed != b->bytesUsed) {
+        return (a->bytesUsed > b->bytesUsed) ? 1 : -1;
+    }
+    return (a->bytesUsed == 0) ? 0 : memcmp(a->array.data, b->array.data, a->bytesUsed);
+}
+
+// Finds the replica holding the newest version retrieved (the mutex is held)
+static KineticReplica* KineticReplication_Newest(KineticReplication* const replication)
+{
+    KineticReplica* newest = NULL;
+    for (int i = 0; i < replication->fanOut.count; i++) {
+        KineticReplica* replica = &replication->replicas[i];
+        if (replica->member.done && replica->member.status == KINETIC_STATUS_SUCCESS &&
+            (newest == NULL || KineticReplication_CompareVersions(
+                &replica->member.entry.dbVersion, &newest->member.entry.dbVersion) > 0))
+        {
+            newest = replica;
+        }
+    }
+    return newest;
+}
+
+// Counts replicas which succeeded, or, for a GET, found no entry
+static bool KineticReplication_Check(KineticFanOutMember* const member,
+    KineticStatus* const status)
+{
+    return *status == KINETIC_STATUS_SUCCESS ||
+        (member->fanOut->reading && *status == KINETIC_STATUS_NOT_FOUND);
+}
+
+// Completes the caller once a quorum has responded, or can no longer be
+// reached, handing it the newest entry retrieved by a GET
+static bool KineticReplication_Decide(KineticFanOut* const fanOut, KineticStatus* const status)
+{
+    KineticReplication* replication = (KineticReplication*)fanOut;
+    if (fanOut->succeeded < replication->quorum &&
+        fanOut->failed <= fanOut->count - replication->quorum) {
+        return false;
+    }
+
+    if (fanOut->succeeded < replication->quorum) {
+        LOGF0("Replication quorum failed (%d replicas responded of %d required)",
+            fanOut->succeeded, replication->quorum);
+        *status = fanOut->failure;
+    }
+    else if (fanOut->reading) {
+        KineticReplica* newest = KineticReplication_Newest(replication);
+        *status = (newest == NULL) ? KINETIC_STATUS_NOT_FOUND :
+            KineticEntry_CopyRetrieved(fanOut->entry, &newest->member.entry);
+    }
+    else {
+        KineticEntry_PromoteVersion(fanOut->entry);
+        *status = KINETIC_STATUS_SUCCESS;
+    }
+    return true;
+}
+
+static void KineticReplication_Release(KineticFanOut* const fanOut);
+
+static void KineticReplication_Repaired(KineticCompletionData* kinetic_data, void* client_data)
+{
+    KineticReplica* replica = (KineticReplica*)client_data;
+    KineticFanOut* fanOut = replica->member.fanOut;
+    if (kinetic_data->status == KINETIC_STATUS_VERSION_MISMATCH) {
+        LOGF1("Read-repair of replica on %s:%d superseded by another write",
+            replica->member.connection->session.host, replica->member.connection->session.port);
+    }
+    else if (kinetic_data->status != KINETIC_STATUS_SUCCESS) {
+        LOGF0("Read-repair of replica on %s:%d failed w/status: %s",
+            replica->member.connection->session.host, replica->member.connection->session.port,
+            Kinetic_GetStatusDescription(kinetic_data->status));
+    }
+    pthread_mutex_lock(&fanOut->mutex);
+    replica->member.operation = NULL;
+    fanOut->references--;
+    bool last = (fanOut->references == 0);
+    pthread_mutex_unlock(&fanOut->mutex);
+    if (last) {
+        KineticReplication_Release(fanOut);
+    }
+}
+
+// Rewrites the newest entry retrieved to replicas which responded with an
+// older version, or without the entry, returning the number of repairs issued.
+// Each repair is conditional on the replica still holding the version it
+// reported (or still lacking the entry), so that a write racing with the
+// repair is never overwritten by it.
+static int KineticReplication_Repair(KineticReplication* const replication)
+{
+    KineticReplica* newest = KineticReplication_Newest(replication);
+    if (newest == NULL || newest->valueData == NULL) {
+        return 0;
+    }
+
+    int repairs = 0;
+    for (int i = 0; i < replication->fanOut.count; i++) {
+        KineticReplica* replica = &replication->replicas[i];
+        KineticEntry* entry = &replica->member.entry;
+        bool stale = (replica->member.status == KINETIC_STATUS_NOT_FOUND) ||
+            (replica->member.status == KINETIC_STATUS_SUCCESS &&
+             KineticReplication_CompareVersions(&entry->dbVersion,
+                &newest->member.entry.dbVersion) != 0);
+        if (!stale) {
+            continue;
+        }
+        LOGF1("Repairing stale replica on %s:%d",
+            replica->member.connection->session.host, replica->member.connection->session.port);
+        ByteBuffer dbVersion = entry->dbVersion;
+        if (replica->member.status == KINETIC_STATUS_NOT_FOUND) {
+            ByteBuffer_Reset(&dbVersion);
+        }
+        *entry = (KineticEntry) {
+            .key = newest->member.entry.key,
+            .value = newest->member.entry.value,
+            .dbVersion = dbVersion,
+            .newVersion = newest->member.entry.dbVersion,
+            .tag = newest->member.entry.tag,
+            .algorithm = newest->member.entry.algorithm,
+            .force = false,
+            .synchronization = KINETIC_SYNCHRONIZATION_WRITEBACK,
+        };
+        pthread_mutex_lock(&replication->fanOut.mutex);
+        replication->fanOut.references++;
+        pthread_mutex_unlock(&replication->fanOut.mutex);
+        // Repairs are issued from the receiver thread, so must not block it
+        KineticStatus status = KineticFanOut_Request(&replica->member,
+            KineticFanOut_BuildPut, KineticReplication_Repaired, false);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            KineticCompletionData completionData = {.status = status};
+            KineticReplication_Repaired(&completionData, replica);
+        }
+        repairs++;
+    }
+    return repairs;
+}
+
+// Releases a replication once nothing refers to it, after repairing any
+// stale replicas found by a GET
+static void KineticReplication_Release(KineticFanOut* const fanOut)
+{
+    KineticReplication* replication = (KineticReplication*)fanOut;
+    if (fanOut->reading && !replication->repaired) {
+        replication->repaired = true;
+
+        // Hold a reference while issuing, since repairs may complete at once
+        fanOut->references++;
+        KineticReplication_Repair(replication);
+        pthread_mutex_lock(&fanOut->mutex);
+        bool last = (--fanOut->references == 0);
+        pthread_mutex_unlock(&fanOut->mutex);
+        if (!last) {
+            return;
+        }
+    }
+    KineticReplication_Destroy(replication);
+}
+
+static const KineticFanOutPolicy KineticReplication_Policy = {
+    .member = "Replica",
+    .check = KineticReplication_Check,
+    .decide = KineticReplication_Decide,
+    .release = KineticReplication_Release,
+};
+
+static KineticStatus KineticReplication_Execute(KineticConnection** const connections,
+    int count, int quorum, KineticEntry* const entry, KineticCompletionClosure* closure,
+    bool reading)
+{
+    assert(connections != NULL);
+    assert(entry != NULL);
+    if (count < 1 || count > KINETIC_REPLICAS_MAX || quorum < 1 || quorum > count) {
+        LOGF0("Invalid replication specified (quorum of %d of %d replicas)!", quorum, count);
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+    if (!KineticFanOut_CheckEntry(entry)) {
+        LOG0("Replicated entry key, version or tag is too long!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    KineticReplication* replication = (KineticReplication*)calloc(1, sizeof(KineticReplication));
+    if (replication == NULL) {
+        LOG0("Failed allocating replication!");
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    KineticFanOut_Init(&replication->fanOut, &KineticReplication_Policy,
+        count, reading, entry, closure);
+    replication->quorum = quorum;
+    for (int i = 0; i < count; i++) {
+        KineticReplica* replica = &replication->replicas[i];
+        KineticFanOut_AddMember(&replication->fanOut, i, &replica->member, connections[i]);
+        if (reading) {
+            if (!entry->metadataOnly) {
+                replica->valueData = (uint8_t*)malloc(entry->value.array.len);
+                if (replica->valueData == NULL) {
+                    LOG0("Failed allocating replica value buffer!");
+                    KineticReplication_Destroy(replication);
+                    return KINETIC_STATUS_MEMORY_ERROR;
+                }
+            }
+            replica->member.entry.value = ByteBuffer_Create(replica->valueData,
+                (replica->valueData != NULL) ? entry->value.array.len : 0, 0);
+        }
+    }
+
+    LOGF1("Replicating %s to %d sessions w/quorum of %d", reading ? "GET" : "PUT",
+        count, quorum);
+    return KineticFanOut_Execute(&replication->fanOut);
+}
+
+KineticStatus KineticReplication_Put(KineticConnection** const connections,
+    int count, int quorum, KineticEntry* const entry,
+    KineticCompletionClosure* closure)
+{
+    return KineticReplication_Execute(connections, count, quorum, entry, closure, false);
+}
+
+KineticStatus KineticReplication_Get(KineticConnection** const connections,
+    int count, int quorum, KineticEntry* const entry,
+    KineticCompletionClosure* closure)
+{
+    return KineticReplication_Execute(connections, count, quorum, entry, closure, true);
+}
@@ -0,0 +1,237 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_session_pool.h"
+#include "kinetic_connection.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+#include <limits.h>
+#include <pthread.h>
+#include <time.h>
+
+// Sets the pool each member belongs to, which is signaled as operations
+// leave its window
+static void KineticSessionPool_Join(KineticSessionPool* const pool,
+    KineticSessionPool* const memberOf)
+{
+    for (int i = 0; i < pool->count; i++) {
+        KineticConnection* member = pool->members[i];
+        pthread_mutex_lock(&member->windowMutex);
+        member->memberOf = memberOf;
+        pthread_mutex_unlock(&member->windowMutex);
+    }
+}
+
+// Closes and releases the members other than the primary connection
+static void KineticSessionPool_Release(KineticSessionPool* const pool)
+{
+    KineticSessionPool_Join(pool, NULL);
+    for (int i = 1; i < pool->count; i++) {
+        KineticStatus status = KineticConnection_Disconnect(pool->members[i]);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            LOGF0("Failed disconnecting pooled connection w/status: %s",
+                Kinetic_GetStatusDescription(status));
+        }
+        KineticConnection_FreeConnection(&pool->handles[i]);
+    }
+    pthread_cond_destroy(&pool->windowCond);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool);
+}
+
+KineticStatus KineticSessionPool_Connect(KineticConnection* const connection)
+{
+    assert(connection != NULL);
+    int count = connection->session.connections;
+    if (count < 1 || count > KINETIC_SESSION_CONNECTIONS_MAX) {
+        LOGF0("Invalid number of session connections specified (%d)!", count);
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+    if (connection->pool != NULL) {
+        LOG0("Session connections already pooled!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    KineticSessionPool* pool = (KineticSessionPool*)calloc(1, sizeof(KineticSessionPool));
+    if (pool == NULL) {
+        LOG0("Failed allocating session pool!");
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    pthread_mutex_init(&pool->mutex, NULL);
+    Kinetic_InitCondition(&pool->windowCond);
+    pool->policy = connection->session.poolPolicy;
+    pool->members[0] = connection;
+    pool->handles[0] = KINETIC_HANDLE_INVALID;
+    pool->count = 1;
+
+    // Open the other connections, each with its own socket, sequence and
+    // receive thread (or reactor registration)
+    KineticStatus status = KINETIC_STATUS_SUCCESS;
+    while (pool->count < count) {
+        KineticSessionHandle handle = KineticConnection_NewConnection(&connection->session);
+        if (handle == KINETIC_HANDLE_INVALID) {
+            LOG0("Failed obtaining pooled connection!");
+            status = KINETIC_STATUS_SESSION_INVALID;
+            break;
+        }
+        KineticConnection* member = KineticConnection_FromHandle(handle);
+        status = KineticConnection_Connect(member);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            LOGF0("Failed creating pooled connection to %s:%d",
+                connection->session.host, connection->session.port);
+            KineticConnection_FreeConnection(&handle);
+            break;
+        }
+        pool->members[pool->count] = member;
+        pool->handles[pool->count] = handle;
+        pool->count++;
+    }
+    if (status != KINETIC_STATUS_SUCCESS) {
+        KineticSessionPool_Release(pool);
+        return status;
+    }
+
+    // Wait for the initial unsolicited status of each, to obtain its connectionID
+    for (int i = 1; i < pool->count; i++) {
+        while (pool->members[i]->connectionID == 0) {sleep(1);}
+    }
+
+    KineticSessionPool_Join(pool, pool);
+    connection->pool = pool;
+    return KINETIC_STATUS_SUCCESS;
+}
+
+static inline bool KineticSessionPool_Usable(KineticConnection* const member)
+{
+    return member->connected && !member->thread.fatalError;
+}
+
+KineticConnection* KineticSessionPool_Select(KineticSessionPool* const pool)
+{
+    assert(pool != NULL);
+    assert(pool->count > 0);
+
+    // Start at the next member in turn, so that ties are spread evenly
+    pthread_mutex_lock(&pool->mutex);
+    int start = pool->next;
+    pool->next = (pool->next + 1) % pool->count;
+    pthread_mutex_unlock(&pool->mutex);
+
+    if (pool->policy == KINETIC_POOL_POLICY_LEAST_LATENCY) {
+        KineticConnection* choice = pool->members[
+            KineticConnection_SelectLeastLoaded(pool->members, pool->count, start)];
+        if (KineticSessionPool_Usable(choice)) {
+            return choice;
+        }
+    }
+
+    // Otherwise, or if both candidates have failed, scan for a usable member
+    KineticConnection* selected = NULL;
+    int fewest = INT_MAX;
+    for (int i = 0; i < pool->count; i++) {
+        KineticConnection* member = pool->members[(start + i) % pool->count];
+        if (!KineticSessionPool_Usable(member)) {
+            continue;
+        }
+        if (pool->policy == KINETIC_POOL_POLICY_ROUND_ROBIN) {
+            selected = member;
+            break;
+        }
+        pthread_mutex_lock(&member->windowMutex);
+        int outstanding = member->outstanding;
+        pthread_mutex_unlock(&member->windowMutex);
+        if (outstanding < fewest) {
+            selected = member;
+            fewest = outstanding;
+        }
+    }
+
+    // Leave reporting a failed connection to the operation itself
+    if (selected == NULL) {
+        selected = pool->members[start];
+    }
+    return selected;
+}
+
+// Whether any usable member has room in its in-flight window. If none is
+// usable, KINETIC_STATUS_CONNECTION_ERROR is reported instead.
+static bool KineticSessionPool_WindowAvailable(KineticSessionPool* const pool,
+    KineticStatus* const status)
+{
+    bool usable = false;
+    for (int i = 0; i < pool->count; i++) {
+        KineticConnection* member = pool->members[i];
+        if (!KineticSessionPool_Usable(member)) {
+            continue;
+        }
+        usable = true;
+        int max = member->session.outstandingOperationsMax;
+        pthread_mutex_lock(&member->windowMutex);
+        bool room = (max <= 0 || member->outstanding < max);
+        pthread_mutex_unlock(&member->windowMutex);
+        if (room) {
+            return true;
+        }
+    }
+    if (!usable) {
+        LOG0("Pooled connections failed while waiting for in-flight window!");
+        *status = KINETIC_STATUS_CONNECTION_ERROR;
+    }
+    return false;
+}
+
+// Each member has its own in-flight window, so waits for room in any of them
+KineticStatus KineticSessionPool_WaitForWindow(KineticSessionPool* const pool)
+{
+    assert(pool != NULL);
+    KineticStatus status = KINETIC_STATUS_SUCCESS;
+    while (true) {
+        pthread_mutex_lock(&pool->mutex);
+        int released = pool->released;
+        pthread_mutex_unlock(&pool->mutex);
+        if (KineticSessionPool_WindowAvailable(pool, &status) ||
+            status != KINETIC_STATUS_SUCCESS) {
+            return status;
+        }
+
+        // Member windows are not locked while waiting, so only wait if none
+        // has released an operation since they were checked, and wake
+        // periodically, in order to notice failed connections
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += 1;
+        pthread_mutex_lock(&pool->mutex);
+        if (pool->released == released) {
+            pthread_cond_timedwait(&pool->windowCond, &pool->mutex, &deadline);
+        }
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+void KineticSessionPool_Disconnect(KineticConnection* const connection)
+{
+    assert(connection != NULL);
+    KineticSessionPool* pool = connection->pool;
+    if (pool == NULL) {
+        return;
+    }
+    connection->pool = NULL;
+    KineticSessionPool_Release(pool);
+}
@@ -19,6 +19,7 @@
 */
 
 #include "kinetic_socket.h"
+#include "kinetic_arena.h"
 #include "kinetic_logger.h"
 #include "kinetic_types_internal.h"
 #include "kinetic_proto.h"
@@ -33,6 +34,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/select.h>
 #include <sys/ioctl.h>
 #include <netinet/in.h>
@@ -342,6 +344,23 @@ KineticStatus KineticSocket_Read(int socket, ByteBuffer* dest, size_t len)
     return KINETIC_STATUS_SUCCESS;
 }
 
+static KineticStatus KineticSocket_UnpackProtobuf(KineticPDU* pdu, const uint8_t* packed, size_t len)
+{
+    ProtobufCAllocator allocator = KineticArena_GetAllocator(&pdu->arena);
+    pdu->proto = KineticProto_Message__unpack(&allocator, len, packed);
+    if (pdu->proto == NULL) {
+        pdu->protobufDynamicallyExtracted = false;
+        KineticArena_Reset(&pdu->arena);
+        LOG0("Error unpacking incoming Kinetic protobuf message!");
+        return KINETIC_STATUS_DATA_ERROR;
+    }
+    else {
+        pdu->protobufDynamicallyExtracted = true;
+        LOG3("Protobuf unpacked successfully!");
+        return KINETIC_STATUS_SUCCESS;
+    }
+}
+
 KineticStatus KineticSocket_ReadProtobuf(int socket, KineticPDU* pdu)
 {
     size_t bytesToRead = pdu->header.protobufLength;
@@ -362,22 +381,230 @@ KineticStatus KineticSocket_ReadProtobuf(int socket, KineticPDU* pdu)
         return status;
     }
     else {
-        pdu->proto = KineticProto_Message__unpack(
-                         NULL, recvBuffer.bytesUsed, recvBuffer.array.data);
+        status = KineticSocket_UnpackProtobuf(pdu, recvBuffer.array.data, recvBuffer.bytesUsed);
     }
 
     free(packed);
+    return status;
+}
 
-    if (pdu->proto == NULL) {
-        pdu->protobufDynamicallyExtracted = false;
-        LOG0("Error unpacking incoming Kinetic protobuf message!");
-        return KINETIC_STATUS_DATA_ERROR;
+// Ensures at least `len` contiguous bytes are buffered, reading as much as
+// the socket has available (up to the free space) on each read
+static KineticStatus KineticSocket_FillReadBuffer(int socket, KineticReadBuffer* buffer, size_t len)
+{
+    assert(len <= KINETIC_READ_BUFFER_SIZE);
+    if (buffer->data == NULL) {
+        buffer->data = (uint8_t*)malloc(KINETIC_READ_BUFFER_SIZE);
+        if (buffer->data == NULL) {
+            LOG0("Failed allocating socket read buffer!");
+            return KINETIC_STATUS_MEMORY_ERROR;
+        }
+        buffer->size = KINETIC_READ_BUFFER_SIZE;
+        buffer->start = buffer->end = 0;
     }
-    else {
-        pdu->protobufDynamicallyExtracted = true;
-        LOG3("Protobuf unpacked successfully!");
+
+    // Move any unconsumed data to the front, if the request would not fit
+    if (buffer->start + len > buffer->size) {
+        memmove(buffer->data, &buffer->data[buffer->start], buffer->end - buffer->start);
+        buffer->end -= buffer->start;
+        buffer->start = 0;
+    }
+
+    while (buffer->end - buffer->start < len) {
+        fd_set readSet;
+        struct timeval timeout = {.tv_sec = 5, .tv_usec = 0};
+        FD_ZERO(&readSet);
+        FD_SET(socket, &readSet);
+        int opStatus = select(socket + 1, &readSet, NULL, NULL, &timeout);
+        if (opStatus < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOGF0("Failed waiting to read from socket!"
+                 " status=%d, errno=%d, desc='%s'",
+                 opStatus, errno, strerror(errno));
+            return KINETIC_STATUS_SOCKET_ERROR;
+        }
+        else if (opStatus == 0) {
+            LOG0("Timed out waiting for socket data to arrive!");
+            return KINETIC_STATUS_SOCKET_TIMEOUT;
+        }
+
+        opStatus = read(socket, &buffer->data[buffer->end], buffer->size - buffer->end);
+        if (opStatus == -1 &&
+            ((errno == EINTR) || (errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+            continue;
+        }
+        else if (opStatus <= 0) {
+            LOGF0("Failed to read from socket!"
+                 " status=%d, errno=%d, desc='%s'",
+                 opStatus, errno, strerror(errno));
+            return KINETIC_STATUS_SOCKET_ERROR;
+        }
+        buffer->end += opStatus;
+        LOGF3("Buffered %d bytes (%zu available)", opStatus, buffer->end - buffer->start);
+    }
+    return KINETIC_STATUS_SUCCESS;
+}
+
+static void KineticSocket_ConsumeBuffered(KineticReadBuffer* buffer, size_t len)
+{
+    buffer->start += len;
+    if (buffer->start == buffer->end) {
+        buffer->start = buffer->end = 0;
+    }
+}
+
+void KineticSocket_FreeReadBuffer(KineticReadBuffer* buffer)
+{
+    assert(buffer != NULL);
+    free(buffer->data);
+    *buffer = (KineticReadBuffer) {.data = NULL};
+}
+
+KineticStatus KineticSocket_ReadAvailable(int socket, KineticReadBuffer* buffer, size_t len)
+{
+    assert(buffer != NULL);
+
+    // Give back space grown for a large PDU, once it has been consumed
+    if (buffer->start == buffer->end && buffer->size > KINETIC_READ_BUFFER_SIZE) {
+        KineticSocket_FreeReadBuffer(buffer);
+    }
+
+    if (buffer->end - buffer->start >= len) {
         return KINETIC_STATUS_SUCCESS;
     }
+
+    // Make room for all of the requested bytes, growing the buffer if need be
+    size_t size = (len > KINETIC_READ_BUFFER_SIZE) ? len : KINETIC_READ_BUFFER_SIZE;
+    if (buffer->start + len > buffer->size && buffer->start > 0) {
+        memmove(buffer->data, &buffer->data[buffer->start], buffer->end - buffer->start);
+        buffer->end -= buffer->start;
+        buffer->start = 0;
+    }
+    if (buffer->size < size) {
+        uint8_t* data = (uint8_t*)realloc(buffer->data, size);
+        if (data == NULL) {
+            LOG0("Failed growing socket read buffer!");
+            return KINETIC_STATUS_MEMORY_ERROR;
+        }
+        if (buffer->data == NULL) {
+            buffer->start = buffer->end = 0;
+        }
+        buffer->data = data;
+        buffer->size = size;
+    }
+
+    // Take only what has already arrived, leaving the rest for later
+    while (buffer->end - buffer->start < len) {
+        ssize_t opStatus = recv(socket, &buffer->data[buffer->end],
+            buffer->size - buffer->end, MSG_DONTWAIT);
+        if (opStatus < 0 && errno == EINTR) {
+            continue;
+        }
+        else if (opStatus < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return KINETIC_STATUS_WOULD_BLOCK;
+        }
+        else if (opStatus <= 0) {
+            LOGF0("Failed to read from socket!"
+                 " status=%zd, errno=%d, desc='%s'",
+                 opStatus, errno, strerror(errno));
+            return KINETIC_STATUS_SOCKET_ERROR;
+        }
+        buffer->end += opStatus;
+        LOGF3("Buffered %zd bytes (%zu available)", opStatus, buffer->end - buffer->start);
+    }
+    return KINETIC_STATUS_SUCCESS;
+}
+
+KineticStatus KineticSocket_ReadBuffered(int socket, KineticReadBuffer* buffer, ByteBuffer* dest, size_t len)
+{
+    assert(buffer != NULL);
+    assert(dest != NULL);
+    LOGF2("Reading %zd buffered bytes into buffer @ 0x%zX from fd=%d",
+         len, (size_t)dest->array.data, socket);
+
+    bool overrun = false;
+    size_t remaining = len;
+    while (remaining > 0) {
+        size_t buffered = buffer->end - buffer->start;
+        size_t space = dest->array.len - dest->bytesUsed;
+
+        // Read large payloads directly, once any buffered bytes are drained
+        if (buffered == 0 && remaining >= KINETIC_READ_BUFFER_SIZE) {
+            // (limit the tail to this payload, so the next PDU is not consumed)
+            size_t tailLen = (remaining < space) ? remaining : space;
+            ByteBuffer tail = ByteBuffer_Create(&dest->array.data[dest->bytesUsed], tailLen, 0);
+            KineticStatus status = KineticSocket_Read(socket, &tail, remaining);
+            dest->bytesUsed += (tail.bytesUsed < tailLen) ? tail.bytesUsed : tailLen;
+            if (status == KINETIC_STATUS_SUCCESS && overrun) {
+                status = KINETIC_STATUS_BUFFER_OVERRUN;
+            }
+            return status;
+        }
+
+        if (buffered == 0) {
+            KineticStatus status = KineticSocket_FillReadBuffer(socket, buffer, remaining);
+            if (status != KINETIC_STATUS_SUCCESS) {
+                return status;
+            }
+            buffered = buffer->end - buffer->start;
+        }
+
+        // Copy what fits, discarding the rest in case of a short dest buffer
+        size_t chunk = (buffered < remaining) ? buffered : remaining;
+        size_t copied = (chunk < space) ? chunk : space;
+        memcpy(&dest->array.data[dest->bytesUsed], &buffer->data[buffer->start], copied);
+        dest->bytesUsed += copied;
+        overrun |= (copied < chunk);
+        KineticSocket_ConsumeBuffered(buffer, chunk);
+        remaining -= chunk;
+    }
+
+    if (overrun) {
+        LOGF1("Socket read buffer was truncated due to buffer overrun!"
+             " received=%zu, copied=%zu",
+             len, dest->array.len);
+        return KINETIC_STATUS_BUFFER_OVERRUN;
+    }
+    LOGF3("Received %zd of %zd bytes requested", dest->bytesUsed, len);
+    return KINETIC_STATUS_SUCCESS;
+}
+
+KineticStatus KineticSocket_ReadProtobufBuffered(int socket, KineticReadBuffer* buffer, KineticPDU* pdu)
+{
+    assert(buffer != NULL);
+    assert(pdu != NULL);
+    size_t bytesToRead = pdu->header.protobufLength;
+    LOGF2("Reading %zd bytes of protobuf", bytesToRead);
+
+    // Unpack in place, if the message fits in the read buffer
+    if (bytesToRead <= KINETIC_READ_BUFFER_SIZE) {
+        KineticStatus status = KineticSocket_FillReadBuffer(socket, buffer, bytesToRead);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            LOG0("Protobuf read failed!");
+            return status;
+        }
+        status = KineticSocket_UnpackProtobuf(pdu, &buffer->data[buffer->start], bytesToRead);
+        KineticSocket_ConsumeBuffered(buffer, bytesToRead);
+        return status;
+    }
+
+    uint8_t* packed = (uint8_t*)malloc(bytesToRead);
+    if (packed == NULL) {
+        LOG0("Failed allocating memory for protocol buffer");
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    ByteBuffer recvBuffer = ByteBuffer_Create(packed, bytesToRead, 0);
+    KineticStatus status = KineticSocket_ReadBuffered(socket, buffer, &recvBuffer, bytesToRead);
+    if (status == KINETIC_STATUS_SUCCESS) {
+        status = KineticSocket_UnpackProtobuf(pdu, recvBuffer.array.data, recvBuffer.bytesUsed);
+    }
+    else {
+        LOG0("Protobuf read failed!");
+    }
+    free(packed);
+    return status;
 }
 
 KineticStatus KineticSocket_Write(int socket, ByteBuffer* src)
@@ -404,6 +631,49 @@ KineticStatus KineticSocket_Write(int socket, ByteBuffer* src)
     return KINETIC_STATUS_SUCCESS;
 }
 
+KineticStatus KineticSocket_WriteV(int socket, ByteBuffer* src, int count)
+{
+    assert(src != NULL);
+    assert(count > 0 && count <= KINETIC_SOCKET_IOV_MAX);
+
+    struct iovec iov[KINETIC_SOCKET_IOV_MAX];
+    size_t bytesRemaining = 0;
+    int iovIndex = 0;
+    for (int i = 0; i < count; i++) {
+        iov[i] = (struct iovec) {.iov_base = src[i].array.data, .iov_len = src[i].bytesUsed};
+        bytesRemaining += src[i].bytesUsed;
+    }
+    LOGF3("Writing %zu bytes from %d buffers to socket...", bytesRemaining, count);
+
+    while (bytesRemaining > 0) {
+        ssize_t status = writev(socket, &iov[iovIndex], count - iovIndex);
+        if (status == -1 &&
+            ((errno == EINTR) || (errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+            LOG2("Write interrupted. retrying...");
+            continue;
+        }
+        else if (status <= 0) {
+            LOGF0("Failed to write to socket! status=%zd, errno=%d\n", status, errno);
+            return KINETIC_STATUS_SOCKET_ERROR;
+        }
+
+        // Resume after a partial write from where it left off
+        bytesRemaining -= status;
+        LOGF2("Wrote %zd bytes (%zu remaining)", status, bytesRemaining);
+        size_t written = (size_t)status;
+        while (iovIndex < count && written >= iov[iovIndex].iov_len) {
+            written -= iov[iovIndex].iov_len;
+            iovIndex++;
+        }
+        if (written > 0) {
+            iov[iovIndex].iov_base = (uint8_t*)iov[iovIndex].iov_base + written;
+            iov[iovIndex].iov_len -= written;
+        }
+    }
+    LOG3("Socket write completed successfully");
+    return KINETIC_STATUS_SUCCESS;
+}
+
 KineticStatus KineticSocket_WriteProtobuf(int socket, KineticPDU* pdu)
 {
     assert(pdu != NULL);
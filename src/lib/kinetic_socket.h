@@ -39,8 +39,13 @@ int KineticSocket_DataBytesAvailable(int socket);
 KineticWaitStatus KineticSocket_WaitUntilDataAvailable(int socket, int timeout);
 KineticStatus KineticSocket_Read(int socket, ByteBuffer* dest, size_t len);
 KineticStatus KineticSocket_ReadProtobuf(int socket, KineticPDU* pdu);
+KineticStatus KineticSocket_ReadBuffered(int socket, KineticReadBuffer* buffer, ByteBuffer* dest, size_t len);
+KineticStatus KineticSocket_ReadProtobufBuffered(int socket, KineticReadBuffer* buffer, KineticPDU* pdu);
+KineticStatus KineticSocket_ReadAvailable(int socket, KineticReadBuffer* buffer, size_t len);
+void KineticSocket_FreeReadBuffer(KineticReadBuffer* buffer);
 
 KineticStatus KineticSocket_Write(int socket, ByteBuffer* src);
+KineticStatus KineticSocket_WriteV(int socket, ByteBuffer* src, int count);
 KineticStatus KineticSocket_WriteProtobuf(int socket, KineticPDU* pdu);
 
 #endif // _KINETIC_SOCKET_H
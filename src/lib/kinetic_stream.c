@@ -0,0 +1,494 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_stream.h"
+#include "kinetic_batch.h"
+#include "kinetic_operation.h"
+#include "kinetic_nbo.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+// Operation applied to each chunk of a transfer
+typedef enum {
+    KINETIC_STREAM_PUT,
+    KINETIC_STREAM_GET,
+    KINETIC_STREAM_DELETE,
+} KineticStreamMode;
+
+// An in-flight chunk operation
+typedef struct _KineticStreamSlot {
+    struct _KineticStreamTransfer* transfer;
+    bool busy;
+    KineticOperation* operation;
+    int64_t chunk;
+    size_t expected;
+    KineticEntry entry;
+    KineticCompletionClosure closure;
+    uint8_t dbVersion[KINETIC_MAX_VERSION_LEN];
+    uint8_t tag[KINETIC_MAX_VERSION_LEN];
+} KineticStreamSlot;
+
+// State shared by the chunk operations of a single PUT/GET
+typedef struct _KineticStreamTransfer {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    KineticStream* stream;
+    KineticStreamMode mode;
+    int64_t chunkCount;
+    size_t chunkSize;
+    int inFlight;
+    KineticStatus status;
+    int slotCount;
+    KineticStreamSlot* slots;
+    uint8_t* keys;
+    size_t keyLen;
+} KineticStreamTransfer;
+
+static void KineticStream_Store32(uint8_t* data, uint32_t value)
+{
+    uint32_t valueNBO = KineticNBO_FromHostU32(value);
+    memcpy(data, &valueNBO, sizeof(valueNBO));
+}
+
+static uint32_t KineticStream_Load32(const uint8_t* data)
+{
+    uint32_t valueNBO;
+    memcpy(&valueNBO, data, sizeof(valueNBO));
+    return KineticNBO_ToHostU32(valueNBO);
+}
+
+void KineticStream_EncodeManifest(const KineticStreamManifest* manifest, uint8_t* data)
+{
+    assert(manifest != NULL);
+    assert(data != NULL);
+    KineticStream_Store32(&data[0], KINETIC_STREAM_MANIFEST_MAGIC);
+    KineticStream_Store32(&data[4], KINETIC_STREAM_MANIFEST_VERSION);
+    KineticStream_Store32(&data[8], (uint32_t)(manifest->length >> 32));
+    KineticStream_Store32(&data[12], (uint32_t)manifest->length);
+    KineticStream_Store32(&data[16], manifest->chunkSize);
+    KineticStream_Store32(&data[20], manifest->chunkCount);
+    KineticStream_Store32(&data[24], (uint32_t)(manifest->generation >> 32));
+    KineticStream_Store32(&data[28], (uint32_t)manifest->generation);
+}
+
+bool KineticStream_DecodeManifest(KineticStreamManifest* manifest, const ByteBuffer data)
+{
+    assert(manifest != NULL);
+    if (data.array.data == NULL || data.bytesUsed != KINETIC_STREAM_MANIFEST_LEN) {
+        return false;
+    }
+    const uint8_t* bytes = data.array.data;
+    if (KineticStream_Load32(&bytes[0]) != KINETIC_STREAM_MANIFEST_MAGIC ||
+        KineticStream_Load32(&bytes[4]) != KINETIC_STREAM_MANIFEST_VERSION) {
+        return false;
+    }
+    manifest->length = ((uint64_t)KineticStream_Load32(&bytes[8]) << 32) |
+        KineticStream_Load32(&bytes[12]);
+    manifest->chunkSize = KineticStream_Load32(&bytes[16]);
+    manifest->chunkCount = KineticStream_Load32(&bytes[20]);
+    manifest->generation = ((uint64_t)KineticStream_Load32(&bytes[24]) << 32) |
+        KineticStream_Load32(&bytes[28]);
+
+    // Reject manifests which do not describe a valid chunking of the object
+    if (manifest->chunkSize == 0 || manifest->chunkSize > KINETIC_OBJ_SIZE) {
+        return false;
+    }
+    uint64_t chunkCount = (manifest->length + manifest->chunkSize - 1) / manifest->chunkSize;
+    return (chunkCount == manifest->chunkCount);
+}
+
+bool KineticStream_ChunkKey(ByteBuffer* chunkKey, const ByteBuffer key, uint64_t generation,
+    uint32_t chunk)
+{
+    assert(chunkKey != NULL);
+    char suffix[KINETIC_STREAM_CHUNK_SUFFIX_LEN + 1];
+    snprintf(suffix, sizeof(suffix), ".%016" PRIX64 ".%08" PRIX32, generation, chunk);
+    ByteBuffer_Reset(chunkKey);
+    if (chunkKey->array.len < key.bytesUsed + KINETIC_STREAM_CHUNK_SUFFIX_LEN) {
+        return false;
+    }
+    ByteBuffer_Append(chunkKey, key.array.data, key.bytesUsed);
+    ByteBuffer_Append(chunkKey, suffix, KINETIC_STREAM_CHUNK_SUFFIX_LEN);
+    return true;
+}
+
+// Chunk keys are the object key plus a suffix, so must still fit in a key
+static bool KineticStream_ValidKey(const ByteBuffer key)
+{
+    if (key.bytesUsed > KINETIC_MAX_KEY_LEN - KINETIC_STREAM_CHUNK_SUFFIX_LEN) {
+        LOGF0("Stream key is too long (%zu bytes, up to %d allowed)!",
+            key.bytesUsed, KINETIC_MAX_KEY_LEN - KINETIC_STREAM_CHUNK_SUFFIX_LEN);
+        return false;
+    }
+    return true;
+}
+
+static void KineticStream_ChunkCompleted(KineticCompletionData* kinetic_data, void* client_data)
+{
+    KineticStreamSlot* slot = (KineticStreamSlot*)client_data;
+    KineticStreamTransfer* transfer = slot->transfer;
+    KineticStream* stream = transfer->stream;
+
+    KineticStatus status = kinetic_data->status;
+    if (status == KINETIC_STATUS_SUCCESS && transfer->mode == KINETIC_STREAM_GET &&
+        slot->entry.value.bytesUsed != slot->expected) {
+        LOGF0("Stream chunk %lld is %zu bytes, but expected %zu bytes!",
+            (long long)slot->chunk, slot->entry.value.bytesUsed, slot->expected);
+        status = KINETIC_STATUS_DATA_ERROR;
+    }
+    if (status == KINETIC_STATUS_NOT_FOUND && transfer->mode == KINETIC_STREAM_DELETE) {
+        status = KINETIC_STATUS_SUCCESS;
+    }
+
+    // Report progress before giving up the slot, since the transfer may
+    // complete, and the caller return, as soon as it is released
+    if (stream->progress != NULL && transfer->mode != KINETIC_STREAM_DELETE) {
+        stream->progress(slot->chunk, transfer->chunkCount, status, stream->clientData);
+    }
+
+    pthread_mutex_lock(&transfer->mutex);
+    if (status != KINETIC_STATUS_SUCCESS && transfer->status == KINETIC_STATUS_SUCCESS) {
+        transfer->status = status;
+    }
+    slot->busy = false;
+    slot->operation = NULL;
+    transfer->inFlight--;
+    pthread_cond_broadcast(&transfer->cond);
+    pthread_mutex_unlock(&transfer->mutex);
+}
+
+static void KineticStream_BuildChunk(KineticOperation* const operation, void* context)
+{
+    KineticStreamSlot* slot = (KineticStreamSlot*)context;
+    switch (slot->transfer->mode) {
+    case KINETIC_STREAM_PUT:
+        KineticOperation_BuildPut(operation, &slot->entry);
+        break;
+    case KINETIC_STREAM_GET:
+        KineticOperation_BuildGet(operation, &slot->entry);
+        break;
+    case KINETIC_STREAM_DELETE:
+        KineticOperation_BuildDelete(operation, &slot->entry);
+        break;
+    }
+}
+
+// Waits for a chunk in flight to complete (the mutex must be held). Chunks
+// which see no response for KINETIC_PDU_RECEIVE_TIMEOUT_SECS are abandoned,
+// which completes them with KINETIC_STATUS_SOCKET_TIMEOUT.
+static void KineticStream_AwaitChunk(KineticStreamTransfer* const transfer)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+
+    const int inFlight = transfer->inFlight;
+    while (transfer->inFlight == inFlight) {
+        int waitStatus = pthread_cond_timedwait(&transfer->cond, &transfer->mutex, &deadline);
+        if (waitStatus != ETIMEDOUT || transfer->inFlight != inFlight) {
+            continue;
+        }
+        LOGF0("Timed out waiting on %d stream chunk(s)!", inFlight);
+        for (int i = 0; i < transfer->slotCount; i++) {
+            // If the response was already claimed by the receiver, it is
+            // still using the operation, so wait for it to finish
+            KineticStreamSlot* slot = &transfer->slots[i];
+            if (slot->operation != NULL && KineticOperation_Abandon(slot->operation)) {
+                slot->operation = NULL;
+                pthread_mutex_unlock(&transfer->mutex);
+                KineticCompletionData completionData = {.status = KINETIC_STATUS_SOCKET_TIMEOUT};
+                KineticStream_ChunkCompleted(&completionData, slot);
+                pthread_mutex_lock(&transfer->mutex);
+            }
+        }
+        deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+    }
+}
+
+// Claims a free slot, waiting for one, if all are in flight. Returns NULL
+// once a chunk has failed, so that no more are started.
+static KineticStreamSlot* KineticStream_ClaimSlot(KineticStreamTransfer* const transfer)
+{
+    KineticStreamSlot* slot = NULL;
+    pthread_mutex_lock(&transfer->mutex);
+    while (transfer->inFlight == transfer->slotCount &&
+           transfer->status == KINETIC_STATUS_SUCCESS) {
+        KineticStream_AwaitChunk(transfer);
+    }
+    if (transfer->status == KINETIC_STATUS_SUCCESS) {
+        for (int i = 0; i < transfer->slotCount; i++) {
+            if (!transfer->slots[i].busy) {
+                slot = &transfer->slots[i];
+                slot->busy = true;
+                transfer->inFlight++;
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&transfer->mutex);
+    return slot;
+}
+
+// Applies the operation to each chunk of the object the manifest describes
+static KineticStatus KineticStream_Transfer(KineticConnection** const connections,
+    int count, KineticStream* const stream, KineticStreamMode mode,
+    const KineticStreamManifest* manifest)
+{
+    const uint64_t length = manifest->length;
+    const size_t chunkSize = manifest->chunkSize;
+    KineticStreamTransfer transfer = {
+        .stream = stream,
+        .mode = mode,
+        .chunkCount = manifest->chunkCount,
+        .chunkSize = chunkSize,
+        .status = KINETIC_STATUS_SUCCESS,
+        .slotCount = (stream->chunksInFlight > 0) ?
+            stream->chunksInFlight : KINETIC_STREAM_CHUNKS_IN_FLIGHT,
+        .keyLen = stream->key.bytesUsed + KINETIC_STREAM_CHUNK_SUFFIX_LEN,
+    };
+    if (transfer.chunkCount == 0) {
+        return KINETIC_STATUS_SUCCESS;
+    }
+    transfer.slots = (KineticStreamSlot*)calloc(transfer.slotCount, sizeof(KineticStreamSlot));
+    transfer.keys = (uint8_t*)malloc(transfer.slotCount * transfer.keyLen);
+    if (transfer.slots == NULL || transfer.keys == NULL) {
+        LOG0("Failed allocating stream chunk slots!");
+        free(transfer.slots);
+        free(transfer.keys);
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    pthread_mutex_init(&transfer.mutex, NULL);
+    Kinetic_InitCondition(&transfer.cond);
+    for (int i = 0; i < transfer.slotCount; i++) {
+        transfer.slots[i].transfer = &transfer;
+        transfer.slots[i].closure = (KineticCompletionClosure) {
+            .callback = KineticStream_ChunkCompleted,
+            .clientData = &transfer.slots[i],
+        };
+    }
+
+    LOGF1("Streaming %lld chunk(s) w/%d in flight", (long long)transfer.chunkCount,
+        transfer.slotCount);
+    uint8_t* data = stream->value.array.data;
+    for (int64_t chunk = 0; chunk < transfer.chunkCount; chunk++) {
+        KineticStreamSlot* slot = KineticStream_ClaimSlot(&transfer);
+        if (slot == NULL) {
+            break;
+        }
+
+        size_t offset = (size_t)chunk * chunkSize;
+        size_t len = (length - offset < chunkSize) ? (size_t)(length - offset) : chunkSize;
+        uint8_t* key = &transfer.keys[(slot - transfer.slots) * transfer.keyLen];
+        slot->chunk = chunk;
+        slot->expected = len;
+        slot->entry = (KineticEntry) {
+            .key = ByteBuffer_Create(key, transfer.keyLen, 0),
+            .synchronization = stream->synchronization,
+        };
+        bool keyed = KineticStream_ChunkKey(&slot->entry.key, stream->key,
+            manifest->generation, (uint32_t)chunk);
+        assert(keyed); (void)keyed; // (key buffers are sized for the suffix)
+        switch (mode) {
+        case KINETIC_STREAM_PUT:
+            slot->entry.value = ByteBuffer_Create(&data[offset], len, len);
+            slot->entry.algorithm = KINETIC_ALGORITHM_SHA1;
+            slot->entry.force = true;
+            break;
+        case KINETIC_STREAM_GET:
+            slot->entry.value = ByteBuffer_Create(&data[offset], len, 0);
+            slot->entry.dbVersion = ByteBuffer_Create(slot->dbVersion, sizeof(slot->dbVersion), 0);
+            slot->entry.tag = ByteBuffer_Create(slot->tag, sizeof(slot->tag), 0);
+            break;
+        case KINETIC_STREAM_DELETE:
+            slot->entry.force = true;
+            break;
+        }
+
+        // Chunks are spread across the sessions, and failures to submit
+        // are reported through the chunk closure, like any other
+        KineticStatus status = KineticOperation_Submit(connections[chunk % count], true,
+            KineticStream_BuildChunk, slot, slot->closure, &transfer.mutex, &slot->operation);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            KineticCompletionData completionData = {.status = status};
+            KineticStream_ChunkCompleted(&completionData, slot);
+        }
+    }
+
+    pthread_mutex_lock(&transfer.mutex);
+    while (transfer.inFlight > 0) {
+        KineticStream_AwaitChunk(&transfer);
+    }
+    pthread_mutex_unlock(&transfer.mutex);
+
+    pthread_cond_destroy(&transfer.cond);
+    pthread_mutex_destroy(&transfer.mutex);
+    free(transfer.slots);
+    free(transfer.keys);
+    return transfer.status;
+}
+
+// Retrieves the manifest stored at the object key, returning
+// KINETIC_STATUS_DATA_ERROR if the object is not a valid manifest
+static KineticStatus KineticStream_GetManifest(KineticConnection* const connection,
+    const ByteBuffer key, KineticStreamManifest* const manifest)
+{
+    // Key, version and tag are echoed back, so are given their own buffers
+    uint8_t keyData[KINETIC_MAX_KEY_LEN];
+    uint8_t dbVersionData[KINETIC_MAX_VERSION_LEN];
+    uint8_t tagData[KINETIC_MAX_VERSION_LEN];
+    uint8_t manifestData[KINETIC_STREAM_MANIFEST_LEN];
+    KineticEntry entry = {
+        .key = ByteBuffer_Create(keyData, sizeof(keyData), 0),
+        .dbVersion = ByteBuffer_Create(dbVersionData, sizeof(dbVersionData), 0),
+        .tag = ByteBuffer_Create(tagData, sizeof(tagData), 0),
+        .value = ByteBuffer_Create(manifestData, sizeof(manifestData), 0),
+    };
+    ByteBuffer_Append(&entry.key, key.array.data, key.bytesUsed);
+    KineticStatus status = KINETIC_STATUS_INVALID;
+    KineticBatch_Execute(connection, &entry, 1, KineticOperation_BuildGet,
+        &status, NULL, NULL);
+    if (status == KINETIC_STATUS_BUFFER_OVERRUN) {
+        LOG0("Object is too large to be a stream manifest!");
+        return KINETIC_STATUS_DATA_ERROR;
+    }
+    if (status != KINETIC_STATUS_SUCCESS) {
+        return status;
+    }
+    if (!KineticStream_DecodeManifest(manifest, entry.value)) {
+        LOG0("Object is not a valid stream manifest!");
+        return KINETIC_STATUS_DATA_ERROR;
+    }
+    return KINETIC_STATUS_SUCCESS;
+}
+
+// Each PUT keys its chunks by a new generation, taken from the clock, so
+// that it never overwrites the chunks of the object it replaces
+static uint64_t KineticStream_NewGeneration(const KineticStreamManifest* const previous)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    uint64_t generation = (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+    if (previous != NULL && generation == previous->generation) {
+        generation++;
+    }
+    return generation;
+}
+
+KineticStatus KineticStream_Put(KineticConnection** const connections, int count,
+    KineticStream* const stream)
+{
+    assert(connections != NULL);
+    assert(count > 0);
+    assert(stream != NULL);
+    assert(stream->value.array.data != NULL || stream->value.bytesUsed == 0);
+
+    if (!KineticStream_ValidKey(stream->key)) {
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+    size_t chunkSize = (stream->chunkSize > 0) ? stream->chunkSize : KINETIC_OBJ_SIZE;
+    uint64_t chunkCount = (stream->value.bytesUsed + chunkSize - 1) / chunkSize;
+    if (chunkSize > KINETIC_OBJ_SIZE || chunkCount > UINT32_MAX) {
+        LOG0("Stream chunk size or count is out of range!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    // Any object already stored at the key, which is not a stream, is
+    // simply replaced
+    KineticStreamManifest previous;
+    KineticStatus status = KineticStream_GetManifest(connections[0], stream->key, &previous);
+    bool replacing = (status == KINETIC_STATUS_SUCCESS);
+    if (!replacing && status != KINETIC_STATUS_NOT_FOUND &&
+        status != KINETIC_STATUS_DATA_ERROR) {
+        return status;
+    }
+    KineticStreamManifest manifest = {
+        .length = stream->value.bytesUsed,
+        .chunkSize = (uint32_t)chunkSize,
+        .chunkCount = (uint32_t)chunkCount,
+        .generation = KineticStream_NewGeneration(replacing ? &previous : NULL),
+    };
+
+    // Store the chunks before the manifest, under a new generation, so that
+    // readers see either the previous object or this one, but never a mix
+    status = KineticStream_Transfer(connections, count, stream, KINETIC_STREAM_PUT, &manifest);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        if (KineticStream_Transfer(connections, count, stream,
+            KINETIC_STREAM_DELETE, &manifest) != KINETIC_STATUS_SUCCESS) {
+            LOG0("Failed deleting the chunks of a failed stream PUT!");
+        }
+        return status;
+    }
+
+    uint8_t manifestData[KINETIC_STREAM_MANIFEST_LEN];
+    KineticStream_EncodeManifest(&manifest, manifestData);
+    KineticEntry entry = {
+        .key = stream->key,
+        .value = ByteBuffer_Create(manifestData, sizeof(manifestData), sizeof(manifestData)),
+        .algorithm = KINETIC_ALGORITHM_SHA1,
+        .force = true,
+        .synchronization = stream->synchronization,
+    };
+    KineticBatch_Execute(connections[0], &entry, 1, KineticOperation_BuildPut,
+        &status, NULL, NULL);
+
+    // The chunks of the replaced object are no longer referenced (readers of
+    // its manifest fail w/KINETIC_STATUS_NOT_FOUND once they are deleted).
+    // If the manifest PUT failed, it may still have been stored, so the
+    // chunks of this one are left alone.
+    if (status == KINETIC_STATUS_SUCCESS && replacing &&
+        KineticStream_Transfer(connections, count, stream,
+            KINETIC_STREAM_DELETE, &previous) != KINETIC_STATUS_SUCCESS) {
+        LOG0("Failed deleting the chunks of a replaced stream!");
+    }
+    return status;
+}
+
+KineticStatus KineticStream_Get(KineticConnection** const connections, int count,
+    KineticStream* const stream)
+{
+    assert(connections != NULL);
+    assert(count > 0);
+    assert(stream != NULL);
+
+    if (!KineticStream_ValidKey(stream->key)) {
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+    KineticStreamManifest manifest;
+    KineticStatus status = KineticStream_GetManifest(connections[0], stream->key, &manifest);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        return status;
+    }
+    if (manifest.length > stream->value.array.len) {
+        LOGF0("Stream of %llu bytes does not fit in the supplied buffer!",
+            (unsigned long long)manifest.length);
+        stream->value.bytesUsed = (size_t)manifest.length;
+        return KINETIC_STATUS_BUFFER_OVERRUN;
+    }
+
+    stream->value.bytesUsed = 0;
+    status = KineticStream_Transfer(connections, count, stream, KINETIC_STREAM_GET, &manifest);
+    if (status == KINETIC_STATUS_SUCCESS) {
+        stream->value.bytesUsed = (size_t)manifest.length;
+    }
+    return status;
+}
@@ -0,0 +1,35 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#ifndef _KINETIC_STREAM_H
+#define _KINETIC_STREAM_H
+
+#include "kinetic_types_internal.h"
+
+void KineticStream_EncodeManifest(const KineticStreamManifest* manifest, uint8_t* data);
+bool KineticStream_DecodeManifest(KineticStreamManifest* manifest, const ByteBuffer data);
+bool KineticStream_ChunkKey(ByteBuffer* chunkKey, const ByteBuffer key, uint64_t generation,
+    uint32_t chunk);
+KineticStatus KineticStream_Put(KineticConnection** const connections, int count,
+    KineticStream* const stream);
+KineticStatus KineticStream_Get(KineticConnection** const connections, int count,
+    KineticStream* const stream);
+
+#endif // _KINETIC_STREAM_H
@@ -43,6 +43,7 @@ STATIC const char* KineticStatusDescriptor[] = {
     "MEMORY_ERROR",
     "SOCKET_TIMEOUT",
     "SOCKET_ERROR",
+    "WOULD_BLOCK",
 };
 
 #ifdef TEST
@@ -296,17 +296,131 @@ bool Copy_KineticProto_Command_Range_to_ByteBufferArray(KineticProto_Command_Ran
     bool bufferOverflow = false;
     LOGF2("Copying: keyRange=0x%0llX, keys=0x%0llX, max_keys=%lld", keyRange, keys->buffers, keys->count);
     if (keyRange != NULL && keys->count > 0 && keys != NULL) {
-        for (size_t i = 0; i < MIN((size_t)keys->count, (size_t)keyRange->n_keys); i++) {
+        size_t count = MIN((size_t)keys->count, (size_t)keyRange->n_keys);
+        for (size_t i = 0; i < count; i++) {
             ByteBuffer_Reset(&keys->buffers[i]);
             if (ByteBuffer_Append(&keys->buffers[i], keyRange->keys[i].data, keyRange->keys[i].len) == NULL) {
                 LOGF2("WANRNING: Buffer overrun for keys[%zd]", i);
                 bufferOverflow = true;
             }
         }
+        keys->used = (int)count;
     }
     return !bufferOverflow;
 }
 
+static void Copy_LogName(char* dest, const char* src)
+{
+    dest[0] = '\0';
+    if (src != NULL) {
+        strncat(dest, src, KINETIC_LOG_NAME_LEN - 1);
+    }
+}
+
+void Copy_KineticProto_Command_GetLog_to_KineticDeviceLog(KineticProto_Command_GetLog* getLog, KineticDeviceLog* log)
+{
+    assert(log != NULL);
+    log->types = 0;
+    if (getLog == NULL) {
+        return;
+    }
+
+    // Entries beyond the capacity of the log are dropped
+    if (getLog->n_utilizations > 0) {
+        log->types |= KINETIC_LOG_TYPE_UTILIZATIONS;
+    }
+    log->utilizationCount = (int)MIN(getLog->n_utilizations, (size_t)KINETIC_LOG_UTILIZATIONS_MAX);
+    for (int i = 0; i < log->utilizationCount; i++) {
+        KineticProto_Command_GetLog_Utilization* utilization = getLog->utilizations[i];
+        Copy_LogName(log->utilizations[i].name, utilization->name);
+        log->utilizations[i].value = utilization->has_value ? utilization->value : 0.0f;
+    }
+
+    if (getLog->n_temperatures > 0) {
+        log->types |= KINETIC_LOG_TYPE_TEMPERATURES;
+    }
+    log->temperatureCount = (int)MIN(getLog->n_temperatures, (size_t)KINETIC_LOG_TEMPERATURES_MAX);
+    for (int i = 0; i < log->temperatureCount; i++) {
+        KineticProto_Command_GetLog_Temperature* temperature = getLog->temperatures[i];
+        Copy_LogName(log->temperatures[i].name, temperature->name);
+        log->temperatures[i].current = temperature->has_current ? temperature->current : 0.0f;
+        log->temperatures[i].minimum = temperature->has_minimum ? temperature->minimum : 0.0f;
+        log->temperatures[i].maximum = temperature->has_maximum ? temperature->maximum : 0.0f;
+        log->temperatures[i].target = temperature->has_target ? temperature->target : 0.0f;
+    }
+
+    if (getLog->capacity != NULL) {
+        log->types |= KINETIC_LOG_TYPE_CAPACITIES;
+        log->capacity = (KineticLogCapacity) {
+            .nominalCapacityInBytes = getLog->capacity->has_nominalCapacityInBytes ?
+                getLog->capacity->nominalCapacityInBytes : 0,
+            .portionFull = getLog->capacity->has_portionFull ?
+                getLog->capacity->portionFull : 0.0f,
+        };
+    }
+
+    if (getLog->n_statistics > 0) {
+        log->types |= KINETIC_LOG_TYPE_STATISTICS;
+    }
+    log->statisticCount = (int)MIN(getLog->n_statistics, (size_t)KINETIC_LOG_STATISTICS_MAX);
+    for (int i = 0; i < log->statisticCount; i++) {
+        KineticProto_Command_GetLog_Statistics* statistics = getLog->statistics[i];
+        const ProtobufCEnumValue* messageType = statistics->has_messageType ?
+            protobuf_c_enum_descriptor_get_value(
+                &KineticProto_command_message_type__descriptor, statistics->messageType) : NULL;
+        Copy_LogName(log->statistics[i].messageType,
+            (messageType != NULL) ? messageType->name : NULL);
+        log->statistics[i].count = statistics->has_count ? statistics->count : 0;
+        log->statistics[i].bytes = statistics->has_bytes ? statistics->bytes : 0;
+    }
+
+    if (getLog->limits != NULL) {
+        KineticProto_Command_GetLog_Limits* limits = getLog->limits;
+        log->types |= KINETIC_LOG_TYPE_LIMITS;
+        log->limits = (KineticLogLimits) {
+            .maxKeySize = limits->has_maxKeySize ? limits->maxKeySize : 0,
+            .maxValueSize = limits->has_maxValueSize ? limits->maxValueSize : 0,
+            .maxVersionSize = limits->has_maxVersionSize ? limits->maxVersionSize : 0,
+            .maxTagSize = limits->has_maxTagSize ? limits->maxTagSize : 0,
+            .maxConnections = limits->has_maxConnections ? limits->maxConnections : 0,
+            .maxOutstandingReadRequests = limits->has_maxOutstandingReadRequests ?
+                limits->maxOutstandingReadRequests : 0,
+            .maxOutstandingWriteRequests = limits->has_maxOutstandingWriteRequests ?
+                limits->maxOutstandingWriteRequests : 0,
+            .maxMessageSize = limits->has_maxMessageSize ? limits->maxMessageSize : 0,
+            .maxKeyRangeCount = limits->has_maxKeyRangeCount ? limits->maxKeyRangeCount : 0,
+        };
+    }
+}
+
+bool Copy_KineticProto_Command_P2POperation_to_KineticP2P_Operation(
+    KineticProto_Command_P2POperation* p2pOperation, KineticP2P_Operation* p2pOp)
+{
+    assert(p2pOp != NULL);
+    bool allSucceeded = (p2pOperation != NULL);
+
+    // Sub-operations are reported in the order they were requested
+    for (size_t i = 0; i < p2pOp->numOperations; i++) {
+        KineticStatus status = KINETIC_STATUS_INVALID;
+        if (p2pOperation != NULL && i < p2pOperation->n_operation) {
+            KineticProto_Command_Status* opStatus = p2pOperation->operation[i]->status;
+            if (opStatus != NULL && opStatus->has_code) {
+                status = KineticProtoStatusCode_to_KineticStatus(opStatus->code);
+            }
+        }
+        p2pOp->operations[i].resultStatus = status;
+        if (status != KINETIC_STATUS_SUCCESS) {
+            allSucceeded = false;
+        }
+    }
+
+    if (p2pOperation != NULL && p2pOperation->has_allChildOperationsSucceeded &&
+        !p2pOperation->allChildOperationsSucceeded) {
+        allSucceeded = false;
+    }
+    return allSucceeded;
+}
+
 int Kinetic_GetErrnoDescription(int err_num, char *buf, size_t len)
 {
     static pthread_mutex_t strerror_lock = PTHREAD_MUTEX_INITIALIZER;
@@ -321,3 +435,16 @@ int Kinetic_GetErrnoDescription(int err_num, char *buf, size_t len)
     pthread_mutex_unlock(&strerror_lock);
     return 0;
 }
+
+// Initializes a condition variable whose timed waits take CLOCK_MONOTONIC
+// deadlines, so that they are not cut short or stretched by changes to the
+// system time
+void Kinetic_InitCondition(pthread_cond_t* const cond)
+{
+    assert(cond != NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
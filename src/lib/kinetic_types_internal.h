@@ -29,12 +29,31 @@
 #include <time.h>
 #include <pthread.h>
 
-#define KINETIC_SESSIONS_MAX (20)
-#define KINETIC_PDUS_PER_SESSION_DEFAULT (2)
-#define KINETIC_PDUS_PER_SESSION_MAX (10)
+#define KINETIC_SESSIONS_MAX (256)
+#define KINETIC_POOL_DEPTH_DEFAULT (8)
 #define KINETIC_SOCKET_DESCRIPTOR_INVALID (-1)
+#define KINETIC_SOCKET_IOV_MAX (96)
+#define KINETIC_BATCH_OPERATIONS_MAX (KINETIC_SOCKET_IOV_MAX / 3) // header, protobuf and value
+#define KINETIC_READ_BUFFER_SIZE (64 * 1024)
+#define KINETIC_ARENA_SIZE_DEFAULT (4096)
+#define KINETIC_ARENA_ALIGNMENT (16)
 #define KINETIC_CONNECTION_INITIAL_STATUS_TIMEOUT_SECS (3)
 #define KINETIC_PDU_RECEIVE_TIMEOUT_SECS (5)
+#define KINETIC_REACTOR_THREADS (2)
+#define KINETIC_REACTOR_EVENTS_MAX (32)
+#define KINETIC_PENDING_OPERATIONS_BUCKETS (64) // must be a power of 2
+#define KINETIC_STREAM_MANIFEST_MAGIC (0x4B53544D) // "KSTM"
+#define KINETIC_STREAM_MANIFEST_VERSION (2)
+#define KINETIC_STREAM_MANIFEST_LEN (32)
+#define KINETIC_STREAM_CHUNK_SUFFIX_LEN (26) // '.', 16 digit hex generation, '.' and 8 digit hex chunk index
+#define KINETIC_CURSOR_READ_AHEAD_MAX (32)
+#define KINETIC_CURSOR_SEQUENTIAL_THRESHOLD (2) // steps before reading ahead
+#define KINETIC_CURSOR_KEYS_PER_PAGE (64)
+#define KINETIC_VALUE_SCAN_GETS_MAX (32)
+#define KINETIC_KEY_SCAN_SPLIT_LEN (8) // bytes beyond the common prefix used to split a scan
+#define KINETIC_HEDGE_SAMPLES (64) // recent GET latencies kept per connection
+#define KINETIC_HEDGE_SAMPLES_MIN (8) // samples needed before the delay adapts
+#define KINETIC_LATENCY_SMOOTHING_SHIFT (3) // each response moves the average 1/8 of the way
 
 // Ensure __func__ is defined (for debugging)
 #if !defined __func__
@@ -52,25 +71,31 @@
 typedef struct _KineticPDU KineticPDU;
 typedef struct _KineticOperation KineticOperation;
 typedef struct _KineticConnection KineticConnection;
+typedef struct _KineticReactor KineticReactor;
 
 
-// Kinetic list item
+// Kinetic list item (allocated in the same block as, and just ahead of, its data)
 typedef struct _KineticListItem KineticListItem;
 struct _KineticListItem {
     KineticListItem* next;
     KineticListItem* previous;
     void* data;
+    bool inUse;
 };
+#define KINETIC_LIST_ITEM_HEADER_SIZE ((sizeof(KineticListItem) + 15) & ~(size_t)15)
 
-// Kinetic list
+// Kinetic list (with a pool of released items kept for reuse)
 typedef struct _KineticList {
     KineticListItem* start;
     KineticListItem* last;
+    KineticListItem* free;
+    size_t freeCount;
     pthread_mutex_t mutex;
     bool locked;
 } KineticList;
 #define KINETIC_LIST_INITIALIZER (KineticList) { \
-    .mutex = PTHREAD_MUTEX_INITIALIZER, .locked = false, .start = NULL, .last = NULL }
+    .mutex = PTHREAD_MUTEX_INITIALIZER, .locked = false, .start = NULL, .last = NULL, \
+    .free = NULL, .freeCount = 0 }
 
 // Kinetic Thread Instance
 typedef struct _KineticThread {
@@ -81,6 +106,335 @@ typedef struct _KineticThread {
 } KineticThread;
 
 
+// Kinetic socket read-ahead buffer (unconsumed data lies between start and end)
+typedef struct _KineticReadBuffer {
+    uint8_t* data;
+    size_t size;
+    size_t start;
+    size_t end;
+} KineticReadBuffer;
+
+// Bump allocator for unpacked protobufs (allocations are released in bulk)
+typedef struct _KineticArena {
+    uint8_t* data;
+    size_t size;
+    size_t used;
+    void* overflow;         // chunks allocated once data was exhausted
+    size_t overflowSize;
+} KineticArena;
+
+// Prepared HMAC-SHA1 key (digest states after absorbing the ipad/opad blocks)
+typedef struct _KineticHMACKey {
+    SHA_CTX inner;
+    SHA_CTX outer;
+    bool prepared;
+} KineticHMACKey;
+
+// Large object stream manifest, stored at the object key
+typedef struct _KineticStreamManifest {
+    uint64_t length;        // object length
+    uint32_t chunkSize;     // length of each chunk, but the last
+    uint32_t chunkCount;    // number of chunk objects
+    uint64_t generation;    // generation in the chunk keys of this write
+} KineticStreamManifest;
+
+// Page of keys retrieved by a key range iterator
+typedef struct _KineticKeyPage {
+    struct _KineticKeyIterator* iterator;
+    KineticKeyRange range;          // range requested for this page
+    uint8_t startKey[KINETIC_MAX_KEY_LEN];
+    uint8_t endKey[KINETIC_MAX_KEY_LEN];
+    ByteBufferArray keys;           // keys retrieved (keys.used are valid)
+    uint8_t* keyData;               // storage for keys
+    KineticOperation* operation;    // GETKEYRANGE operation in flight, if any
+    bool requested;                 // page requested, but not yet consumed
+    KineticStatus status;
+} KineticKeyPage;
+
+// Kinetic key range iterator, which consumes one page while the next page
+// is in flight
+struct _KineticKeyIterator {
+    KineticConnection* connection;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;            // signalled as each page arrives
+    KineticKeyPage pages[2];
+    int current;                    // page being consumed
+    int next;                       // index of next key in the current page
+    KineticStatus status;           // first failure, which ends the iteration
+};
+
+// Slot of a cursor or value scan, holding an entry being retrieved, or not
+// yet consumed
+typedef struct _KineticCursorSlot {
+    void* owner;                    // cursor or value scan
+    KineticEntry entry;
+    uint8_t keyData[KINETIC_MAX_KEY_LEN];
+    uint8_t versionData[KINETIC_MAX_VERSION_LEN];
+    uint8_t tagData[KINETIC_MAX_VERSION_LEN];
+    uint8_t* valueData;             // KINETIC_OBJ_SIZE bytes, allocated upon first use
+    KineticOperation* operation;    // GET operation in flight, if any
+    KineticStatus status;
+} KineticCursorSlot;
+
+// Kinetic cursor, which steps with GETNEXT/GETPREVIOUS until it sees
+// sequential access, then keeps up to readAhead GETs in flight for the keys
+// listed by a key iterator
+struct _KineticCursor {
+    KineticConnection* connection;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;            // signalled as each entry arrives
+    uint8_t positionData[KINETIC_MAX_KEY_LEN];
+    ByteBuffer position;            // key last consumed (or sought)
+    bool reverse;                   // walk in descending key order
+    int readAhead;                  // entries in flight once sequential
+    int steps;                      // entries consumed since opened/sought
+    KineticKeyIterator* keys;       // keys to read ahead (once sequential)
+    bool keysExhausted;             // no more keys to read ahead
+    KineticCursorSlot* slots;       // ring of readAhead slots
+    int head;                       // oldest slot in use
+    int used;                       // number of slots in use
+};
+
+// Kinetic value scan, which keeps GETs in flight for the keys listed by a
+// key range iterator, reporting each entry as it arrives
+typedef struct _KineticValueScan {
+    KineticConnection* connection;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;            // signalled as each slot is freed
+    KineticValueScanCallback callback;
+    void* clientData;
+    KineticStatus status;           // first failure, which ends the scan
+    int count;                      // number of slots
+    KineticCursorSlot slots[KINETIC_VALUE_SCAN_GETS_MAX];
+} KineticValueScan;
+
+// Kinetic device log poller, which periodically refreshes a snapshot of the
+// device log on its connection from a background thread
+typedef struct _KineticLogPoller {
+    KineticConnection* connection;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;            // signalled upon stop, and as each poll completes
+    bool running;                   // cleared to stop the thread
+    int types;                      // KineticLogType flags to request
+    int intervalMillis;             // delay between polls
+    KineticOperation* operation;    // GETLOG operation in flight, if any
+    struct timespec sent;           // time the GETLOG in flight was sent
+    KineticDeviceLog staging;       // decoded into by the GETLOG in flight
+    KineticDeviceLog snapshot;      // most recently received device log
+    bool hasSnapshot;
+    KineticStatus status;           // outcome of the most recent poll
+} KineticLogPoller;
+
+// Write (or barrier) awaiting durability by a group commit
+typedef struct _KineticGroupCommitWrite {
+    struct _KineticGroupCommit* groupCommit;
+    struct _KineticGroupCommitWrite* next;
+    struct _KineticGroupCommitWrite* previous; // (only while writing)
+    KineticEntry* entry;            // entry being written (only while writing)
+    KineticOperation* operation;    // PUT operation in flight (once sent)
+    struct timespec sent;           // time the PUT was sent
+    KineticCompletionClosure closure; // called upon completion (if asynchronous)
+    KineticStatus status;
+    bool done;                      // completed (synchronous callers only)
+} KineticGroupCommitWrite;
+
+// Kinetic group commit, which sends puts WRITEBACK and completes them once a
+// FLUSHALLDATA, shared by all writes acknowledged before it, has succeeded
+typedef struct _KineticGroupCommit {
+    KineticConnection* connection;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;            // signalled upon stop, and as writes progress
+    bool running;                   // cleared to stop the thread
+    int writesPerFlush;             // waiting writes which trigger a flush
+    int delayMillis;                // maximum delay before flushing a write
+    KineticGroupCommitWrite* writing;  // PUTs in flight
+    KineticGroupCommitWrite* waiting;  // acknowledged, awaiting the next flush
+    int waitingCount;
+    struct timespec waitingSince;   // time the first waiting write was acknowledged
+    bool barrierRequested;          // flush waiting writes without delay
+    KineticGroupCommitWrite* flushing; // covered by the FLUSHALLDATA in flight
+    KineticOperation* operation;    // FLUSHALLDATA operation in flight, if any
+    struct timespec sent;           // time the FLUSHALLDATA in flight was sent
+    int active;                     // writes allocated, but not yet released
+    KineticGroupCommitWrite* free;  // released writes kept for reuse
+} KineticGroupCommit;
+
+// Kinetic session pool, which spreads the operations of a session handle
+// across several connections to the same device
+typedef struct _KineticSessionPool {
+    pthread_mutex_t mutex;          // protects next and released
+    pthread_cond_t windowCond;      // signaled as operations leave the window of any member
+    int released;                   // operations which have left the window of any member
+    KineticPoolPolicy policy;
+    int count;                      // connections, including the primary
+    KineticConnection* members[KINETIC_SESSION_CONNECTIONS_MAX]; // primary first
+    KineticSessionHandle handles[KINETIC_SESSION_CONNECTIONS_MAX]; // of the other members
+    int next;                       // member to start the next selection at
+} KineticSessionPool;
+
+// Kinetic cluster drive, which owns KINETIC_CLUSTER_VIRTUAL_NODES points on
+// the hash ring, placed by the identity of the drive alone
+typedef struct _KineticClusterDrive {
+    KineticSessionHandle handle;
+    KineticConnection* connection;
+    uint64_t id;                    // hash of the drive host and port
+    int users;                      // requests being routed to the drive
+} KineticClusterDrive;
+
+typedef struct _KineticClusterPoint {
+    uint64_t hash;
+    int drive;                      // index of the owning drive
+} KineticClusterPoint;
+
+// Kinetic cluster, routing each key to the drive owning the first point on the
+// hash ring at or after the hash of the key, so that a change of membership
+// only moves the keys of the points gained or lost
+struct _KineticCluster {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;            // signalled as requests stop using a drive
+    int count;
+    KineticClusterDrive drives[KINETIC_CLUSTER_DRIVES_MAX];
+    int pointCount;
+    KineticClusterPoint* points;    // sorted by hash
+};
+
+// Sessions a request may be fanned out to, as replicas or erasure fragments
+#define KINETIC_FAN_OUT_MAX ((KINETIC_REPLICAS_MAX > KINETIC_ERASURE_FRAGMENTS_MAX) ? \
+    KINETIC_REPLICAS_MAX : KINETIC_ERASURE_FRAGMENTS_MAX)
+
+// Member of a fan-out, sending the entry to one session, with buffers of its
+// own for the versions and tag
+typedef struct _KineticFanOutMember {
+    struct _KineticFanOut* fanOut;
+    KineticConnection* connection;
+    KineticEntry entry;
+    uint8_t versionData[KINETIC_MAX_VERSION_LEN];
+    uint8_t newVersionData[KINETIC_MAX_VERSION_LEN];
+    uint8_t tagData[KINETIC_MAX_VERSION_LEN];
+    KineticOperation* operation;    // request in flight, if any
+    bool done;
+    KineticStatus status;
+} KineticFanOutMember;
+
+// What sets apart each kind of fan-out, called with its mutex held unless
+// noted otherwise
+typedef struct _KineticFanOutPolicy {
+    const char* member;             // what a member is called, when logged
+    // Checks the outcome of a member, which may be replaced, returning true
+    // if it counts towards completing the caller
+    bool (*check)(KineticFanOutMember* const member, KineticStatus* const status);
+    // Returns true if the caller may be completed, with the status given
+    bool (*decide)(struct _KineticFanOut* const fanOut, KineticStatus* const status);
+    // Releases the fan-out, once nothing refers to it (the mutex is not held)
+    void (*release)(struct _KineticFanOut* const fanOut);
+} KineticFanOutPolicy;
+
+// Kinetic fan-out, which sends an entry to several sessions, completing the
+// caller once its policy decides, while the rest finish in the background.
+// Released once the last member is done.
+typedef struct _KineticFanOut {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;            // signalled as members respond
+    const KineticFanOutPolicy* policy;
+    bool reading;
+    int count;
+    int succeeded;                  // members counted by the policy
+    int failed;
+    KineticStatus failure;          // first failure
+    int references;                 // members (and anything else) not yet done, plus the caller
+    bool submitted;                 // all requests have been sent
+    bool completed;                 // the caller has been completed
+    KineticStatus status;           // status reported to the caller
+    KineticEntry* entry;            // caller's entry (until completed)
+    KineticCompletionClosure closure;
+    uint8_t keyData[KINETIC_MAX_KEY_LEN];
+    KineticFanOutMember* members[KINETIC_FAN_OUT_MAX];
+} KineticFanOut;
+
+// Replica of a replicated entry, with a buffer of its own for the value
+// retrieved by a GET (which is also the source of a repair)
+typedef struct _KineticReplica {
+    KineticFanOutMember member;
+    uint8_t* valueData;             // GET only
+} KineticReplica;
+
+// Kinetic replication, which completes the caller once a quorum of replicas
+// has responded. Released once the last replica (and any repair) is done.
+typedef struct _KineticReplication {
+    KineticFanOut fanOut;
+    int quorum;
+    bool repaired;                  // read-repair has been issued
+    KineticReplica replicas[KINETIC_REPLICAS_MAX];
+} KineticReplication;
+
+// Fragment of an erasure-coded entry, stored under the entry key on a
+// session of its own
+typedef struct _KineticErasureFragment {
+    KineticFanOutMember member;
+    bool valid;                     // GET only, retrieved a fragment of the entry
+    uint32_t length;                // GET only, value length of the version retrieved
+} KineticErasureFragment;
+
+// Kinetic erasure coding, which splits an entry into data fragments and
+// Reed-Solomon parity fragments, one per session. A PUT completes once every
+// fragment is stored, and a GET once any dataFragments of the same version
+// have arrived. Released once the last fragment is done.
+typedef struct _KineticErasure {
+    KineticFanOut fanOut;
+    int dataFragments;
+    int parityFragments;
+    uint32_t length;                // length of the entry value
+    size_t fragmentSize;            // header, plus a share of the value
+    uint8_t* buffer;                // fragments, fragmentSize bytes each
+    KineticErasureFragment* reference; // GET only, fragment of the version decoded
+    KineticErasureFragment fragments[KINETIC_ERASURE_FRAGMENTS_MAX];
+} KineticErasure;
+
+// Recent GET latencies of a connection, which set the delay before a GET is
+// hedged with another replica
+typedef struct _KineticLatencyHistory {
+    pthread_mutex_t mutex;
+    uint32_t samples[KINETIC_HEDGE_SAMPLES]; // microseconds, oldest overwritten first
+    int count;                      // samples recorded (up to KINETIC_HEDGE_SAMPLES)
+    int next;                       // sample to overwrite next
+} KineticLatencyHistory;
+
+// GET of a hedged entry from one replica, with buffers of its own for the
+// entry retrieved
+typedef struct _KineticHedgeRequest {
+    struct _KineticHedge* hedge;
+    KineticConnection* connection;
+    KineticEntry entry;
+    uint8_t versionData[KINETIC_MAX_VERSION_LEN];
+    uint8_t tagData[KINETIC_MAX_VERSION_LEN];
+    uint8_t* valueData;
+    KineticOperation* operation;    // request in flight, if any
+    struct timespec sent;
+} KineticHedgeRequest;
+
+// Kinetic hedged GET, which sends the GET to the next replica each time the
+// last one has not responded within its usual latency, completing the caller
+// with the first response. Released once the last request is done.
+typedef struct _KineticHedge {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;            // signalled upon completion
+    int count;                      // replicas which may be asked
+    int issued;                     // requests issued so far
+    int failed;
+    KineticStatus failure;          // first failure
+    int references;                 // requests not yet done, the timer, and the caller
+    bool completed;                 // the caller has been completed
+    KineticStatus status;           // status reported to the caller
+    KineticEntry* entry;            // caller's entry (until completed)
+    KineticCompletionClosure closure;
+    struct timespec deadline;       // when to hedge with the next replica
+    struct _KineticHedge* next;     // next hedge due on the timer
+    uint8_t keyData[KINETIC_MAX_KEY_LEN];
+    KineticHedgeRequest requests[KINETIC_REPLICAS_MAX];
+} KineticHedge;
+
 // Kinetic Device Client Connection
 struct _KineticConnection {
     bool            connected;      // state of connection
@@ -92,13 +446,36 @@ struct _KineticConnection {
     KineticSession  session;        // session configuration
     KineticThread   thread;         // worker thread instance struct
     pthread_t       threadID;       // worker pthread
+    KineticReactor* reactor;        // shared reactor servicing this connection (if any)
+    pthread_mutex_t pendingMutex;   // protects the in-flight operation table
+    KineticOperation* pending[KINETIC_PENDING_OPERATIONS_BUCKETS]; // in-flight operations by sequence
+    int             inFlight;       // requests sent and awaiting their responses
+    uint32_t        latency;        // smoothed response latency in microseconds (0 until measured)
+    pthread_mutex_t sendMutex;      // serializes packing and sending of request PDUs
+    uint8_t*        packBuffer;     // reusable buffer for packed outbound protobufs
+    size_t          packBufferSize; // allocated size of packBuffer
+    KineticReadBuffer readBuffer;   // data received from socket, but not yet parsed
+    KineticHMACKey  hmacKey;        // session HMAC key, prepared for signing/validation
+    pthread_mutex_t windowMutex;    // protects outstanding and memberOf
+    pthread_cond_t  windowCond;     // signaled as operations leave the in-flight window
+    int             outstanding;    // operations admitted into the in-flight window
+    KineticSessionPool* memberOf;   // pool this connection belongs to (if pooled)
+    KineticLogPoller* logPoller;    // background device log poller (if started)
+    KineticGroupCommit* groupCommit; // group commit of durable puts (if started)
+    KineticSessionPool* pool;       // connections sharing this handle (if pooled)
+    KineticLatencyHistory getLatency; // recent hedged GET latencies
 };
 #define KINETIC_CONNECTION_INIT(_con) { (*_con) = (KineticConnection) { \
         .connected = false, \
         .socket = -1, \
         .operations = KINETIC_LIST_INITIALIZER, \
         .pdus = KINETIC_LIST_INITIALIZER, \
+        .pendingMutex = PTHREAD_MUTEX_INITIALIZER, \
+        .sendMutex = PTHREAD_MUTEX_INITIALIZER, \
+        .windowMutex = PTHREAD_MUTEX_INITIALIZER, \
+        .getLatency.mutex = PTHREAD_MUTEX_INITIALIZER, \
     }; \
+    Kinetic_InitCondition(&(_con)->windowCond); \
 }
 
 
@@ -127,6 +504,10 @@ typedef struct _KineticMessage {
     KineticProto_Command_Security_ACL   acl;
     KineticProto_Command_KeyValue       keyValue;
     KineticProto_Command_Range          keyRange;
+    KineticProto_Command_GetLog         getLog;
+    KineticProto_Command_GetLog_Type    getLogTypes[5];
+    KineticProto_Command_P2POperation   p2pOperation;
+    KineticProto_Command_P2POperation_Peer p2pPeer;
 } KineticMessage;
 
 #define KINETIC_MESSAGE_AUTH_HMAC_INIT(_msg, _identity, _hmac) { \
@@ -174,6 +555,9 @@ typedef struct _KineticMessage {
     KineticProto_command_body__init(&(msg)->body); \
     KineticProto_command_key_value__init(&(msg)->keyValue); \
     KineticProto_command_range__init(&(msg)->keyRange); \
+    KineticProto_command_get_log__init(&(msg)->getLog); \
+    KineticProto_command_p2_poperation__init(&(msg)->p2pOperation); \
+    KineticProto_command_p2_poperation_peer__init(&(msg)->p2pPeer); \
     KINETIC_MESSAGE_AUTH_HMAC_INIT(msg, 0, BYTE_ARRAY_NONE); \
     (msg)->has_command = false; \
 }
@@ -212,8 +596,9 @@ struct _KineticPDU {
         KineticMessage message;
     } protoData;        // Proto will always be first
     KineticProto_Message* proto;
-    bool protobufDynamicallyExtracted;
+    bool protobufDynamicallyExtracted; // proto/command were unpacked into arena
     KineticProto_Command* command;
+    KineticArena arena;
 
     // Embedded HMAC instance
     KineticHMAC hmac;
@@ -260,15 +645,24 @@ struct _KineticOperation {
     bool valueEnabled;
     bool sendValue;
     bool receiveComplete;
+    pthread_mutex_t receiveMutex;
+    pthread_cond_t receiveCond;
     KineticEntry* entry;
     ByteBufferArray* buffers;
+    KineticDeviceLog* deviceLog;
+    KineticP2P_Operation* p2pOp;
     KineticOperationCallback callback;
+    bool callbackOnFailure; // callback also inspects responses reporting failure
     KineticCompletionClosure closure;
+    KineticOperation* nextPending;
+    struct timespec sent; // when registered as in-flight (CLOCK_MONOTONIC), for measuring latency
 };
 #define KINETIC_OPERATION_INIT(_op, _con) \
     assert((_op) != NULL); \
     assert((_con) != NULL); \
-    *(_op) = (KineticOperation) {.connection = (_con)}
+    *(_op) = (KineticOperation) {.connection = (_con), \
+        .receiveMutex = PTHREAD_MUTEX_INITIALIZER}; \
+    Kinetic_InitCondition(&(_op)->receiveCond)
 
 
 KineticProto_Command_Algorithm KineticProto_Command_Algorithm_from_KineticAlgorithm(
@@ -291,6 +685,11 @@ bool Copy_KineticProto_Command_KeyValue_to_KineticEntry(
     KineticProto_Command_KeyValue* keyValue, KineticEntry* entry);
 bool Copy_KineticProto_Command_Range_to_ByteBufferArray(
     KineticProto_Command_Range* keyRange, ByteBufferArray* keys);
+void Copy_KineticProto_Command_GetLog_to_KineticDeviceLog(
+    KineticProto_Command_GetLog* getLog, KineticDeviceLog* log);
+bool Copy_KineticProto_Command_P2POperation_to_KineticP2P_Operation(
+    KineticProto_Command_P2POperation* p2pOperation, KineticP2P_Operation* p2pOp);
 int Kinetic_GetErrnoDescription(int err_num, char *buf, size_t len);
+void Kinetic_InitCondition(pthread_cond_t* const cond);
 
 #endif // _KINETIC_TYPES_INTERNAL_H
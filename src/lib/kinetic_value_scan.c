@@ -0,0 +1,178 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_value_scan.h"
+#include "kinetic_key_iterator.h"
+#include "kinetic_cursor.h"
+#include "kinetic_logger.h"
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+// Records the first failure, which ends the scan (the scan mutex is held)
+static void KineticValueScan_Fail(KineticValueScan* const scan, KineticStatus status)
+{
+    if (scan->status == KINETIC_STATUS_SUCCESS) {
+        LOGF1("Value scan failed w/status: %s", Kinetic_GetStatusDescription(status));
+        scan->status = status;
+    }
+}
+
+static void KineticValueScan_EntryReceived(KineticCompletionData* kinetic_data, void* client_data)
+{
+    KineticCursorSlot* slot = (KineticCursorSlot*)client_data;
+    KineticValueScan* scan = (KineticValueScan*)slot->owner;
+
+    // Report the entry before freeing the slot, since the entry is in it.
+    // Keys deleted since they were listed are skipped.
+    if (kinetic_data->status == KINETIC_STATUS_SUCCESS) {
+        scan->callback(&slot->entry, scan->clientData);
+    }
+
+    pthread_mutex_lock(&scan->mutex);
+    if (kinetic_data->status != KINETIC_STATUS_SUCCESS &&
+        kinetic_data->status != KINETIC_STATUS_NOT_FOUND) {
+        KineticValueScan_Fail(scan, kinetic_data->status);
+    }
+    slot->operation = NULL;
+    pthread_cond_broadcast(&scan->cond);
+    pthread_mutex_unlock(&scan->mutex);
+}
+
+// Gives up on any GETs still in flight, once no response has arrived within
+// KINETIC_PDU_RECEIVE_TIMEOUT_SECS (the scan mutex is held)
+static void KineticValueScan_Timeout(KineticValueScan* const scan)
+{
+    for (int i = 0; i < scan->count; i++) {
+        if (KineticCursor_AbandonSlot(&scan->slots[i])) {
+            LOG0("Timed out waiting for scanned entry!");
+            KineticValueScan_Fail(scan, KINETIC_STATUS_SOCKET_TIMEOUT);
+        }
+    }
+}
+
+// Waits for a free slot, or for all slots to be free if 'all' is set
+static KineticCursorSlot* KineticValueScan_AwaitSlot(KineticValueScan* const scan, bool all)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+
+    pthread_mutex_lock(&scan->mutex);
+    KineticCursorSlot* slot = NULL;
+    while (true) {
+        int pending = 0;
+        slot = NULL;
+        for (int i = 0; i < scan->count; i++) {
+            if (scan->slots[i].operation != NULL) {
+                pending++;
+            }
+            else if (slot == NULL) {
+                slot = &scan->slots[i];
+            }
+        }
+        if (all ? (pending == 0) : (slot != NULL)) {
+            break;
+        }
+        if (pthread_cond_timedwait(&scan->cond, &scan->mutex, &deadline) == ETIMEDOUT) {
+            KineticValueScan_Timeout(scan);
+            deadline.tv_sec += KINETIC_PDU_RECEIVE_TIMEOUT_SECS;
+        }
+    }
+    pthread_mutex_unlock(&scan->mutex);
+    return slot;
+}
+
+KineticStatus KineticValueScan_Execute(KineticConnection* const connection,
+    const KineticKeyRange* range, int getsInFlight,
+    KineticValueScanCallback callback, void* clientData)
+{
+    assert(connection != NULL);
+    assert(range != NULL);
+    if (getsInFlight == 0) {
+        getsInFlight = KINETIC_VALUE_SCAN_GETS_IN_FLIGHT;
+    }
+    if (callback == NULL || getsInFlight < 0 || getsInFlight > KINETIC_VALUE_SCAN_GETS_MAX) {
+        LOG0("Invalid value scan specified!");
+        return KINETIC_STATUS_INVALID_REQUEST;
+    }
+
+    KineticKeyIterator* keys = NULL;
+    KineticStatus status = KineticKeyIterator_Open(connection, range, &keys);
+    if (status != KINETIC_STATUS_SUCCESS) {
+        return status;
+    }
+    KineticValueScan* scan = (KineticValueScan*)calloc(1, sizeof(KineticValueScan));
+    if (scan == NULL) {
+        LOG0("Failed allocating value scan!");
+        KineticKeyIterator_Close(keys);
+        return KINETIC_STATUS_MEMORY_ERROR;
+    }
+    scan->connection = connection;
+    scan->callback = callback;
+    scan->clientData = clientData;
+    scan->status = KINETIC_STATUS_SUCCESS;
+    scan->count = getsInFlight;
+    pthread_mutex_init(&scan->mutex, NULL);
+    Kinetic_InitCondition(&scan->cond);
+    for (int i = 0; i < scan->count; i++) {
+        scan->slots[i].owner = scan;
+    }
+
+    // Request each key as it is listed, once a slot is free, until the
+    // range is exhausted or a request fails
+    while (true) {
+        KineticCursorSlot* slot = KineticValueScan_AwaitSlot(scan, false);
+        pthread_mutex_lock(&scan->mutex);
+        status = scan->status;
+        pthread_mutex_unlock(&scan->mutex);
+        if (status != KINETIC_STATUS_SUCCESS) {
+            break;
+        }
+
+        KineticCompletionClosure closure = {
+            .callback = KineticValueScan_EntryReceived,
+            .clientData = slot,
+        };
+        status = KineticCursor_FillSlot(connection, keys, slot, closure, &scan->mutex);
+        if (status == KINETIC_STATUS_NOT_FOUND) {
+            break;
+        }
+        if (status != KINETIC_STATUS_SUCCESS) {
+            pthread_mutex_lock(&scan->mutex);
+            KineticValueScan_Fail(scan, status);
+            pthread_mutex_unlock(&scan->mutex);
+            break;
+        }
+    }
+
+    // Entries still in flight reference the slots, so must be retired
+    KineticValueScan_AwaitSlot(scan, true);
+    KineticKeyIterator_Close(keys);
+    status = scan->status;
+    for (int i = 0; i < scan->count; i++) {
+        free(scan->slots[i].valueData);
+    }
+    pthread_cond_destroy(&scan->cond);
+    pthread_mutex_destroy(&scan->mutex);
+    free(scan);
+    return status;
+}
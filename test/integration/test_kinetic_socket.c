@@ -22,6 +22,7 @@
 #include "kinetic_types.h"
 #include "kinetic_types_internal.h"
 #include "kinetic_socket.h"
+#include "kinetic_arena.h"
 #include "kinetic_logger.h"
 #include "kinetic_proto.h"
 #include "kinetic_message.h"
@@ -255,6 +256,35 @@ void test_KineticSocket_Read_should_read_up_to_the_array_length_into_the_buffer_
 
 
 
+void test_KineticSocket_ReadBuffered_should_satisfy_successive_reads_from_a_single_socket_read(void)
+{
+    LOG_LOCATION;
+    KineticReadBuffer readBuffer = {.data = NULL};
+    uint8_t respData[16];
+    ByteBuffer respBuffer = ByteBuffer_Create(respData, sizeof(respData), 0);
+
+    FileDesc = KineticSocket_Connect("localhost", KineticTestPort, true);
+    TEST_ASSERT_TRUE_MESSAGE(FileDesc >= 0, "File descriptor invalid");
+
+    Socket_RequestBytes(15);
+
+    KineticStatus status = KineticSocket_ReadBuffered(FileDesc, &readBuffer, &respBuffer, 5);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(5, respBuffer.bytesUsed);
+    TEST_ASSERT_EQUAL_MESSAGE(10, readBuffer.end - readBuffer.start,
+        "Remaining bytes should have been read ahead into the buffer");
+
+    ByteBuffer_Reset(&respBuffer);
+    status = KineticSocket_ReadBuffered(FileDesc, &readBuffer, &respBuffer, 10);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(10, respBuffer.bytesUsed);
+    TEST_ASSERT_EQUAL(0, readBuffer.end - readBuffer.start);
+
+    KineticSocket_FreeReadBuffer(&readBuffer);
+    TEST_ASSERT_NULL(readBuffer.data);
+}
+
+
 void test_KineticSocket_ReadProtobuf_should_read_the_specified_length_of_an_encoded_protobuf_from_the_specified_socket(void)
 {
     LOG_LOCATION;
@@ -292,7 +322,7 @@ void test_KineticSocket_ReadProtobuf_should_read_the_specified_length_of_an_enco
     // LOGF0("    header: (0x%zX)", (size_t)PDU.command->header);
     // LOGF0("      identity: %016llX",
     //      (unsigned long long)PDU.command->header->identity);
-    KineticProto_Message__free_unpacked(PDU.proto, NULL);
+    KineticArena_Free(&PDU.arena);
     // ByteArray hmacArray = {
     //     .data = PDU.proto->hmac.data, .len = PDU.proto->hmac.len
     // };
@@ -0,0 +1,113 @@
+/*
+* kinetic-c-client
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#ifndef _OPERATION_TEST_FIXTURE
+#define _OPERATION_TEST_FIXTURE
+
+// Fixture for modules submitting asynchronous requests via
+// KineticOperation_Submit, to be included after mock_kinetic_operation.h.
+// FakeSubmit hands each expected submission the next of the operations
+// supplied, building and recording it as the real submission does, so a test
+// can play the part of the receiver by completing its closure.
+
+#include <pthread.h>
+#include <time.h>
+
+#define MAX_EXPECTED_SUBMISSIONS (16)
+
+typedef struct _ExpectedSubmission {
+    KineticConnection* connection;
+    bool wait;              // waits for room in the window, if full
+    KineticStatus status;   // reported, and the operation not sent, if a failure
+} ExpectedSubmission;
+
+static KineticOperation* SubmittedOperations;
+static ExpectedSubmission ExpectedSubmissions[MAX_EXPECTED_SUBMISSIONS];
+static int ExpectedSubmissionCount;
+static int SubmissionCount;
+
+static KineticStatus FakeSubmit(KineticConnection* const connection, bool wait,
+    KineticOperationBuilder build, void* context, KineticCompletionClosure closure,
+    pthread_mutex_t* const mutex, KineticOperation** const submitted, int cmock_num_calls)
+{
+    TEST_ASSERT_TRUE_MESSAGE(cmock_num_calls < ExpectedSubmissionCount,
+        "Unexpected submission of an operation!");
+    ExpectedSubmission* expected = &ExpectedSubmissions[cmock_num_calls];
+    SubmissionCount = cmock_num_calls + 1;
+    TEST_ASSERT_EQUAL_PTR(expected->connection, connection);
+    TEST_ASSERT_EQUAL(expected->wait, wait);
+    if (expected->status != KINETIC_STATUS_SUCCESS) {
+        return expected->status;
+    }
+
+    // Record the operation, and then complete its closure, which the test
+    // awaits to respond, as sending the request would
+    KineticOperation* operation = &SubmittedOperations[cmock_num_calls];
+    build(operation, context);
+    pthread_mutex_lock(mutex);
+    *submitted = operation;
+    operation->closure.clientData = closure.clientData;
+    pthread_mutex_unlock(mutex);
+    operation->closure.callback = closure.callback;
+    return KINETIC_STATUS_SUCCESS;
+}
+
+// Submissions are handed operations[0], operations[1], ... in turn
+static inline void SubmitOperations(KineticOperation* operations)
+{
+    SubmittedOperations = operations;
+    ExpectedSubmissionCount = 0;
+    SubmissionCount = 0;
+    KineticOperation_Submit_StubWithCallback(FakeSubmit);
+}
+
+static inline void ExpectSubmit(KineticConnection* connection, bool wait, KineticStatus status)
+{
+    TEST_ASSERT_TRUE(ExpectedSubmissionCount < MAX_EXPECTED_SUBMISSIONS);
+    ExpectedSubmissions[ExpectedSubmissionCount++] = (ExpectedSubmission) {
+        .connection = connection,
+        .wait = wait,
+        .status = status,
+    };
+}
+
+// Waits for the operation to be submitted, when submitted on another thread
+static inline void AwaitSubmitted(KineticOperation* operation)
+{
+    volatile KineticCompletionCallback* callback = &operation->closure.callback;
+    while (*callback == NULL) {
+        nanosleep(&(struct timespec) {.tv_nsec = 1000000}, NULL);
+    }
+}
+
+// Plays the part of the receiver, completing the operation with the status given
+static inline void CompleteOperation(KineticOperation* operation, KineticStatus status)
+{
+    KineticCompletionData completionData = {.status = status};
+    operation->closure.callback(&completionData, operation->closure.clientData);
+}
+
+static inline void VerifySubmissions(void)
+{
+    TEST_ASSERT_EQUAL_MESSAGE(ExpectedSubmissionCount, SubmissionCount,
+        "Expected submission of an operation not made!");
+}
+
+#endif // _OPERATION_TEST_FIXTURE
@@ -23,6 +23,24 @@
 #include "kinetic_operation.h"
 #include "kinetic_hmac.h"
 #include "kinetic_connection.h"
+#include "kinetic_reactor.h"
+#include "kinetic_arena.h"
+#include "kinetic_batch.h"
+#include "kinetic_stream.h"
+#include "kinetic_key_iterator.h"
+#include "kinetic_cursor.h"
+#include "kinetic_key_scan.h"
+#include "kinetic_value_scan.h"
+#include "kinetic_log_poller.h"
+#include "kinetic_group_commit.h"
+#include "kinetic_session_pool.h"
+#include "kinetic_cluster.h"
+#include "kinetic_entry.h"
+#include "kinetic_fan_out.h"
+#include "kinetic_replication.h"
+#include "kinetic_reed_solomon.h"
+#include "kinetic_erasure.h"
+#include "kinetic_hedge.h"
 #include "kinetic_socket.h"
 #include "kinetic_nbo.h"
 #include "protobuf-c/protobuf-c.h"
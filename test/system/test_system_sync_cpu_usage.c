@@ -0,0 +1,160 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_client.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_proto.h"
+#include "kinetic_allocator.h"
+#include "kinetic_message.h"
+#include "kinetic_pdu.h"
+#include "kinetic_logger.h"
+#include "kinetic_operation.h"
+#include "kinetic_hmac.h"
+#include "kinetic_connection.h"
+#include "kinetic_reactor.h"
+#include "kinetic_arena.h"
+#include "kinetic_batch.h"
+#include "kinetic_stream.h"
+#include "kinetic_key_iterator.h"
+#include "kinetic_cursor.h"
+#include "kinetic_key_scan.h"
+#include "kinetic_value_scan.h"
+#include "kinetic_log_poller.h"
+#include "kinetic_group_commit.h"
+#include "kinetic_session_pool.h"
+#include "kinetic_cluster.h"
+#include "kinetic_entry.h"
+#include "kinetic_fan_out.h"
+#include "kinetic_replication.h"
+#include "kinetic_reed_solomon.h"
+#include "kinetic_erasure.h"
+#include "kinetic_hedge.h"
+#include "kinetic_socket.h"
+#include "kinetic_nbo.h"
+
+#include "byte_array.h"
+#include "unity.h"
+#include "unity_helper.h"
+#include "system_test_fixture.h"
+#include "protobuf-c/protobuf-c.h"
+#include "socket99/socket99.h"
+#include <string.h>
+#include <stdlib.h>
+
+#include <pthread.h>
+#include <time.h>
+#include <sys/time.h>
+
+#define SYNC_BENCH_THREADS (8)
+#define SYNC_BENCH_OPS_PER_THREAD (500)
+
+static SystemTestFixture Fixture;
+
+typedef struct {
+    KineticSessionHandle handle;
+    int failures;
+} SyncBenchArg;
+
+void setUp(void)
+{
+    SystemTestSetup(&Fixture);
+}
+
+void tearDown(void)
+{
+    SystemTestTearDown(&Fixture);
+}
+
+static void* SyncBenchWorker(void* arg)
+{
+    SyncBenchArg* bench = arg;
+    for (int i = 0; i < SYNC_BENCH_OPS_PER_THREAD; i++) {
+        if (KineticClient_NoOp(bench->handle) != KINETIC_STATUS_SUCCESS) {
+            bench->failures++;
+        }
+    }
+    return NULL;
+}
+
+void test_SynchronousOperations_should_not_burn_CPU_while_awaiting_responses(void)
+{
+    SyncBenchArg args[SYNC_BENCH_THREADS];
+    pthread_t threads[SYNC_BENCH_THREADS];
+
+    for (int i = 0; i < SYNC_BENCH_THREADS; i++) {
+        args[i] = (SyncBenchArg) {.failures = 0};
+        TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+            KineticClient_Connect(&Fixture.config, &args[i].handle));
+    }
+
+    struct timeval startTime, stopTime;
+    clock_t startCPU = clock();
+    gettimeofday(&startTime, NULL);
+
+    for (int i = 0; i < SYNC_BENCH_THREADS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, SyncBenchWorker, &args[i]));
+    }
+    for (int i = 0; i < SYNC_BENCH_THREADS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_join(threads[i], NULL));
+    }
+
+    gettimeofday(&stopTime, NULL);
+    clock_t stopCPU = clock();
+
+    int failures = 0;
+    for (int i = 0; i < SYNC_BENCH_THREADS; i++) {
+        failures += args[i].failures;
+        KineticClient_Disconnect(&args[i].handle);
+    }
+
+    const int totalOps = SYNC_BENCH_THREADS * SYNC_BENCH_OPS_PER_THREAD;
+    int64_t elapsed_us = ((stopTime.tv_sec - startTime.tv_sec) * 1000000)
+        + (stopTime.tv_usec - startTime.tv_usec);
+    double cpu_us = ((double)(stopCPU - startCPU) * 1000000.0) / CLOCKS_PER_SEC;
+    fflush(stdout);
+    printf("\n"
+        "Synchronous NOOP CPU Usage:\n"
+        "----------------------------------------\n"
+        "threads:    %d\n"
+        "operations: %d\n"
+        "duration:   %.3f seconds\n"
+        "cpu time:   %.3f seconds\n"
+        "cpu/op:     %.1f us\n"
+        "wall/op:    %.1f us\n\n",
+        SYNC_BENCH_THREADS,
+        totalOps,
+        elapsed_us / 1000000.0,
+        cpu_us / 1000000.0,
+        cpu_us / totalOps,
+        (double)elapsed_us / totalOps);
+    fflush(stdout);
+
+    TEST_ASSERT_EQUAL(0, failures);
+
+    // Waiting threads should be asleep; CPU time must not approach
+    // wall time multiplied by the number of waiting threads
+    TEST_ASSERT_TRUE(cpu_us < (double)elapsed_us * SYNC_BENCH_THREADS / 2);
+}
+
+/*******************************************************************************
+* ENSURE THIS IS AFTER ALL TESTS IN THE TEST SUITE
+*******************************************************************************/
+SYSTEM_TEST_SUITE_TEARDOWN(&Fixture);
@@ -19,6 +19,7 @@
 */
 
 #include "kinetic_allocator.h"
+#include "kinetic_arena.h"
 #include "kinetic_types_internal.h"
 #include "kinetic_logger.h"
 #include "kinetic_proto.h"
@@ -430,3 +431,113 @@ void test_KineticAllocator_should_allocate_and_free_multiple_Operation_list_item
     KineticAllocator_FreeOperation(&Connection, operations[2]);
     TEST_ASSERT_TRUE(KineticAllocator_ValidateAllMemoryFreed(&Connection));
 }
+
+//==============================================================================
+// Pool Support
+//==============================================================================
+
+void test_KineticAllocator_InitPools_should_preallocate_operations_and_PDUs(void)
+{
+    LOG_LOCATION;
+    KineticAllocator_InitPools(&Connection, 3);
+
+    TEST_ASSERT_EQUAL(3, Connection.operations.freeCount);
+    TEST_ASSERT_EQUAL(6, Connection.pdus.freeCount);
+    TEST_ASSERT_TRUE(KineticAllocator_ValidateAllMemoryFreed(&Connection));
+
+    KineticOperation* operation = KineticAllocator_NewOperation(&Connection);
+    TEST_ASSERT_NOT_NULL(operation);
+    TEST_ASSERT_EQUAL(2, Connection.operations.freeCount);
+    TEST_ASSERT_EQUAL(5, Connection.pdus.freeCount);
+
+    KineticAllocator_FreeOperation(&Connection, operation);
+    TEST_ASSERT_EQUAL(3, Connection.operations.freeCount);
+    TEST_ASSERT_EQUAL(6, Connection.pdus.freeCount);
+
+    KineticAllocator_FreeAllOperations(&Connection);
+    KineticAllocator_FreeAllPDUs(&Connection);
+    TEST_ASSERT_EQUAL(0, Connection.operations.freeCount);
+    TEST_ASSERT_EQUAL(0, Connection.pdus.freeCount);
+}
+
+void test_KineticAllocator_InitPools_should_use_default_depth_if_not_specified(void)
+{
+    LOG_LOCATION;
+    KineticAllocator_InitPools(&Connection, 0);
+
+    TEST_ASSERT_EQUAL(KINETIC_POOL_DEPTH_DEFAULT, Connection.operations.freeCount);
+    TEST_ASSERT_EQUAL(KINETIC_POOL_DEPTH_DEFAULT * 2, Connection.pdus.freeCount);
+
+    KineticAllocator_FreeAllOperations(&Connection);
+    KineticAllocator_FreeAllPDUs(&Connection);
+}
+
+void test_KineticAllocator_NewPDU_should_reuse_released_PDUs(void)
+{
+    LOG_LOCATION;
+    KineticPDU* pdu = KineticAllocator_NewPDU(&Connection);
+    TEST_ASSERT_NOT_NULL(pdu);
+    KineticAllocator_FreePDU(&Connection, pdu);
+    TEST_ASSERT_EQUAL(1, Connection.pdus.freeCount);
+
+    TEST_ASSERT_EQUAL_PTR(pdu, KineticAllocator_NewPDU(&Connection));
+    TEST_ASSERT_EQUAL(0, Connection.pdus.freeCount);
+    TEST_ASSERT_EQUAL_PTR(&Connection, pdu->connection);
+
+    KineticAllocator_FreePDU(&Connection, pdu);
+    KineticAllocator_FreeAllPDUs(&Connection);
+}
+
+void test_KineticAllocator_FreePDU_should_ignore_PDUs_already_released(void)
+{
+    LOG_LOCATION;
+    KineticPDU* pdus[2];
+    pdus[0] = KineticAllocator_NewPDU(&Connection);
+    pdus[1] = KineticAllocator_NewPDU(&Connection);
+
+    KineticAllocator_FreePDU(&Connection, pdus[0]);
+    KineticAllocator_FreePDU(&Connection, pdus[0]);
+    TEST_ASSERT_EQUAL(1, Connection.pdus.freeCount);
+    TEST_ASSERT_EQUAL_PTR(pdus[1], KineticAllocator_GetFirstPDU(&Connection));
+
+    KineticAllocator_FreePDU(&Connection, pdus[1]);
+    TEST_ASSERT_TRUE(KineticAllocator_ValidateAllMemoryFreed(&Connection));
+    KineticAllocator_FreeAllPDUs(&Connection);
+}
+
+void test_KineticAllocator_FreePDU_should_reset_and_retain_the_unpacking_arena_for_reuse(void)
+{
+    LOG_LOCATION;
+    KineticPDU* pdu = KineticAllocator_NewPDU(&Connection);
+    KineticProto_Message* unpacked = KineticArena_Alloc(&pdu->arena, sizeof(KineticProto_Message));
+    TEST_ASSERT_NOT_NULL(unpacked);
+    pdu->proto = unpacked;
+    pdu->protobufDynamicallyExtracted = true;
+    uint8_t* arenaData = pdu->arena.data;
+
+    KineticAllocator_FreePDU(&Connection, pdu);
+    TEST_ASSERT_NULL(pdu->proto);
+    TEST_ASSERT_FALSE(pdu->protobufDynamicallyExtracted);
+    TEST_ASSERT_EQUAL(0, pdu->arena.used);
+
+    TEST_ASSERT_EQUAL_PTR(pdu, KineticAllocator_NewPDU(&Connection));
+    TEST_ASSERT_EQUAL_PTR(arenaData, pdu->arena.data);
+
+    KineticAllocator_FreePDU(&Connection, pdu);
+    KineticAllocator_FreeAllPDUs(&Connection);
+}
+
+void test_KineticAllocator_FreePDU_should_allow_a_sent_request_PDU_to_be_reused(void)
+{
+    LOG_LOCATION;
+    KineticPDU* pdu = KineticAllocator_NewPDU(&Connection);
+    pdu->proto = &pdu->protoData.message.message;
+
+    KineticAllocator_FreePDU(&Connection, pdu);
+    TEST_ASSERT_NULL(pdu->proto);
+
+    TEST_ASSERT_EQUAL_PTR(pdu, KineticAllocator_NewPDU(&Connection));
+
+    KineticAllocator_FreePDU(&Connection, pdu);
+    KineticAllocator_FreeAllPDUs(&Connection);
+}
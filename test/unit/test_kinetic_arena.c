@@ -0,0 +1,145 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_arena.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include <stdlib.h>
+#include <string.h>
+
+static KineticArena Arena;
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    Arena = (KineticArena) {.data = NULL};
+}
+
+void tearDown(void)
+{
+    KineticArena_Free(&Arena);
+    KineticLogger_Close();
+}
+
+void test_KineticArena_Alloc_should_bump_allocate_aligned_blocks_from_a_single_buffer(void)
+{
+    uint8_t* a = KineticArena_Alloc(&Arena, 3);
+    uint8_t* b = KineticArena_Alloc(&Arena, 40);
+    uint8_t* c = KineticArena_Alloc(&Arena, 1);
+
+    TEST_ASSERT_NOT_NULL(Arena.data);
+    TEST_ASSERT_EQUAL(KINETIC_ARENA_SIZE_DEFAULT, Arena.size);
+    TEST_ASSERT_EQUAL_PTR(Arena.data, a);
+    TEST_ASSERT_EQUAL_PTR(a + KINETIC_ARENA_ALIGNMENT, b);
+    TEST_ASSERT_EQUAL_PTR(b + 48, c);
+    TEST_ASSERT_EQUAL(0, (size_t)c % KINETIC_ARENA_ALIGNMENT);
+    TEST_ASSERT_NULL(Arena.overflow);
+}
+
+void test_KineticArena_Reset_should_rewind_the_arena_and_reuse_its_memory(void)
+{
+    uint8_t* first = KineticArena_Alloc(&Arena, 100);
+    KineticArena_Alloc(&Arena, 200);
+    uint8_t* data = Arena.data;
+
+    KineticArena_Reset(&Arena);
+
+    TEST_ASSERT_EQUAL(0, Arena.used);
+    TEST_ASSERT_EQUAL_PTR(data, Arena.data);
+    TEST_ASSERT_EQUAL_PTR(first, KineticArena_Alloc(&Arena, 100));
+}
+
+void test_KineticArena_should_spill_into_overflow_chunks_and_grow_upon_reset(void)
+{
+    KineticArena_Alloc(&Arena, KINETIC_ARENA_SIZE_DEFAULT - 32);
+    uint8_t* spilled = KineticArena_Alloc(&Arena, 256);
+
+    TEST_ASSERT_NOT_NULL(spilled);
+    TEST_ASSERT_NOT_NULL(Arena.overflow);
+    TEST_ASSERT_EQUAL(256, Arena.overflowSize);
+    memset(spilled, 0xA5, 256);
+
+    KineticArena_Reset(&Arena);
+
+    TEST_ASSERT_NULL(Arena.overflow);
+    TEST_ASSERT_EQUAL(0, Arena.overflowSize);
+    TEST_ASSERT_EQUAL(2 * KINETIC_ARENA_SIZE_DEFAULT, Arena.size);
+    KineticArena_Alloc(&Arena, KINETIC_ARENA_SIZE_DEFAULT - 32);
+    KineticArena_Alloc(&Arena, 256);
+    TEST_ASSERT_NULL(Arena.overflow);
+}
+
+void test_KineticArena_Alloc_should_size_the_initial_buffer_to_fit_a_large_request(void)
+{
+    uint8_t* big = KineticArena_Alloc(&Arena, 3 * KINETIC_ARENA_SIZE_DEFAULT);
+
+    TEST_ASSERT_EQUAL_PTR(Arena.data, big);
+    TEST_ASSERT_EQUAL(4 * KINETIC_ARENA_SIZE_DEFAULT, Arena.size);
+}
+
+void test_KineticArena_GetAllocator_should_unpack_protobufs_into_the_arena(void)
+{
+    uint8_t keyData[] = {1, 2, 3, 4, 5};
+    KineticProto_Command_Header header = KINETIC_PROTO_COMMAND_HEADER__INIT;
+    header.sequence = 1234;
+    header.has_sequence = true;
+    KineticProto_Command_KeyValue keyValue = KINETIC_PROTO_COMMAND_KEY_VALUE__INIT;
+    keyValue.key = (ProtobufCBinaryData) {.data = keyData, .len = sizeof(keyData)};
+    keyValue.has_key = true;
+    KineticProto_Command_Body body = KINETIC_PROTO_COMMAND_BODY__INIT;
+    body.keyValue = &keyValue;
+    KineticProto_Command command = KINETIC_PROTO_COMMAND__INIT;
+    command.header = &header;
+    command.body = &body;
+    uint8_t packed[64];
+    size_t len = KineticProto_command__pack(&command, packed);
+
+    ProtobufCAllocator allocator = KineticArena_GetAllocator(&Arena);
+    KineticProto_Command* unpacked = KineticProto_command__unpack(&allocator, len, packed);
+
+    TEST_ASSERT_NOT_NULL(unpacked);
+    TEST_ASSERT_TRUE((uint8_t*)unpacked >= Arena.data);
+    TEST_ASSERT_TRUE((uint8_t*)unpacked < Arena.data + Arena.used);
+    TEST_ASSERT_NOT_NULL(unpacked->header);
+    TEST_ASSERT_EQUAL(1234, unpacked->header->sequence);
+    TEST_ASSERT_NOT_NULL(unpacked->body);
+    TEST_ASSERT_NOT_NULL(unpacked->body->keyValue);
+    TEST_ASSERT_TRUE(unpacked->body->keyValue->has_key);
+    TEST_ASSERT_EQUAL(sizeof(keyData), unpacked->body->keyValue->key.len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(keyData, unpacked->body->keyValue->key.data, sizeof(keyData));
+    TEST_ASSERT_NULL(Arena.overflow);
+}
+
+void test_KineticArena_Free_should_release_all_memory_and_clear_the_arena(void)
+{
+    KineticArena_Alloc(&Arena, KINETIC_ARENA_SIZE_DEFAULT);
+    KineticArena_Alloc(&Arena, 64);
+
+    KineticArena_Free(&Arena);
+
+    TEST_ASSERT_NULL(Arena.data);
+    TEST_ASSERT_NULL(Arena.overflow);
+    TEST_ASSERT_EQUAL(0, Arena.size);
+    TEST_ASSERT_EQUAL(0, Arena.used);
+}
@@ -0,0 +1,305 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_batch.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include "mock_kinetic_connection.h"
+#include "mock_kinetic_allocator.h"
+#include "mock_kinetic_operation.h"
+#include <pthread.h>
+#include <time.h>
+
+#define NUM_ENTRIES (3)
+
+static KineticConnection Connection;
+static KineticOperation Operations[NUM_ENTRIES];
+static KineticPDU Requests[NUM_ENTRIES];
+static KineticEntry Entries[NUM_ENTRIES];
+static KineticCompletionClosure Closures[NUM_ENTRIES];
+static KineticStatus Completed[NUM_ENTRIES];
+static int CompletedCount;
+static KineticEntry* Built[NUM_ENTRIES];
+static int BuiltCount;
+
+static void BuildTestOperation(KineticOperation* const operation, KineticEntry* const entry)
+{
+    TEST_ASSERT_NOT_NULL(operation);
+    Built[BuiltCount++] = entry;
+}
+
+static void TestCompletion(KineticCompletionData* kinetic_data, void* client_data)
+{
+    int index = (int)(intptr_t)client_data;
+    Completed[index] = kinetic_data->status;
+    CompletedCount++;
+}
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    KINETIC_CONNECTION_INIT(&Connection);
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        KINETIC_OPERATION_INIT(&Operations[i], &Connection);
+        Operations[i].request = &Requests[i];
+        Entries[i] = (KineticEntry) {.algorithm = KINETIC_ALGORITHM_SHA1};
+        Closures[i] = (KineticCompletionClosure) {
+            .callback = TestCompletion,
+            .clientData = (void*)(intptr_t)i,
+        };
+        Completed[i] = KINETIC_STATUS_INVALID;
+        Built[i] = NULL;
+    }
+    CompletedCount = 0;
+    BuiltCount = 0;
+}
+
+void tearDown(void)
+{
+    KineticLogger_Close();
+}
+
+void test_KineticBatch_Execute_should_send_all_entries_with_a_single_request_write(void)
+{
+    LOG_LOCATION;
+    KineticOperation* expected[] = {&Operations[0], &Operations[1], &Operations[2]};
+
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[0]);
+    KineticConnection_TryAcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[1]);
+    KineticConnection_TryAcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[2]);
+    KineticOperation_SendRequests_ExpectAndReturn(expected, 3, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticBatch_Execute(&Connection, Entries, NUM_ENTRIES,
+        BuildTestOperation, NULL, Closures, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(NUM_ENTRIES, BuiltCount);
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        TEST_ASSERT_EQUAL_PTR(&Entries[i], Built[i]);
+        TEST_ASSERT_EQUAL_PTR(Closures[i].callback, Operations[i].closure.callback);
+        TEST_ASSERT_EQUAL_PTR(Closures[i].clientData, Operations[i].closure.clientData);
+    }
+    TEST_ASSERT_EQUAL(0, CompletedCount);
+}
+
+void test_KineticBatch_Execute_should_flush_built_requests_once_the_window_fills(void)
+{
+    LOG_LOCATION;
+    KineticOperation* first[] = {&Operations[0]};
+    KineticOperation* rest[] = {&Operations[1], &Operations[2]};
+
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[0]);
+    KineticConnection_TryAcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_WOULD_BLOCK);
+    KineticOperation_SendRequests_ExpectAndReturn(first, 1, KINETIC_STATUS_SUCCESS);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[1]);
+    KineticConnection_TryAcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[2]);
+    KineticOperation_SendRequests_ExpectAndReturn(rest, 2, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticBatch_Execute(&Connection, Entries, NUM_ENTRIES,
+        BuildTestOperation, NULL, Closures, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(NUM_ENTRIES, BuiltCount);
+}
+
+void test_KineticBatch_Execute_should_fail_each_entry_if_the_requests_could_not_be_sent(void)
+{
+    LOG_LOCATION;
+    KineticOperation* expected[] = {&Operations[0], &Operations[1]};
+
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[0]);
+    KineticConnection_TryAcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[1]);
+    KineticOperation_SendRequests_ExpectAndReturn(expected, 2, KINETIC_STATUS_SOCKET_ERROR);
+    KineticAllocator_FreeOperation_Expect(&Connection, &Operations[0]);
+    KineticConnection_ReleaseWindow_Expect(&Connection);
+    KineticAllocator_FreeOperation_Expect(&Connection, &Operations[1]);
+    KineticConnection_ReleaseWindow_Expect(&Connection);
+
+    KineticStatus status = KineticBatch_Execute(&Connection, Entries, 2,
+        BuildTestOperation, NULL, Closures, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_ERROR, status);
+    TEST_ASSERT_EQUAL(2, CompletedCount);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_ERROR, Completed[0]);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_ERROR, Completed[1]);
+}
+
+void test_KineticBatch_Execute_should_fail_unsubmitted_entries_if_an_operation_could_not_be_allocated(void)
+{
+    LOG_LOCATION;
+    KineticOperation* expected[] = {&Operations[0]};
+
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[0]);
+    KineticConnection_TryAcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, NULL);
+    KineticConnection_ReleaseWindow_Expect(&Connection);
+    KineticOperation_SendRequests_ExpectAndReturn(expected, 1, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticBatch_Execute(&Connection, Entries, NUM_ENTRIES,
+        BuildTestOperation, NULL, Closures, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_MEMORY_ERROR, status);
+    TEST_ASSERT_EQUAL(2, CompletedCount);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID, Completed[0]);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_MEMORY_ERROR, Completed[1]);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_MEMORY_ERROR, Completed[2]);
+}
+
+void test_KineticBatch_Execute_should_fail_all_entries_if_the_window_could_not_be_acquired(void)
+{
+    LOG_LOCATION;
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_CONNECTION_ERROR);
+
+    KineticStatus status = KineticBatch_Execute(&Connection, Entries, NUM_ENTRIES,
+        BuildTestOperation, NULL, Closures, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_CONNECTION_ERROR, status);
+    TEST_ASSERT_EQUAL(0, BuiltCount);
+    TEST_ASSERT_EQUAL(NUM_ENTRIES, CompletedCount);
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_CONNECTION_ERROR, Completed[i]);
+    }
+}
+
+static int BatchCompletedCount;
+static KineticStatus BatchCompletedStatus;
+
+static void TestBatchCompletion(KineticCompletionData* kinetic_data, void* client_data)
+{
+    TEST_ASSERT_EQUAL_PTR(&BatchCompletedCount, client_data);
+    BatchCompletedStatus = kinetic_data->status;
+    BatchCompletedCount++;
+}
+
+void test_KineticBatch_Execute_should_call_the_batch_closure_once_all_entries_complete(void)
+{
+    LOG_LOCATION;
+    KineticOperation* expected[] = {&Operations[0], &Operations[1], &Operations[2]};
+    KineticCompletionClosure closure = {
+        .callback = TestBatchCompletion,
+        .clientData = &BatchCompletedCount,
+    };
+    KineticStatus statuses[NUM_ENTRIES];
+    BatchCompletedCount = 0;
+
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[0]);
+    KineticConnection_TryAcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[1]);
+    KineticConnection_TryAcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[2]);
+    KineticOperation_SendRequests_ExpectAndReturn(expected, 3, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticBatch_Execute(&Connection, Entries, NUM_ENTRIES,
+        BuildTestOperation, statuses, NULL, &closure);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+
+    KineticStatus results[NUM_ENTRIES] = {
+        KINETIC_STATUS_SUCCESS, KINETIC_STATUS_NOT_FOUND, KINETIC_STATUS_SUCCESS,
+    };
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        TEST_ASSERT_EQUAL(0, BatchCompletedCount);
+        KineticCompletionData completionData = {.status = results[i]};
+        Operations[i].closure.callback(&completionData, Operations[i].closure.clientData);
+    }
+
+    TEST_ASSERT_EQUAL(1, BatchCompletedCount);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, BatchCompletedStatus);
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        TEST_ASSERT_EQUAL_KineticStatus(results[i], statuses[i]);
+    }
+}
+
+void test_KineticBatch_Execute_should_call_the_batch_closure_if_no_entries_could_be_submitted(void)
+{
+    LOG_LOCATION;
+    KineticCompletionClosure closure = {
+        .callback = TestBatchCompletion,
+        .clientData = &BatchCompletedCount,
+    };
+    BatchCompletedCount = 0;
+
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_CONNECTION_ERROR);
+
+    KineticStatus status = KineticBatch_Execute(&Connection, Entries, NUM_ENTRIES,
+        BuildTestOperation, NULL, NULL, &closure);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_CONNECTION_ERROR, status);
+    TEST_ASSERT_EQUAL(1, BatchCompletedCount);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_CONNECTION_ERROR, BatchCompletedStatus);
+}
+
+// Plays the part of the receiver, completing each operation once submitted
+static void* CompleteOperations(void* arg)
+{
+    KineticStatus* results = (KineticStatus*)arg;
+    volatile KineticCompletionCallback* last = &Operations[NUM_ENTRIES - 1].closure.callback;
+    while (*last == NULL) {
+        nanosleep(&(struct timespec) {.tv_nsec = 1000000}, NULL);
+    }
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        KineticCompletionData completionData = {.status = results[i]};
+        Operations[i].closure.callback(&completionData, Operations[i].closure.clientData);
+    }
+    return NULL;
+}
+
+void test_KineticBatch_Execute_should_wait_for_all_entries_and_report_each_status_if_synchronous(void)
+{
+    LOG_LOCATION;
+    KineticOperation* expected[] = {&Operations[0], &Operations[1], &Operations[2]};
+    KineticStatus results[NUM_ENTRIES] = {
+        KINETIC_STATUS_SUCCESS, KINETIC_STATUS_VERSION_MISMATCH, KINETIC_STATUS_SUCCESS,
+    };
+    KineticStatus statuses[NUM_ENTRIES];
+
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[0]);
+    KineticConnection_TryAcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[1]);
+    KineticConnection_TryAcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[2]);
+    KineticOperation_SendRequests_ExpectAndReturn(expected, 3, KINETIC_STATUS_SUCCESS);
+
+    pthread_t receiver;
+    TEST_ASSERT_EQUAL(0, pthread_create(&receiver, NULL, CompleteOperations, results));
+    KineticStatus status = KineticBatch_Execute(&Connection, Entries, NUM_ENTRIES,
+        BuildTestOperation, statuses, NULL, NULL);
+    pthread_join(receiver, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_VERSION_MISMATCH, status);
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        TEST_ASSERT_EQUAL_KineticStatus(results[i], statuses[i]);
+    }
+}
@@ -31,6 +31,19 @@
 #include "mock_kinetic_message.h"
 #include "mock_kinetic_pdu.h"
 #include "mock_kinetic_operation.h"
+#include "mock_kinetic_log_poller.h"
+#include "mock_kinetic_group_commit.h"
+#include "mock_kinetic_session_pool.h"
+#include "mock_kinetic_cluster.h"
+#include "mock_kinetic_replication.h"
+#include "mock_kinetic_erasure.h"
+#include "mock_kinetic_hedge.h"
+#include "mock_kinetic_batch.h"
+#include "mock_kinetic_stream.h"
+#include "mock_kinetic_key_iterator.h"
+#include "mock_kinetic_cursor.h"
+#include "mock_kinetic_key_scan.h"
+#include "mock_kinetic_value_scan.h"
 #include "protobuf-c/protobuf-c.h"
 #include <stdio.h>
 
@@ -184,6 +197,44 @@ void test_KineticClient_Connect_should_return_status_from_a_failed_connection(vo
 
 
 
+void test_KineticClient_Connect_should_open_the_other_connections_of_a_pooled_session(void)
+{
+    KINETIC_CONNECTION_INIT(&Connection);
+    Connection.connectionID = 12374626536;
+    HmacKey = ByteArray_CreateWithCString("some hmac key");
+    KINETIC_SESSION_INIT(&Session, "somehost.com", ClusterVersion, Identity, HmacKey);
+    Session.connections = 4;
+
+    KineticConnection_NewConnection_ExpectAndReturn(&Session, DummyHandle);
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_Connect_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticSessionPool_Connect_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_Connect(&Session, &SessionHandle);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(DummyHandle, SessionHandle);
+}
+
+void test_KineticClient_Connect_should_close_the_session_if_pooled_connections_fail(void)
+{
+    KINETIC_CONNECTION_INIT(&Connection);
+    Connection.connectionID = 12374626536;
+    HmacKey = ByteArray_CreateWithCString("some hmac key");
+    KINETIC_SESSION_INIT(&Session, "somehost.com", ClusterVersion, Identity, HmacKey);
+    Session.connections = 4;
+
+    KineticConnection_NewConnection_ExpectAndReturn(&Session, DummyHandle);
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_Connect_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticSessionPool_Connect_ExpectAndReturn(&Connection, KINETIC_STATUS_CONNECTION_ERROR);
+    KineticConnection_Disconnect_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticConnection_FreeConnection_Expect(&SessionHandle);
+
+    KineticStatus status = KineticClient_Connect(&Session, &SessionHandle);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_CONNECTION_ERROR, status);
+    TEST_ASSERT_EQUAL(KINETIC_HANDLE_INVALID, SessionHandle);
+}
+
 void test_KineticClient_Disconnect_should_return_KINETIC_STATUS_CONNECTION_ERROR_upon_failure_to_get_connection_from_handle(void)
 {
     SessionHandle = DummyHandle;
@@ -196,6 +247,8 @@ void test_KineticClient_Disconnect_should_disconnect_and_free_the_connection_ass
 {
     SessionHandle = DummyHandle;
     KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticLogPoller_Stop_Expect(&Connection);
+    KineticGroupCommit_Stop_Expect(&Connection);
     KineticConnection_Disconnect_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
     KineticConnection_FreeConnection_Expect(&SessionHandle);
     KineticStatus status = KineticClient_Disconnect(&SessionHandle);
@@ -203,13 +256,97 @@ void test_KineticClient_Disconnect_should_disconnect_and_free_the_connection_ass
     TEST_ASSERT_EQUAL(KINETIC_HANDLE_INVALID, SessionHandle);
 }
 
+void test_KineticClient_Disconnect_should_close_the_other_connections_of_a_pooled_session(void)
+{
+    KineticSessionPool pool;
+    KINETIC_CONNECTION_INIT(&Connection);
+    Connection.pool = &pool;
+    SessionHandle = DummyHandle;
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticLogPoller_Stop_Expect(&Connection);
+    KineticGroupCommit_Stop_Expect(&Connection);
+    KineticSessionPool_Disconnect_Expect(&Connection);
+    KineticConnection_Disconnect_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticConnection_FreeConnection_Expect(&SessionHandle);
+    KineticStatus status = KineticClient_Disconnect(&SessionHandle);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(KINETIC_HANDLE_INVALID, SessionHandle);
+    Connection.pool = NULL;
+}
+
 void test_KineticClient_Disconnect_should_return_status_from_KineticConnection_upon_faileure(void)
 {
     SessionHandle = DummyHandle;
     KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticLogPoller_Stop_Expect(&Connection);
+    KineticGroupCommit_Stop_Expect(&Connection);
     KineticConnection_Disconnect_ExpectAndReturn(&Connection, KINETIC_STATUS_SESSION_INVALID);
     KineticConnection_FreeConnection_Expect(&SessionHandle);
     KineticStatus status = KineticClient_Disconnect(&SessionHandle);
     TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SESSION_INVALID, status);
     TEST_ASSERT_EQUAL(KINETIC_HANDLE_INVALID, SessionHandle);
 }
+
+void test_KineticClient_should_send_operations_of_a_pooled_session_on_the_selected_connection(void)
+{
+    KineticSessionPool pool;
+    KineticConnection member;
+    KineticPDU request, response;
+    KINETIC_CONNECTION_INIT(&Connection);
+    KINETIC_CONNECTION_INIT(&member);
+    Connection.pool = &pool;
+    KineticOperation operation = {
+        .connection = &member,
+        .request = &request,
+        .response = &response,
+    };
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticSessionPool_Select_ExpectAndReturn(&pool, &member);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&member, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&member, &operation);
+    KineticOperation_BuildNoop_Expect(&operation);
+    KineticOperation_SendRequest_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
+    KineticOperation_ReceiveAsync_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_NoOp(DummyHandle);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    Connection.pool = NULL;
+}
+
+void test_KineticClient_should_open_cursors_of_a_pooled_session_on_the_selected_connection(void)
+{
+    KineticSessionPool pool;
+    KineticConnection member;
+    KINETIC_CONNECTION_INIT(&Connection);
+    KINETIC_CONNECTION_INIT(&member);
+    Connection.pool = &pool;
+    uint8_t startKeyData[] = "start";
+    ByteBuffer startKey = ByteBuffer_Create(startKeyData, sizeof(startKeyData), sizeof(startKeyData));
+    KineticCursor* cursor = NULL;
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticSessionPool_Select_ExpectAndReturn(&pool, &member);
+    KineticCursor_Open_ExpectAndReturn(&member, &startKey, false, 4, &cursor, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_OpenCursor(DummyHandle, &startKey, false, 4, &cursor);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    Connection.pool = NULL;
+}
+
+void test_KineticClient_should_start_group_commit_of_a_pooled_session_on_its_own_connection(void)
+{
+    KineticSessionPool pool;
+    KINETIC_CONNECTION_INIT(&Connection);
+    Connection.pool = &pool;
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticGroupCommit_Start_ExpectAndReturn(&Connection, 8, 5, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_StartGroupCommit(DummyHandle, 8, 5);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    Connection.pool = NULL;
+}
@@ -0,0 +1,166 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_client.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_proto.h"
+#include "kinetic_logger.h"
+#include "mock_kinetic_allocator.h"
+#include "mock_kinetic_operation.h"
+#include "mock_kinetic_connection.h"
+#include "mock_kinetic_message.h"
+#include "mock_kinetic_pdu.h"
+#include "mock_kinetic_log_poller.h"
+#include "mock_kinetic_group_commit.h"
+#include "mock_kinetic_session_pool.h"
+#include "mock_kinetic_cluster.h"
+#include "mock_kinetic_replication.h"
+#include "mock_kinetic_erasure.h"
+#include "mock_kinetic_hedge.h"
+#include "mock_kinetic_batch.h"
+#include "mock_kinetic_stream.h"
+#include "mock_kinetic_key_iterator.h"
+#include "mock_kinetic_cursor.h"
+#include "mock_kinetic_key_scan.h"
+#include "mock_kinetic_value_scan.h"
+#include <stdio.h>
+#include "protobuf-c/protobuf-c.h"
+#include "byte_array.h"
+#include "unity.h"
+#include "unity_helper.h"
+
+static KineticSession Configs[2];
+static KineticConnection Connections[2];
+static KineticCluster ClusterInstance;
+static KineticCluster* Cluster = &ClusterInstance;
+static uint8_t ValueData[] = "cluster value";
+static uint8_t KeyData[] = "cluster key";
+static KineticEntry Entry;
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    ByteArray hmacKey = ByteArray_CreateWithCString("some hmac key");
+    for (int i = 0; i < 2; i++) {
+        KINETIC_CONNECTION_INIT(&Connections[i]);
+        Connections[i].connectionID = 182736 + i; // Dummy connection ID to allow connect to complete
+    }
+    KINETIC_SESSION_INIT(&Configs[0], "drive0.example.com", 0, 1, hmacKey);
+    KINETIC_SESSION_INIT(&Configs[1], "drive1.example.com", 0, 1, hmacKey);
+    Entry = (KineticEntry) {
+        .key = ByteBuffer_Create(KeyData, sizeof(KeyData), sizeof(KeyData)),
+        .value = ByteBuffer_Create(ValueData, sizeof(ValueData), sizeof(ValueData)),
+    };
+}
+
+void tearDown(void)
+{
+    KineticLogger_Close();
+}
+
+void test_KineticClient_ConnectCluster_should_connect_to_and_add_each_drive(void)
+{
+    KineticCluster* cluster = NULL;
+
+    KineticCluster_Create_ExpectAndReturn(Cluster);
+    for (int i = 0; i < 2; i++) {
+        KineticSessionHandle handle = i + 1;
+        KineticConnection_NewConnection_ExpectAndReturn(&Configs[i], handle);
+        KineticConnection_FromHandle_ExpectAndReturn(handle, &Connections[i]);
+        KineticConnection_Connect_ExpectAndReturn(&Connections[i], KINETIC_STATUS_SUCCESS);
+        KineticConnection_FromHandle_ExpectAndReturn(handle, &Connections[i]);
+        KineticCluster_AddDrive_ExpectAndReturn(Cluster, handle, &Connections[i],
+            KINETIC_STATUS_SUCCESS);
+    }
+
+    KineticStatus status = KineticClient_ConnectCluster(Configs, 2, &cluster);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL_PTR(Cluster, cluster);
+}
+
+void test_KineticClient_ConnectCluster_should_reject_an_invalid_number_of_drives(void)
+{
+    KineticCluster* cluster = Cluster;
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticClient_ConnectCluster(Configs, 0, &cluster));
+    TEST_ASSERT_NULL(cluster);
+}
+
+void test_KineticClient_ClusterPut_should_route_a_PUT_by_the_entry_key(void)
+{
+    KineticCluster_Execute_ExpectAndReturn(Cluster, &Entry, KineticOperation_BuildPut, NULL,
+        KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_ClusterPut(Cluster, &Entry, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
+
+void test_KineticClient_ClusterGet_should_route_a_GET_by_the_entry_key(void)
+{
+    KineticCompletionClosure closure = {.callback = NULL};
+    KineticCluster_Execute_ExpectAndReturn(Cluster, &Entry, KineticOperation_BuildGet, &closure,
+        KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_ClusterGet(Cluster, &Entry, &closure);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
+
+void test_KineticClient_ClusterDelete_should_route_a_DELETE_by_the_entry_key(void)
+{
+    KineticCluster_Execute_ExpectAndReturn(Cluster, &Entry, KineticOperation_BuildDelete, NULL,
+        KINETIC_STATUS_NOT_FOUND);
+
+    KineticStatus status = KineticClient_ClusterDelete(Cluster, &Entry, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, status);
+}
+
+void test_KineticClient_RemoveClusterDrive_should_report_a_drive_not_in_the_cluster(void)
+{
+    KineticCluster_RemoveDrive_ExpectAndReturn(Cluster, "drive9.example.com", KINETIC_PORT,
+        KINETIC_HANDLE_INVALID);
+
+    KineticStatus status = KineticClient_RemoveClusterDrive(Cluster, "drive9.example.com",
+        KINETIC_PORT);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST, status);
+}
+
+void test_KineticClient_RemoveClusterDrive_should_disconnect_the_removed_drive(void)
+{
+    KineticSessionHandle handle = 2;
+    KineticCluster_RemoveDrive_ExpectAndReturn(Cluster, "drive1.example.com", KINETIC_PORT,
+        handle);
+    KineticConnection_FromHandle_ExpectAndReturn(handle, &Connections[1]);
+    KineticLogPoller_Stop_Expect(&Connections[1]);
+    KineticGroupCommit_Stop_Expect(&Connections[1]);
+    KineticConnection_Disconnect_ExpectAndReturn(&Connections[1], KINETIC_STATUS_SUCCESS);
+    KineticConnection_FreeConnection_Expect(&handle);
+
+    KineticStatus status = KineticClient_RemoveClusterDrive(Cluster, "drive1.example.com",
+        KINETIC_PORT);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
@@ -28,6 +28,19 @@
 #include "mock_kinetic_connection.h"
 #include "mock_kinetic_message.h"
 #include "mock_kinetic_pdu.h"
+#include "mock_kinetic_batch.h"
+#include "mock_kinetic_stream.h"
+#include "mock_kinetic_key_iterator.h"
+#include "mock_kinetic_cursor.h"
+#include "mock_kinetic_key_scan.h"
+#include "mock_kinetic_value_scan.h"
+#include "mock_kinetic_log_poller.h"
+#include "mock_kinetic_group_commit.h"
+#include "mock_kinetic_session_pool.h"
+#include "mock_kinetic_cluster.h"
+#include "mock_kinetic_replication.h"
+#include "mock_kinetic_erasure.h"
+#include "mock_kinetic_hedge.h"
 #include <stdio.h>
 #include "protobuf-c/protobuf-c.h"
 #include "byte_array.h"
@@ -82,6 +95,7 @@ void test_KineticClient_Delete_should_execute_DELETE_operation(void)
     };
 
     KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
     KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &operation);
     KineticOperation_BuildDelete_Expect(&operation, &entry);
     KineticOperation_SendRequest_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
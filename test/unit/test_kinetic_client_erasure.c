@@ -0,0 +1,121 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_client.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_proto.h"
+#include "kinetic_logger.h"
+#include "mock_kinetic_allocator.h"
+#include "mock_kinetic_operation.h"
+#include "mock_kinetic_connection.h"
+#include "mock_kinetic_message.h"
+#include "mock_kinetic_pdu.h"
+#include "mock_kinetic_log_poller.h"
+#include "mock_kinetic_group_commit.h"
+#include "mock_kinetic_session_pool.h"
+#include "mock_kinetic_cluster.h"
+#include "mock_kinetic_replication.h"
+#include "mock_kinetic_erasure.h"
+#include "mock_kinetic_hedge.h"
+#include "mock_kinetic_batch.h"
+#include "mock_kinetic_stream.h"
+#include "mock_kinetic_key_iterator.h"
+#include "mock_kinetic_cursor.h"
+#include "mock_kinetic_key_scan.h"
+#include "mock_kinetic_value_scan.h"
+#include <stdio.h>
+#include "protobuf-c/protobuf-c.h"
+#include "byte_array.h"
+#include "unity.h"
+#include "unity_helper.h"
+
+#define FRAGMENTS (5)
+
+static KineticSessionHandle Handles[FRAGMENTS] = {1, 2, 3, 4, 5};
+static KineticConnection Connections[FRAGMENTS];
+static KineticConnection* ConnectionList[FRAGMENTS];
+static uint8_t ValueData[] = "erasure coded value";
+static uint8_t KeyData[] = "erasure coded key";
+static KineticEntry Entry;
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    for (int i = 0; i < FRAGMENTS; i++) {
+        KINETIC_CONNECTION_INIT(&Connections[i]);
+        ConnectionList[i] = &Connections[i];
+    }
+    Entry = (KineticEntry) {
+        .key = ByteBuffer_Create(KeyData, sizeof(KeyData), sizeof(KeyData)),
+        .value = ByteBuffer_Create(ValueData, sizeof(ValueData), sizeof(ValueData)),
+    };
+}
+
+void tearDown(void)
+{
+    KineticLogger_Close();
+}
+
+static void ExpectFragments(void)
+{
+    for (int i = 0; i < FRAGMENTS; i++) {
+        KineticConnection_FromHandle_ExpectAndReturn(Handles[i], &Connections[i]);
+    }
+}
+
+void test_KineticClient_ErasurePut_should_put_a_fragment_to_the_connection_of_each_session(void)
+{
+    ExpectFragments();
+    KineticErasure_Put_ExpectAndReturn(ConnectionList, 3, 2, &Entry, NULL,
+        KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_ErasurePut(Handles, 3, 2, &Entry, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
+
+void test_KineticClient_ErasureGet_should_get_a_fragment_from_the_connection_of_each_session(void)
+{
+    KineticCompletionClosure closure = {.callback = NULL};
+    ExpectFragments();
+    KineticErasure_Get_ExpectAndReturn(ConnectionList, 4, 1, &Entry, &closure,
+        KINETIC_STATUS_NOT_FOUND);
+
+    KineticStatus status = KineticClient_ErasureGet(Handles, 4, 1, &Entry, &closure);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, status);
+}
+
+void test_KineticClient_ErasurePut_should_reject_too_many_fragments(void)
+{
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticClient_ErasurePut(Handles, KINETIC_ERASURE_FRAGMENTS_MAX, 1, &Entry, NULL));
+}
+
+void test_KineticClient_ErasureGet_should_reject_a_fragment_without_a_session(void)
+{
+    KineticSessionHandle handles[FRAGMENTS] = {1, 2, KINETIC_HANDLE_INVALID, 4, 5};
+    KineticConnection_FromHandle_ExpectAndReturn(handles[0], &Connections[0]);
+    KineticConnection_FromHandle_ExpectAndReturn(handles[1], &Connections[1]);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SESSION_EMPTY,
+        KineticClient_ErasureGet(handles, 3, 2, &Entry, NULL));
+}
@@ -28,6 +28,19 @@
 #include "mock_kinetic_connection.h"
 #include "mock_kinetic_message.h"
 #include "mock_kinetic_pdu.h"
+#include "mock_kinetic_batch.h"
+#include "mock_kinetic_stream.h"
+#include "mock_kinetic_cursor.h"
+#include "mock_kinetic_key_iterator.h"
+#include "mock_kinetic_key_scan.h"
+#include "mock_kinetic_value_scan.h"
+#include "mock_kinetic_log_poller.h"
+#include "mock_kinetic_group_commit.h"
+#include "mock_kinetic_session_pool.h"
+#include "mock_kinetic_cluster.h"
+#include "mock_kinetic_replication.h"
+#include "mock_kinetic_erasure.h"
+#include "mock_kinetic_hedge.h"
 #include <stdio.h>
 #include "protobuf-c/protobuf-c.h"
 #include "byte_array.h"
@@ -43,6 +56,7 @@ static uint8_t ValueData[64];
 static KineticSessionHandle DummyHandle = 1;
 static KineticSessionHandle SessionHandle = KINETIC_HANDLE_INVALID;
 static KineticPDU Request, Response;
+static KineticCursor Cursor;
 
 
 void setUp(void)
@@ -106,6 +120,7 @@ void test_KineticClient_Get_should_execute_GET_operation(void)
     };
 
     KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
     KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &operation);
     KineticOperation_BuildGet_Expect(&operation, &entry);
     KineticOperation_SendRequest_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
@@ -157,6 +172,7 @@ void test_KineticClient_Get_should_execute_GET_operation_and_populate_supplied_b
     };
 
     KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
     KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &operation);
     KineticOperation_BuildGet_Expect(&operation, &entry);
     KineticOperation_SendRequest_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
@@ -204,6 +220,7 @@ void test_KineticClient_Get_should_execute_GET_operation_and_retrieve_only_metad
     };
 
     KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
     KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &operation);
     KineticOperation_BuildGet_Expect(&operation, &entry);
     KineticOperation_SendRequest_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
@@ -216,3 +233,129 @@ void test_KineticClient_Get_should_execute_GET_operation_and_retrieve_only_metad
     KineticLogger_LogByteBuffer(0, "value", entry.value);
     TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
 }
+
+void test_KineticClient_GetNext_should_execute_GETNEXT_operation(void)
+{
+    LOG_LOCATION;
+    uint8_t keyData[32];
+    KineticEntry entry = {
+        .key = ByteBuffer_Create(keyData, sizeof(keyData), 0),
+        .value = ByteBuffer_Create(ValueData, sizeof(ValueData), 0),
+    };
+    ByteBuffer_AppendCString(&entry.key, "key_a");
+    KineticOperation operation = {
+        .connection = &Connection,
+        .request = &Request,
+        .response = &Response,
+    };
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &operation);
+    KineticOperation_BuildGetNext_Expect(&operation, &entry);
+    KineticOperation_SendRequest_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
+    KineticOperation_ReceiveAsync_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_GetNext(DummyHandle, &entry, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
+
+void test_KineticClient_GetPrevious_should_execute_GETPREVIOUS_operation(void)
+{
+    LOG_LOCATION;
+    uint8_t keyData[32];
+    KineticEntry entry = {
+        .key = ByteBuffer_Create(keyData, sizeof(keyData), 0),
+        .metadataOnly = true,
+    };
+    ByteBuffer_AppendCString(&entry.key, "key_z");
+    KineticOperation operation = {
+        .connection = &Connection,
+        .request = &Request,
+        .response = &Response,
+    };
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &operation);
+    KineticOperation_BuildGetPrevious_Expect(&operation, &entry);
+    KineticOperation_SendRequest_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
+    KineticOperation_ReceiveAsync_ExpectAndReturn(&operation, KINETIC_STATUS_NOT_FOUND);
+
+    KineticStatus status = KineticClient_GetPrevious(DummyHandle, &entry, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, status);
+}
+
+void test_KineticClient_OpenCursor_should_open_a_cursor_from_the_start_key(void)
+{
+    LOG_LOCATION;
+    ByteBuffer startKey = ByteBuffer_Create("key_a", 5, 5);
+    KineticCursor* cursor = NULL;
+    KineticCursor* opened = &Cursor;
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticCursor_Open_ExpectAndReturn(&Connection, &startKey, true, 8, &cursor, KINETIC_STATUS_SUCCESS);
+    KineticCursor_Open_ReturnThruPtr_cursor(&opened);
+
+    KineticStatus status = KineticClient_OpenCursor(DummyHandle, &startKey, true, 8, &cursor);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL_PTR(opened, cursor);
+}
+
+void test_KineticClient_NextEntry_SeekCursor_and_CloseCursor_should_delegate_to_the_cursor(void)
+{
+    LOG_LOCATION;
+    KineticCursor* cursor = &Cursor;
+    ByteBuffer key = ByteBuffer_Create("key_m", 5, 5);
+    KineticEntry entry = {.value = ByteBuffer_Create(ValueData, sizeof(ValueData), 0)};
+
+    KineticCursor_Next_ExpectAndReturn(cursor, &entry, KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticClient_NextEntry(cursor, &entry));
+
+    KineticCursor_Seek_ExpectAndReturn(cursor, &key, KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticClient_SeekCursor(cursor, &key));
+
+    KineticCursor_Close_Expect(cursor);
+    KineticClient_CloseCursor(cursor);
+}
+
+void test_KineticClient_GetMany_should_execute_a_batch_of_GET_operations(void)
+{
+    uint8_t valueData[16];
+    KineticEntry entries[2] = {
+        {.value = ByteBuffer_Create(valueData, sizeof(valueData), 0)},
+        {.metadataOnly = true},
+    };
+    KineticStatus statuses[2];
+    KineticCompletionClosure closure = {.callback = (KineticCompletionCallback)0x1234};
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticBatch_Execute_ExpectAndReturn(&Connection, entries, 2,
+        KineticOperation_BuildGet, statuses, NULL, &closure, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_GetMany(DummyHandle, entries, 2, statuses, &closure);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
+
+void test_KineticClient_GetStream_should_stream_the_object_over_the_specified_sessions(void)
+{
+    KineticSessionHandle handles[] = {DummyHandle, DummyHandle};
+    KineticConnection* connections[] = {&Connection, &Connection};
+    uint8_t data[64];
+    KineticStream stream = {
+        .key = ByteBuffer_Create("my_object", 9, 9),
+        .value = ByteBuffer_Create(data, sizeof(data), sizeof(data)),
+    };
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticStream_Get_ExpectAndReturn(connections, 2, &stream, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_GetStream(handles, 2, &stream);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
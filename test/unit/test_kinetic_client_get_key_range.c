@@ -31,6 +31,19 @@
 #include "mock_kinetic_connection.h"
 #include "mock_kinetic_message.h"
 #include "mock_kinetic_pdu.h"
+#include "mock_kinetic_key_iterator.h"
+#include "mock_kinetic_key_scan.h"
+#include "mock_kinetic_value_scan.h"
+#include "mock_kinetic_batch.h"
+#include "mock_kinetic_stream.h"
+#include "mock_kinetic_cursor.h"
+#include "mock_kinetic_log_poller.h"
+#include "mock_kinetic_group_commit.h"
+#include "mock_kinetic_session_pool.h"
+#include "mock_kinetic_cluster.h"
+#include "mock_kinetic_replication.h"
+#include "mock_kinetic_erasure.h"
+#include "mock_kinetic_hedge.h"
 #include <stdio.h>
 #include "protobuf-c/protobuf-c.h"
 #include "byte_array.h"
@@ -51,6 +64,7 @@ static ByteBuffer Keys[MAX_KEYS_RETRIEVED];
 static KineticSessionHandle DummyHandle = 1;
 static KineticSessionHandle SessionHandle = KINETIC_HANDLE_INVALID;
 static KineticPDU Request, Response;
+static KineticKeyIterator Iterator;
 
 void setUp(void)
 {
@@ -160,6 +174,7 @@ void test_KineticClient_GetKeyRange_should_return_a_list_of_keys_within_the_spec
     };
 
     KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
     KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &operation);
     KineticOperation_BuildGetKeyRange_Expect(&operation, &keyRange, &keyArray);
     KineticOperation_SendRequest_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
@@ -169,3 +184,105 @@ void test_KineticClient_GetKeyRange_should_return_a_list_of_keys_within_the_spec
 
     TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_BUFFER_OVERRUN, status);
 }
+
+void test_KineticClient_OpenKeyIterator_should_open_an_iterator_over_the_range(void)
+{
+    LOG_LOCATION;
+    KineticKeyRange range = {
+        .startKey = StartKey,
+        .endKey = EndKey,
+        .startKeyInclusive = true,
+        .endKeyInclusive = true,
+        .maxReturned = MAX_KEYS_RETRIEVED,
+    };
+    KineticKeyIterator* iterator = NULL;
+    KineticKeyIterator* opened = &Iterator;
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticKeyIterator_Open_ExpectAndReturn(&Connection, &range, &iterator, KINETIC_STATUS_SUCCESS);
+    KineticKeyIterator_Open_ReturnThruPtr_iterator(&opened);
+
+    KineticStatus status = KineticClient_OpenKeyIterator(DummyHandle, &range, &iterator);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL_PTR(opened, iterator);
+}
+
+void test_KineticClient_NextKey_and_CloseKeyIterator_should_delegate_to_the_iterator(void)
+{
+    LOG_LOCATION;
+    KineticKeyIterator* iterator = &Iterator;
+    ByteBuffer key = ByteBuffer_Create(KeyRangeData[0], KINETIC_MAX_KEY_LEN, 0);
+
+    KineticKeyIterator_Next_ExpectAndReturn(iterator, &key, KINETIC_STATUS_NOT_FOUND);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, KineticClient_NextKey(iterator, &key));
+
+    KineticKeyIterator_Close_Expect(iterator);
+    KineticClient_CloseKeyIterator(iterator);
+}
+
+static void TestScanCallback(int partition, const ByteBuffer* key, void* clientData)
+{
+    (void)partition;
+    (void)key;
+    (void)clientData;
+}
+
+void test_KineticClient_ScanKeyRange_should_scan_the_range_over_the_specified_sessions(void)
+{
+    LOG_LOCATION;
+    KineticSessionHandle handles[] = {DummyHandle, DummyHandle};
+    KineticConnection* connections[] = {&Connection, &Connection};
+    KineticKeyScan scan = {
+        .range = {
+            .startKey = StartKey,
+            .endKey = EndKey,
+            .maxReturned = MAX_KEYS_RETRIEVED,
+        },
+        .callback = TestScanCallback,
+    };
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticKeyScan_Execute_ExpectAndReturn(connections, 2, &scan, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_ScanKeyRange(handles, 2, &scan);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
+
+void test_KineticClient_ScanKeyRange_should_require_at_least_one_session(void)
+{
+    LOG_LOCATION;
+    KineticKeyScan scan = {.callback = TestScanCallback};
+
+    KineticStatus status = KineticClient_ScanKeyRange(NULL, 0, &scan);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST, status);
+}
+
+static void TestValueCallback(const KineticEntry* entry, void* clientData)
+{
+    (void)entry;
+    (void)clientData;
+}
+
+void test_KineticClient_ScanValues_should_scan_the_entries_in_the_range(void)
+{
+    LOG_LOCATION;
+    KineticKeyRange range = {
+        .startKey = StartKey,
+        .endKey = EndKey,
+        .maxReturned = MAX_KEYS_RETRIEVED,
+    };
+    int clientData;
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticValueScan_Execute_ExpectAndReturn(&Connection, &range, 4,
+        TestValueCallback, &clientData, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_ScanValues(DummyHandle, &range, 4,
+        TestValueCallback, &clientData);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
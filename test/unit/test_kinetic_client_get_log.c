@@ -0,0 +1,187 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_client.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_proto.h"
+#include "kinetic_logger.h"
+#include "mock_kinetic_allocator.h"
+#include "mock_kinetic_operation.h"
+#include "mock_kinetic_connection.h"
+#include "mock_kinetic_message.h"
+#include "mock_kinetic_pdu.h"
+#include "mock_kinetic_log_poller.h"
+#include "mock_kinetic_group_commit.h"
+#include "mock_kinetic_session_pool.h"
+#include "mock_kinetic_cluster.h"
+#include "mock_kinetic_replication.h"
+#include "mock_kinetic_erasure.h"
+#include "mock_kinetic_hedge.h"
+#include "mock_kinetic_batch.h"
+#include "mock_kinetic_stream.h"
+#include "mock_kinetic_key_iterator.h"
+#include "mock_kinetic_cursor.h"
+#include "mock_kinetic_key_scan.h"
+#include "mock_kinetic_value_scan.h"
+#include <stdio.h>
+#include "protobuf-c/protobuf-c.h"
+#include "byte_array.h"
+#include "unity.h"
+#include "unity_helper.h"
+
+static KineticSession Session;
+static KineticConnection Connection;
+static const int64_t ClusterVersion = 1234;
+static const int64_t Identity = 47;
+static ByteArray HmacKey;
+static KineticSessionHandle DummyHandle = 1;
+static KineticSessionHandle SessionHandle = KINETIC_HANDLE_INVALID;
+static KineticPDU Request, Response;
+static KineticDeviceLog Log;
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    KINETIC_CONNECTION_INIT(&Connection);
+    Connection.connected = false;
+    Connection.connectionID = 182736; // Dummy connection ID to allow connect to complete
+    HmacKey = ByteArray_CreateWithCString("some hmac key");
+    memset(&Log, 0, sizeof(Log));
+    KINETIC_SESSION_INIT(&Session, "somehost.com", ClusterVersion, Identity, HmacKey);
+
+    KineticConnection_NewConnection_ExpectAndReturn(&Session, DummyHandle);
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_Connect_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_Connect(&Session, &SessionHandle);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(DummyHandle, SessionHandle);
+}
+
+void tearDown(void)
+{
+    KineticLogger_Close();
+}
+
+// command {
+//   header {
+//     // See above for descriptions of these fields
+//     clusterVersion: ...
+//     identity: ...
+//     connectionID: ...
+//     sequence: ...
+//
+//     // messageType should be GETLOG
+//     messageType: GETLOG
+//   }
+//   body {
+//     // The list of log types to return
+//     getLog {
+//       types: UTILIZATIONS
+//       types: STATISTICS
+//     }
+//   }
+// }
+void test_KineticClient_GetLog_should_retrieve_the_requested_device_log_types(void)
+{
+    LOG_LOCATION;
+    int types = KINETIC_LOG_TYPE_UTILIZATIONS | KINETIC_LOG_TYPE_STATISTICS;
+    KineticOperation operation = {
+        .connection = &Connection,
+        .request = &Request,
+        .response = &Response,
+    };
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &operation);
+    KineticOperation_BuildGetLog_Expect(&operation, types, &Log);
+    KineticOperation_SendRequest_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
+    KineticOperation_ReceiveAsync_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_GetLog(DummyHandle, types, &Log, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
+
+void test_KineticClient_GetLog_should_reject_unknown_log_types(void)
+{
+    LOG_LOCATION;
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticClient_GetLog(DummyHandle, 0, &Log, NULL));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticClient_GetLog(DummyHandle, KINETIC_LOG_TYPE_ALL + 1, &Log, NULL));
+}
+
+void test_KineticClient_StartLogPolling_should_start_the_poller_on_the_connection(void)
+{
+    LOG_LOCATION;
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticLogPoller_Start_ExpectAndReturn(&Connection, KINETIC_LOG_TYPE_ALL, 250,
+        KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_StartLogPolling(DummyHandle, KINETIC_LOG_TYPE_ALL, 250);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
+
+void test_KineticClient_StartLogPolling_should_reject_an_invalid_session(void)
+{
+    LOG_LOCATION;
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SESSION_EMPTY,
+        KineticClient_StartLogPolling(KINETIC_HANDLE_INVALID, KINETIC_LOG_TYPE_ALL, 0));
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, NULL);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SESSION_INVALID,
+        KineticClient_StartLogPolling(DummyHandle, KINETIC_LOG_TYPE_ALL, 0));
+}
+
+void test_KineticClient_GetLogSnapshot_should_return_the_snapshot_from_the_poller(void)
+{
+    LOG_LOCATION;
+    KineticDeviceLog snapshot = {.types = KINETIC_LOG_TYPE_CAPACITIES};
+    snapshot.capacity.portionFull = 0.25f;
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticLogPoller_GetSnapshot_ExpectAndReturn(&Connection, &Log, KINETIC_STATUS_SUCCESS);
+    KineticLogPoller_GetSnapshot_ReturnThruPtr_log(&snapshot);
+
+    KineticStatus status = KineticClient_GetLogSnapshot(DummyHandle, &Log);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(KINETIC_LOG_TYPE_CAPACITIES, Log.types);
+    TEST_ASSERT_TRUE(Log.capacity.portionFull == 0.25f);
+}
+
+void test_KineticClient_StopLogPolling_should_stop_the_poller_on_the_connection(void)
+{
+    LOG_LOCATION;
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticLogPoller_Stop_Expect(&Connection);
+
+    KineticStatus status = KineticClient_StopLogPolling(DummyHandle);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
@@ -28,6 +28,19 @@
 #include "mock_kinetic_message.h"
 #include "mock_kinetic_pdu.h"
 #include "mock_kinetic_operation.h"
+#include "mock_kinetic_batch.h"
+#include "mock_kinetic_stream.h"
+#include "mock_kinetic_key_iterator.h"
+#include "mock_kinetic_cursor.h"
+#include "mock_kinetic_key_scan.h"
+#include "mock_kinetic_value_scan.h"
+#include "mock_kinetic_log_poller.h"
+#include "mock_kinetic_group_commit.h"
+#include "mock_kinetic_session_pool.h"
+#include "mock_kinetic_cluster.h"
+#include "mock_kinetic_replication.h"
+#include "mock_kinetic_erasure.h"
+#include "mock_kinetic_hedge.h"
 #include <stdio.h>
 #include "protobuf-c/protobuf-c.h"
 #include "byte_array.h"
@@ -75,6 +88,7 @@ void test_KineticClient_NoOp_should_execute_NOOP_operation_in_asynchronous_mode(
     };
 
     KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
     KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &operation);
     KineticOperation_BuildNoop_Expect(&operation);
     KineticOperation_SendRequest_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
@@ -84,3 +98,55 @@ void test_KineticClient_NoOp_should_execute_NOOP_operation_in_asynchronous_mode(
 
     TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
 }
+
+void test_KineticClient_NoOp_should_return_WOULD_BLOCK_if_in_flight_window_is_full(void)
+{
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_WOULD_BLOCK);
+
+    KineticStatus status = KineticClient_NoOp(DummyHandle);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_WOULD_BLOCK, status);
+}
+
+void test_KineticClient_NoOp_should_free_operation_and_release_window_if_send_fails(void)
+{
+    KineticOperation operation = {
+        .connection = &Connection,
+        .request = &Request,
+        .response = &Response,
+    };
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &operation);
+    KineticOperation_BuildNoop_Expect(&operation);
+    KineticOperation_SendRequest_ExpectAndReturn(&operation, KINETIC_STATUS_SOCKET_ERROR);
+    KineticAllocator_FreeOperation_Expect(&Connection, &operation);
+    KineticConnection_ReleaseWindow_Expect(&Connection);
+
+    KineticStatus status = KineticClient_NoOp(DummyHandle);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_ERROR, status);
+}
+
+void test_KineticClient_WaitUntilWindowAvailable_should_wait_on_the_session_window(void)
+{
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_WaitForWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticClient_WaitUntilWindowAvailable(DummyHandle));
+}
+
+void test_KineticClient_WaitUntilWindowAvailable_should_wait_on_any_connection_of_a_pooled_session(void)
+{
+    KineticSessionPool pool;
+    Connection.pool = &pool;
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticSessionPool_WaitForWindow_ExpectAndReturn(&pool, KINETIC_STATUS_SUCCESS);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticClient_WaitUntilWindowAvailable(DummyHandle));
+    Connection.pool = NULL;
+}
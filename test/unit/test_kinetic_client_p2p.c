@@ -0,0 +1,172 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_client.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_proto.h"
+#include "kinetic_logger.h"
+#include "mock_kinetic_allocator.h"
+#include "mock_kinetic_operation.h"
+#include "mock_kinetic_connection.h"
+#include "mock_kinetic_message.h"
+#include "mock_kinetic_pdu.h"
+#include "mock_kinetic_group_commit.h"
+#include "mock_kinetic_session_pool.h"
+#include "mock_kinetic_cluster.h"
+#include "mock_kinetic_replication.h"
+#include "mock_kinetic_erasure.h"
+#include "mock_kinetic_hedge.h"
+#include "mock_kinetic_batch.h"
+#include "mock_kinetic_stream.h"
+#include "mock_kinetic_key_iterator.h"
+#include "mock_kinetic_cursor.h"
+#include "mock_kinetic_key_scan.h"
+#include "mock_kinetic_value_scan.h"
+#include "mock_kinetic_log_poller.h"
+#include <stdio.h>
+#include "protobuf-c/protobuf-c.h"
+#include "byte_array.h"
+#include "unity.h"
+#include "unity_helper.h"
+
+static KineticSession Session;
+static KineticConnection Connection;
+static const int64_t ClusterVersion = 1234;
+static const int64_t Identity = 47;
+static ByteArray HmacKey;
+static KineticSessionHandle DummyHandle = 1;
+static KineticSessionHandle SessionHandle = KINETIC_HANDLE_INVALID;
+static KineticPDU Request, Response;
+static uint8_t KeyData[] = "p2p key";
+static KineticP2P_OperationData Operations[1];
+static KineticP2P_Operation P2POp;
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    KINETIC_CONNECTION_INIT(&Connection);
+    Connection.connected = false;
+    Connection.connectionID = 182736; // Dummy connection ID to allow connect to complete
+    HmacKey = ByteArray_CreateWithCString("some hmac key");
+    KINETIC_SESSION_INIT(&Session, "somehost.com", ClusterVersion, Identity, HmacKey);
+
+    KineticConnection_NewConnection_ExpectAndReturn(&Session, DummyHandle);
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_Connect_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_Connect(&Session, &SessionHandle);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(DummyHandle, SessionHandle);
+
+    Operations[0] = (KineticP2P_OperationData) {
+        .key = ByteBuffer_Create(KeyData, sizeof(KeyData), sizeof(KeyData)),
+    };
+    P2POp = (KineticP2P_Operation) {
+        .peer = {.hostname = "peerhost.com", .port = 8123},
+        .numOperations = 1,
+        .operations = Operations,
+    };
+}
+
+void tearDown(void)
+{
+    KineticLogger_Close();
+}
+
+// command {
+//   header {
+//     // See above for descriptions of these fields
+//     clusterVersion: ...
+//     identity: ...
+//     connectionID: ...
+//     sequence: ...
+//
+//     // messageType should be PEER2PEERPUSH
+//     messageType: PEER2PEERPUSH
+//   }
+//   body {
+//     p2pOperation {
+//       peer {
+//         hostname: "peerhost.com"
+//         port: 8123
+//         tls: false
+//       }
+//       operation {
+//         key: "p2p key"
+//       }
+//     }
+//   }
+// }
+void test_KineticClient_P2POperation_should_execute_a_PEER2PEERPUSH_operation(void)
+{
+    LOG_LOCATION;
+    KineticOperation operation = {
+        .connection = &Connection,
+        .request = &Request,
+        .response = &Response,
+    };
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &operation);
+    KineticOperation_BuildP2POperation_ExpectAndReturn(&operation, &P2POp, KINETIC_STATUS_SUCCESS);
+    KineticOperation_SendRequest_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
+    KineticOperation_ReceiveAsync_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_P2POperation(DummyHandle, &P2POp, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
+
+void test_KineticClient_P2POperation_should_reject_a_request_without_a_peer_or_entries(void)
+{
+    LOG_LOCATION;
+
+    P2POp.numOperations = 0;
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticClient_P2POperation(DummyHandle, &P2POp, NULL));
+
+    P2POp.numOperations = 1;
+    P2POp.peer.hostname[0] = '\0';
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticClient_P2POperation(DummyHandle, &P2POp, NULL));
+}
+
+void test_KineticClient_P2POperation_should_release_the_operation_if_it_could_not_be_built(void)
+{
+    LOG_LOCATION;
+    KineticOperation operation = {
+        .connection = &Connection,
+        .request = &Request,
+        .response = &Response,
+    };
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &operation);
+    KineticOperation_BuildP2POperation_ExpectAndReturn(&operation, &P2POp, KINETIC_STATUS_MEMORY_ERROR);
+    KineticAllocator_FreeOperation_Expect(&Connection, &operation);
+    KineticConnection_ReleaseWindow_Expect(&Connection);
+
+    KineticStatus status = KineticClient_P2POperation(DummyHandle, &P2POp, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_MEMORY_ERROR, status);
+}
@@ -28,6 +28,19 @@
 #include "mock_kinetic_connection.h"
 #include "mock_kinetic_message.h"
 #include "mock_kinetic_pdu.h"
+#include "mock_kinetic_batch.h"
+#include "mock_kinetic_stream.h"
+#include "mock_kinetic_key_iterator.h"
+#include "mock_kinetic_cursor.h"
+#include "mock_kinetic_key_scan.h"
+#include "mock_kinetic_value_scan.h"
+#include "mock_kinetic_log_poller.h"
+#include "mock_kinetic_group_commit.h"
+#include "mock_kinetic_session_pool.h"
+#include "mock_kinetic_cluster.h"
+#include "mock_kinetic_replication.h"
+#include "mock_kinetic_erasure.h"
+#include "mock_kinetic_hedge.h"
 #include <stdio.h>
 #include "protobuf-c/protobuf-c.h"
 #include "byte_array.h"
@@ -89,6 +102,7 @@ void test_KineticClient_Put_should_execute_PUT_operation(void)
     };
     
     KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
     KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &operation);
     KineticOperation_BuildPut_Expect(&operation, &entry);
     KineticOperation_SendRequest_ExpectAndReturn(&operation, KINETIC_STATUS_SUCCESS);
@@ -98,3 +112,63 @@ void test_KineticClient_Put_should_execute_PUT_operation(void)
 
     TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_VERSION_MISMATCH, status);
 }
+
+void test_KineticClient_PutBatch_should_execute_a_batch_of_PUT_operations(void)
+{
+    uint8_t valueData[2][16];
+    KineticEntry entries[2] = {
+        {.value = ByteBuffer_Create(valueData[0], sizeof(valueData[0]), 0)},
+        {.value = ByteBuffer_Create(valueData[1], sizeof(valueData[1]), 0)},
+    };
+    KineticStatus statuses[2];
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticBatch_Execute_ExpectAndReturn(&Connection, entries, 2,
+        KineticOperation_BuildPut, statuses, NULL, NULL, KINETIC_STATUS_NOT_FOUND);
+
+    KineticStatus status = KineticClient_PutBatch(DummyHandle, entries, 2, statuses, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, status);
+}
+
+void test_KineticClient_PutBatch_should_reject_an_invalid_session_handle(void)
+{
+    uint8_t valueData[16];
+    KineticEntry entry = {.value = ByteBuffer_Create(valueData, sizeof(valueData), 0)};
+    KineticStatus statuses[1];
+
+    KineticStatus status = KineticClient_PutBatch(KINETIC_HANDLE_INVALID, &entry, 1, statuses, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SESSION_EMPTY, status);
+}
+
+void test_KineticClient_PutStream_should_stream_the_object_over_the_specified_sessions(void)
+{
+    KineticSessionHandle handles[] = {DummyHandle, DummyHandle};
+    KineticConnection* connections[] = {&Connection, &Connection};
+    uint8_t data[64];
+    KineticStream stream = {
+        .key = ByteBuffer_Create("my_object", 9, 9),
+        .value = ByteBuffer_Create(data, sizeof(data), sizeof(data)),
+    };
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+    KineticStream_Put_ExpectAndReturn(connections, 2, &stream, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_PutStream(handles, 2, &stream);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
+
+void test_KineticClient_PutStream_should_reject_an_invalid_session_handle(void)
+{
+    KineticSessionHandle handles[] = {DummyHandle, KINETIC_HANDLE_INVALID};
+    KineticStream stream = {.key = ByteBuffer_Create("my_object", 9, 9)};
+
+    KineticConnection_FromHandle_ExpectAndReturn(DummyHandle, &Connection);
+
+    KineticStatus status = KineticClient_PutStream(handles, 2, &stream);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SESSION_EMPTY, status);
+}
@@ -0,0 +1,145 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "kinetic_client.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_proto.h"
+#include "kinetic_logger.h"
+#include "mock_kinetic_allocator.h"
+#include "mock_kinetic_operation.h"
+#include "mock_kinetic_connection.h"
+#include "mock_kinetic_message.h"
+#include "mock_kinetic_pdu.h"
+#include "mock_kinetic_log_poller.h"
+#include "mock_kinetic_group_commit.h"
+#include "mock_kinetic_session_pool.h"
+#include "mock_kinetic_cluster.h"
+#include "mock_kinetic_replication.h"
+#include "mock_kinetic_erasure.h"
+#include "mock_kinetic_hedge.h"
+#include "mock_kinetic_batch.h"
+#include "mock_kinetic_stream.h"
+#include "mock_kinetic_key_iterator.h"
+#include "mock_kinetic_cursor.h"
+#include "mock_kinetic_key_scan.h"
+#include "mock_kinetic_value_scan.h"
+#include <stdio.h>
+#include "protobuf-c/protobuf-c.h"
+#include "byte_array.h"
+#include "unity.h"
+#include "unity_helper.h"
+
+#define REPLICAS (3)
+
+static KineticSessionHandle Handles[REPLICAS] = {1, 2, 3};
+static KineticConnection Connections[REPLICAS];
+static KineticConnection* ConnectionList[REPLICAS];
+static KineticSessionPool PoolInstance;
+static uint8_t ValueData[] = "replicated value";
+static uint8_t KeyData[] = "replicated key";
+static KineticEntry Entry;
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    for (int i = 0; i < REPLICAS; i++) {
+        KINETIC_CONNECTION_INIT(&Connections[i]);
+        ConnectionList[i] = &Connections[i];
+    }
+    Entry = (KineticEntry) {
+        .key = ByteBuffer_Create(KeyData, sizeof(KeyData), sizeof(KeyData)),
+        .value = ByteBuffer_Create(ValueData, sizeof(ValueData), sizeof(ValueData)),
+    };
+}
+
+void tearDown(void)
+{
+    KineticLogger_Close();
+}
+
+static void ExpectReplicas(void)
+{
+    for (int i = 0; i < REPLICAS; i++) {
+        KineticConnection_FromHandle_ExpectAndReturn(Handles[i], &Connections[i]);
+    }
+}
+
+void test_KineticClient_ReplicatedPut_should_put_to_the_connection_of_each_replica(void)
+{
+    ExpectReplicas();
+    KineticReplication_Put_ExpectAndReturn(ConnectionList, REPLICAS, 2, &Entry, NULL,
+        KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_ReplicatedPut(Handles, REPLICAS, 2, &Entry, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
+
+void test_KineticClient_ReplicatedGet_should_get_from_the_connection_of_each_replica(void)
+{
+    KineticCompletionClosure closure = {.callback = NULL};
+    ExpectReplicas();
+    KineticReplication_Get_ExpectAndReturn(ConnectionList, REPLICAS, 2, &Entry, &closure,
+        KINETIC_STATUS_NOT_FOUND);
+
+    KineticStatus status = KineticClient_ReplicatedGet(Handles, REPLICAS, 2, &Entry, &closure);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, status);
+}
+
+void test_KineticClient_ReplicatedGet_should_select_a_connection_of_a_pooled_replica(void)
+{
+    Connections[0].pool = &PoolInstance;
+    ExpectReplicas();
+    KineticSessionPool_Select_ExpectAndReturn(&PoolInstance, &Connections[1]);
+    ConnectionList[0] = &Connections[1];
+    KineticReplication_Get_ExpectAndReturn(ConnectionList, REPLICAS, 1, &Entry, NULL,
+        KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticClient_ReplicatedGet(Handles, REPLICAS, 1, &Entry, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
+
+void test_KineticClient_ReplicatedPut_should_reject_an_invalid_number_of_replicas(void)
+{
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticClient_ReplicatedPut(Handles, 0, 1, &Entry, NULL));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticClient_ReplicatedPut(Handles, KINETIC_REPLICAS_MAX + 1, 1, &Entry, NULL));
+}
+
+void test_KineticClient_ReplicatedPut_should_reject_a_replica_without_a_session(void)
+{
+    KineticSessionHandle handles[REPLICAS] = {1, KINETIC_HANDLE_INVALID, 3};
+    KineticConnection_FromHandle_ExpectAndReturn(handles[0], &Connections[0]);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SESSION_EMPTY,
+        KineticClient_ReplicatedPut(handles, REPLICAS, 2, &Entry, NULL));
+}
+
+void test_KineticClient_ReplicatedGet_should_reject_a_replica_without_a_connection(void)
+{
+    KineticConnection_FromHandle_ExpectAndReturn(Handles[0], NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SESSION_INVALID,
+        KineticClient_ReplicatedGet(Handles, REPLICAS, 2, &Entry, NULL));
+}
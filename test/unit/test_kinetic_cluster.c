@@ -0,0 +1,277 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_cluster.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include "mock_kinetic_batch.h"
+#include "mock_kinetic_session_pool.h"
+#include "mock_kinetic_operation.h"
+#include "operation_test_fixture.h"
+#include <stdio.h>
+#include <string.h>
+
+#define DRIVES (5)
+#define KEYS (5000)
+
+static KineticCluster* Cluster;
+static KineticConnection Connections[DRIVES];
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    for (int i = 0; i < DRIVES; i++) {
+        KINETIC_CONNECTION_INIT(&Connections[i]);
+        sprintf(Connections[i].session.host, "drive%d.example.com", i);
+        Connections[i].session.port = KINETIC_PORT;
+    }
+    Cluster = KineticCluster_Create();
+    TEST_ASSERT_NOT_NULL(Cluster);
+}
+
+void tearDown(void)
+{
+    KineticCluster_Destroy(Cluster);
+    KineticLogger_Close();
+}
+
+static void AddDrives(int count)
+{
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+            KineticCluster_AddDrive(Cluster, (KineticSessionHandle)(i + 1), &Connections[i]));
+    }
+}
+
+static KineticConnection* Locate(int key)
+{
+    char keyData[32];
+    int len = sprintf(keyData, "object/%d", key);
+    ByteBuffer keyBuffer = ByteBuffer_Create(keyData, sizeof(keyData), len);
+    int drive = KineticCluster_Locate(Cluster, keyBuffer);
+    TEST_ASSERT_TRUE(drive >= 0);
+    return Cluster->drives[drive].connection;
+}
+
+static void LocateKeys(KineticConnection** owners)
+{
+    for (int key = 0; key < KEYS; key++) {
+        owners[key] = Locate(key);
+    }
+}
+
+static KineticEntry* BuiltEntry;
+
+static void TestBuild(KineticOperation* const operation, KineticEntry* const entry)
+{
+    (void)operation;
+    BuiltEntry = entry;
+}
+
+static int CompletedCount;
+static KineticStatus CompletedStatus;
+
+static void TestCompleted(KineticCompletionData* kinetic_data, void* client_data)
+{
+    (void)client_data;
+    CompletedCount++;
+    CompletedStatus = kinetic_data->status;
+}
+
+void test_KineticCluster_AddDrive_should_reject_a_drive_already_in_the_cluster(void)
+{
+    AddDrives(1);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticCluster_AddDrive(Cluster, 7, &Connections[0]));
+    TEST_ASSERT_EQUAL(1, Cluster->count);
+    TEST_ASSERT_EQUAL(KINETIC_CLUSTER_VIRTUAL_NODES, Cluster->pointCount);
+}
+
+void test_KineticCluster_Locate_should_spread_keys_evenly_across_the_drives(void)
+{
+    int counts[DRIVES] = {0};
+    AddDrives(DRIVES);
+
+    for (int key = 0; key < KEYS; key++) {
+        counts[Locate(key) - Connections]++;
+    }
+
+    // Within 30% of an even share
+    for (int i = 0; i < DRIVES; i++) {
+        TEST_ASSERT_INT_WITHIN(KEYS / DRIVES * 3 / 10, KEYS / DRIVES, counts[i]);
+    }
+}
+
+void test_KineticCluster_AddDrive_should_only_move_keys_to_the_new_drive(void)
+{
+    static KineticConnection* before[KEYS];
+    static KineticConnection* after[KEYS];
+    AddDrives(DRIVES - 1);
+    LocateKeys(before);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticCluster_AddDrive(Cluster, DRIVES, &Connections[DRIVES - 1]));
+    LocateKeys(after);
+
+    int moved = 0;
+    for (int key = 0; key < KEYS; key++) {
+        if (after[key] != before[key]) {
+            TEST_ASSERT_EQUAL_PTR(&Connections[DRIVES - 1], after[key]);
+            moved++;
+        }
+    }
+    TEST_ASSERT_INT_WITHIN(KEYS / DRIVES * 3 / 10, KEYS / DRIVES, moved);
+}
+
+void test_KineticCluster_RemoveDrive_should_only_move_the_keys_of_the_removed_drive(void)
+{
+    static KineticConnection* before[KEYS];
+    static KineticConnection* after[KEYS];
+    AddDrives(DRIVES);
+    LocateKeys(before);
+
+    KineticSessionHandle handle = KineticCluster_RemoveDrive(Cluster,
+        Connections[2].session.host, KINETIC_PORT);
+    TEST_ASSERT_EQUAL(3, handle);
+    TEST_ASSERT_EQUAL(DRIVES - 1, Cluster->count);
+    LocateKeys(after);
+
+    for (int key = 0; key < KEYS; key++) {
+        if (before[key] == &Connections[2]) {
+            TEST_ASSERT_TRUE(after[key] != &Connections[2]);
+        }
+        else {
+            TEST_ASSERT_EQUAL_PTR(before[key], after[key]);
+        }
+    }
+}
+
+void test_KineticCluster_RemoveDrive_should_report_a_drive_not_in_the_cluster(void)
+{
+    AddDrives(2);
+
+    TEST_ASSERT_EQUAL(KINETIC_HANDLE_INVALID,
+        KineticCluster_RemoveDrive(Cluster, "unknown.example.com", KINETIC_PORT));
+    TEST_ASSERT_EQUAL(2, Cluster->count);
+}
+
+void test_KineticCluster_Execute_should_submit_the_entry_to_the_drive_owning_its_key(void)
+{
+    uint8_t keyData[] = "object/42";
+    KineticEntry entry = {.key = ByteBuffer_Create(keyData, sizeof(keyData), sizeof(keyData))};
+    AddDrives(DRIVES);
+    int owner = KineticCluster_Locate(Cluster, entry.key);
+
+    KineticBatch_Execute_ExpectAndReturn(Cluster->drives[owner].connection, &entry, 1,
+        TestBuild, NULL, NULL, NULL, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticCluster_Execute(Cluster, &entry, TestBuild, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    for (int i = 0; i < DRIVES; i++) {
+        TEST_ASSERT_EQUAL(0, Cluster->drives[i].users);
+    }
+}
+
+void test_KineticCluster_Execute_should_keep_the_drive_in_use_until_an_asynchronous_request_completes(void)
+{
+    uint8_t keyData[] = "object/42";
+    KineticEntry entry = {.key = ByteBuffer_Create(keyData, sizeof(keyData), sizeof(keyData))};
+    KineticCompletionClosure closure = {.callback = TestCompleted};
+    KineticOperation operations[1];
+    memset(operations, 0, sizeof(operations));
+    AddDrives(DRIVES);
+    int owner = KineticCluster_Locate(Cluster, entry.key);
+    BuiltEntry = NULL;
+    CompletedCount = 0;
+
+    SubmitOperations(operations);
+    ExpectSubmit(Cluster->drives[owner].connection, true, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticCluster_Execute(Cluster, &entry, TestBuild, &closure);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    VerifySubmissions();
+    TEST_ASSERT_EQUAL_PTR(&entry, BuiltEntry);
+    TEST_ASSERT_EQUAL(1, Cluster->drives[owner].users);
+    TEST_ASSERT_EQUAL(0, CompletedCount);
+
+    CompleteOperation(&operations[0], KINETIC_STATUS_NOT_FOUND);
+
+    TEST_ASSERT_EQUAL(1, CompletedCount);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, CompletedStatus);
+    TEST_ASSERT_EQUAL(0, Cluster->drives[owner].users);
+}
+
+void test_KineticCluster_Execute_should_release_the_drive_if_an_asynchronous_request_is_not_sent(void)
+{
+    uint8_t keyData[] = "object/42";
+    KineticEntry entry = {.key = ByteBuffer_Create(keyData, sizeof(keyData), sizeof(keyData))};
+    KineticCompletionClosure closure = {.callback = TestCompleted};
+    KineticOperation operations[1];
+    memset(operations, 0, sizeof(operations));
+    AddDrives(DRIVES);
+    int owner = KineticCluster_Locate(Cluster, entry.key);
+    CompletedCount = 0;
+
+    SubmitOperations(operations);
+    ExpectSubmit(Cluster->drives[owner].connection, true, KINETIC_STATUS_SOCKET_ERROR);
+
+    KineticStatus status = KineticCluster_Execute(Cluster, &entry, TestBuild, &closure);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_ERROR, status);
+    VerifySubmissions();
+    TEST_ASSERT_EQUAL(0, Cluster->drives[owner].users);
+    TEST_ASSERT_EQUAL(0, CompletedCount);
+}
+
+void test_KineticCluster_Execute_should_select_a_connection_of_a_pooled_drive(void)
+{
+    uint8_t keyData[] = "object/42";
+    KineticEntry entry = {.key = ByteBuffer_Create(keyData, sizeof(keyData), sizeof(keyData))};
+    KineticSessionPool pool;
+    KineticConnection member;
+    KINETIC_CONNECTION_INIT(&member);
+    AddDrives(1);
+    Connections[0].pool = &pool;
+
+    KineticSessionPool_Select_ExpectAndReturn(&pool, &member);
+    KineticBatch_Execute_ExpectAndReturn(&member, &entry, 1, TestBuild, NULL, NULL, NULL,
+        KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticCluster_Execute(Cluster, &entry, TestBuild, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+}
+
+void test_KineticCluster_Execute_should_fail_without_any_drives(void)
+{
+    uint8_t keyData[] = "object/42";
+    KineticEntry entry = {.key = ByteBuffer_Create(keyData, sizeof(keyData), sizeof(keyData))};
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SESSION_EMPTY,
+        KineticCluster_Execute(Cluster, &entry, TestBuild, NULL));
+}
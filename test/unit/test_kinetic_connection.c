@@ -26,13 +26,18 @@
 #include "kinetic_logger.h"
 #include "kinetic_types.h"
 #include "kinetic_types_internal.h"
+#include "kinetic_nbo.h"
 #include "mock_kinetic_socket.h"
 #include "mock_kinetic_pdu.h"
 #include "mock_kinetic_operation.h"
 #include "mock_kinetic_allocator.h"
+#include "mock_kinetic_reactor.h"
+#include "mock_kinetic_hmac.h"
 #include "byte_array.h"
 #include <string.h>
 #include <sys/time.h>
+#include <time.h>
+#include <pthread.h>
 
 static KineticConnection* Connection;
 static KineticSessionHandle SessionHandle;
@@ -48,6 +53,11 @@ static KineticStatus LastStatus;
 void setUp(void)
 {
     KineticLogger_Init("stdout", 3);
+    KineticAllocator_InitPools_Ignore();
+    KineticAllocator_FreeAllOperations_Ignore();
+    KineticAllocator_FreeAllPDUs_Ignore();
+    KineticSocket_FreeReadBuffer_Ignore();
+    KineticHMAC_PrepareKey_Ignore();
     SessionHandle = KineticConnection_NewConnection(&SessionConfig);
     TEST_ASSERT_TRUE(SessionHandle > KINETIC_HANDLE_INVALID);
     Connection = KineticConnection_FromHandle(SessionHandle);
@@ -358,6 +368,7 @@ void test_KineticConnection_Worker_should_process_solicited_response_PDUs(void)
     };
     KineticOperation op;
     KINETIC_OPERATION_INIT(&op, Connection);
+    Connection->outstanding = 1; // as admitted into the in-flight window
     op.closure = (KineticCompletionClosure) {
         .callback = &DummyCompletionCallback,
         .clientData = &dummyClosureData,
@@ -400,6 +411,47 @@ void test_KineticConnection_Worker_should_process_solicited_response_PDUs(void)
     TEST_ASSERT_EQUAL(1, dummyClosureData.callbackCount);
 }
 
+static KineticStatus ResubmitStatus;
+
+static void ResubmittingCallback(KineticCompletionData* kinetic_data, void* client_data)
+{
+    (void)kinetic_data;
+    ResubmitStatus = KineticConnection_AcquireWindow((KineticConnection*)client_data);
+}
+
+void test_KineticConnection_ReceivePDU_should_free_a_window_slot_before_calling_the_closure(void)
+{
+    LOG_LOCATION;
+    Connection->connected = true;
+    Connection->session.outstandingOperationsMax = 1;
+    Connection->session.failOnFullWindow = false;
+    Connection->outstanding = 1; // the window is full with the operation completing
+    KineticOperation op;
+    KINETIC_OPERATION_INIT(&op, Connection);
+    op.closure = (KineticCompletionClosure) {
+        .callback = &ResubmittingCallback,
+        .clientData = Connection,
+    };
+    ResubmitStatus = KINETIC_STATUS_INVALID;
+    Response.type = KINETIC_PDU_TYPE_RESPONSE;
+    Response.proto->authType = KINETIC_PROTO_MESSAGE_AUTH_TYPE_HMACAUTH;
+    Response.proto->has_authType = true;
+
+    KineticAllocator_NewPDU_ExpectAndReturn(Connection, &Response);
+    KineticPDU_ReceiveMain_ExpectAndReturn(&Response, KINETIC_STATUS_SUCCESS);
+    KineticPDU_GetStatus_ExpectAndReturn(&Response, KINETIC_STATUS_SUCCESS);
+    KineticOperation_AssociateResponseWithOperation_ExpectAndReturn(&Response, &op);
+    KineticPDU_GetValueLength_ExpectAndReturn(&Response, 0);
+    KineticAllocator_FreeOperation_Expect(Connection, &op);
+
+    // The closure submitting another request must not block on the window
+    KineticConnection_ReceivePDU(Connection);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, ResubmitStatus);
+    TEST_ASSERT_EQUAL(1, Connection->outstanding);
+    Connection->connected = false;
+}
+
 void test_KineticConnection_Worker_should_process_solicited_response_PDUs_with_Value_payload(void)
 {
     LOG_LOCATION;
@@ -443,6 +495,7 @@ void test_KineticConnection_Worker_should_process_solicited_response_PDUs_with_V
     };
     KineticOperation op;
     KINETIC_OPERATION_INIT(&op, Connection);
+    Connection->outstanding = 1; // as admitted into the in-flight window
     op.closure = (KineticCompletionClosure) {
         .callback = &DummyCompletionCallback,
         .clientData = &dummyClosureData,
@@ -471,7 +524,7 @@ void test_KineticConnection_Worker_should_process_solicited_response_PDUs_with_V
     KineticPDU_GetStatus_ExpectAndReturn(&Response, KINETIC_STATUS_SUCCESS);
     KineticOperation_AssociateResponseWithOperation_ExpectAndReturn(&Response, &op);
     KineticPDU_GetValueLength_ExpectAndReturn(&Response, 83);
-    KineticPDU_ReceiveValue_ExpectAndReturn(socket, &entry.value, 83, KINETIC_STATUS_SUCCESS);
+    KineticPDU_ReceiveValue_ExpectAndReturn(Connection, &entry.value, 83, KINETIC_STATUS_SUCCESS);
     KineticAllocator_FreeOperation_Expect(Connection, &op);
 
     // Signal data has arrived so status PDU can be consumed
@@ -496,14 +549,460 @@ void test_KineticConnection_Worker_should_not_poll_but_instead_do_a_blocking_wai
 
 
 
-void test_KineticConnection_IncrementSequence_should_increment_the_sequence_count(void)
+void test_KineticConnection_Connect_should_hand_off_connection_to_reactor_if_requested(void)
+{
+    LOG_LOCATION;
+    const int socket = 24;
+    uint8_t dummyReactor;
+
+    Connection->session.useReactor = true;
+    KineticSocket_Connect_ExpectAndReturn(SessionConfig.host, SessionConfig.port,
+                                          SessionConfig.nonBlocking, socket);
+    KineticReactor_AddConnection_ExpectAndReturn(Connection, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticConnection_Connect(Connection);
+
+    TEST_ASSERT_EQUAL(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_TRUE(Connection->connected);
+    TEST_ASSERT_EQUAL(socket, Connection->socket);
+
+    // Simulate the reactor having taken ownership of the connection
+    Connection->reactor = (KineticReactor*)&dummyReactor;
+    KineticReactor_RemoveConnection_Expect(Connection);
+
+    status = KineticConnection_Disconnect(Connection);
+
+    TEST_ASSERT_EQUAL(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_FALSE(Connection->connected);
+}
+
+void test_KineticConnection_Connect_should_fall_back_to_worker_thread_if_reactor_unavailable(void)
+{
+    LOG_LOCATION;
+    const int socket = 24;
+
+    Connection->session.useReactor = true;
+    KineticSocket_Connect_ExpectAndReturn(SessionConfig.host, SessionConfig.port,
+                                          SessionConfig.nonBlocking, socket);
+    KineticReactor_AddConnection_ExpectAndReturn(Connection, KINETIC_STATUS_CONNECTION_ERROR);
+
+    // Setup mock expectations for worker thread so it can run in IDLE mode
+    KineticSocket_WaitUntilDataAvailable_IgnoreAndReturn(KINETIC_WAIT_STATUS_TIMED_OUT);
+
+    KineticStatus status = KineticConnection_Connect(Connection);
+
+    TEST_ASSERT_EQUAL(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_TRUE(Connection->connected);
+    TEST_ASSERT_NULL(Connection->reactor);
+}
+
+void test_KineticConnection_ReceivePDU_should_report_socket_errors(void)
+{
+    LOG_LOCATION;
+    KineticAllocator_NewPDU_ExpectAndReturn(Connection, &Response);
+    KineticPDU_ReceiveMain_ExpectAndReturn(&Response, KINETIC_STATUS_SOCKET_ERROR);
+    Response.proto = NULL;
+    KineticAllocator_FreePDU_Expect(Connection, &Response);
+
+    KineticStatus status = KineticConnection_ReceivePDU(Connection);
+
+    TEST_ASSERT_EQUAL(KINETIC_STATUS_SOCKET_ERROR, status);
+}
+
+static size_t DiscardedValueLength;
+
+static KineticStatus DiscardValue(KineticConnection* const connection,
+    ByteBuffer* value, size_t value_length, int cmock_num_calls)
+{
+    (void)cmock_num_calls;
+    TEST_ASSERT_EQUAL_PTR(Connection, connection);
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_TRUE(value->array.len < value_length);
+    DiscardedValueLength += value_length;
+    return KINETIC_STATUS_BUFFER_OVERRUN;
+}
+
+void test_KineticConnection_ReceivePDU_should_discard_the_value_of_an_unmatched_response(void)
+{
+    LOG_LOCATION;
+    Response.proto->authType = KINETIC_PROTO_MESSAGE_AUTH_TYPE_HMACAUTH;
+    Response.proto->has_authType = true;
+    DiscardedValueLength = 0;
+    KineticAllocator_NewPDU_ExpectAndReturn(Connection, &Response);
+    KineticPDU_ReceiveMain_ExpectAndReturn(&Response, KINETIC_STATUS_SUCCESS);
+    KineticPDU_GetStatus_ExpectAndReturn(&Response, KINETIC_STATUS_SUCCESS);
+    KineticOperation_AssociateResponseWithOperation_ExpectAndReturn(&Response, NULL);
+    KineticPDU_GetValueLength_ExpectAndReturn(&Response, 83);
+    KineticPDU_ReceiveValue_StubWithCallback(DiscardValue);
+    KineticAllocator_FreePDU_Expect(Connection, &Response);
+
+    KineticStatus status = KineticConnection_ReceivePDU(Connection);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(83, DiscardedValueLength);
+}
+
+// Places a PDU header at the front of the connection read buffer
+static void BufferHeader(uint8_t* data, size_t size, uint32_t protobufLength, uint32_t valueLength)
+{
+    KineticPDUHeader header = {
+        .versionPrefix = 'F',
+        .protobufLength = KineticNBO_FromHostU32(protobufLength),
+        .valueLength = KineticNBO_FromHostU32(valueLength),
+    };
+    memcpy(data, &header, sizeof(header));
+    Connection->readBuffer = (KineticReadBuffer) {
+        .data = data, .size = size, .start = 0, .end = sizeof(header)};
+}
+
+void test_KineticConnection_ReceiveAvailable_should_wait_for_a_PDU_header_to_arrive(void)
+{
+    LOG_LOCATION;
+    KineticSocket_ReadAvailable_ExpectAndReturn(Connection->socket, &Connection->readBuffer,
+        PDU_HEADER_LEN, KINETIC_STATUS_WOULD_BLOCK);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticConnection_ReceiveAvailable(Connection));
+}
+
+void test_KineticConnection_ReceiveAvailable_should_wait_for_the_rest_of_a_PDU_to_arrive(void)
+{
+    LOG_LOCATION;
+    uint8_t data[PDU_HEADER_LEN];
+    BufferHeader(data, sizeof(data), 100, 5);
+    KineticSocket_ReadAvailable_ExpectAndReturn(Connection->socket, &Connection->readBuffer,
+        PDU_HEADER_LEN, KINETIC_STATUS_SUCCESS);
+    KineticSocket_ReadAvailable_ExpectAndReturn(Connection->socket, &Connection->readBuffer,
+        PDU_HEADER_LEN + 100 + 5, KINETIC_STATUS_WOULD_BLOCK);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticConnection_ReceiveAvailable(Connection));
+
+    Connection->readBuffer = (KineticReadBuffer) {.data = NULL};
+}
+
+void test_KineticConnection_ReceiveAvailable_should_reject_an_oversized_PDU(void)
 {
     LOG_LOCATION;
-    Connection->sequence = 57;
-    KineticConnection_IncrementSequence(Connection);
-    TEST_ASSERT_EQUAL_INT64(58, Connection->sequence);
+    uint8_t data[PDU_HEADER_LEN];
+    BufferHeader(data, sizeof(data), 100, KINETIC_OBJ_SIZE + 1);
+    KineticSocket_ReadAvailable_ExpectAndReturn(Connection->socket, &Connection->readBuffer,
+        PDU_HEADER_LEN, KINETIC_STATUS_SUCCESS);
 
-    Connection->sequence = 0;
-    KineticConnection_IncrementSequence(Connection);
-    TEST_ASSERT_EQUAL_INT64(1, Connection->sequence);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_ERROR,
+        KineticConnection_ReceiveAvailable(Connection));
+
+    Connection->readBuffer = (KineticReadBuffer) {.data = NULL};
+}
+
+void test_KineticConnection_ReceiveAvailable_should_report_socket_errors(void)
+{
+    LOG_LOCATION;
+    KineticSocket_ReadAvailable_ExpectAndReturn(Connection->socket, &Connection->readBuffer,
+        PDU_HEADER_LEN, KINETIC_STATUS_SOCKET_ERROR);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_ERROR,
+        KineticConnection_ReceiveAvailable(Connection));
+}
+
+void test_KineticConnection_PendingOperations_should_be_found_by_sequence(void)
+{
+    LOG_LOCATION;
+    #define PENDING_TEST_COUNT (KINETIC_PENDING_OPERATIONS_BUCKETS * 2 + 3)
+    static KineticPDU requests[PENDING_TEST_COUNT];
+    static KineticOperation ops[PENDING_TEST_COUNT];
+    const int count = PENDING_TEST_COUNT;
+
+    // Add more operations than buckets, so that some share a bucket
+    for (int i = 0; i < count; i++) {
+        KINETIC_PDU_INIT_WITH_COMMAND(&requests[i], Connection);
+        requests[i].command->header->sequence = 1000 + i;
+        requests[i].command->header->has_sequence = true;
+        KINETIC_OPERATION_INIT(&ops[i], Connection);
+        ops[i].request = &requests[i];
+        KineticConnection_AddPendingOperation(Connection, &ops[i]);
+    }
+
+    TEST_ASSERT_NULL(KineticConnection_TakePendingOperation(Connection, 999));
+    TEST_ASSERT_NULL(KineticConnection_TakePendingOperation(Connection, 1000 + count));
+
+    // Remove one explicitly, as if its request timed out
+    TEST_ASSERT_TRUE(KineticConnection_RemovePendingOperation(Connection, &ops[5], true));
+    TEST_ASSERT_FALSE(KineticConnection_RemovePendingOperation(Connection, &ops[5], true));
+
+    for (int i = count - 1; i >= 0; i--) {
+        KineticOperation* op = KineticConnection_TakePendingOperation(Connection, 1000 + i);
+        if (i == 5) {
+            TEST_ASSERT_NULL(op);
+        }
+        else {
+            TEST_ASSERT_EQUAL_PTR(&ops[i], op);
+        }
+        TEST_ASSERT_NULL(KineticConnection_TakePendingOperation(Connection, 1000 + i));
+    }
+}
+
+static void AddPendingOperation(KineticOperation* op, KineticPDU* request, int64_t sequence)
+{
+    KINETIC_PDU_INIT_WITH_COMMAND(request, Connection);
+    request->command->header->sequence = sequence;
+    request->command->header->has_sequence = true;
+    KINETIC_OPERATION_INIT(op, Connection);
+    op->request = request;
+    KineticConnection_AddPendingOperation(Connection, op);
+}
+
+// Backdates when an operation was sent by the specified number of milliseconds
+static void SentEarlier(KineticOperation* op, int millis)
+{
+    int64_t nanos = (int64_t)op->sent.tv_nsec - (int64_t)millis * 1000000;
+    op->sent.tv_sec += nanos / 1000000000;
+    nanos %= 1000000000;
+    if (nanos < 0) {
+        op->sent.tv_sec--;
+        nanos += 1000000000;
+    }
+    op->sent.tv_nsec = (long)nanos;
+}
+
+void test_KineticConnection_PendingOperations_should_track_the_operations_in_flight(void)
+{
+    LOG_LOCATION;
+    static KineticPDU requests[3];
+    static KineticOperation ops[3];
+    for (int i = 0; i < 3; i++) {
+        AddPendingOperation(&ops[i], &requests[i], 100 + i);
+    }
+    TEST_ASSERT_EQUAL(3, Connection->inFlight);
+
+    TEST_ASSERT_EQUAL_PTR(&ops[0], KineticConnection_TakePendingOperation(Connection, 100));
+    TEST_ASSERT_NULL(KineticConnection_TakePendingOperation(Connection, 100));
+    TEST_ASSERT_EQUAL(2, Connection->inFlight);
+
+    TEST_ASSERT_TRUE(KineticConnection_RemovePendingOperation(Connection, &ops[1], true));
+    TEST_ASSERT_FALSE(KineticConnection_RemovePendingOperation(Connection, &ops[1], true));
+    TEST_ASSERT_EQUAL(1, Connection->inFlight);
+
+    TEST_ASSERT_EQUAL_PTR(&ops[2], KineticConnection_TakePendingOperation(Connection, 102));
+    TEST_ASSERT_EQUAL(0, Connection->inFlight);
+}
+
+void test_KineticConnection_TakePendingOperation_should_smooth_the_latency_of_responses(void)
+{
+    LOG_LOCATION;
+    static KineticPDU request;
+    static KineticOperation op;
+    TEST_ASSERT_EQUAL(0, Connection->latency);
+
+    // The first response sets the latency
+    AddPendingOperation(&op, &request, 200);
+    SentEarlier(&op, 80);
+    KineticConnection_TakePendingOperation(Connection, 200);
+    TEST_ASSERT_INT_WITHIN(20000, 80000, Connection->latency);
+
+    // Later ones move it an eighth of the way
+    Connection->latency = 80000;
+    AddPendingOperation(&op, &request, 201);
+    SentEarlier(&op, 160);
+    KineticConnection_TakePendingOperation(Connection, 201);
+    TEST_ASSERT_INT_WITHIN(2500, 90000, Connection->latency);
+
+    // Operations which failed to send are not measured
+    AddPendingOperation(&op, &request, 202);
+    SentEarlier(&op, 1000);
+    KineticConnection_RemovePendingOperation(Connection, &op, false);
+    TEST_ASSERT_INT_WITHIN(2500, 90000, Connection->latency);
+}
+
+void test_KineticConnection_RemovePendingOperation_should_count_the_time_abandoned_operations_waited(void)
+{
+    LOG_LOCATION;
+    static KineticPDU request;
+    static KineticOperation op;
+
+    // A connection which never responds no longer looks idle
+    AddPendingOperation(&op, &request, 300);
+    SentEarlier(&op, 2000);
+    KineticConnection_RemovePendingOperation(Connection, &op, true);
+    TEST_ASSERT_INT_WITHIN(200000, 2000000, Connection->latency);
+
+    // Abandoned sooner than the usual latency, nothing is learnt
+    Connection->latency = 80000;
+    AddPendingOperation(&op, &request, 301);
+    SentEarlier(&op, 10);
+    KineticConnection_RemovePendingOperation(Connection, &op, true);
+    TEST_ASSERT_EQUAL(80000, Connection->latency);
+
+    // Abandoned later, the time waited moves it an eighth of the way
+    AddPendingOperation(&op, &request, 302);
+    SentEarlier(&op, 880);
+    KineticConnection_RemovePendingOperation(Connection, &op, true);
+    TEST_ASSERT_INT_WITHIN(2500, 180000, Connection->latency);
+}
+
+void test_KineticConnection_SelectLeastLoaded_should_keep_the_first_if_no_other(void)
+{
+    LOG_LOCATION;
+    KineticConnection* connections[] = {Connection};
+    TEST_ASSERT_EQUAL(0, KineticConnection_SelectLeastLoaded(connections, 1, 0));
+}
+
+void test_KineticConnection_SelectLeastLoaded_should_keep_the_first_unless_another_is_less_loaded(void)
+{
+    LOG_LOCATION;
+    static KineticConnection others[2];
+    KineticConnection* connections[] = {&others[0], &others[1]};
+    for (int i = 0; i < 2; i++) {
+        KINETIC_CONNECTION_INIT(&others[i]);
+        others[i].connected = true;
+        others[i].latency = 1000;
+        others[i].inFlight = 2;
+    }
+
+    // Ties go to the first
+    TEST_ASSERT_EQUAL(0, KineticConnection_SelectLeastLoaded(connections, 2, 0));
+    TEST_ASSERT_EQUAL(1, KineticConnection_SelectLeastLoaded(connections, 2, 1));
+
+    // A faster connection with more in flight may still be less loaded
+    others[1].latency = 200;
+    others[1].inFlight = 8;
+    TEST_ASSERT_EQUAL(1, KineticConnection_SelectLeastLoaded(connections, 2, 0));
+
+    // As may a slower one with less in flight
+    others[1].latency = 2000;
+    others[1].inFlight = 0;
+    TEST_ASSERT_EQUAL(1, KineticConnection_SelectLeastLoaded(connections, 2, 0));
+
+    // A failed connection never is
+    others[1].thread.fatalError = true;
+    TEST_ASSERT_EQUAL(0, KineticConnection_SelectLeastLoaded(connections, 2, 0));
+    others[0].connected = false;
+    TEST_ASSERT_EQUAL(0, KineticConnection_SelectLeastLoaded(connections, 2, 0));
+}
+
+void test_KineticConnection_SelectLeastLoaded_should_steer_away_from_a_congested_connection(void)
+{
+    LOG_LOCATION;
+    #define LOADED_TEST_COUNT (4)
+    static KineticConnection others[LOADED_TEST_COUNT];
+    KineticConnection* connections[LOADED_TEST_COUNT];
+    for (int i = 0; i < LOADED_TEST_COUNT; i++) {
+        KINETIC_CONNECTION_INIT(&others[i]);
+        others[i].connected = true;
+        others[i].latency = 1000;
+        connections[i] = &others[i];
+    }
+    others[2].latency = 50000;
+    others[2].inFlight = 10;
+
+    // Every other is compared with it in time, but it is never chosen
+    bool compared[LOADED_TEST_COUNT] = {false};
+    for (int i = 0; i < 1000; i++) {
+        int selected = KineticConnection_SelectLeastLoaded(connections, LOADED_TEST_COUNT, 2);
+        TEST_ASSERT_NOT_EQUAL(2, selected);
+        compared[selected] = true;
+    }
+    TEST_ASSERT_TRUE(compared[0]);
+    TEST_ASSERT_TRUE(compared[1]);
+    TEST_ASSERT_TRUE(compared[3]);
+}
+
+void test_KineticConnection_AcquireWindow_should_not_limit_operations_if_no_maximum_configured(void)
+{
+    LOG_LOCATION;
+    Connection->session.outstandingOperationsMax = 0;
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+            KineticConnection_AcquireWindow(Connection));
+    }
+    TEST_ASSERT_EQUAL(100, Connection->outstanding);
+}
+
+void test_KineticConnection_AcquireWindow_should_return_WOULD_BLOCK_if_window_full_and_configured_to_fail(void)
+{
+    LOG_LOCATION;
+    Connection->session.outstandingOperationsMax = 2;
+    Connection->session.failOnFullWindow = true;
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticConnection_AcquireWindow(Connection));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticConnection_AcquireWindow(Connection));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_WOULD_BLOCK, KineticConnection_AcquireWindow(Connection));
+    TEST_ASSERT_EQUAL(2, Connection->outstanding);
+
+    KineticConnection_ReleaseWindow(Connection);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticConnection_AcquireWindow(Connection));
+    TEST_ASSERT_EQUAL(2, Connection->outstanding);
+}
+
+void test_KineticConnection_TryAcquireWindow_should_return_WOULD_BLOCK_if_window_full_even_if_configured_to_block(void)
+{
+    LOG_LOCATION;
+    Connection->session.outstandingOperationsMax = 1;
+    Connection->session.failOnFullWindow = false;
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticConnection_TryAcquireWindow(Connection));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_WOULD_BLOCK, KineticConnection_TryAcquireWindow(Connection));
+    TEST_ASSERT_EQUAL(1, Connection->outstanding);
+
+    KineticConnection_ReleaseWindow(Connection);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticConnection_TryAcquireWindow(Connection));
+    TEST_ASSERT_EQUAL(1, Connection->outstanding);
+}
+
+void test_KineticConnection_ReleaseWindow_should_signal_the_pool_the_connection_belongs_to(void)
+{
+    LOG_LOCATION;
+    KineticSessionPool pool = {
+        .mutex = PTHREAD_MUTEX_INITIALIZER,
+        .windowCond = PTHREAD_COND_INITIALIZER,
+    };
+    Connection->memberOf = &pool;
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticConnection_AcquireWindow(Connection));
+
+    KineticConnection_ReleaseWindow(Connection);
+
+    TEST_ASSERT_EQUAL(1, pool.released);
+    TEST_ASSERT_EQUAL(0, Connection->outstanding);
+    Connection->memberOf = NULL;
+}
+
+static void* ReleaseWindowAfterDelay(void* arg)
+{
+    struct timespec delay = {.tv_nsec = 50 * 1000 * 1000};
+    nanosleep(&delay, NULL);
+    KineticConnection_ReleaseWindow((KineticConnection*)arg);
+    return NULL;
+}
+
+void test_KineticConnection_AcquireWindow_should_block_until_an_operation_leaves_a_full_window(void)
+{
+    LOG_LOCATION;
+    Connection->connected = true;
+    Connection->session.outstandingOperationsMax = 1;
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticConnection_AcquireWindow(Connection));
+
+    pthread_t releaser;
+    TEST_ASSERT_EQUAL(0, pthread_create(&releaser, NULL, ReleaseWindowAfterDelay, Connection));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticConnection_AcquireWindow(Connection));
+    pthread_join(releaser, NULL);
+
+    TEST_ASSERT_EQUAL(1, Connection->outstanding);
+    Connection->connected = false;
+}
+
+void test_KineticConnection_WaitForWindow_should_report_a_failed_connection(void)
+{
+    LOG_LOCATION;
+    Connection->connected = true;
+    Connection->session.outstandingOperationsMax = 1;
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticConnection_AcquireWindow(Connection));
+    Connection->thread.fatalError = true;
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_CONNECTION_ERROR,
+        KineticConnection_WaitForWindow(Connection));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_CONNECTION_ERROR,
+        KineticConnection_AcquireWindow(Connection));
+
+    Connection->connected = false;
+    Connection->thread.fatalError = false;
 }
@@ -0,0 +1,257 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_cursor.h"
+#include "kinetic_key_iterator.h"
+#include "kinetic_entry.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include "mock_kinetic_operation.h"
+#include "operation_test_fixture.h"
+#include <pthread.h>
+
+#define NUM_OPERATIONS (5)
+
+// Response the receiver delivers for each operation, in submission order
+typedef struct _TestResponse {
+    bool page;              // page of keys, rather than an entry
+    const char* requestKey; // key expected in the entry requested
+    const char* keys[2];    // keys of the page, or key of the entry
+    KineticStatus status;   // status delivered, if not successful
+    int awaitSubmitted;     // operations to await before responding
+} TestResponse;
+
+static KineticConnection Connection;
+static KineticOperation Operations[NUM_OPERATIONS];
+static KineticPDU Requests[NUM_OPERATIONS];
+static TestResponse Responses[NUM_OPERATIONS];
+static KineticCursor* Cursor;
+static uint8_t StartKeyData[] = "key_a";
+static ByteBuffer StartKey;
+static uint8_t KeyData[KINETIC_MAX_KEY_LEN];
+static uint8_t ValueData[64];
+static KineticEntry Entry;
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    KINETIC_CONNECTION_INIT(&Connection);
+    for (int i = 0; i < NUM_OPERATIONS; i++) {
+        KINETIC_OPERATION_INIT(&Operations[i], &Connection);
+        Operations[i].request = &Requests[i];
+    }
+    memset(Responses, 0, sizeof(Responses));
+    Cursor = NULL;
+    StartKey = ByteBuffer_Create(StartKeyData, sizeof(StartKeyData) - 1, sizeof(StartKeyData) - 1);
+    Entry = (KineticEntry) {
+        .key = ByteBuffer_Create(KeyData, sizeof(KeyData), 0),
+        .value = ByteBuffer_Create(ValueData, sizeof(ValueData), 0),
+    };
+    SubmitOperations(Operations);
+}
+
+void tearDown(void)
+{
+    KineticCursor_Close(Cursor);
+    VerifySubmissions();
+    KineticLogger_Close();
+}
+
+// Plays the part of the receiver, responding to each operation once submitted.
+// An entry's value is its key in upper case.
+static void* Respond(void* arg)
+{
+    int count = *(int*)arg;
+    for (int i = 0; i < count; i++) {
+        TestResponse* response = &Responses[i];
+        KineticStatus status = (response->status == KINETIC_STATUS_NOT_ATTEMPTED) ?
+            KINETIC_STATUS_SUCCESS : response->status;
+        AwaitSubmitted(&Operations[i]);
+        for (int j = i + 1; j <= response->awaitSubmitted; j++) {
+            AwaitSubmitted(&Operations[j]);
+        }
+
+        if (response->page) {
+            KineticKeyPage* page = (KineticKeyPage*)Operations[i].closure.clientData;
+            page->keys.used = 0;
+            for (int k = 0; k < 2 && response->keys[k] != NULL; k++) {
+                ByteBuffer_Reset(&page->keys.buffers[k]);
+                ByteBuffer_AppendCString(&page->keys.buffers[k], response->keys[k]);
+                page->keys.used++;
+            }
+        }
+        else if (status == KINETIC_STATUS_SUCCESS) {
+            KineticCursorSlot* slot = (KineticCursorSlot*)Operations[i].closure.clientData;
+            TEST_ASSERT_EQUAL(strlen(response->requestKey), slot->entry.key.bytesUsed);
+            TEST_ASSERT_EQUAL(0, memcmp(response->requestKey, slot->entry.key.array.data,
+                slot->entry.key.bytesUsed));
+            ByteBuffer_Reset(&slot->entry.key);
+            ByteBuffer_AppendCString(&slot->entry.key, response->keys[0]);
+            ByteBuffer_Reset(&slot->entry.value);
+            for (const char* c = response->keys[0]; *c != '\0'; c++) {
+                uint8_t upper = (uint8_t)((*c >= 'a' && *c <= 'z') ? *c - 'a' + 'A' : *c);
+                ByteBuffer_Append(&slot->entry.value, &upper, 1);
+            }
+        }
+        CompleteOperation(&Operations[i], status);
+    }
+    return NULL;
+}
+
+static void AssertNextEntry(const char* key, const char* value)
+{
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticCursor_Next(Cursor, &Entry));
+    TEST_ASSERT_EQUAL(strlen(key), Entry.key.bytesUsed);
+    TEST_ASSERT_EQUAL(0, memcmp(key, KeyData, Entry.key.bytesUsed));
+    TEST_ASSERT_EQUAL(strlen(value), Entry.value.bytesUsed);
+    TEST_ASSERT_EQUAL(0, memcmp(value, ValueData, Entry.value.bytesUsed));
+}
+
+void test_KineticCursor_Next_should_step_with_GETNEXT_and_then_read_ahead_once_sequential(void)
+{
+    LOG_LOCATION;
+    int count = 5;
+    Responses[0] = (TestResponse) {.requestKey = "key_a", .keys = {"key_b"}};
+    Responses[1] = (TestResponse) {.requestKey = "key_b", .keys = {"key_c"}};
+    Responses[2] = (TestResponse) {.page = true, .keys = {"key_d", "key_e"}};
+    // Both entries are in flight before the first one arrives
+    Responses[3] = (TestResponse) {.requestKey = "key_d", .keys = {"key_d"}, .awaitSubmitted = 4};
+    Responses[4] = (TestResponse) {.requestKey = "key_e", .keys = {"key_e"}};
+    KineticOperation_BuildGetNext_Ignore();
+    KineticOperation_BuildGetKeyRange_Ignore();
+    KineticOperation_BuildGet_Ignore();
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticCursor_Open(&Connection, &StartKey, false, 2, &Cursor));
+    for (int i = 0; i < count; i++) {
+        ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+    }
+
+    pthread_t receiver;
+    TEST_ASSERT_EQUAL(0, pthread_create(&receiver, NULL, Respond, &count));
+    AssertNextEntry("key_b", "KEY_B");
+    AssertNextEntry("key_c", "KEY_C");
+    TEST_ASSERT_NULL(Cursor->keys);
+    AssertNextEntry("key_d", "KEY_D");
+    TEST_ASSERT_NOT_NULL(Cursor->keys);
+    AssertNextEntry("key_e", "KEY_E");
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, KineticCursor_Next(Cursor, &Entry));
+    pthread_join(receiver, NULL);
+
+    // The keys read ahead start beyond the last entry stepped to
+    KineticKeyPage* page = (KineticKeyPage*)Operations[2].closure.clientData;
+    TEST_ASSERT_EQUAL(0, memcmp("key_c", page->range.startKey.array.data, 5));
+    TEST_ASSERT_FALSE(page->range.startKeyInclusive);
+    TEST_ASSERT_FALSE(page->range.reverse);
+}
+
+void test_KineticCursor_Next_should_step_with_GETPREVIOUS_in_reverse(void)
+{
+    LOG_LOCATION;
+    int count = 1;
+    Responses[0] = (TestResponse) {.requestKey = "key_a", .keys = {"key_9"}};
+    KineticOperation_BuildGetPrevious_Ignore();
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticCursor_Open(&Connection, &StartKey, true, 0, &Cursor));
+    TEST_ASSERT_EQUAL(KINETIC_CURSOR_READ_AHEAD, Cursor->readAhead);
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+
+    pthread_t receiver;
+    TEST_ASSERT_EQUAL(0, pthread_create(&receiver, NULL, Respond, &count));
+    AssertNextEntry("key_9", "KEY_9");
+    pthread_join(receiver, NULL);
+}
+
+void test_KineticCursor_Next_should_report_the_end_of_the_keyspace_and_not_move(void)
+{
+    LOG_LOCATION;
+    int count = 2;
+    Responses[0] = (TestResponse) {.status = KINETIC_STATUS_NOT_FOUND};
+    Responses[1] = (TestResponse) {.requestKey = "key_a", .keys = {"key_b"}};
+    KineticOperation_BuildGetNext_Ignore();
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticCursor_Open(&Connection, &StartKey, false, 1, &Cursor));
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+
+    pthread_t receiver;
+    TEST_ASSERT_EQUAL(0, pthread_create(&receiver, NULL, Respond, &count));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, KineticCursor_Next(Cursor, &Entry));
+    AssertNextEntry("key_b", "KEY_B");
+    pthread_join(receiver, NULL);
+}
+
+void test_KineticCursor_Next_should_report_an_entry_which_does_not_fit_and_not_move(void)
+{
+    LOG_LOCATION;
+    int count = 2;
+    Responses[0] = (TestResponse) {.requestKey = "key_a", .keys = {"key_b"}};
+    Responses[1] = (TestResponse) {.requestKey = "key_a", .keys = {"key_b"}};
+    KineticOperation_BuildGetNext_Ignore();
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticCursor_Open(&Connection, &StartKey, false, 1, &Cursor));
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+
+    pthread_t receiver;
+    TEST_ASSERT_EQUAL(0, pthread_create(&receiver, NULL, Respond, &count));
+    Entry.value.array.len = 2;
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_BUFFER_OVERRUN, KineticCursor_Next(Cursor, &Entry));
+    TEST_ASSERT_EQUAL(5, Entry.value.bytesUsed);
+    Entry.value.array.len = sizeof(ValueData);
+    AssertNextEntry("key_b", "KEY_B");
+    pthread_join(receiver, NULL);
+}
+
+void test_KineticCursor_Seek_should_move_the_cursor_and_return_to_stepping(void)
+{
+    LOG_LOCATION;
+    int count = 2;
+    Responses[0] = (TestResponse) {.requestKey = "key_a", .keys = {"key_b"}};
+    Responses[1] = (TestResponse) {.requestKey = "key_x", .keys = {"key_y"}};
+    KineticOperation_BuildGetNext_Ignore();
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticCursor_Open(&Connection, &StartKey, false, 2, &Cursor));
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+
+    pthread_t receiver;
+    TEST_ASSERT_EQUAL(0, pthread_create(&receiver, NULL, Respond, &count));
+    AssertNextEntry("key_b", "KEY_B");
+    ByteBuffer key = ByteBuffer_Create("key_x", 5, 5);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticCursor_Seek(Cursor, &key));
+    TEST_ASSERT_EQUAL(0, Cursor->steps);
+    AssertNextEntry("key_y", "KEY_Y");
+    pthread_join(receiver, NULL);
+}
+
+void test_KineticCursor_Open_should_reject_too_many_entries_read_ahead(void)
+{
+    LOG_LOCATION;
+    KineticStatus status = KineticCursor_Open(&Connection, &StartKey, false,
+        KINETIC_CURSOR_READ_AHEAD_MAX + 1, &Cursor);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST, status);
+    TEST_ASSERT_NULL(Cursor);
+}
@@ -26,4 +26,90 @@
 #include <string.h>
 #include <stdlib.h>
 
-// Need some tests!
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_KineticEntry_CopyBuffer_should_copy_into_the_destination(void)
+{
+    uint8_t data[8];
+    ByteBuffer dest = ByteBuffer_Create(data, sizeof(data), 3);
+    ByteBuffer src = ByteBuffer_Create("abcd", 4, 4);
+
+    TEST_ASSERT_TRUE(KineticEntry_CopyBuffer(&dest, &src));
+    TEST_ASSERT_EQUAL(4, dest.bytesUsed);
+    TEST_ASSERT_EQUAL_MEMORY("abcd", data, 4);
+}
+
+void test_KineticEntry_CopyBuffer_should_report_the_length_required_if_too_small(void)
+{
+    uint8_t data[2];
+    ByteBuffer dest = ByteBuffer_Create(data, sizeof(data), 0);
+    ByteBuffer src = ByteBuffer_Create("abcd", 4, 4);
+
+    TEST_ASSERT_FALSE(KineticEntry_CopyBuffer(&dest, &src));
+    TEST_ASSERT_EQUAL(4, dest.bytesUsed);
+}
+
+void test_KineticEntry_CopyRetrieved_should_leave_the_value_alone_if_only_metadata_was_asked_for(void)
+{
+    uint8_t valueData[8], versionData[8], tagData[8];
+    KineticEntry dest = {
+        .value = ByteBuffer_Create(valueData, sizeof(valueData), 0),
+        .dbVersion = ByteBuffer_Create(versionData, sizeof(versionData), 0),
+        .tag = ByteBuffer_Create(tagData, sizeof(tagData), 0),
+        .metadataOnly = true,
+    };
+    KineticEntry src = {
+        .value = ByteBuffer_Create("value", 5, 5),
+        .dbVersion = ByteBuffer_Create("v1", 2, 2),
+        .tag = ByteBuffer_Create("tag", 3, 3),
+        .algorithm = KINETIC_ALGORITHM_SHA1,
+    };
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticEntry_CopyRetrieved(&dest, &src));
+    TEST_ASSERT_EQUAL(0, dest.value.bytesUsed);
+    TEST_ASSERT_EQUAL(2, dest.dbVersion.bytesUsed);
+    TEST_ASSERT_EQUAL_MEMORY("v1", versionData, 2);
+    TEST_ASSERT_EQUAL(3, dest.tag.bytesUsed);
+    TEST_ASSERT_EQUAL(KINETIC_ALGORITHM_SHA1, dest.algorithm);
+
+    dest.metadataOnly = false;
+    dest.value.array.len = 2;
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_BUFFER_OVERRUN,
+        KineticEntry_CopyRetrieved(&dest, &src));
+    TEST_ASSERT_EQUAL(5, dest.value.bytesUsed);
+}
+
+void test_KineticEntry_PromoteVersion_should_copy_newVersion_into_dbVersion_if_both_supplied(void)
+{
+    uint8_t versionData[8];
+    KineticEntry entry = {
+        .dbVersion = ByteBuffer_Create(versionData, sizeof(versionData), 0),
+        .newVersion = ByteBuffer_Create("v2", 2, 2),
+    };
+
+    KineticEntry_PromoteVersion(&entry);
+
+    TEST_ASSERT_EQUAL_PTR(versionData, entry.dbVersion.array.data);
+    TEST_ASSERT_EQUAL(2, entry.dbVersion.bytesUsed);
+    TEST_ASSERT_EQUAL_MEMORY("v2", versionData, 2);
+    TEST_ASSERT_EQUAL(0, entry.newVersion.bytesUsed);
+}
+
+void test_KineticEntry_PromoteVersion_should_move_newVersion_into_dbVersion_if_only_newVersion_supplied(void)
+{
+    ByteBuffer newVersion = ByteBuffer_Create("v2", 2, 2);
+    KineticEntry entry = {.newVersion = newVersion};
+
+    KineticEntry_PromoteVersion(&entry);
+
+    TEST_ASSERT_EQUAL_PTR(newVersion.array.data, entry.dbVersion.array.data);
+    TEST_ASSERT_EQUAL(2, entry.dbVersion.bytesUsed);
+    TEST_ASSERT_NULL(entry.newVersion.array.data);
+}
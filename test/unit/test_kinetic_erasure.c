@@ -0,0 +1,349 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_erasure.h"
+#include "kinetic_reed_solomon.h"
+#include "kinetic_fan_out.h"
+#include "kinetic_entry.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include "mock_kinetic_operation.h"
+#include "operation_test_fixture.h"
+#include <stdio.h>
+#include <string.h>
+
+#define DATA_FRAGMENTS (3)
+#define PARITY_FRAGMENTS (2)
+#define FRAGMENTS (DATA_FRAGMENTS + PARITY_FRAGMENTS)
+
+static KineticConnection Connections[FRAGMENTS];
+static KineticConnection* ConnectionList[FRAGMENTS];
+static KineticOperation Operations[2 * FRAGMENTS]; // a PUT of each fragment, then a GET
+static KineticPDU Requests[2 * FRAGMENTS];
+static KineticOperation* Fragments;                 // operations of the current request
+static uint8_t KeyData[] = "erasure coded key";
+static const char Value[] = "The quick brown fox jumps over the lazy dog";
+static uint8_t ValueData[64];
+static uint8_t VersionData[KINETIC_MAX_VERSION_LEN];
+static uint8_t NewVersionData[KINETIC_MAX_VERSION_LEN];
+static KineticEntry Entry;
+static uint8_t Stored[FRAGMENTS][64];
+static size_t StoredLength[FRAGMENTS];
+static KineticStatus CompletedStatus;
+static int Completions;
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    for (int i = 0; i < FRAGMENTS; i++) {
+        KINETIC_CONNECTION_INIT(&Connections[i]);
+        sprintf(Connections[i].session.host, "drive%d.example.com", i);
+        Connections[i].session.port = KINETIC_PORT;
+        ConnectionList[i] = &Connections[i];
+    }
+    for (int i = 0; i < 2 * FRAGMENTS; i++) {
+        KINETIC_OPERATION_INIT(&Operations[i], &Connections[i % FRAGMENTS]);
+        Operations[i].request = &Requests[i];
+    }
+    Fragments = Operations;
+    memset(ValueData, 0, sizeof(ValueData));
+    Entry = (KineticEntry) {
+        .key = ByteBuffer_Create(KeyData, sizeof(KeyData), sizeof(KeyData)),
+        .value = ByteBuffer_Create(ValueData, sizeof(ValueData), 0),
+        .dbVersion = ByteBuffer_Create(VersionData, sizeof(VersionData), 0),
+        .newVersion = ByteBuffer_Create(NewVersionData, sizeof(NewVersionData), 0),
+    };
+    CompletedStatus = KINETIC_STATUS_INVALID;
+    Completions = 0;
+    SubmitOperations(Operations);
+}
+
+void tearDown(void)
+{
+    VerifySubmissions();
+    KineticLogger_Close();
+}
+
+static void Completed(KineticCompletionData* kinetic_data, void* client_data)
+{
+    TEST_ASSERT_EQUAL_PTR(&Entry, client_data);
+    CompletedStatus = kinetic_data->status;
+    Completions++;
+}
+
+static KineticCompletionClosure Closure = {.callback = Completed, .clientData = &Entry};
+
+static void ExpectOperations(KineticStatus sendStatus)
+{
+    for (int i = 0; i < FRAGMENTS; i++) {
+        ExpectSubmit(&Connections[i], true, sendStatus);
+    }
+}
+
+static KineticEntry* FragmentEntry(int index)
+{
+    return &((KineticErasureFragment*)Fragments[index].closure.clientData)->member.entry;
+}
+
+// Plays the part of the receiver, completing the operation as the device did
+static void Respond(int index, KineticStatus status)
+{
+    CompleteOperation(&Fragments[index], status);
+}
+
+// Stores the value with a PUT of each fragment, keeping the fragments to
+// respond to GETs with
+static void Store(void)
+{
+    ByteBuffer_AppendCString(&Entry.value, Value);
+    KineticOperation_BuildPut_Ignore();
+    ExpectOperations(KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticErasure_Put(ConnectionList, DATA_FRAGMENTS, PARITY_FRAGMENTS, &Entry, &Closure));
+    for (int i = 0; i < FRAGMENTS; i++) {
+        KineticEntry* fragment = FragmentEntry(i);
+        memcpy(Stored[i], fragment->value.array.data, fragment->value.bytesUsed);
+        StoredLength[i] = fragment->value.bytesUsed;
+        Respond(i, KINETIC_STATUS_SUCCESS);
+    }
+    TEST_ASSERT_EQUAL(1, Completions);
+    Completions = 0;
+    memset(ValueData, 0, sizeof(ValueData));
+    ByteBuffer_Reset(&Entry.value);
+    Fragments = &Operations[FRAGMENTS];
+}
+
+// Completes a GET with the fragment stored on the session, as stored with
+// the version given
+static void RespondVersion(int index, const char* version)
+{
+    KineticEntry* fragment = FragmentEntry(index);
+    ByteBuffer_Append(&fragment->value, Stored[index], StoredLength[index]);
+    ByteBuffer_AppendCString(&fragment->dbVersion, version);
+    Respond(index, KINETIC_STATUS_SUCCESS);
+}
+
+// Completes a GET with the fragment stored on the session
+static void RespondFragment(int index)
+{
+    RespondVersion(index, "v1");
+}
+
+void test_KineticErasure_Put_should_reject_invalid_fragment_counts(void)
+{
+    LOG_LOCATION;
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticErasure_Put(ConnectionList, 0, 2, &Entry, &Closure));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticErasure_Put(ConnectionList, 3, -1, &Entry, &Closure));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticErasure_Put(ConnectionList, KINETIC_ERASURE_FRAGMENTS_MAX, 1, &Entry, &Closure));
+    TEST_ASSERT_EQUAL(0, Completions);
+}
+
+void test_KineticErasure_Put_should_store_a_fragment_on_each_session_and_complete_once_all_are_stored(void)
+{
+    LOG_LOCATION;
+    ByteBuffer_AppendCString(&Entry.value, Value);
+    ByteBuffer_AppendCString(&Entry.newVersion, "v1");
+    KineticOperation_BuildPut_Ignore();
+    ExpectOperations(KINETIC_STATUS_SUCCESS);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticErasure_Put(ConnectionList, DATA_FRAGMENTS, PARITY_FRAGMENTS, &Entry, &Closure));
+
+    // Each fragment holds its header and a third of the value, under the same key
+    size_t share = (strlen(Value) + DATA_FRAGMENTS - 1) / DATA_FRAGMENTS;
+    for (int i = 0; i < FRAGMENTS; i++) {
+        KineticEntry* fragment = FragmentEntry(i);
+        TEST_ASSERT_EQUAL(sizeof(KeyData), fragment->key.bytesUsed);
+        TEST_ASSERT_EQUAL(0, memcmp(KeyData, fragment->key.array.data, sizeof(KeyData)));
+        TEST_ASSERT_EQUAL(8 + share, fragment->value.bytesUsed);
+        TEST_ASSERT_EQUAL(i, fragment->value.array.data[0]);
+        TEST_ASSERT_EQUAL(2, fragment->newVersion.bytesUsed);
+    }
+    TEST_ASSERT_EQUAL(0, memcmp(Value, &FragmentEntry(0)->value.array.data[8], share));
+    TEST_ASSERT_EQUAL(0, memcmp(&Value[share], &FragmentEntry(1)->value.array.data[8], share));
+
+    for (int i = 0; i < FRAGMENTS - 1; i++) {
+        Respond(i, KINETIC_STATUS_SUCCESS);
+        TEST_ASSERT_EQUAL(0, Completions);
+    }
+    Respond(FRAGMENTS - 1, KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, CompletedStatus);
+    TEST_ASSERT_EQUAL(2, Entry.dbVersion.bytesUsed);
+    TEST_ASSERT_EQUAL(0, memcmp("v1", VersionData, 2));
+}
+
+void test_KineticErasure_Put_should_report_the_first_fragment_failure(void)
+{
+    LOG_LOCATION;
+    ByteBuffer_AppendCString(&Entry.value, Value);
+    KineticOperation_BuildPut_Ignore();
+    ExpectOperations(KINETIC_STATUS_SUCCESS);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticErasure_Put(ConnectionList, DATA_FRAGMENTS, PARITY_FRAGMENTS, &Entry, &Closure));
+    Respond(0, KINETIC_STATUS_SUCCESS);
+    Respond(3, KINETIC_STATUS_DATA_ERROR);
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_DATA_ERROR, CompletedStatus);
+
+    for (int i = 1; i < FRAGMENTS; i++) {
+        if (i != 3) {
+            Respond(i, KINETIC_STATUS_SUCCESS);
+        }
+    }
+    TEST_ASSERT_EQUAL(1, Completions);
+}
+
+void test_KineticErasure_Put_should_complete_a_synchronous_put_which_fails_to_send(void)
+{
+    LOG_LOCATION;
+    ByteBuffer_AppendCString(&Entry.value, Value);
+    KineticOperation_BuildPut_Ignore();
+    ExpectOperations(KINETIC_STATUS_SOCKET_ERROR);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_ERROR,
+        KineticErasure_Put(ConnectionList, DATA_FRAGMENTS, PARITY_FRAGMENTS, &Entry, NULL));
+}
+
+void test_KineticErasure_Get_should_decode_from_the_first_data_fragments_to_arrive(void)
+{
+    LOG_LOCATION;
+    Store();
+    KineticOperation_BuildGet_Ignore();
+    ExpectOperations(KINETIC_STATUS_SUCCESS);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticErasure_Get(ConnectionList, DATA_FRAGMENTS, PARITY_FRAGMENTS, &Entry, &Closure));
+    RespondFragment(2);
+    RespondFragment(0);
+    TEST_ASSERT_EQUAL(0, Completions);
+    RespondFragment(1);
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, CompletedStatus);
+    TEST_ASSERT_EQUAL(strlen(Value), Entry.value.bytesUsed);
+    TEST_ASSERT_EQUAL(0, memcmp(Value, ValueData, strlen(Value)));
+    TEST_ASSERT_EQUAL(2, Entry.dbVersion.bytesUsed);
+
+    // The parity fragments arrive too late to be needed
+    RespondFragment(3);
+    RespondFragment(4);
+    TEST_ASSERT_EQUAL(1, Completions);
+}
+
+void test_KineticErasure_Get_should_decode_missing_data_fragments_from_parity(void)
+{
+    LOG_LOCATION;
+    Store();
+    KineticOperation_BuildGet_Ignore();
+    ExpectOperations(KINETIC_STATUS_SUCCESS);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticErasure_Get(ConnectionList, DATA_FRAGMENTS, PARITY_FRAGMENTS, &Entry, &Closure));
+    RespondFragment(4);
+    Respond(0, KINETIC_STATUS_SOCKET_TIMEOUT);
+    RespondFragment(3);
+    TEST_ASSERT_EQUAL(0, Completions);
+    RespondFragment(2);
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, CompletedStatus);
+    TEST_ASSERT_EQUAL(strlen(Value), Entry.value.bytesUsed);
+    TEST_ASSERT_EQUAL(0, memcmp(Value, ValueData, strlen(Value)));
+
+    RespondFragment(1);
+    TEST_ASSERT_EQUAL(1, Completions);
+}
+
+void test_KineticErasure_Get_should_fail_once_more_than_the_parity_fragments_are_lost(void)
+{
+    LOG_LOCATION;
+    Store();
+    KineticOperation_BuildGet_Ignore();
+    ExpectOperations(KINETIC_STATUS_SUCCESS);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticErasure_Get(ConnectionList, DATA_FRAGMENTS, PARITY_FRAGMENTS, &Entry, &Closure));
+    Respond(1, KINETIC_STATUS_NOT_FOUND);
+    RespondFragment(0);
+    Respond(2, KINETIC_STATUS_NOT_FOUND);
+    TEST_ASSERT_EQUAL(0, Completions);
+
+    // A fragment stored for another index is not used
+    KineticEntry* fragment = FragmentEntry(3);
+    ByteBuffer_Append(&fragment->value, Stored[4], StoredLength[4]);
+    Respond(3, KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, CompletedStatus);
+
+    RespondFragment(4);
+    TEST_ASSERT_EQUAL(1, Completions);
+}
+
+void test_KineticErasure_Get_should_decode_from_the_first_version_with_enough_fragments(void)
+{
+    LOG_LOCATION;
+    Store();
+    KineticOperation_BuildGet_Ignore();
+    ExpectOperations(KINETIC_STATUS_SUCCESS);
+
+    // A stale fragment arriving first does not stop the others being used
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticErasure_Get(ConnectionList, DATA_FRAGMENTS, PARITY_FRAGMENTS, &Entry, &Closure));
+    RespondVersion(0, "v0");
+    RespondFragment(1);
+    RespondFragment(2);
+    TEST_ASSERT_EQUAL(0, Completions);
+    RespondFragment(3);
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, CompletedStatus);
+    TEST_ASSERT_EQUAL(strlen(Value), Entry.value.bytesUsed);
+    TEST_ASSERT_EQUAL(0, memcmp(Value, ValueData, strlen(Value)));
+    TEST_ASSERT_EQUAL(0, memcmp("v1", VersionData, Entry.dbVersion.bytesUsed));
+
+    RespondFragment(4);
+    TEST_ASSERT_EQUAL(1, Completions);
+}
+
+void test_KineticErasure_Get_should_fail_if_no_version_has_enough_fragments(void)
+{
+    LOG_LOCATION;
+    Store();
+    KineticOperation_BuildGet_Ignore();
+    ExpectOperations(KINETIC_STATUS_SUCCESS);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticErasure_Get(ConnectionList, DATA_FRAGMENTS, PARITY_FRAGMENTS, &Entry, &Closure));
+    RespondVersion(0, "v0");
+    RespondVersion(1, "v0");
+    RespondFragment(2);
+    RespondFragment(3);
+    TEST_ASSERT_EQUAL(0, Completions);
+    Respond(4, KINETIC_STATUS_SOCKET_TIMEOUT);
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_VERSION_MISMATCH, CompletedStatus);
+}
@@ -0,0 +1,216 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_fan_out.h"
+#include "kinetic_entry.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include "mock_kinetic_operation.h"
+#include "operation_test_fixture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MEMBERS (3)
+
+// Fan-out completing the caller once every member has succeeded, or any
+// has failed
+typedef struct _TestFanOut {
+    KineticFanOut fanOut;
+    KineticFanOutMember members[MEMBERS];
+} TestFanOut;
+
+static KineticConnection Connections[MEMBERS];
+static KineticOperation Operations[MEMBERS];
+static KineticPDU Requests[MEMBERS];
+static uint8_t KeyData[] = "fanned out key";
+static uint8_t VersionData[KINETIC_MAX_VERSION_LEN];
+static uint8_t NewVersionData[KINETIC_MAX_VERSION_LEN];
+static KineticEntry Entry;
+static KineticStatus CompletedStatus;
+static int Completions;
+static int Releases;
+
+static bool Check(KineticFanOutMember* const member, KineticStatus* const status)
+{
+    (void)member;
+    return *status == KINETIC_STATUS_SUCCESS;
+}
+
+static bool Decide(KineticFanOut* const fanOut, KineticStatus* const status)
+{
+    if (fanOut->failed > 0) {
+        *status = fanOut->failure;
+        return true;
+    }
+    return fanOut->succeeded == fanOut->count;
+}
+
+static void Release(KineticFanOut* const fanOut)
+{
+    Releases++;
+    KineticFanOut_Destroy(fanOut);
+}
+
+static const KineticFanOutPolicy Policy = {
+    .member = "Member",
+    .check = Check,
+    .decide = Decide,
+    .release = Release,
+};
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    for (int i = 0; i < MEMBERS; i++) {
+        KINETIC_CONNECTION_INIT(&Connections[i]);
+        sprintf(Connections[i].session.host, "drive%d.example.com", i);
+        Connections[i].session.port = KINETIC_PORT;
+        KINETIC_OPERATION_INIT(&Operations[i], &Connections[i]);
+        Operations[i].request = &Requests[i];
+    }
+    Entry = (KineticEntry) {
+        .key = ByteBuffer_Create(KeyData, sizeof(KeyData), sizeof(KeyData)),
+        .dbVersion = ByteBuffer_Create(VersionData, sizeof(VersionData), 0),
+        .newVersion = ByteBuffer_Create(NewVersionData, sizeof(NewVersionData), 0),
+    };
+    CompletedStatus = KINETIC_STATUS_INVALID;
+    Completions = 0;
+    Releases = 0;
+    SubmitOperations(Operations);
+}
+
+void tearDown(void)
+{
+    VerifySubmissions();
+    KineticLogger_Close();
+}
+
+static void Completed(KineticCompletionData* kinetic_data, void* client_data)
+{
+    TEST_ASSERT_EQUAL_PTR(&Entry, client_data);
+    CompletedStatus = kinetic_data->status;
+    Completions++;
+}
+
+static KineticCompletionClosure Closure = {.callback = Completed, .clientData = &Entry};
+
+static TestFanOut* Create(bool reading)
+{
+    TestFanOut* test = (TestFanOut*)calloc(1, sizeof(TestFanOut));
+    TEST_ASSERT_NOT_NULL(test);
+    KineticFanOut_Init(&test->fanOut, &Policy, MEMBERS, reading, &Entry, &Closure);
+    for (int i = 0; i < MEMBERS; i++) {
+        KineticFanOut_AddMember(&test->fanOut, i, &test->members[i], &Connections[i]);
+    }
+    return test;
+}
+
+void test_KineticFanOut_CheckEntry_should_reject_fields_too_long_for_members(void)
+{
+    LOG_LOCATION;
+    TEST_ASSERT_TRUE(KineticFanOut_CheckEntry(&Entry));
+
+    Entry.dbVersion.bytesUsed = KINETIC_MAX_VERSION_LEN + 1;
+    TEST_ASSERT_FALSE(KineticFanOut_CheckEntry(&Entry));
+}
+
+void test_KineticFanOut_AddMember_should_give_members_their_own_key_and_versions(void)
+{
+    LOG_LOCATION;
+    ByteBuffer_AppendCString(&Entry.dbVersion, "v1");
+    ByteBuffer_AppendCString(&Entry.newVersion, "v2");
+
+    TestFanOut* test = Create(false);
+
+    KineticEntry* entry = &test->members[1].entry;
+    TEST_ASSERT_EQUAL_PTR(test->fanOut.keyData, entry->key.array.data);
+    TEST_ASSERT_EQUAL(sizeof(KeyData), entry->key.bytesUsed);
+    TEST_ASSERT_EQUAL_PTR(test->members[1].versionData, entry->dbVersion.array.data);
+    TEST_ASSERT_EQUAL(2, entry->dbVersion.bytesUsed);
+    TEST_ASSERT_EQUAL_PTR(test->members[1].newVersionData, entry->newVersion.array.data);
+    TEST_ASSERT_EQUAL(2, entry->newVersion.bytesUsed);
+    KineticFanOut_Destroy(&test->fanOut);
+}
+
+void test_KineticFanOut_AddMember_should_not_send_versions_with_a_GET(void)
+{
+    LOG_LOCATION;
+    ByteBuffer_AppendCString(&Entry.dbVersion, "v1");
+
+    TestFanOut* test = Create(true);
+
+    KineticEntry* entry = &test->members[0].entry;
+    TEST_ASSERT_EQUAL(0, entry->dbVersion.bytesUsed);
+    TEST_ASSERT_NULL(entry->newVersion.array.data);
+    KineticFanOut_Destroy(&test->fanOut);
+}
+
+void test_KineticFanOut_Execute_should_complete_the_caller_as_the_policy_decides(void)
+{
+    LOG_LOCATION;
+    KineticOperation_BuildPut_Ignore();
+    for (int i = 0; i < MEMBERS; i++) {
+        ExpectSubmit(&Connections[i], true, KINETIC_STATUS_SUCCESS);
+    }
+
+    TestFanOut* test = Create(false);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticFanOut_Execute(&test->fanOut));
+    TEST_ASSERT_EQUAL(0, Completions);
+
+    CompleteOperation(&Operations[0], KINETIC_STATUS_SUCCESS);
+    CompleteOperation(&Operations[1], KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL(0, Completions);
+    TEST_ASSERT_EQUAL(0, Releases);
+
+    CompleteOperation(&Operations[2], KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, CompletedStatus);
+    TEST_ASSERT_EQUAL(1, Releases);
+}
+
+void test_KineticFanOut_Execute_should_count_a_failure_to_submit_as_a_member_failure(void)
+{
+    LOG_LOCATION;
+    KineticOperation_BuildGet_Ignore();
+    ExpectSubmit(&Connections[0], true, KINETIC_STATUS_SUCCESS);
+    ExpectSubmit(&Connections[1], true, KINETIC_STATUS_CONNECTION_ERROR);
+    ExpectSubmit(&Connections[2], true, KINETIC_STATUS_SUCCESS);
+
+    TestFanOut* test = Create(true);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticFanOut_Execute(&test->fanOut));
+
+    // Completed once all requests have been sent, but released only once
+    // the members in flight are done
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_CONNECTION_ERROR, CompletedStatus);
+    CompleteOperation(&Operations[0], KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL(0, Releases);
+    CompleteOperation(&Operations[2], KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL(1, Releases);
+}
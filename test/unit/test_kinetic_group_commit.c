@@ -0,0 +1,226 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_group_commit.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include "mock_kinetic_connection.h"
+#include "mock_kinetic_operation.h"
+#include "operation_test_fixture.h"
+#include <pthread.h>
+#include <time.h>
+
+// Long enough that only a barrier, or enough writes, trigger a flush
+#define DELAY_MS (60000)
+
+typedef struct _Response {
+    KineticOperation* operation;
+    KineticStatus status;
+} Response;
+
+static KineticConnection Connection;
+static KineticOperation Operations[2]; // the PUT, and then the FLUSHALLDATA
+static KineticPDU Requests[2];
+static KineticEntry Entry;
+static uint8_t ValueData[] = "some value";
+static KineticStatus Statuses[2];
+static int Completions;
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    KINETIC_CONNECTION_INIT(&Connection);
+    for (int i = 0; i < 2; i++) {
+        KINETIC_OPERATION_INIT(&Operations[i], &Connection);
+        Operations[i].request = &Requests[i];
+    }
+    Entry = (KineticEntry) {
+        .value = ByteBuffer_Create(ValueData, sizeof(ValueData), sizeof(ValueData)),
+        .synchronization = KINETIC_SYNCHRONIZATION_WRITETHROUGH,
+    };
+    Statuses[0] = Statuses[1] = KINETIC_STATUS_INVALID;
+    Completions = 0;
+    SubmitOperations(Operations);
+}
+
+void tearDown(void)
+{
+    VerifySubmissions();
+    KineticLogger_Close();
+}
+
+// Plays the part of the receiver, responding to an operation once it has
+// been configured with a closure
+static void* Respond(void* arg)
+{
+    Response* response = (Response*)arg;
+    AwaitSubmitted(response->operation);
+    nanosleep(&(struct timespec) {.tv_nsec = 10000000}, NULL);
+    CompleteOperation(response->operation, response->status);
+    return NULL;
+}
+
+static void Completed(KineticCompletionData* kinetic_data, void* client_data)
+{
+    KineticStatus* status = (KineticStatus*)client_data;
+    *status = kinetic_data->status;
+    Completions++;
+}
+
+static void ExpectPut(void)
+{
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+    KineticOperation_BuildPut_Expect(&Operations[0], &Entry);
+}
+
+static void ExpectFlush(void)
+{
+    ExpectSubmit(&Connection, false, KINETIC_STATUS_SUCCESS);
+    KineticOperation_BuildFlush_Expect(&Operations[1]);
+}
+
+void test_KineticGroupCommit_Start_should_reject_invalid_settings(void)
+{
+    LOG_LOCATION;
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticGroupCommit_Start(&Connection, -1, DELAY_MS));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticGroupCommit_Start(&Connection, 1, -1));
+    TEST_ASSERT_NULL(Connection.groupCommit);
+}
+
+void test_KineticGroupCommit_Put_and_Flush_should_fail_if_group_commit_not_started(void)
+{
+    LOG_LOCATION;
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticGroupCommit_Put(&Connection, &Entry, NULL));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticGroupCommit_Flush(&Connection, NULL));
+}
+
+void test_KineticGroupCommit_Put_should_complete_once_a_flush_after_the_write_succeeds(void)
+{
+    LOG_LOCATION;
+    Response putResponse = {.operation = &Operations[0], .status = KINETIC_STATUS_SUCCESS};
+    Response flushResponse = {.operation = &Operations[1], .status = KINETIC_STATUS_SUCCESS};
+    pthread_t putReceiver, flushReceiver;
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticGroupCommit_Start(&Connection, 1, DELAY_MS));
+    ExpectPut();
+    ExpectFlush();
+    TEST_ASSERT_EQUAL(0, pthread_create(&putReceiver, NULL, Respond, &putResponse));
+    TEST_ASSERT_EQUAL(0, pthread_create(&flushReceiver, NULL, Respond, &flushResponse));
+
+    KineticStatus status = KineticGroupCommit_Put(&Connection, &Entry, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(KINETIC_SYNCHRONIZATION_WRITEBACK, Entry.synchronization);
+    pthread_join(putReceiver, NULL);
+    pthread_join(flushReceiver, NULL);
+
+    KineticGroupCommit_Stop(&Connection);
+    TEST_ASSERT_NULL(Connection.groupCommit);
+}
+
+void test_KineticGroupCommit_Put_should_report_a_failed_write_without_flushing(void)
+{
+    LOG_LOCATION;
+    Response putResponse = {.operation = &Operations[0], .status = KINETIC_STATUS_VERSION_MISMATCH};
+    pthread_t putReceiver;
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticGroupCommit_Start(&Connection, 1, DELAY_MS));
+    ExpectPut();
+    TEST_ASSERT_EQUAL(0, pthread_create(&putReceiver, NULL, Respond, &putResponse));
+
+    KineticStatus status = KineticGroupCommit_Put(&Connection, &Entry, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_VERSION_MISMATCH, status);
+    pthread_join(putReceiver, NULL);
+
+    KineticGroupCommit_Stop(&Connection);
+}
+
+void test_KineticGroupCommit_Flush_should_share_one_flush_with_the_writes_waiting(void)
+{
+    LOG_LOCATION;
+    Response putResponse = {.operation = &Operations[0], .status = KINETIC_STATUS_SUCCESS};
+    Response flushResponse = {.operation = &Operations[1], .status = KINETIC_STATUS_DATA_ERROR};
+    KineticCompletionClosure putClosure = {.callback = Completed, .clientData = &Statuses[0]};
+    KineticCompletionClosure flushClosure = {.callback = Completed, .clientData = &Statuses[1]};
+    pthread_t putReceiver, flushReceiver;
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticGroupCommit_Start(&Connection, 100, DELAY_MS));
+    ExpectPut();
+    ExpectFlush();
+    TEST_ASSERT_EQUAL(0, pthread_create(&putReceiver, NULL, Respond, &putResponse));
+
+    KineticStatus status = KineticGroupCommit_Put(&Connection, &Entry, &putClosure);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    pthread_join(putReceiver, NULL);
+    TEST_ASSERT_EQUAL(1, Connection.groupCommit->waitingCount);
+    TEST_ASSERT_EQUAL(0, Completions);
+
+    TEST_ASSERT_EQUAL(0, pthread_create(&flushReceiver, NULL, Respond, &flushResponse));
+    status = KineticGroupCommit_Flush(&Connection, &flushClosure);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    pthread_join(flushReceiver, NULL);
+
+    // The write was acknowledged, but is reported as failed, since the flush
+    // which was to make it durable failed
+    TEST_ASSERT_EQUAL(2, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_DATA_ERROR, Statuses[0]);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_DATA_ERROR, Statuses[1]);
+
+    KineticGroupCommit_Stop(&Connection);
+    TEST_ASSERT_NULL(Connection.groupCommit);
+}
+
+void test_KineticGroupCommit_Stop_should_flush_the_writes_waiting(void)
+{
+    LOG_LOCATION;
+    Response putResponse = {.operation = &Operations[0], .status = KINETIC_STATUS_SUCCESS};
+    Response flushResponse = {.operation = &Operations[1], .status = KINETIC_STATUS_SUCCESS};
+    KineticCompletionClosure putClosure = {.callback = Completed, .clientData = &Statuses[0]};
+    pthread_t putReceiver, flushReceiver;
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticGroupCommit_Start(&Connection, 100, DELAY_MS));
+    ExpectPut();
+    ExpectFlush();
+    TEST_ASSERT_EQUAL(0, pthread_create(&putReceiver, NULL, Respond, &putResponse));
+    TEST_ASSERT_EQUAL(0, pthread_create(&flushReceiver, NULL, Respond, &flushResponse));
+
+    KineticStatus status = KineticGroupCommit_Put(&Connection, &Entry, &putClosure);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+
+    KineticGroupCommit_Stop(&Connection);
+
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, Statuses[0]);
+    TEST_ASSERT_NULL(Connection.groupCommit);
+    pthread_join(putReceiver, NULL);
+    pthread_join(flushReceiver, NULL);
+}
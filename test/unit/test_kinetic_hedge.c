@@ -0,0 +1,284 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_hedge.h"
+#include "kinetic_entry.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include "mock_kinetic_connection.h"
+#include "mock_kinetic_operation.h"
+#include "operation_test_fixture.h"
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#define REPLICAS (2)
+
+static KineticConnection Connections[REPLICAS];
+static KineticConnection* ConnectionList[REPLICAS];
+static KineticOperation Operations[REPLICAS]; // in the order submitted
+static KineticPDU Requests[REPLICAS];
+static uint8_t KeyData[] = "hedged key";
+static uint8_t ValueData[64];
+static uint8_t VersionData[KINETIC_MAX_VERSION_LEN];
+static KineticEntry Entry;
+static KineticStatus CompletedStatus;
+static int Completions;
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    for (int i = 0; i < REPLICAS; i++) {
+        KINETIC_CONNECTION_INIT(&Connections[i]);
+        sprintf(Connections[i].session.host, "drive%d.example.com", i);
+        Connections[i].session.port = KINETIC_PORT;
+        ConnectionList[i] = &Connections[i];
+        KINETIC_OPERATION_INIT(&Operations[i], &Connections[i]);
+        Operations[i].request = &Requests[i];
+    }
+    memset(ValueData, 0, sizeof(ValueData));
+    Entry = (KineticEntry) {
+        .key = ByteBuffer_Create(KeyData, sizeof(KeyData), sizeof(KeyData)),
+        .value = ByteBuffer_Create(ValueData, sizeof(ValueData), 0),
+        .dbVersion = ByteBuffer_Create(VersionData, sizeof(VersionData), 0),
+    };
+    CompletedStatus = KINETIC_STATUS_INVALID;
+    Completions = 0;
+    SubmitOperations(Operations);
+}
+
+void tearDown(void)
+{
+    VerifySubmissions();
+    KineticHedge_Shutdown();
+    KineticLogger_Close();
+}
+
+static void Completed(KineticCompletionData* kinetic_data, void* client_data)
+{
+    TEST_ASSERT_EQUAL_PTR(&Entry, client_data);
+    CompletedStatus = kinetic_data->status;
+    Completions++;
+}
+
+static KineticCompletionClosure Closure = {.callback = Completed, .clientData = &Entry};
+
+// Makes the usual GET latency of a replica the specified number of milliseconds
+static void RecordLatencies(int index, uint32_t millis)
+{
+    for (int i = 0; i < KINETIC_HEDGE_SAMPLES_MIN; i++) {
+        KineticHedge_RecordLatency(&Connections[index], millis * 1000);
+    }
+}
+
+static void ExpectFirst(int index)
+{
+    KineticConnection_SelectLeastLoaded_ExpectAndReturn(ConnectionList, REPLICAS, 0, index);
+}
+
+// Expects the GET of a replica, which waits for room in the window unless hedged
+static void ExpectOperation(int index, bool hedged, KineticStatus sendStatus)
+{
+    ExpectSubmit(&Connections[index], !hedged, sendStatus);
+}
+
+// Plays the part of the receiver, completing the GET submitted with the
+// specified index with the entry the replica holds
+static void Respond(int index, KineticStatus status, const char* value)
+{
+    KineticHedgeRequest* request = (KineticHedgeRequest*)Operations[index].closure.clientData;
+    if (value != NULL) {
+        ByteBuffer_AppendCString(&request->entry.value, value);
+        ByteBuffer_AppendCString(&request->entry.dbVersion, "v1");
+    }
+    CompleteOperation(&Operations[index], status);
+}
+
+static void* RespondWhenHedged(void* arg)
+{
+    (void)arg;
+    AwaitSubmitted(&Operations[1]);
+    Respond(1, KINETIC_STATUS_SUCCESS, "second");
+    return NULL;
+}
+
+void test_KineticHedge_Delay_should_default_until_enough_latencies_are_known(void)
+{
+    LOG_LOCATION;
+    TEST_ASSERT_EQUAL(KINETIC_HEDGE_DELAY_MS * 1000, KineticHedge_Delay(&Connections[0]));
+
+    KineticHedge_RecordLatency(&Connections[0], 123);
+
+    TEST_ASSERT_EQUAL(KINETIC_HEDGE_DELAY_MS * 1000, KineticHedge_Delay(&Connections[0]));
+}
+
+void test_KineticHedge_Delay_should_be_the_percentile_of_recent_latencies(void)
+{
+    LOG_LOCATION;
+    for (uint32_t i = 20; i > 0; i--) {
+        KineticHedge_RecordLatency(&Connections[0], i * 1000);
+    }
+
+    TEST_ASSERT_EQUAL((20 * KINETIC_HEDGE_PERCENTILE + 99) / 100 * 1000,
+        KineticHedge_Delay(&Connections[0]));
+}
+
+void test_KineticHedge_Delay_should_forget_the_oldest_latencies(void)
+{
+    LOG_LOCATION;
+    for (int i = 0; i < KINETIC_HEDGE_SAMPLES; i++) {
+        KineticHedge_RecordLatency(&Connections[0], 1000000);
+    }
+    for (int i = 0; i < KINETIC_HEDGE_SAMPLES; i++) {
+        KineticHedge_RecordLatency(&Connections[0], 500);
+    }
+
+    TEST_ASSERT_EQUAL(KINETIC_HEDGE_SAMPLES, Connections[0].getLatency.count);
+    TEST_ASSERT_EQUAL(500, KineticHedge_Delay(&Connections[0]));
+}
+
+void test_KineticHedge_Get_should_reject_an_invalid_number_of_replicas(void)
+{
+    LOG_LOCATION;
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticHedge_Get(ConnectionList, 0, &Entry, &Closure));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticHedge_Get(ConnectionList, KINETIC_REPLICAS_MAX + 1, &Entry, &Closure));
+    TEST_ASSERT_EQUAL(0, Completions);
+}
+
+void test_KineticHedge_Get_should_not_hedge_a_GET_answered_within_the_delay(void)
+{
+    LOG_LOCATION;
+    RecordLatencies(0, 1000);
+    KineticOperation_BuildGet_Ignore();
+    ExpectFirst(0);
+    ExpectOperation(0, false, KINETIC_STATUS_SUCCESS);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticHedge_Get(ConnectionList, REPLICAS, &Entry, &Closure));
+    Respond(0, KINETIC_STATUS_SUCCESS, "first");
+
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, CompletedStatus);
+    TEST_ASSERT_EQUAL(strlen("first"), Entry.value.bytesUsed);
+    TEST_ASSERT_EQUAL(0, memcmp("first", ValueData, Entry.value.bytesUsed));
+    TEST_ASSERT_EQUAL(KINETIC_HEDGE_SAMPLES_MIN + 1, Connections[0].getLatency.count);
+}
+
+void test_KineticHedge_Get_should_hedge_a_slow_GET_and_take_the_first_response(void)
+{
+    LOG_LOCATION;
+    RecordLatencies(0, 1);
+    KineticOperation_BuildGet_Ignore();
+    ExpectFirst(0);
+    ExpectOperation(0, false, KINETIC_STATUS_SUCCESS);
+    ExpectOperation(1, true, KINETIC_STATUS_SUCCESS);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticHedge_Get(ConnectionList, REPLICAS, &Entry, &Closure));
+    AwaitSubmitted(&Operations[1]);
+    Respond(1, KINETIC_STATUS_SUCCESS, "second");
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, CompletedStatus);
+    TEST_ASSERT_EQUAL(0, memcmp("second", ValueData, Entry.value.bytesUsed));
+    TEST_ASSERT_EQUAL(2, Entry.dbVersion.bytesUsed);
+
+    // The loser is discarded, although its latency still counts
+    Respond(0, KINETIC_STATUS_SUCCESS, "first");
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL(0, memcmp("second", ValueData, Entry.value.bytesUsed));
+    TEST_ASSERT_EQUAL(KINETIC_HEDGE_SAMPLES_MIN + 1, Connections[0].getLatency.count);
+    TEST_ASSERT_EQUAL(1, Connections[1].getLatency.count);
+}
+
+void test_KineticHedge_Get_should_ask_a_less_loaded_replica_first(void)
+{
+    LOG_LOCATION;
+    RecordLatencies(1, 1000);
+    KineticOperation_BuildGet_Ignore();
+    ExpectFirst(1);
+    ExpectOperation(1, false, KINETIC_STATUS_SUCCESS);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticHedge_Get(ConnectionList, REPLICAS, &Entry, &Closure));
+    Respond(0, KINETIC_STATUS_SUCCESS, "second");
+
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL(0, memcmp("second", ValueData, Entry.value.bytesUsed));
+    TEST_ASSERT_EQUAL(KINETIC_HEDGE_SAMPLES_MIN + 1, Connections[1].getLatency.count);
+    TEST_ASSERT_EQUAL(0, Connections[0].getLatency.count);
+}
+
+void test_KineticHedge_Get_should_ask_the_next_replica_at_once_if_the_primary_fails(void)
+{
+    LOG_LOCATION;
+    RecordLatencies(0, 1000);
+    KineticOperation_BuildGet_Ignore();
+    ExpectFirst(0);
+    ExpectOperation(0, false, KINETIC_STATUS_SUCCESS);
+    ExpectOperation(1, true, KINETIC_STATUS_SUCCESS);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticHedge_Get(ConnectionList, REPLICAS, &Entry, &Closure));
+    Respond(0, KINETIC_STATUS_CONNECTION_ERROR, NULL);
+    TEST_ASSERT_EQUAL(0, Completions);
+    Respond(1, KINETIC_STATUS_NOT_FOUND, NULL);
+
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, CompletedStatus);
+}
+
+void test_KineticHedge_Get_should_report_the_first_failure_once_every_replica_fails(void)
+{
+    LOG_LOCATION;
+    KineticOperation_BuildGet_Ignore();
+    ExpectFirst(0);
+    ExpectOperation(0, false, KINETIC_STATUS_CONNECTION_ERROR);
+    ExpectOperation(1, true, KINETIC_STATUS_SOCKET_ERROR);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_CONNECTION_ERROR,
+        KineticHedge_Get(ConnectionList, REPLICAS, &Entry, NULL));
+}
+
+void test_KineticHedge_Get_should_hedge_a_slow_synchronous_GET(void)
+{
+    LOG_LOCATION;
+    RecordLatencies(0, 1);
+    KineticOperation_BuildGet_Ignore();
+    ExpectFirst(0);
+    ExpectOperation(0, false, KINETIC_STATUS_SUCCESS);
+    ExpectOperation(1, false, KINETIC_STATUS_SUCCESS);
+
+    pthread_t receiver;
+    TEST_ASSERT_EQUAL(0, pthread_create(&receiver, NULL, RespondWhenHedged, NULL));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticHedge_Get(ConnectionList, REPLICAS, &Entry, NULL));
+    pthread_join(receiver, NULL);
+    TEST_ASSERT_EQUAL(0, memcmp("second", ValueData, Entry.value.bytesUsed));
+
+    Respond(0, KINETIC_STATUS_SUCCESS, "first");
+    TEST_ASSERT_EQUAL(0, memcmp("second", ValueData, Entry.value.bytesUsed));
+}
@@ -87,7 +87,8 @@ void test_KineticHMAC_Populate_should_compute_and_populate_the_SHA1_HMAC_for_the
     KineticProto_Message_HMACauth hmacAuth = KINETIC_PROTO_MESSAGE_HMACAUTH__INIT;
     uint8_t data[KINETIC_HMAC_MAX_LEN];
     ProtobufCBinaryData hmac = {.len = KINETIC_HMAC_MAX_LEN, .data = data};
-    const ByteArray key = ByteArray_CreateWithCString("1234567890ABCDEFGHIJK");
+    KineticHMACKey key;
+    KineticHMAC_PrepareKey(&key, ByteArray_CreateWithCString("1234567890ABCDEFGHIJK"));
     uint8_t commandBytes[123];
     ByteArray commandArray = ByteArray_Create(commandBytes, sizeof(commandBytes));
     ByteArray_FillWithDummyData(commandArray);
@@ -102,7 +103,7 @@ void test_KineticHMAC_Populate_should_compute_and_populate_the_SHA1_HMAC_for_the
     msg.hmacAuth = &hmacAuth;
 
     KineticHMAC_Init(&actual, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
-    KineticHMAC_Populate(&actual, &msg, key);
+    KineticHMAC_Populate(&actual, &msg, &key);
 
     TEST_ASSERT_TRUE(msg.hmacAuth->has_hmac);
     TEST_ASSERT_EQUAL_PTR(hmac.data, msg.hmacAuth->hmac.data);
@@ -119,6 +120,45 @@ void test_KineticHMAC_Populate_should_compute_and_populate_the_SHA1_HMAC_for_the
          actual.data[16], actual.data[17], actual.data[18], actual.data[19]);
 }
 
+void test_KineticHMAC_Populate_should_match_OpenSSL_HMAC_for_short_and_long_keys(void)
+{
+    uint8_t keyData[KINETIC_MAX_KEY_LEN];
+    size_t keyLens[] = {1, 21, SHA_CBLOCK, SHA_CBLOCK + 1, sizeof(keyData)};
+    uint8_t commandBytes[77];
+    ByteArray commandArray = ByteArray_Create(commandBytes, sizeof(commandBytes));
+    ByteArray_FillWithDummyData(commandArray);
+    ByteArray_FillWithDummyData(ByteArray_Create(keyData, sizeof(keyData)));
+
+    // The HMAC covers the network-byte-order length followed by the command
+    uint8_t signedData[sizeof(uint32_t) + sizeof(commandBytes)];
+    uint32_t lenNBO = KineticNBO_FromHostU32(sizeof(commandBytes));
+    memcpy(signedData, &lenNBO, sizeof(lenNBO));
+    memcpy(&signedData[sizeof(lenNBO)], commandBytes, sizeof(commandBytes));
+
+    for (size_t i = 0; i < sizeof(keyLens) / sizeof(keyLens[0]); i++) {
+        KineticProto_Message msg = KINETIC_PROTO_MESSAGE__INIT;
+        KineticProto_Message_HMACauth hmacAuth = KINETIC_PROTO_MESSAGE_HMACAUTH__INIT;
+        uint8_t data[KINETIC_HMAC_MAX_LEN];
+        hmacAuth.hmac = (ProtobufCBinaryData) {.len = sizeof(data), .data = data};
+        msg.hmacAuth = &hmacAuth;
+        msg.commandBytes = (ProtobufCBinaryData) {.data = commandBytes, .len = sizeof(commandBytes)};
+        msg.has_commandBytes = true;
+
+        KineticHMACKey key;
+        KineticHMAC_PrepareKey(&key, ByteArray_Create(keyData, keyLens[i]));
+        KineticHMAC actual;
+        KineticHMAC_Init(&actual, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
+        KineticHMAC_Populate(&actual, &msg, &key);
+
+        uint8_t expected[KINETIC_HMAC_MAX_LEN];
+        unsigned int expectedLen = 0;
+        HMAC(EVP_sha1(), keyData, keyLens[i], signedData, sizeof(signedData), expected, &expectedLen);
+        TEST_ASSERT_EQUAL(expectedLen, actual.len);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, actual.data, expectedLen);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, msg.hmacAuth->hmac.data, expectedLen);
+    }
+}
+
 void test_KineticHMAC_Validate_should_return_true_if_the_HMAC_for_the_supplied_message_and_key_is_correct(void)
 {
     KineticHMAC actual;
@@ -131,7 +171,8 @@ void test_KineticHMAC_Validate_should_return_true_if_the_HMAC_for_the_supplied_m
     KineticProto_Message_HMACauth hmacAuth = KINETIC_PROTO_MESSAGE_HMACAUTH__INIT;
     uint8_t data[KINETIC_HMAC_MAX_LEN];
     ProtobufCBinaryData hmac = {.len = KINETIC_HMAC_MAX_LEN, .data = data};
-    const ByteArray key = ByteArray_CreateWithCString("1234567890ABCDEFGHIJK");
+    KineticHMACKey key;
+    KineticHMAC_PrepareKey(&key, ByteArray_CreateWithCString("1234567890ABCDEFGHIJK"));
     proto.has_commandBytes = true;
     uint8_t packedCmd[128];
     size_t packedLen = KineticProto_command__pack(&command, packedCmd);
@@ -145,9 +186,9 @@ void test_KineticHMAC_Validate_should_return_true_if_the_HMAC_for_the_supplied_m
     proto.has_authType = true;
 
     KineticHMAC_Init(&actual, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
-    KineticHMAC_Populate(&actual, &proto, key);
+    KineticHMAC_Populate(&actual, &proto, &key);
 
-    TEST_ASSERT_TRUE(KineticHMAC_Validate(&proto, key));
+    TEST_ASSERT_TRUE(KineticHMAC_Validate(&proto, &key));
 }
 
 void test_KineticHMAC_Validate_should_return_false_if_the_HMAC_value_of_the_supplied_message_and_key_is_incorrect(void)
@@ -162,7 +203,8 @@ void test_KineticHMAC_Validate_should_return_false_if_the_HMAC_value_of_the_supp
     KineticProto_Message_HMACauth hmacAuth = KINETIC_PROTO_MESSAGE_HMACAUTH__INIT;
     uint8_t data[KINETIC_HMAC_MAX_LEN];
     ProtobufCBinaryData hmac = {.len = KINETIC_HMAC_MAX_LEN, .data = data};
-    const ByteArray key = ByteArray_CreateWithCString("1234567890ABCDEFGHIJK");
+    KineticHMACKey key;
+    KineticHMAC_PrepareKey(&key, ByteArray_CreateWithCString("1234567890ABCDEFGHIJK"));
     proto.has_commandBytes = true;
     uint8_t packedCmd[128];
     size_t packedLen = KineticProto_command__pack(&command, packedCmd);
@@ -176,14 +218,14 @@ void test_KineticHMAC_Validate_should_return_false_if_the_HMAC_value_of_the_supp
     proto.has_authType = true;
 
     KineticHMAC_Init(&actual, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
-    KineticHMAC_Populate(&actual, &proto, key);
+    KineticHMAC_Populate(&actual, &proto, &key);
 
-    TEST_ASSERT_TRUE(KineticHMAC_Validate(&proto, key));
+    TEST_ASSERT_TRUE(KineticHMAC_Validate(&proto, &key));
 
     // Bork the HMAC
     hmacAuth.hmac.data[3]++;
 
-    TEST_ASSERT_FALSE(KineticHMAC_Validate(&proto, key));
+    TEST_ASSERT_FALSE(KineticHMAC_Validate(&proto, &key));
 }
 
 void test_KineticHMAC_Validate_should_return_false_if_the_HMAC_length_of_the_supplied_message_and_key_is_incorrect(void)
@@ -198,7 +240,8 @@ void test_KineticHMAC_Validate_should_return_false_if_the_HMAC_length_of_the_sup
     KineticProto_Message_HMACauth hmacAuth = KINETIC_PROTO_MESSAGE_HMACAUTH__INIT;
     uint8_t data[KINETIC_HMAC_MAX_LEN];
     ProtobufCBinaryData hmac = {.len = KINETIC_HMAC_MAX_LEN, .data = data};
-    const ByteArray key = ByteArray_CreateWithCString("1234567890ABCDEFGHIJK");
+    KineticHMACKey key;
+    KineticHMAC_PrepareKey(&key, ByteArray_CreateWithCString("1234567890ABCDEFGHIJK"));
     proto.has_commandBytes = true;
     uint8_t packedCmd[128];
     size_t packedLen = KineticProto_command__pack(&command, packedCmd);
@@ -212,14 +255,14 @@ void test_KineticHMAC_Validate_should_return_false_if_the_HMAC_length_of_the_sup
     proto.has_authType = true;
 
     KineticHMAC_Init(&actual, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
-    KineticHMAC_Populate(&actual, &proto, key);
+    KineticHMAC_Populate(&actual, &proto, &key);
 
-    TEST_ASSERT_TRUE(KineticHMAC_Validate(&proto, key));
+    TEST_ASSERT_TRUE(KineticHMAC_Validate(&proto, &key));
 
     // Bork the HMAC
     hmacAuth.hmac.len--;
 
-    TEST_ASSERT_FALSE(KineticHMAC_Validate(&proto, key));
+    TEST_ASSERT_FALSE(KineticHMAC_Validate(&proto, &key));
 }
 
 void test_KineticHMAC_Validate_should_return_false_if_the_HMAC_presence_is_false_for_the_supplied_message_and_key_is_incorrect(void)
@@ -234,7 +277,8 @@ void test_KineticHMAC_Validate_should_return_false_if_the_HMAC_presence_is_false
     KineticProto_Message_HMACauth hmacAuth = KINETIC_PROTO_MESSAGE_HMACAUTH__INIT;
     uint8_t data[KINETIC_HMAC_MAX_LEN];
     ProtobufCBinaryData hmac = {.len = KINETIC_HMAC_MAX_LEN, .data = data};
-    const ByteArray key = ByteArray_CreateWithCString("1234567890ABCDEFGHIJK");
+    KineticHMACKey key;
+    KineticHMAC_PrepareKey(&key, ByteArray_CreateWithCString("1234567890ABCDEFGHIJK"));
     proto.has_commandBytes = true;
     uint8_t packedCmd[128];
     size_t packedLen = KineticProto_command__pack(&command, packedCmd);
@@ -248,12 +292,12 @@ void test_KineticHMAC_Validate_should_return_false_if_the_HMAC_presence_is_false
     proto.has_authType = true;
 
     KineticHMAC_Init(&actual, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
-    KineticHMAC_Populate(&actual, &proto, key);
+    KineticHMAC_Populate(&actual, &proto, &key);
 
-    TEST_ASSERT_TRUE(KineticHMAC_Validate(&proto, key));
+    TEST_ASSERT_TRUE(KineticHMAC_Validate(&proto, &key));
 
     // Bork the HMAC
     hmacAuth.has_hmac = false;
 
-    TEST_ASSERT_FALSE(KineticHMAC_Validate(&proto, key));
+    TEST_ASSERT_FALSE(KineticHMAC_Validate(&proto, &key));
 }
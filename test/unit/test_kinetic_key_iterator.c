@@ -0,0 +1,180 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_key_iterator.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include "mock_kinetic_operation.h"
+#include "operation_test_fixture.h"
+
+#define KEYS_PER_PAGE (2)
+
+static KineticConnection Connection;
+static KineticOperation Operations[3];
+static KineticPDU Requests[3];
+static KineticKeyRange Range;
+static KineticKeyIterator* Iterator;
+static uint8_t KeyData[KINETIC_MAX_KEY_LEN];
+static ByteBuffer Key;
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    KINETIC_CONNECTION_INIT(&Connection);
+    for (int i = 0; i < 3; i++) {
+        KINETIC_OPERATION_INIT(&Operations[i], &Connection);
+        Operations[i].request = &Requests[i];
+    }
+    Range = (KineticKeyRange) {
+        .startKey = ByteBuffer_Create("key_a", 5, 5),
+        .endKey = ByteBuffer_Create("key_z", 5, 5),
+        .startKeyInclusive = true,
+        .endKeyInclusive = true,
+        .maxReturned = KEYS_PER_PAGE,
+    };
+    Iterator = NULL;
+    Key = ByteBuffer_Create(KeyData, sizeof(KeyData), 0);
+    SubmitOperations(Operations);
+}
+
+void tearDown(void)
+{
+    KineticKeyIterator_Close(Iterator);
+    VerifySubmissions();
+    KineticLogger_Close();
+}
+
+// Plays the part of the receiver, delivering a page of keys for an operation
+static void DeliverPage(int index, const char** keys, int count)
+{
+    KineticKeyPage* page = (KineticKeyPage*)Operations[index].closure.clientData;
+    TEST_ASSERT_NOT_NULL(page);
+    for (int i = 0; i < count; i++) {
+        ByteBuffer_Reset(&page->keys.buffers[i]);
+        ByteBuffer_AppendCString(&page->keys.buffers[i], keys[i]);
+    }
+    page->keys.used = count;
+    CompleteOperation(&Operations[index], KINETIC_STATUS_SUCCESS);
+}
+
+static void AssertNextKey(const char* expected)
+{
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticKeyIterator_Next(Iterator, &Key));
+    TEST_ASSERT_EQUAL(strlen(expected), Key.bytesUsed);
+    TEST_ASSERT_EQUAL(0, memcmp(expected, KeyData, Key.bytesUsed));
+}
+
+void test_KineticKeyIterator_Next_should_page_through_the_range_prefetching_the_next_page(void)
+{
+    LOG_LOCATION;
+    const char* firstPage[] = {"key_a", "key_b"};
+    const char* lastPage[] = {"key_c"};
+    KineticOperation_BuildGetKeyRange_Ignore();
+
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticKeyIterator_Open(&Connection, &Range, &Iterator));
+    DeliverPage(0, firstPage, 2);
+
+    // The following page is requested as soon as the first is reached
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+    AssertNextKey("key_a");
+    KineticKeyPage* following = (KineticKeyPage*)Operations[1].closure.clientData;
+    TEST_ASSERT_EQUAL_PTR(&Operations[1], following->operation);
+    TEST_ASSERT_EQUAL(5, following->range.startKey.bytesUsed);
+    TEST_ASSERT_EQUAL(0, memcmp("key_b", following->range.startKey.array.data, 5));
+    TEST_ASSERT_FALSE(following->range.startKeyInclusive);
+    TEST_ASSERT_EQUAL(0, memcmp("key_z", following->range.endKey.array.data, 5));
+    AssertNextKey("key_b");
+
+    // A partial page ends the range, so nothing more is requested
+    DeliverPage(1, lastPage, 1);
+    AssertNextKey("key_c");
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, KineticKeyIterator_Next(Iterator, &Key));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, KineticKeyIterator_Next(Iterator, &Key));
+}
+
+void test_KineticKeyIterator_Next_should_continue_from_the_end_of_a_reverse_range(void)
+{
+    LOG_LOCATION;
+    const char* firstPage[] = {"key_z", "key_y"};
+    Range.reverse = true;
+    KineticOperation_BuildGetKeyRange_Ignore();
+
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticKeyIterator_Open(&Connection, &Range, &Iterator));
+    DeliverPage(0, firstPage, 2);
+
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+    AssertNextKey("key_z");
+    KineticKeyPage* following = (KineticKeyPage*)Operations[1].closure.clientData;
+    TEST_ASSERT_EQUAL(0, memcmp("key_a", following->range.startKey.array.data, 5));
+    TEST_ASSERT_TRUE(following->range.startKeyInclusive);
+    TEST_ASSERT_EQUAL(0, memcmp("key_y", following->range.endKey.array.data, 5));
+    TEST_ASSERT_FALSE(following->range.endKeyInclusive);
+    DeliverPage(1, firstPage, 0);
+}
+
+void test_KineticKeyIterator_Next_should_report_a_failed_page_and_end_the_iteration(void)
+{
+    LOG_LOCATION;
+    const char* firstPage[] = {"key_a", "key_b"};
+    KineticOperation_BuildGetKeyRange_Ignore();
+
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticKeyIterator_Open(&Connection, &Range, &Iterator));
+    DeliverPage(0, firstPage, 2);
+
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SOCKET_ERROR);
+    AssertNextKey("key_a");
+    AssertNextKey("key_b");
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_ERROR, KineticKeyIterator_Next(Iterator, &Key));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_ERROR, KineticKeyIterator_Next(Iterator, &Key));
+}
+
+void test_KineticKeyIterator_Open_should_fail_if_the_first_page_could_not_be_requested(void)
+{
+    LOG_LOCATION;
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_WOULD_BLOCK);
+
+    KineticStatus status = KineticKeyIterator_Open(&Connection, &Range, &Iterator);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_WOULD_BLOCK, status);
+    TEST_ASSERT_NULL(Iterator);
+}
+
+void test_KineticKeyIterator_Open_should_reject_a_range_without_a_page_size(void)
+{
+    LOG_LOCATION;
+    Range.maxReturned = 0;
+
+    KineticStatus status = KineticKeyIterator_Open(&Connection, &Range, &Iterator);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST, status);
+    TEST_ASSERT_NULL(Iterator);
+}
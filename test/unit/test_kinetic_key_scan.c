@@ -0,0 +1,215 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_key_scan.h"
+#include "kinetic_key_iterator.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include "mock_kinetic_connection.h"
+#include "mock_kinetic_allocator.h"
+#include "mock_kinetic_operation.h"
+#include <pthread.h>
+#include <time.h>
+
+#define NUM_OPERATIONS (4)
+
+static const char* Keys[] = {"key_a", "key_c", "key_m", "key_q", "key_x"};
+static KineticConnection Connection;
+static KineticConnection* Connections[] = {&Connection, &Connection};
+static KineticOperation Operations[NUM_OPERATIONS];
+static KineticPDU Requests[NUM_OPERATIONS];
+static KineticKeyRange SubRanges[KINETIC_KEY_SCAN_PARTITIONS_MAX];
+static uint8_t SplitKeyData[KINETIC_KEY_SCAN_PARTITIONS_MAX * KINETIC_MAX_KEY_LEN];
+static KineticKeyScan Scan;
+static char Reported[8][8];
+static int ReportedPartitions[8];
+static int ReportedCount;
+
+static void TestScanCallback(int partition, const ByteBuffer* key, void* clientData)
+{
+    TEST_ASSERT_EQUAL_PTR(&ReportedCount, clientData);
+    TEST_ASSERT_TRUE(ReportedCount < 8);
+    TEST_ASSERT_EQUAL(5, key->bytesUsed);
+    memcpy(Reported[ReportedCount], key->array.data, 5);
+    Reported[ReportedCount][5] = '\0';
+    ReportedPartitions[ReportedCount] = partition;
+    ReportedCount++;
+}
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    KINETIC_CONNECTION_INIT(&Connection);
+    for (int i = 0; i < NUM_OPERATIONS; i++) {
+        KINETIC_OPERATION_INIT(&Operations[i], &Connection);
+        Operations[i].request = &Requests[i];
+    }
+    ReportedCount = 0;
+    Scan = (KineticKeyScan) {
+        .range = {
+            .startKey = ByteBuffer_Create("key_a", 5, 5),
+            .endKey = ByteBuffer_Create("key_z", 5, 5),
+            .startKeyInclusive = true,
+            .endKeyInclusive = true,
+            .maxReturned = 10,
+        },
+        .partitions = 2,
+        .ordered = true,
+        .callback = TestScanCallback,
+        .clientData = &ReportedCount,
+    };
+}
+
+void tearDown(void)
+{
+    KineticLogger_Close();
+}
+
+void test_KineticKeyScan_Split_should_split_the_range_after_the_common_prefix(void)
+{
+    LOG_LOCATION;
+    int count = KineticKeyScan_Split(&Scan.range, 4, SubRanges, SplitKeyData);
+
+    TEST_ASSERT_EQUAL(4, count);
+    TEST_ASSERT_EQUAL_PTR(Scan.range.startKey.array.data, SubRanges[0].startKey.array.data);
+    TEST_ASSERT_TRUE(SubRanges[0].startKeyInclusive);
+    TEST_ASSERT_EQUAL_PTR(Scan.range.endKey.array.data, SubRanges[3].endKey.array.data);
+    TEST_ASSERT_TRUE(SubRanges[3].endKeyInclusive);
+
+    // Split keys are the common prefix followed by evenly spaced values
+    const uint8_t expected[] = {'g', 'm', 's'};
+    for (int i = 0; i < 3; i++) {
+        ByteBuffer* split = &SubRanges[i].endKey;
+        TEST_ASSERT_EQUAL(4 + KINETIC_KEY_SCAN_SPLIT_LEN, split->bytesUsed);
+        TEST_ASSERT_EQUAL(0, memcmp("key_", split->array.data, 4));
+        TEST_ASSERT_EQUAL(expected[i], split->array.data[4]);
+        TEST_ASSERT_FALSE(SubRanges[i].endKeyInclusive);
+        TEST_ASSERT_EQUAL_PTR(split->array.data, SubRanges[i + 1].startKey.array.data);
+        TEST_ASSERT_TRUE(SubRanges[i + 1].startKeyInclusive);
+    }
+}
+
+void test_KineticKeyScan_Split_should_not_split_a_range_too_narrow_to_partition(void)
+{
+    LOG_LOCATION;
+    Scan.range.endKey = ByteBuffer_Create("key_a", 5, 5);
+
+    int count = KineticKeyScan_Split(&Scan.range, 4, SubRanges, SplitKeyData);
+
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL_PTR(Scan.range.endKey.array.data, SubRanges[0].endKey.array.data);
+    TEST_ASSERT_TRUE(SubRanges[0].endKeyInclusive);
+}
+
+static int CompareKey(const char* key, const ByteBuffer* other)
+{
+    size_t len = strlen(key);
+    int result = memcmp(key, other->array.data, (len < other->bytesUsed) ? len : other->bytesUsed);
+    return (result != 0) ? result : (int)len - (int)other->bytesUsed;
+}
+
+// Plays the part of the receiver, responding to each page request with the
+// keys within the range of the page
+static void* RespondWithKeys(void* arg)
+{
+    int count = *(int*)arg;
+    for (int i = 0; i < count; i++) {
+        volatile KineticCompletionCallback* callback = &Operations[i].closure.callback;
+        while (*callback == NULL) {
+            nanosleep(&(struct timespec) {.tv_nsec = 1000000}, NULL);
+        }
+        KineticKeyPage* page = (KineticKeyPage*)Operations[i].closure.clientData;
+        const KineticKeyRange* range = &page->range;
+        page->keys.used = 0;
+        for (size_t k = 0; k < sizeof(Keys) / sizeof(Keys[0]); k++) {
+            int start = CompareKey(Keys[k], &range->startKey);
+            int end = CompareKey(Keys[k], &range->endKey);
+            if ((start > 0 || (start == 0 && range->startKeyInclusive)) &&
+                (end < 0 || (end == 0 && range->endKeyInclusive))) {
+                ByteBuffer* key = &page->keys.buffers[page->keys.used++];
+                ByteBuffer_Reset(key);
+                ByteBuffer_AppendCString(key, Keys[k]);
+            }
+        }
+        KineticCompletionData completionData = {.status = KINETIC_STATUS_SUCCESS};
+        Operations[i].closure.callback(&completionData, Operations[i].closure.clientData);
+    }
+    return NULL;
+}
+
+static void ExpectPageRequest(int index)
+{
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[index]);
+    KineticOperation_SendRequest_ExpectAndReturn(&Operations[index], KINETIC_STATUS_SUCCESS);
+}
+
+void test_KineticKeyScan_Execute_should_scan_all_partitions_and_report_keys_in_order(void)
+{
+    LOG_LOCATION;
+    int count = 2;
+    KineticOperation_BuildGetKeyRange_Ignore();
+    ExpectPageRequest(0);
+    ExpectPageRequest(1);
+
+    pthread_t receiver;
+    TEST_ASSERT_EQUAL(0, pthread_create(&receiver, NULL, RespondWithKeys, &count));
+    KineticStatus status = KineticKeyScan_Execute(Connections, 2, &Scan);
+    pthread_join(receiver, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(5, ReportedCount);
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_STRING(Keys[i], Reported[i]);
+        TEST_ASSERT_EQUAL((i < 3) ? 0 : 1, ReportedPartitions[i]);
+    }
+}
+
+void test_KineticKeyScan_Execute_should_fail_if_a_partition_could_not_be_opened(void)
+{
+    LOG_LOCATION;
+    int count = 1;
+    KineticOperation_BuildGetKeyRange_Ignore();
+    ExpectPageRequest(0);
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_CONNECTION_ERROR);
+
+    pthread_t receiver;
+    TEST_ASSERT_EQUAL(0, pthread_create(&receiver, NULL, RespondWithKeys, &count));
+    KineticStatus status = KineticKeyScan_Execute(Connections, 2, &Scan);
+    pthread_join(receiver, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_CONNECTION_ERROR, status);
+    TEST_ASSERT_EQUAL(0, ReportedCount);
+}
+
+void test_KineticKeyScan_Execute_should_reject_a_scan_without_an_end_key(void)
+{
+    LOG_LOCATION;
+    Scan.range.endKey = BYTE_BUFFER_NONE;
+
+    KineticStatus status = KineticKeyScan_Execute(Connections, 2, &Scan);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST, status);
+}
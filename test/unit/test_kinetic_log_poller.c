@@ -0,0 +1,163 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_log_poller.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include "mock_kinetic_operation.h"
+#include "operation_test_fixture.h"
+#include <pthread.h>
+#include <time.h>
+
+// Long enough that only the initial poll is issued during a test
+#define POLL_INTERVAL_MS (60000)
+
+static KineticConnection Connection;
+static KineticOperation Operation;
+static KineticPDU Request;
+static KineticStatus Result;
+static volatile bool Responded;
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    KINETIC_CONNECTION_INIT(&Connection);
+    KINETIC_OPERATION_INIT(&Operation, &Connection);
+    Operation.request = &Request;
+    Result = KINETIC_STATUS_SUCCESS;
+    Responded = false;
+    SubmitOperations(&Operation);
+}
+
+void tearDown(void)
+{
+    VerifySubmissions();
+    KineticLogger_Close();
+}
+
+// Plays the part of the receiver, decoding a device log into the staging log
+// of the poller, as the operation callback does, before completing the poll
+static void* Respond(void* arg)
+{
+    (void)arg;
+    AwaitSubmitted(&Operation);
+    nanosleep(&(struct timespec) {.tv_nsec = 10000000}, NULL);
+    KineticLogPoller* poller = (KineticLogPoller*)Operation.closure.clientData;
+    poller->staging = (KineticDeviceLog) {
+        .types = KINETIC_LOG_TYPE_CAPACITIES,
+        .capacity = {.nominalCapacityInBytes = 4000000000000, .portionFull = 0.5f},
+    };
+    Responded = true;
+    CompleteOperation(&Operation, Result);
+    return NULL;
+}
+
+void test_KineticLogPoller_Start_should_reject_invalid_types_and_intervals(void)
+{
+    LOG_LOCATION;
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticLogPoller_Start(&Connection, 0, POLL_INTERVAL_MS));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticLogPoller_Start(&Connection, 0x100, POLL_INTERVAL_MS));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticLogPoller_Start(&Connection, KINETIC_LOG_TYPE_ALL, -1));
+    TEST_ASSERT_NULL(Connection.logPoller);
+}
+
+void test_KineticLogPoller_GetSnapshot_should_fail_if_polling_not_started(void)
+{
+    LOG_LOCATION;
+    KineticDeviceLog log;
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticLogPoller_GetSnapshot(&Connection, &log));
+}
+
+void test_KineticLogPoller_should_publish_each_device_log_received_as_the_snapshot(void)
+{
+    LOG_LOCATION;
+    KineticDeviceLog log;
+    pthread_t receiver;
+    KineticOperation_BuildGetLog_Ignore();
+    ExpectSubmit(&Connection, false, KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL(0, pthread_create(&receiver, NULL, Respond, NULL));
+
+    KineticStatus status = KineticLogPoller_Start(&Connection,
+        KINETIC_LOG_TYPE_CAPACITIES, POLL_INTERVAL_MS);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_NOT_NULL(Connection.logPoller);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticLogPoller_Start(&Connection, KINETIC_LOG_TYPE_ALL, POLL_INTERVAL_MS));
+    pthread_join(receiver, NULL);
+
+    status = KineticLogPoller_GetSnapshot(&Connection, &log);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(KINETIC_LOG_TYPE_CAPACITIES, log.types);
+    TEST_ASSERT_EQUAL(4000000000000, log.capacity.nominalCapacityInBytes);
+    TEST_ASSERT_TRUE(log.capacity.portionFull == 0.5f);
+
+    KineticLogPoller_Stop(&Connection);
+    TEST_ASSERT_NULL(Connection.logPoller);
+}
+
+void test_KineticLogPoller_should_skip_polls_while_the_window_is_full(void)
+{
+    LOG_LOCATION;
+    KineticDeviceLog log;
+    ExpectSubmit(&Connection, false, KINETIC_STATUS_WOULD_BLOCK);
+
+    KineticStatus status = KineticLogPoller_Start(&Connection,
+        KINETIC_LOG_TYPE_ALL, POLL_INTERVAL_MS);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+
+    KineticLogPoller_Stop(&Connection);
+
+    TEST_ASSERT_NULL(Connection.logPoller);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticLogPoller_GetSnapshot(&Connection, &log));
+}
+
+void test_KineticLogPoller_Stop_should_wait_for_the_poll_in_flight(void)
+{
+    LOG_LOCATION;
+    pthread_t receiver;
+    KineticOperation_BuildGetLog_Ignore();
+    ExpectSubmit(&Connection, false, KINETIC_STATUS_SUCCESS);
+    Result = KINETIC_STATUS_DATA_ERROR;
+    TEST_ASSERT_EQUAL(0, pthread_create(&receiver, NULL, Respond, NULL));
+
+    KineticStatus status = KineticLogPoller_Start(&Connection,
+        KINETIC_LOG_TYPE_ALL, POLL_INTERVAL_MS);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    AwaitSubmitted(&Operation);
+
+    KineticLogPoller_Stop(&Connection);
+
+    TEST_ASSERT_TRUE(Responded);
+    TEST_ASSERT_NULL(Connection.logPoller);
+    pthread_join(receiver, NULL);
+}
@@ -234,3 +234,75 @@ void test_KineticMessage_ConfigureKeyRange_should_add_and_configure_a_KineticPro
     TEST_ASSERT_EQUAL(0, message.command.body->range->n_keys);
     TEST_ASSERT_NULL(message.command.body->range->keys);
 }
+
+void test_KineticMessage_ConfigureGetLog_should_request_only_the_specified_log_types(void)
+{
+    KineticMessage message;
+
+    memset(&message, 0, sizeof(KineticMessage));
+    KineticMessage_Init(&message);
+
+    KineticMessage_ConfigureGetLog(&message,
+        KINETIC_LOG_TYPE_UTILIZATIONS | KINETIC_LOG_TYPE_STATISTICS | KINETIC_LOG_TYPE_LIMITS);
+
+    // Validate that message getLog and body container are enabled in protobuf
+    TEST_ASSERT_EQUAL_PTR(&message.body, message.command.body);
+    TEST_ASSERT_EQUAL_PTR(&message.getLog, message.command.body->getLog);
+
+    // Validate requested types
+    TEST_ASSERT_EQUAL(3, message.command.body->getLog->n_types);
+    TEST_ASSERT_EQUAL_PTR(message.getLogTypes, message.command.body->getLog->types);
+    TEST_ASSERT_EQUAL(KINETIC_PROTO_COMMAND_GET_LOG_TYPE_UTILIZATIONS, message.getLogTypes[0]);
+    TEST_ASSERT_EQUAL(KINETIC_PROTO_COMMAND_GET_LOG_TYPE_STATISTICS, message.getLogTypes[1]);
+    TEST_ASSERT_EQUAL(KINETIC_PROTO_COMMAND_GET_LOG_TYPE_LIMITS, message.getLogTypes[2]);
+}
+
+void test_KineticMessage_ConfigureP2POperation_should_configure_the_peer_and_each_operation(void)
+{
+    KineticMessage message;
+    uint8_t keyData[] = "key one";
+    uint8_t newKeyData[] = "key two";
+    KineticP2P_OperationData ops[2] = {
+        {.key = ByteBuffer_Create(keyData, sizeof(keyData), sizeof(keyData)), .force = true},
+        {.key = ByteBuffer_Create(keyData, sizeof(keyData), sizeof(keyData)),
+         .newKey = ByteBuffer_Create(newKeyData, sizeof(newKeyData), sizeof(newKeyData))},
+    };
+    KineticP2P_Operation p2pOp = {
+        .peer = {.hostname = "peerhost", .port = 8123, .tls = false},
+        .numOperations = 2,
+        .operations = ops,
+    };
+    KineticProto_Command_P2POperation_Operation storage[2];
+    KineticProto_Command_P2POperation_Operation* operations[] = {&storage[0], &storage[1]};
+
+    memset(&message, 0, sizeof(KineticMessage));
+    KineticMessage_Init(&message);
+
+    KineticMessage_ConfigureP2POperation(&message, &p2pOp, operations);
+
+    // Validate that message p2pOperation and body container are enabled in protobuf
+    TEST_ASSERT_EQUAL_PTR(&message.body, message.command.body);
+    TEST_ASSERT_EQUAL_PTR(&message.p2pOperation, message.command.body->p2pOperation);
+
+    // Validate peer
+    TEST_ASSERT_EQUAL_PTR(&message.p2pPeer, message.p2pOperation.peer);
+    TEST_ASSERT_EQUAL_STRING("peerhost", message.p2pPeer.hostname);
+    TEST_ASSERT_TRUE(message.p2pPeer.has_port);
+    TEST_ASSERT_EQUAL(8123, message.p2pPeer.port);
+    TEST_ASSERT_TRUE(message.p2pPeer.has_tls);
+    TEST_ASSERT_FALSE(message.p2pPeer.tls);
+
+    // Validate operations
+    TEST_ASSERT_EQUAL(2, message.p2pOperation.n_operation);
+    TEST_ASSERT_EQUAL_PTR(operations, message.p2pOperation.operation);
+    TEST_ASSERT_TRUE(storage[0].has_key);
+    TEST_ASSERT_EQUAL_PTR(keyData, storage[0].key.data);
+    TEST_ASSERT_FALSE(storage[0].has_version);
+    TEST_ASSERT_FALSE(storage[0].has_newKey);
+    TEST_ASSERT_TRUE(storage[0].has_force);
+    TEST_ASSERT_TRUE(storage[0].force);
+    TEST_ASSERT_TRUE(storage[1].has_newKey);
+    TEST_ASSERT_EQUAL_PTR(newKeyData, storage[1].newKey.data);
+    TEST_ASSERT_EQUAL(sizeof(newKeyData), storage[1].newKey.len);
+    TEST_ASSERT_FALSE(storage[1].has_force);
+}
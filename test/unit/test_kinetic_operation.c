@@ -26,6 +26,8 @@
 #include "kinetic_nbo.h"
 #include "kinetic_proto.h"
 #include "kinetic_logger.h"
+#include "kinetic_arena.h"
+#include "kinetic_entry.h"
 #include "mock_kinetic_types_internal.h"
 #include "mock_kinetic_allocator.h"
 #include "mock_kinetic_connection.h"
@@ -33,17 +35,32 @@
 #include "mock_kinetic_pdu.h"
 #include "mock_kinetic_socket.h"
 #include "mock_kinetic_hmac.h"
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
 
 static KineticConnection Connection;
 static int64_t ConnectionID = 12345;
 static KineticPDU Request, Response;
 static KineticPDU Requests[3];
 static KineticOperation Operation;
+static KineticEntry Entry;
 
+// Conditions are initialized for real, since operations are waited upon
+static void InitCondition(pthread_cond_t* const cond, int cmock_num_calls)
+{
+    (void)cmock_num_calls;
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
 
 void setUp(void)
 {
     KineticLogger_Init("stdout", 3);
+    Kinetic_InitCondition_StubWithCallback(InitCondition);
     KINETIC_CONNECTION_INIT(&Connection);
     Connection.connectionID = ConnectionID;
     KINETIC_PDU_INIT_WITH_COMMAND(&Request, &Connection);
@@ -79,45 +96,26 @@ void test_KINETIC_OPERATION_INIT_should_configure_the_operation(void)
 void test_KineticOperation_SendRequest_should_transmit_PDU_with_no_value_payload(void)
 {
     LOG_LOCATION;
-    KineticProto_Message* msg = &Request.protoData.message.message;
-
-    // KineticProto_Message__init(msg);
     KINETIC_PDU_INIT_WITH_COMMAND(&Request, &Connection);
     ByteBuffer headerNBO = ByteBuffer_Create(&Request.headerNBO, sizeof(KineticPDUHeader), sizeof(KineticPDUHeader));
-    // KineticEntry entry = {.value = BYTE_BUFFER_NONE};
     KINETIC_OPERATION_INIT(&Operation, &Connection);
     Operation.request = &Request;
 
-    uint8_t packedCommandBytes[1024];
-
-    // Pack message `command` element in order to precalculate fully packed message size 
-    size_t expectedCommandLen = KineticProto_command__get_packed_size(&Request.protoData.message.command);
-    Request.protoData.message.message.commandBytes.data = packedCommandBytes;
-    assert(Request.protoData.message.message.commandBytes.data != NULL);
-    size_t packedCommandLen = KineticProto_command__pack(
-        &Request.protoData.message.command,
-        Request.protoData.message.message.commandBytes.data);
-    assert(packedCommandLen == expectedCommandLen);
-    Request.protoData.message.message.commandBytes.len = packedCommandLen;
-    Request.protoData.message.message.has_commandBytes = true;
-
-    // Create NBO copy of header for sending
-    Request.header.versionPrefix = 'F';
-    Request.header.protobufLength = KineticProto_Message__get_packed_size(msg);
-    Request.header.valueLength = 0;
-    Request.headerNBO.versionPrefix = Request.header.versionPrefix;
-    Request.headerNBO.protobufLength = KineticNBO_FromHostU32(Request.header.protobufLength);
-    Request.headerNBO.valueLength = KineticNBO_FromHostU32(Request.header.valueLength);
-
     // Setup expectations for interaction
     KineticHMAC_Init_Expect(&Request.hmac, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
-    KineticHMAC_Populate_Expect(&Request.hmac, &Request.protoData.message.message, Request.connection->session.hmacKey);
-    KineticSocket_Write_ExpectAndReturn(Connection.socket, &headerNBO, KINETIC_STATUS_SUCCESS);
-    KineticSocket_WriteProtobuf_ExpectAndReturn(Connection.socket, &Request, KINETIC_STATUS_SUCCESS);
+    KineticHMAC_Populate_Expect(&Request.hmac, &Request.protoData.message.message, &Request.connection->hmacKey);
+    KineticConnection_AddPendingOperation_Expect(&Connection, &Operation);
+    KineticSocket_WriteV_ExpectAndReturn(Connection.socket, &headerNBO, 2, KINETIC_STATUS_SUCCESS);
 
     KineticStatus status = KineticOperation_SendRequest(&Operation);
 
     TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL('F', Request.headerNBO.versionPrefix);
+    TEST_ASSERT_EQUAL(0, Request.header.valueLength);
+    TEST_ASSERT_TRUE(Request.header.protobufLength > 0);
+    TEST_ASSERT_NOT_NULL(Connection.packBuffer);
+    TEST_ASSERT_TRUE(Connection.packBufferSize >= Request.header.protobufLength);
+    free(Connection.packBuffer);
 }
 
 void test_KineticOperation_SendRequest_should_send_PDU_with_value_payload(void)
@@ -138,96 +136,281 @@ void test_KineticOperation_SendRequest_should_send_PDU_with_value_payload(void)
 
     KineticHMAC_Init_Expect(&Request.hmac, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
     KineticHMAC_Populate_Expect(&Request.hmac,
-        &Request.protoData.message.message, Request.connection->session.hmacKey);
-    KineticSocket_Write_ExpectAndReturn(Connection.socket, &headerNBO, KINETIC_STATUS_SUCCESS);
-    KineticSocket_WriteProtobuf_ExpectAndReturn(Connection.socket, &Request, KINETIC_STATUS_SUCCESS);
-    KineticSocket_Write_ExpectAndReturn(Connection.socket, &entry.value, KINETIC_STATUS_SUCCESS);
+        &Request.protoData.message.message, &Request.connection->hmacKey);
+    KineticConnection_AddPendingOperation_Expect(&Connection, &Operation);
+    KineticSocket_WriteV_ExpectAndReturn(Connection.socket, &headerNBO, 3, KINETIC_STATUS_SUCCESS);
 
     KineticStatus status = KineticOperation_SendRequest(&Operation);
 
     TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(entry.value.bytesUsed, Request.header.valueLength);
+    free(Connection.packBuffer);
 }
 
-void test_KineticOperation_SendRequest_should_send_the_specified_message_and_return_false_upon_failure_to_send_header(void)
+void test_KineticOperation_SendRequest_should_reuse_the_connection_pack_buffer(void)
 {
     LOG_LOCATION;
     ByteBuffer headerNBO = ByteBuffer_Create(&Request.headerNBO, sizeof(KineticPDUHeader), sizeof(KineticPDUHeader));
-
     KINETIC_PDU_INIT_WITH_COMMAND(&Request, &Connection);
     KINETIC_OPERATION_INIT(&Operation, &Connection);
     Operation.request = &Request;
-    char valueData[] = "Some arbitrary value";
-    KineticEntry entry = {
-        .value = ByteBuffer_Create(valueData, strlen(valueData), strlen(valueData))
-    };
-    Operation.entry = &entry;
-    Operation.valueEnabled = true;
-    Operation.sendValue = true;
 
-    KineticHMAC_Init_Expect(&Request.hmac, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
-    KineticHMAC_Populate_Expect(&Request.hmac, &Request.protoData.message.message, Request.connection->session.hmacKey);
-    KineticSocket_Write_ExpectAndReturn(Connection.socket, &headerNBO, KINETIC_STATUS_SOCKET_ERROR);
+    for (int i = 0; i < 2; i++) {
+        KineticHMAC_Init_Expect(&Request.hmac, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
+        KineticHMAC_Populate_Expect(&Request.hmac, &Request.protoData.message.message, &Request.connection->hmacKey);
+        KineticConnection_AddPendingOperation_Expect(&Connection, &Operation);
+        KineticSocket_WriteV_ExpectAndReturn(Connection.socket, &headerNBO, 2, KINETIC_STATUS_SUCCESS);
+    }
 
-    KineticStatus status = KineticOperation_SendRequest(&Operation);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticOperation_SendRequest(&Operation));
+    uint8_t* packBuffer = Connection.packBuffer;
+    TEST_ASSERT_NOT_NULL(packBuffer);
+    TEST_ASSERT_FALSE(Request.protoData.message.message.has_commandBytes);
 
-    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_ERROR, status);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticOperation_SendRequest(&Operation));
+    TEST_ASSERT_EQUAL_PTR(packBuffer, Connection.packBuffer);
+    free(Connection.packBuffer);
 }
 
-void test_KineticOperation_SendRequest_should_send_the_specified_message_and_return_false_upon_failure_to_send_protobuf(void)
+void test_KineticOperation_SendRequest_should_return_KineticStatus_and_unregister_operation_if_send_fails(void)
 {
     LOG_LOCATION;
     ByteBuffer headerNBO = ByteBuffer_Create(&Request.headerNBO, sizeof(KineticPDUHeader), sizeof(KineticPDUHeader));
 
     KINETIC_PDU_INIT_WITH_COMMAND(&Request, &Connection);
     KINETIC_OPERATION_INIT(&Operation, &Connection);
-    char valueData[] = "Some arbitrary value";
+    uint8_t valueData[128];
     KineticEntry entry = {
-        .value = ByteBuffer_Create(valueData, strlen(valueData), strlen(valueData))
+        .value = ByteBuffer_Create(valueData, sizeof(valueData), 0)
     };
+    ByteBuffer_AppendCString(&entry.value, "Some arbitrary value");
     Operation.entry = &entry;
     Operation.request = &Request;
     Operation.valueEnabled = true;
     Operation.sendValue = true;
 
     KineticHMAC_Init_Expect(&Request.hmac, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
-    KineticHMAC_Populate_Expect(&Request.hmac,
-        &Request.protoData.message.message, Request.connection->session.hmacKey);
-    KineticSocket_Write_ExpectAndReturn(Connection.socket, &headerNBO, KINETIC_STATUS_SUCCESS);
-    KineticSocket_WriteProtobuf_ExpectAndReturn(Connection.socket, &Request, KINETIC_STATUS_SOCKET_TIMEOUT);
+    KineticHMAC_Populate_Expect(&Request.hmac, &Request.protoData.message.message, &Request.connection->hmacKey);
+    KineticConnection_AddPendingOperation_Expect(&Connection, &Operation);
+    KineticSocket_WriteV_ExpectAndReturn(Connection.socket, &headerNBO, 3, KINETIC_STATUS_SOCKET_TIMEOUT);
+    KineticConnection_RemovePendingOperation_ExpectAndReturn(&Connection, &Operation, true, true);
 
     KineticStatus status = KineticOperation_SendRequest(&Operation);
 
     TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_TIMEOUT, status);
+    free(Connection.packBuffer);
+}
+
+void test_KineticOperation_SendRequests_should_pack_and_transmit_several_PDUs_with_a_single_write(void)
+{
+    LOG_LOCATION;
+    KineticOperation operations[3];
+    KineticOperation* ops[3];
+    uint8_t valueData[3][32];
+    KineticEntry entries[3];
+
+    for (int i = 0; i < 3; i++) {
+        KINETIC_PDU_INIT_WITH_COMMAND(&Requests[i], &Connection);
+        KINETIC_OPERATION_INIT(&operations[i], &Connection);
+        entries[i] = (KineticEntry) {.value = ByteBuffer_Create(valueData[i], sizeof(valueData[i]), 0)};
+        ByteBuffer_AppendCString(&entries[i].value, "Some arbitrary value");
+        operations[i].request = &Requests[i];
+        operations[i].entry = &entries[i];
+        operations[i].valueEnabled = true;
+        operations[i].sendValue = (i != 1);
+        ops[i] = &operations[i];
+    }
+    ByteBuffer headerNBO = ByteBuffer_Create(&Requests[0].headerNBO, sizeof(KineticPDUHeader), sizeof(KineticPDUHeader));
+    Connection.sequence = 57;
+
+    for (int i = 0; i < 3; i++) {
+        KineticHMAC_Init_Expect(&Requests[i].hmac, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
+        KineticHMAC_Populate_Expect(&Requests[i].hmac, &Requests[i].protoData.message.message, &Connection.hmacKey);
+    }
+    for (int i = 0; i < 3; i++) {
+        KineticConnection_AddPendingOperation_Expect(&Connection, &operations[i]);
+    }
+    KineticSocket_WriteV_ExpectAndReturn(Connection.socket, &headerNBO, 8, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticOperation_SendRequests(ops, 3);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_TRUE(Connection.packBufferSize >= Requests[0].header.protobufLength
+        + Requests[1].header.protobufLength + Requests[2].header.protobufLength);
+    TEST_ASSERT_EQUAL(0, Requests[1].header.valueLength);
+    TEST_ASSERT_EQUAL(entries[2].value.bytesUsed, Requests[2].header.valueLength);
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_INT64(57 + i, Requests[i].command->header->sequence);
+    }
+    TEST_ASSERT_EQUAL_INT64(60, Connection.sequence);
+    free(Connection.packBuffer);
+}
+
+void test_KineticOperation_SendRequests_should_release_only_operations_not_claimed_by_the_receiver_if_send_fails(void)
+{
+    LOG_LOCATION;
+    KineticOperation operations[2];
+    KineticOperation* ops[2];
+
+    for (int i = 0; i < 2; i++) {
+        KINETIC_PDU_INIT_WITH_COMMAND(&Requests[i], &Connection);
+        KINETIC_OPERATION_INIT(&operations[i], &Connection);
+        operations[i].request = &Requests[i];
+        ops[i] = &operations[i];
+    }
+    ByteBuffer headerNBO = ByteBuffer_Create(&Requests[0].headerNBO, sizeof(KineticPDUHeader), sizeof(KineticPDUHeader));
+
+    for (int i = 0; i < 2; i++) {
+        KineticHMAC_Init_Expect(&Requests[i].hmac, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
+        KineticHMAC_Populate_Expect(&Requests[i].hmac, &Requests[i].protoData.message.message, &Connection.hmacKey);
+    }
+    KineticConnection_AddPendingOperation_Expect(&Connection, &operations[0]);
+    KineticConnection_AddPendingOperation_Expect(&Connection, &operations[1]);
+    KineticSocket_WriteV_ExpectAndReturn(Connection.socket, &headerNBO, 4, KINETIC_STATUS_SOCKET_ERROR);
+    KineticConnection_RemovePendingOperation_ExpectAndReturn(&Connection, &operations[0], false, false);
+    KineticConnection_RemovePendingOperation_ExpectAndReturn(&Connection, &operations[1], false, true);
+
+    KineticStatus status = KineticOperation_SendRequests(ops, 2);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_ERROR, status);
+    TEST_ASSERT_NULL(ops[0]);
+    TEST_ASSERT_EQUAL_PTR(&operations[1], ops[1]);
+    free(Connection.packBuffer);
+}
+
+
+
+static void* BuiltContext;
+static KineticOperation* BuiltOperation;
+
+static void Build(KineticOperation* const operation, void* context)
+{
+    BuiltOperation = operation;
+    BuiltContext = context;
+}
+
+static void Completed(KineticCompletionData* kinetic_data, void* client_data)
+{
+    (void)kinetic_data;
+    (void)client_data;
 }
 
-void test_KineticOperation_SendRequest_should_send_the_specified_message_and_return_KineticStatus_if_value_write_fails(void)
+void test_KineticOperation_Submit_should_build_record_and_send_the_request(void)
 {
     LOG_LOCATION;
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    KineticOperation* submitted = NULL;
+    KineticCompletionClosure closure = {.callback = Completed, .clientData = &Entry};
     ByteBuffer headerNBO = ByteBuffer_Create(&Request.headerNBO, sizeof(KineticPDUHeader), sizeof(KineticPDUHeader));
+    BuiltOperation = NULL;
+    BuiltContext = NULL;
 
-    KINETIC_PDU_INIT_WITH_COMMAND(&Request, &Connection);
-    KINETIC_OPERATION_INIT(&Operation, &Connection);
-    uint8_t valueData[128];
-    KineticEntry entry = {
-        .value = ByteBuffer_Create(valueData, sizeof(valueData), 0)
-    };
-    ByteBuffer_AppendCString(&entry.value, "Some arbitrary value");
-    Operation.entry = &entry;
-    Operation.request = &Request;
-    Operation.valueEnabled = true;
-    Operation.sendValue = true;
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operation);
+    KineticHMAC_Init_Expect(&Request.hmac, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
+    KineticHMAC_Populate_Expect(&Request.hmac, &Request.protoData.message.message, &Connection.hmacKey);
+    KineticConnection_AddPendingOperation_Expect(&Connection, &Operation);
+    KineticSocket_WriteV_ExpectAndReturn(Connection.socket, &headerNBO, 2, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = KineticOperation_Submit(&Connection, true, Build, &Entry,
+        closure, &mutex, &submitted);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL_PTR(&Operation, BuiltOperation);
+    TEST_ASSERT_EQUAL_PTR(&Entry, BuiltContext);
+    TEST_ASSERT_EQUAL_PTR(&Operation, submitted);
+    TEST_ASSERT_EQUAL_PTR(Completed, Operation.closure.callback);
+    TEST_ASSERT_EQUAL_PTR(&Entry, Operation.closure.clientData);
+    free(Connection.packBuffer);
+}
+
+void test_KineticOperation_Submit_should_not_wait_for_room_in_the_window_unless_asked(void)
+{
+    LOG_LOCATION;
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    KineticOperation* submitted = NULL;
+    KineticCompletionClosure closure = {.callback = Completed};
+    BuiltOperation = NULL;
+
+    KineticConnection_TryAcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_WOULD_BLOCK);
+
+    KineticStatus status = KineticOperation_Submit(&Connection, false, Build, NULL,
+        closure, &mutex, &submitted);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_WOULD_BLOCK, status);
+    TEST_ASSERT_NULL(BuiltOperation);
+    TEST_ASSERT_NULL(submitted);
+}
+
+void test_KineticOperation_Submit_should_release_the_window_if_no_operation_is_available(void)
+{
+    LOG_LOCATION;
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    KineticOperation* submitted = NULL;
+    KineticCompletionClosure closure = {.callback = Completed};
+
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, NULL);
+    KineticConnection_ReleaseWindow_Expect(&Connection);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_MEMORY_ERROR,
+        KineticOperation_Submit(&Connection, true, Build, NULL, closure, &mutex, &submitted));
+    TEST_ASSERT_NULL(submitted);
+
+    Operation.request = NULL;
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operation);
+    KineticAllocator_FreeOperation_Expect(&Connection, &Operation);
+    KineticConnection_ReleaseWindow_Expect(&Connection);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NO_PDUS_AVAVILABLE,
+        KineticOperation_Submit(&Connection, true, Build, NULL, closure, &mutex, &submitted));
+    TEST_ASSERT_NULL(submitted);
+}
 
+void test_KineticOperation_Submit_should_release_the_operation_and_window_if_send_fails(void)
+{
+    LOG_LOCATION;
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    KineticOperation* submitted = NULL;
+    KineticCompletionClosure closure = {.callback = Completed};
+    ByteBuffer headerNBO = ByteBuffer_Create(&Request.headerNBO, sizeof(KineticPDUHeader), sizeof(KineticPDUHeader));
+
+    KineticConnection_TryAcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operation);
     KineticHMAC_Init_Expect(&Request.hmac, KINETIC_PROTO_COMMAND_SECURITY_ACL_HMACALGORITHM_HmacSHA1);
-    KineticHMAC_Populate_Expect(&Request.hmac, &Request.protoData.message.message, Request.connection->session.hmacKey);
-    KineticSocket_Write_ExpectAndReturn(Connection.socket, &headerNBO, KINETIC_STATUS_SUCCESS);
-    KineticSocket_WriteProtobuf_ExpectAndReturn(Connection.socket, &Request, KINETIC_STATUS_SUCCESS);
-    KineticSocket_Write_ExpectAndReturn(Connection.socket, &entry.value, KINETIC_STATUS_SOCKET_TIMEOUT);
+    KineticHMAC_Populate_Expect(&Request.hmac, &Request.protoData.message.message, &Connection.hmacKey);
+    KineticConnection_AddPendingOperation_Expect(&Connection, &Operation);
+    KineticSocket_WriteV_ExpectAndReturn(Connection.socket, &headerNBO, 2, KINETIC_STATUS_SOCKET_ERROR);
+    KineticConnection_RemovePendingOperation_ExpectAndReturn(&Connection, &Operation, true, true);
+    KineticAllocator_FreeOperation_Expect(&Connection, &Operation);
+    KineticConnection_ReleaseWindow_Expect(&Connection);
 
-    KineticStatus status = KineticOperation_SendRequest(&Operation);
+    KineticStatus status = KineticOperation_Submit(&Connection, false, Build, NULL,
+        closure, &mutex, &submitted);
 
-    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_TIMEOUT, status);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_ERROR, status);
+    TEST_ASSERT_NULL(submitted);
+    free(Connection.packBuffer);
+}
+
+void test_KineticOperation_Abandon_should_release_an_operation_awaiting_its_response(void)
+{
+    LOG_LOCATION;
+    KineticConnection_RemovePendingOperation_ExpectAndReturn(&Connection, &Operation, true, true);
+    KineticAllocator_FreeOperation_Expect(&Connection, &Operation);
+    KineticConnection_ReleaseWindow_Expect(&Connection);
+
+    TEST_ASSERT_TRUE(KineticOperation_Abandon(&Operation));
 }
 
+void test_KineticOperation_Abandon_should_leave_an_operation_whose_response_was_claimed(void)
+{
+    LOG_LOCATION;
+    KineticConnection_RemovePendingOperation_ExpectAndReturn(&Connection, &Operation, true, false);
+
+    TEST_ASSERT_FALSE(KineticOperation_Abandon(&Operation));
+}
 
 
 void test_KineticOperation_GetStatus_should_return_KINETIC_STATUS_INVALID_if_no_KineticProto_Command_Status_StatusCode_in_response(void)
@@ -246,7 +429,6 @@ void test_KineticOperation_GetStatus_should_return_KINETIC_STATUS_INVALID_if_no_
     // Build a valid NOOP to facilitate testing protobuf structure and status extraction
     Operation.request = &Request;
     Operation.response = &Response;
-    KineticConnection_IncrementSequence_Expect(&Connection);
     KineticOperation_BuildNoop(&Operation);
 
     KineticPDU_GetStatus_ExpectAndReturn(&Response, KINETIC_STATUS_SUCCESS);
@@ -260,6 +442,43 @@ void test_KineticOperation_GetStatus_should_return_KINETIC_STATUS_INVALID_if_no_
 
 
 
+static void* CompleteOperationAfterDelay(void* arg)
+{
+    nanosleep(&(struct timespec){.tv_nsec = 50000000}, NULL);
+    KineticOperation_Complete(arg);
+    return NULL;
+}
+
+void test_KineticOperation_ReceiveAsync_should_block_until_synchronous_operation_completes(void)
+{
+    LOG_LOCATION;
+    Connection.socket = 123;
+    Operation.response = &Response;
+    KineticOperation_BuildNoop(&Operation);
+
+    pthread_t completer;
+    TEST_ASSERT_EQUAL(0, pthread_create(&completer, NULL,
+        CompleteOperationAfterDelay, &Operation));
+
+    KineticPDU_GetStatus_ExpectAndReturn(&Response, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_FreeOperation_Expect(&Connection, &Operation);
+    KineticConnection_ReleaseWindow_Expect(&Connection);
+
+    KineticStatus status = KineticOperation_ReceiveAsync(&Operation);
+
+    pthread_join(completer, NULL);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_TRUE(Operation.receiveComplete);
+}
+
+void test_KineticOperation_Complete_should_flag_the_operation_as_complete(void)
+{
+    LOG_LOCATION;
+    TEST_ASSERT_FALSE(Operation.receiveComplete);
+    KineticOperation_Complete(&Operation);
+    TEST_ASSERT_TRUE(Operation.receiveComplete);
+}
+
 void test_KineticOperation_AssociateResponseWithOperation_should_return_NULL_if_supplied_PDU_is_invalid(void)
 {
     LOG_LOCATION;
@@ -287,7 +506,7 @@ void test_KineticOperation_AssociateResponseWithOperation_should_return_NULL_if_
     TEST_ASSERT_NULL(KineticOperation_AssociateResponseWithOperation(&Response));
 }
 
-void test_KineticOperation_AssociateResponseWithOperation_should_return_NULL_if_no_matching_request_was_found_in_PDU_list(void)
+void test_KineticOperation_AssociateResponseWithOperation_should_return_NULL_if_no_matching_request_is_in_flight(void)
 {
     LOG_LOCATION;
 
@@ -295,58 +514,32 @@ void test_KineticOperation_AssociateResponseWithOperation_should_return_NULL_if_
     Response.command->header->has_ackSequence = true;
     Response.command->header->ackSequence = 9876543210;
     TEST_ASSERT_EQUAL_PTR(&Connection, Response.connection);
-    TEST_ASSERT_NOT_NULL(Response.command);
-    TEST_ASSERT_NOT_NULL(Response.command->header);
 
-    KineticOperation ops[3];
-    for(int i = 0; i < 3; i++) {
-        KINETIC_PDU_INIT_WITH_COMMAND(&Requests[i], &Connection);
-        Requests[i].command->header->has_sequence = true;
-        Requests[i].type = KINETIC_PDU_TYPE_REQUEST;
-        KINETIC_OPERATION_INIT(&ops[i], &Connection);
-    }
-
-    // Empty operations list should result in NULL being returned (no match)
-    KineticAllocator_GetFirstOperation_ExpectAndReturn(&Connection, NULL);
+    KineticConnection_TakePendingOperation_ExpectAndReturn(&Connection, 9876543210, NULL);
     TEST_ASSERT_NULL(KineticOperation_AssociateResponseWithOperation(&Response));
+}
+
+void test_KineticOperation_AssociateResponseWithOperation_should_claim_the_in_flight_operation_matching_the_ackSequence(void)
+{
+    LOG_LOCATION;
 
-    // A list with only the expected operation w/ matching request PDU
+    Response.type = KINETIC_PDU_TYPE_RESPONSE;
+    Response.command->header->has_ackSequence = true;
+    Response.command->header->ackSequence = 9876543210;
+
+    KineticOperation op;
+    KINETIC_PDU_INIT_WITH_COMMAND(&Requests[0], &Connection);
+    Requests[0].command->header->has_sequence = true;
     Requests[0].command->header->sequence = 9876543210;
-    ops[0].request = &Requests[0];
-    KineticAllocator_GetFirstOperation_ExpectAndReturn(&Connection, &ops[0]);
-    TEST_ASSERT_EQUAL_PTR(&ops[0], KineticOperation_AssociateResponseWithOperation(&Response));
-    TEST_ASSERT_EQUAL_PTR(&Response, ops[0].response);
-
-    // A list starting with a non-matching PDU, followed by the expected PDU
-    Requests[0].command->header->sequence = 12345;
-    ops[0].request = &Requests[0];
-    ops[0].response = NULL;
-    Requests[1].command->header->sequence = 9876543210;
-    ops[1].request = &Requests[1];
-    ops[1].response = NULL;
-    KineticAllocator_GetFirstOperation_ExpectAndReturn(&Connection, &ops[0]);
-    KineticAllocator_GetNextOperation_ExpectAndReturn(&Connection, &ops[0], &ops[1]);
-    TEST_ASSERT_EQUAL_PTR(&ops[1], KineticOperation_AssociateResponseWithOperation(&Response));
-    TEST_ASSERT_EQUAL_PTR(&Response, ops[1].response);
-    TEST_ASSERT_NULL(ops[0].response);
-
-    // A list starting with with multiple non-matching PDUs, followed by the expected PDU
-    Requests[0].command->header->sequence = 12345;
-    ops[0].request = &Requests[0];
-    ops[0].response = NULL;
-    Requests[1].command->header->sequence = 45678;
-    ops[1].request = &Requests[1];
-    ops[1].response = NULL;
-    Requests[2].command->header->sequence = 9876543210;
-    ops[2].request = &Requests[2];
-    ops[2].response = NULL;
-    KineticAllocator_GetFirstOperation_ExpectAndReturn(&Connection, &ops[0]);
-    KineticAllocator_GetNextOperation_ExpectAndReturn(&Connection, &ops[0], &ops[1]);
-    KineticAllocator_GetNextOperation_ExpectAndReturn(&Connection, &ops[1], &ops[2]);
-    TEST_ASSERT_EQUAL_PTR(&ops[2], KineticOperation_AssociateResponseWithOperation(&Response));
-    TEST_ASSERT_EQUAL_PTR(&Response, ops[2].response);
-    TEST_ASSERT_NULL(ops[1].response);
-    TEST_ASSERT_NULL(ops[0].response);
+    Requests[0].type = KINETIC_PDU_TYPE_REQUEST;
+    KINETIC_OPERATION_INIT(&op, &Connection);
+    op.request = &Requests[0];
+    op.receiveComplete = true;
+
+    KineticConnection_TakePendingOperation_ExpectAndReturn(&Connection, 9876543210, &op);
+    TEST_ASSERT_EQUAL_PTR(&op, KineticOperation_AssociateResponseWithOperation(&Response));
+    TEST_ASSERT_EQUAL_PTR(&Response, op.response);
+    TEST_ASSERT_FALSE(op.receiveComplete);
 }
 
 
@@ -355,7 +548,6 @@ void test_KineticOperation_BuildNoop_should_build_and_execute_a_NOOP_operation(v
 {
     LOG_LOCATION;
 
-    KineticConnection_IncrementSequence_Expect(&Connection);
 
     KineticOperation_BuildNoop(&Operation);
 
@@ -390,7 +582,6 @@ void test_KineticOperation_BuildPut_should_build_and_execute_a_PUT_operation_to_
     ByteArray newVersion = ByteArray_CreateWithCString("v1.0");
     ByteArray tag = ByteArray_CreateWithCString("some_tag");
 
-    KineticConnection_IncrementSequence_Expect(&Connection);
 
     // PUT
     // The PUT operation sets the value and metadata for a given key. If a value
@@ -503,7 +694,6 @@ void test_KineticOperation_BuildGet_should_build_a_GET_operation(void)
     };
     entry.value.bytesUsed = 123; // Set to non-empty state, since it should be reset to 0
 
-    KineticConnection_IncrementSequence_Expect(&Connection);
     KineticMessage_ConfigureKeyValue_Expect(&Request.protoData.message, &entry);
 
     KineticOperation_BuildGet(&Operation, &entry);
@@ -557,7 +747,6 @@ void test_KineticOperation_BuildGet_should_build_a_GET_operation_requesting_meta
     };
     entry.value.bytesUsed = 123; // Set to non-empty state, since it should be reset to 0 for a metadata-only request
 
-    KineticConnection_IncrementSequence_Expect(&Connection);
     KineticMessage_ConfigureKeyValue_Expect(&Request.protoData.message, &entry);
 
     KineticOperation_BuildGet(&Operation, &entry);
@@ -599,6 +788,57 @@ void test_KineticOperation_BuildGet_should_build_a_GET_operation_requesting_meta
 }
 
 
+void test_KineticOperation_BuildGetNext_should_build_a_GETNEXT_operation(void)
+{
+    LOG_LOCATION;
+    const ByteArray key = ByteArray_CreateWithCString("foobar");
+    ByteArray value = ByteArray_Create(ValueData, sizeof(ValueData));
+    KineticEntry entry = {
+        .key = ByteBuffer_CreateWithArray(key),
+        .value = ByteBuffer_CreateWithArray(value),
+    };
+    entry.value.bytesUsed = 123; // Set to non-empty state, since it should be reset to 0
+
+    KineticMessage_ConfigureKeyValue_Expect(&Request.protoData.message, &entry);
+
+    KineticOperation_BuildGetNext(&Operation, &entry);
+
+    // GETNEXT
+    // The GETNEXT operation is used to retrieve the value and metadata for
+    // the key following the specified key, which is replaced in the entry
+    TEST_ASSERT_TRUE(Request.protoData.message.command.header->has_messageType);
+    TEST_ASSERT_EQUAL(KINETIC_PROTO_COMMAND_MESSAGE_TYPE_GETNEXT, Request.protoData.message.command.header->messageType);
+    TEST_ASSERT_TRUE(Operation.valueEnabled);
+    TEST_ASSERT_FALSE(Operation.sendValue);
+    TEST_ASSERT_EQUAL_PTR(&entry, Operation.entry);
+    TEST_ASSERT_EQUAL(0, Operation.entry->value.bytesUsed);
+    TEST_ASSERT_NULL(Operation.response);
+}
+
+void test_KineticOperation_BuildGetPrevious_should_build_a_GETPREVIOUS_operation(void)
+{
+    LOG_LOCATION;
+    const ByteArray key = ByteArray_CreateWithCString("foobar");
+    KineticEntry entry = {
+        .key = ByteBuffer_CreateWithArray(key),
+        .metadataOnly = true,
+    };
+
+    KineticMessage_ConfigureKeyValue_Expect(&Request.protoData.message, &entry);
+
+    KineticOperation_BuildGetPrevious(&Operation, &entry);
+
+    // GETPREVIOUS
+    // The GETPREVIOUS operation is used to retrieve the value and metadata
+    // for the key preceding the specified key, which is replaced in the entry
+    TEST_ASSERT_TRUE(Request.protoData.message.command.header->has_messageType);
+    TEST_ASSERT_EQUAL(KINETIC_PROTO_COMMAND_MESSAGE_TYPE_GETPREVIOUS, Request.protoData.message.command.header->messageType);
+    TEST_ASSERT_FALSE(Operation.valueEnabled);
+    TEST_ASSERT_FALSE(Operation.sendValue);
+    TEST_ASSERT_EQUAL_PTR(&entry, Operation.entry);
+    TEST_ASSERT_NULL(Operation.response);
+}
+
 void test_KineticOperation_BuildDelete_should_build_a_DELETE_operation(void)
 {
     LOG_LOCATION;
@@ -606,7 +846,6 @@ void test_KineticOperation_BuildDelete_should_build_a_DELETE_operation(void)
     ByteArray value = ByteArray_Create(ValueData, sizeof(ValueData));
     KineticEntry entry = {.key = ByteBuffer_CreateWithArray(key), .value = ByteBuffer_CreateWithArray(value)};
 
-    KineticConnection_IncrementSequence_Expect(&Connection);
     KineticMessage_ConfigureKeyValue_Expect(&Request.protoData.message, &entry);
 
     KineticOperation_BuildDelete(&Operation, &entry);
@@ -676,7 +915,6 @@ void test_KineticOperation_BuildGetKeyRange_should_build_a_GetKeyRange_request(v
     }
     ByteBufferArray keys = {.buffers = keyBuffers, .count = numKeysInRange};
 
-    KineticConnection_IncrementSequence_Expect(&Connection);
     KineticMessage_ConfigureKeyRange_Expect(&Request.protoData.message, &range);
 
     KineticOperation_BuildGetKeyRange(&Operation, &range, &keys);
@@ -747,4 +985,84 @@ void test_KineticOperation_BuildGetKeyRange_should_build_a_GetKeyRange_request(v
     TEST_ASSERT_EQUAL_PTR(&Request.protoData.message, Request.proto);
     TEST_ASSERT_EQUAL_PTR(&Request.protoData.message.command, Request.command);
 }
+
+void test_KineticOperation_BuildGetLog_should_build_a_GetLog_request(void)
+{
+    LOG_LOCATION;
+    KineticDeviceLog log;
+    int types = KINETIC_LOG_TYPE_CAPACITIES | KINETIC_LOG_TYPE_LIMITS;
+
+    KineticMessage_ConfigureGetLog_Expect(&Request.protoData.message, types);
+
+    KineticOperation_BuildGetLog(&Operation, types, &log);
+
+    // GETLOG
+    // The GETLOG operation is used to retrieve device information of the
+    // requested types, which is decoded into the device log upon completion
+    TEST_ASSERT_TRUE(Request.command->header->has_messageType);
+    TEST_ASSERT_EQUAL(KINETIC_PROTO_COMMAND_MESSAGE_TYPE_GETLOG, Request.command->header->messageType);
+    TEST_ASSERT_FALSE(Operation.valueEnabled);
+    TEST_ASSERT_FALSE(Operation.sendValue);
+    TEST_ASSERT_NULL(Operation.entry);
+    TEST_ASSERT_EQUAL_PTR(&log, Operation.deviceLog);
+    TEST_ASSERT_NOT_NULL(Operation.callback);
+    TEST_ASSERT_NULL(Operation.response);
+}
+
+void test_KineticOperation_BuildFlush_should_build_a_FLUSHALLDATA_request(void)
+{
+    LOG_LOCATION;
+
+
+    KineticOperation_BuildFlush(&Operation);
+
+    // FLUSHALLDATA
+    // The FLUSHALLDATA operation makes all data previously written to the
+    // device durable, and carries no body
+    TEST_ASSERT_TRUE(Request.command->header->has_messageType);
+    TEST_ASSERT_EQUAL(KINETIC_PROTO_COMMAND_MESSAGE_TYPE_FLUSHALLDATA, Request.command->header->messageType);
+    TEST_ASSERT_FALSE(Operation.valueEnabled);
+    TEST_ASSERT_FALSE(Operation.sendValue);
+    TEST_ASSERT_NULL(Operation.entry);
+    TEST_ASSERT_NOT_NULL(Operation.callback);
+    TEST_ASSERT_NULL(Operation.response);
+}
+
+void test_KineticOperation_BuildP2POperation_should_build_a_PEER2PEERPUSH_request(void)
+{
+    LOG_LOCATION;
+    uint8_t keyData[2][8] = {"key one", "key two"};
+    KineticP2P_OperationData ops[2] = {
+        {.key = ByteBuffer_Create(keyData[0], sizeof(keyData[0]), sizeof(keyData[0]))},
+        {.key = ByteBuffer_Create(keyData[1], sizeof(keyData[1]), sizeof(keyData[1]))},
+    };
+    KineticP2P_Operation p2pOp = {
+        .peer = {.hostname = "peerhost", .port = 8123},
+        .numOperations = 2,
+        .operations = ops,
+    };
+
+    KineticMessage_ConfigureP2POperation_Ignore();
+
+    KineticStatus status = KineticOperation_BuildP2POperation(&Operation, &p2pOp);
+
+    // PEER2PEERPUSH
+    // The PEER2PEERPUSH operation has the device copy a batch of entries
+    // directly to a peer device. Each entry reports its own status, so the
+    // callback also inspects responses reporting failure
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_TRUE(Request.command->header->has_messageType);
+    TEST_ASSERT_EQUAL(KINETIC_PROTO_COMMAND_MESSAGE_TYPE_PEER2PEERPUSH, Request.command->header->messageType);
+    TEST_ASSERT_FALSE(Operation.valueEnabled);
+    TEST_ASSERT_FALSE(Operation.sendValue);
+    TEST_ASSERT_NULL(Operation.entry);
+    TEST_ASSERT_EQUAL_PTR(&p2pOp, Operation.p2pOp);
+    TEST_ASSERT_NOT_NULL(Operation.callback);
+    TEST_ASSERT_TRUE(Operation.callbackOnFailure);
+    TEST_ASSERT_NULL(Operation.response);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_ATTEMPTED, ops[0].resultStatus);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_ATTEMPTED, ops[1].resultStatus);
+
+    KineticArena_Free(&Request.arena);
+}
 #endif
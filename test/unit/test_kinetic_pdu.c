@@ -23,6 +23,7 @@
 #include "kinetic_types.h"
 #include "kinetic_types_internal.h"
 #include "kinetic_pdu.h"
+#include "kinetic_arena.h"
 #include "kinetic_nbo.h"
 #include "kinetic_proto.h"
 #include "kinetic_logger.h"
@@ -180,9 +181,9 @@ void test_KineticPDU_ReceiveMain_should_return_true_upon_receipt_of_valid_header
     ByteBuffer headerNBO = ByteBuffer_Create(&PDU.headerNBO, sizeof(KineticPDUHeader), 0);
     int32_t valueLen = 123;
 
-    KineticSocket_Read_ExpectAndReturn(Connection.socket, &headerNBO, sizeof(KineticPDUHeader), KINETIC_STATUS_SUCCESS);
-    KineticSocket_ReadProtobuf_ExpectAndReturn(Connection.socket, &PDU, KINETIC_STATUS_SUCCESS);
-    KineticHMAC_Validate_ExpectAndReturn(PDU.proto, PDU.connection->session.hmacKey, true);
+    KineticSocket_ReadBuffered_ExpectAndReturn(Connection.socket, &Connection.readBuffer, &headerNBO, sizeof(KineticPDUHeader), KINETIC_STATUS_SUCCESS);
+    KineticSocket_ReadProtobufBuffered_ExpectAndReturn(Connection.socket, &Connection.readBuffer, &PDU, KINETIC_STATUS_SUCCESS);
+    KineticHMAC_Validate_ExpectAndReturn(PDU.proto, &PDU.connection->hmacKey, true);
 
     PDU.headerNBO.valueLength = KineticNBO_FromHostU32(valueLen);
     EnableAndSetPDUConnectionID(&PDU, 12345);
@@ -202,9 +203,9 @@ void test_KineticPDU_ReceiveMain_should_receive_a_message_with_no_value_payload_
     KINETIC_PDU_INIT_WITH_COMMAND(&PDU, &Connection);
     ByteBuffer headerNBO = ByteBuffer_Create(&PDU.headerNBO, sizeof(KineticPDUHeader), 0);
 
-    KineticSocket_Read_ExpectAndReturn(Connection.socket, &headerNBO, sizeof(KineticPDUHeader), KINETIC_STATUS_SUCCESS);
-    KineticSocket_ReadProtobuf_ExpectAndReturn(Connection.socket, &PDU, KINETIC_STATUS_SUCCESS);
-    KineticHMAC_Validate_ExpectAndReturn(PDU.proto, PDU.connection->session.hmacKey, true);
+    KineticSocket_ReadBuffered_ExpectAndReturn(Connection.socket, &Connection.readBuffer, &headerNBO, sizeof(KineticPDUHeader), KINETIC_STATUS_SUCCESS);
+    KineticSocket_ReadProtobufBuffered_ExpectAndReturn(Connection.socket, &Connection.readBuffer, &PDU, KINETIC_STATUS_SUCCESS);
+    KineticHMAC_Validate_ExpectAndReturn(PDU.proto, &PDU.connection->hmacKey, true);
     EnableAndSetPDUConnectionID(&PDU, 12345);
     EnableAndSetPDUStatus(&PDU, KINETIC_PROTO_COMMAND_STATUS_STATUS_CODE_SUCCESS);
 
@@ -225,9 +226,9 @@ void test_KineticPDU_ReceiveMain_should_receive_a_message_with_no_payload_and_re
     ByteBuffer headerNBO = ByteBuffer_Create(&PDU.headerNBO, sizeof(KineticPDUHeader), 0);
 
     PDU.headerNBO.valueLength = KineticNBO_FromHostU32(0);
-    KineticSocket_Read_ExpectAndReturn(Connection.socket, &headerNBO, sizeof(KineticPDUHeader), KINETIC_STATUS_SUCCESS);
-    KineticSocket_ReadProtobuf_ExpectAndReturn(Connection.socket, &PDU, KINETIC_STATUS_SUCCESS);
-    KineticHMAC_Validate_ExpectAndReturn(PDU.proto, PDU.connection->session.hmacKey, true);
+    KineticSocket_ReadBuffered_ExpectAndReturn(Connection.socket, &Connection.readBuffer, &headerNBO, sizeof(KineticPDUHeader), KINETIC_STATUS_SUCCESS);
+    KineticSocket_ReadProtobufBuffered_ExpectAndReturn(Connection.socket, &Connection.readBuffer, &PDU, KINETIC_STATUS_SUCCESS);
+    KineticHMAC_Validate_ExpectAndReturn(PDU.proto, &PDU.connection->hmacKey, true);
     EnableAndSetPDUStatus(&PDU, KINETIC_PROTO_COMMAND_STATUS_STATUS_CODE_PERM_DATA_ERROR);
 
     KineticStatus status = KineticPDU_ReceiveMain(&PDU);
@@ -244,7 +245,7 @@ void test_KineticPDU_ReceiveMain_should_receive_a_message_for_the_exchange_and_r
     KINETIC_PDU_INIT_WITH_COMMAND(&PDU, &Connection);
     ByteBuffer headerNBO = ByteBuffer_Create(&PDU.headerNBO, sizeof(KineticPDUHeader), 0);
 
-    KineticSocket_Read_ExpectAndReturn(Connection.socket, &headerNBO, sizeof(KineticPDUHeader), KINETIC_STATUS_CONNECTION_ERROR);
+    KineticSocket_ReadBuffered_ExpectAndReturn(Connection.socket, &Connection.readBuffer, &headerNBO, sizeof(KineticPDUHeader), KINETIC_STATUS_CONNECTION_ERROR);
 
     KineticStatus status = KineticPDU_ReceiveMain(&PDU);
 
@@ -265,8 +266,8 @@ void test_KineticPDU_ReceiveMain_should_receive_a_message_for_the_exchange_and_r
         .protobufLength = KineticNBO_FromHostU32(12),
     };
 
-    KineticSocket_Read_ExpectAndReturn(Connection.socket, &headerNBO, sizeof(KineticPDUHeader), KINETIC_STATUS_SUCCESS);
-    KineticSocket_ReadProtobuf_ExpectAndReturn(Connection.socket, &PDU, KINETIC_STATUS_DEVICE_BUSY);
+    KineticSocket_ReadBuffered_ExpectAndReturn(Connection.socket, &Connection.readBuffer, &headerNBO, sizeof(KineticPDUHeader), KINETIC_STATUS_SUCCESS);
+    KineticSocket_ReadProtobufBuffered_ExpectAndReturn(Connection.socket, &Connection.readBuffer, &PDU, KINETIC_STATUS_DEVICE_BUSY);
 
     KineticStatus status = KineticPDU_ReceiveMain(&PDU);
 
@@ -296,8 +297,8 @@ void test_KineticPDU_ReceiveMain_should_receive_a_message_with_no_authentication
     PDU.protoData.message.message.commandBytes.len = packedCommandLen;
     PDU.protoData.message.message.has_commandBytes = true;
 
-    KineticSocket_Read_ExpectAndReturn(Connection.socket, &headerNBO, sizeof(KineticPDUHeader), KINETIC_STATUS_SUCCESS);
-    KineticSocket_ReadProtobuf_ExpectAndReturn(Connection.socket, &PDU, KINETIC_STATUS_SUCCESS);
+    KineticSocket_ReadBuffered_ExpectAndReturn(Connection.socket, &Connection.readBuffer, &headerNBO, sizeof(KineticPDUHeader), KINETIC_STATUS_SUCCESS);
+    KineticSocket_ReadProtobufBuffered_ExpectAndReturn(Connection.socket, &Connection.readBuffer, &PDU, KINETIC_STATUS_SUCCESS);
 
     KineticStatus status = KineticPDU_ReceiveMain(&PDU);
 
@@ -313,9 +314,9 @@ void test_KineticPDU_ReceiveMain_should_receive_a_message_for_the_exchange_and_r
     KINETIC_PDU_INIT_WITH_COMMAND(&PDU, &Connection);
     ByteBuffer headerNBO = ByteBuffer_Create(&PDU.headerNBO, sizeof(KineticPDUHeader), 0);
 
-    KineticSocket_Read_ExpectAndReturn(Connection.socket, &headerNBO, sizeof(KineticPDUHeader), KINETIC_STATUS_SUCCESS);
-    KineticSocket_ReadProtobuf_ExpectAndReturn(Connection.socket, &PDU, KINETIC_STATUS_SUCCESS);
-    KineticHMAC_Validate_ExpectAndReturn(PDU.proto, PDU.connection->session.hmacKey, false);
+    KineticSocket_ReadBuffered_ExpectAndReturn(Connection.socket, &Connection.readBuffer, &headerNBO, sizeof(KineticPDUHeader), KINETIC_STATUS_SUCCESS);
+    KineticSocket_ReadProtobufBuffered_ExpectAndReturn(Connection.socket, &Connection.readBuffer, &PDU, KINETIC_STATUS_SUCCESS);
+    KineticHMAC_Validate_ExpectAndReturn(PDU.proto, &PDU.connection->hmacKey, false);
 
     KineticStatus status = KineticPDU_ReceiveMain(&PDU);
 
@@ -327,16 +328,18 @@ void test_KineticPDU_ReceiveValue_should_receive_value_payload_into_specified_bu
 {
     uint8_t valueData[64];
     ByteBuffer value = ByteBuffer_Create(valueData, sizeof(valueData), 0);
-    KineticSocket_Read_ExpectAndReturn(7, &value, 57, KINETIC_STATUS_SUCCESS);
-    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticPDU_ReceiveValue(7, &value, 57));
+    Connection.socket = 7;
+    KineticSocket_ReadBuffered_ExpectAndReturn(7, &Connection.readBuffer, &value, 57, KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, KineticPDU_ReceiveValue(&Connection, &value, 57));
 }
 
 void test_KineticPDU_ReceiveValue_should_report_any_socket_receive_error(void)
 {
     uint8_t valueData[64];
     ByteBuffer value = ByteBuffer_Create(valueData, sizeof(valueData), 0);
-    KineticSocket_Read_ExpectAndReturn(134, &value, 26, KINETIC_STATUS_DEVICE_BUSY);
-    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_DEVICE_BUSY, KineticPDU_ReceiveValue(134, &value, 26));
+    Connection.socket = 134;
+    KineticSocket_ReadBuffered_ExpectAndReturn(134, &Connection.readBuffer, &value, 26, KINETIC_STATUS_DEVICE_BUSY);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_DEVICE_BUSY, KineticPDU_ReceiveValue(&Connection, &value, 26));
 }
 
 
@@ -459,3 +462,22 @@ void test_KineticPDU_GetKeyRange_should_return_the_KineticProto_Command_Range_fr
     range = KineticPDU_GetKeyRange(&PDU);
     TEST_ASSERT_EQUAL_PTR(&PDU.protoData.message.keyRange, range);
 }
+
+void test_KineticPDU_GetLog_should_return_the_KineticProto_Command_GetLog_from_the_message_if_avaliable(void)
+{ LOG_LOCATION;
+    KINETIC_PDU_INIT_WITH_COMMAND(&PDU, &Connection);
+    KineticProto_Command_GetLog* getLog;
+
+    PDU.command->body = NULL;
+    getLog = KineticPDU_GetLog(&PDU);
+    TEST_ASSERT_NULL(getLog);
+
+    PDU.command->body = &PDU.protoData.message.body;
+    PDU.command->body->getLog = NULL;
+    getLog = KineticPDU_GetLog(&PDU);
+    TEST_ASSERT_NULL(getLog);
+
+    PDU.command->body->getLog = &PDU.protoData.message.getLog;
+    getLog = KineticPDU_GetLog(&PDU);
+    TEST_ASSERT_EQUAL_PTR(&PDU.protoData.message.getLog, getLog);
+}
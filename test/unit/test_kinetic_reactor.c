@@ -0,0 +1,143 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_reactor.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "mock_kinetic_connection.h"
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+static KineticConnection Connection;
+static int Sockets[2];
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    KINETIC_CONNECTION_INIT(&Connection);
+    TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, Sockets));
+    Connection.socket = Sockets[0];
+    Connection.connected = true;
+    Connection.thread.connection = &Connection;
+}
+
+void tearDown(void)
+{
+    close(Sockets[0]);
+    close(Sockets[1]);
+    KineticLogger_Close();
+}
+
+void test_KineticReactor_AddConnection_should_attach_connection_to_a_reactor(void)
+{
+    LOG_LOCATION;
+    KineticStatus status = KineticReactor_AddConnection(&Connection);
+
+    TEST_ASSERT_EQUAL(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_NOT_NULL(Connection.reactor);
+
+    KineticReactor_RemoveConnection(&Connection);
+    TEST_ASSERT_NULL(Connection.reactor);
+}
+
+void test_KineticReactor_AddConnection_should_balance_connections_across_reactors(void)
+{
+    LOG_LOCATION;
+    KineticConnection other;
+    KINETIC_CONNECTION_INIT(&other);
+    int otherSockets[2];
+    TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, otherSockets));
+    other.socket = otherSockets[0];
+
+    TEST_ASSERT_EQUAL(KINETIC_STATUS_SUCCESS, KineticReactor_AddConnection(&Connection));
+    TEST_ASSERT_EQUAL(KINETIC_STATUS_SUCCESS, KineticReactor_AddConnection(&other));
+    if (KINETIC_REACTOR_THREADS > 1) {
+        TEST_ASSERT_TRUE(Connection.reactor != other.reactor);
+    }
+
+    KineticReactor_RemoveConnection(&other);
+    KineticReactor_RemoveConnection(&Connection);
+    close(otherSockets[0]);
+    close(otherSockets[1]);
+}
+
+void test_KineticReactor_should_receive_PDUs_once_data_arrives(void)
+{
+    LOG_LOCATION;
+    KineticConnection_ReceiveAvailable_IgnoreAndReturn(KINETIC_STATUS_SOCKET_ERROR);
+    TEST_ASSERT_EQUAL(KINETIC_STATUS_SUCCESS, KineticReactor_AddConnection(&Connection));
+
+    uint8_t data = 0xA5;
+    TEST_ASSERT_EQUAL(1, write(Sockets[1], &data, sizeof(data)));
+
+    // Wait for the reactor to service the socket and flag the reported error
+    for (int i = 0; i < 100 && !Connection.thread.fatalError; i++) {
+        nanosleep(&(struct timespec){.tv_nsec = 10000000}, NULL);
+    }
+    TEST_ASSERT_TRUE(Connection.thread.fatalError);
+
+    KineticReactor_RemoveConnection(&Connection);
+}
+
+void test_KineticReactor_should_flag_a_fatal_error_if_the_peer_hangs_up(void)
+{
+    LOG_LOCATION;
+    KineticConnection_ReceiveAvailable_IgnoreAndReturn(KINETIC_STATUS_SOCKET_ERROR);
+    TEST_ASSERT_EQUAL(KINETIC_STATUS_SUCCESS, KineticReactor_AddConnection(&Connection));
+
+    close(Sockets[1]);
+    Sockets[1] = -1;
+
+    for (int i = 0; i < 100 && !Connection.thread.fatalError; i++) {
+        nanosleep(&(struct timespec){.tv_nsec = 10000000}, NULL);
+    }
+    TEST_ASSERT_TRUE(Connection.thread.fatalError);
+
+    KineticReactor_RemoveConnection(&Connection);
+}
+
+void test_KineticReactor_Pause_should_stop_servicing_a_connection_until_resumed(void)
+{
+    LOG_LOCATION;
+    KineticConnection_ReceiveAvailable_IgnoreAndReturn(KINETIC_STATUS_SOCKET_ERROR);
+    TEST_ASSERT_EQUAL(KINETIC_STATUS_SUCCESS, KineticReactor_AddConnection(&Connection));
+    KineticReactor_Pause(&Connection, true);
+    TEST_ASSERT_TRUE(Connection.thread.paused);
+
+    uint8_t data = 0xA5;
+    TEST_ASSERT_EQUAL(1, write(Sockets[1], &data, sizeof(data)));
+    nanosleep(&(struct timespec){.tv_nsec = 100000000}, NULL);
+    TEST_ASSERT_FALSE(Connection.thread.fatalError);
+
+    KineticReactor_Pause(&Connection, false);
+    TEST_ASSERT_FALSE(Connection.thread.paused);
+    for (int i = 0; i < 100 && !Connection.thread.fatalError; i++) {
+        nanosleep(&(struct timespec){.tv_nsec = 10000000}, NULL);
+    }
+    TEST_ASSERT_TRUE(Connection.thread.fatalError);
+
+    KineticReactor_RemoveConnection(&Connection);
+}
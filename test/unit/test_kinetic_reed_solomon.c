@@ -0,0 +1,134 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_reed_solomon.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SIZE (37)
+
+static uint8_t Buffers[KINETIC_ERASURE_FRAGMENTS_MAX][SIZE];
+static uint8_t Original[KINETIC_ERASURE_FRAGMENTS_MAX][SIZE];
+static uint8_t* Fragments[KINETIC_ERASURE_FRAGMENTS_MAX];
+static bool Present[KINETIC_ERASURE_FRAGMENTS_MAX];
+
+void setUp(void)
+{
+    srand(42);
+    for (int i = 0; i < KINETIC_ERASURE_FRAGMENTS_MAX; i++) {
+        Fragments[i] = Buffers[i];
+        Present[i] = true;
+        for (int j = 0; j < SIZE; j++) {
+            Buffers[i][j] = (uint8_t)rand();
+        }
+    }
+}
+
+void tearDown(void)
+{
+}
+
+static void Encode(int k, int m)
+{
+    KineticReedSolomon_Encode(k, m, SIZE, Fragments);
+    memcpy(Original, Buffers, sizeof(Original));
+}
+
+static void Lose(int index)
+{
+    Present[index] = false;
+    memset(Buffers[index], 0xA5, SIZE);
+}
+
+static void AssertDataDecoded(int k, int m)
+{
+    TEST_ASSERT_TRUE(KineticReedSolomon_Decode(k, m, SIZE, Fragments, Present));
+    for (int i = 0; i < k; i++) {
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(Original[i], Buffers[i], SIZE);
+    }
+}
+
+void test_KineticReedSolomon_Encode_should_only_write_the_parity_fragments(void)
+{
+    memcpy(Original, Buffers, sizeof(Original));
+
+    KineticReedSolomon_Encode(3, 2, SIZE, Fragments);
+
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(Original[i], Buffers[i], SIZE);
+    }
+    for (int i = 5; i < KINETIC_ERASURE_FRAGMENTS_MAX; i++) {
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(Original[i], Buffers[i], SIZE);
+    }
+}
+
+void test_KineticReedSolomon_Decode_should_leave_the_data_when_all_data_fragments_are_present(void)
+{
+    Encode(4, 2);
+    Lose(4);
+    Lose(5);
+
+    AssertDataDecoded(4, 2);
+}
+
+void test_KineticReedSolomon_Decode_should_recover_from_the_loss_of_any_m_fragments(void)
+{
+    int k = 4, m = 3;
+    Encode(k, m);
+
+    // Every combination of m lost fragments
+    for (int a = 0; a < k + m; a++) {
+        for (int b = a + 1; b < k + m; b++) {
+            for (int c = b + 1; c < k + m; c++) {
+                Lose(a);
+                Lose(b);
+                Lose(c);
+                AssertDataDecoded(k, m);
+                memcpy(Buffers, Original, sizeof(Buffers));
+                Present[a] = Present[b] = Present[c] = true;
+            }
+        }
+    }
+}
+
+void test_KineticReedSolomon_Decode_should_recover_with_the_most_fragments_supported(void)
+{
+    int k = KINETIC_ERASURE_FRAGMENTS_MAX - 4, m = 4;
+    Encode(k, m);
+    for (int i = 0; i < m; i++) {
+        Lose(i * 3);
+    }
+
+    AssertDataDecoded(k, m);
+}
+
+void test_KineticReedSolomon_Decode_should_fail_with_fewer_than_k_fragments(void)
+{
+    Encode(3, 2);
+    Lose(0);
+    Lose(2);
+    Lose(4);
+
+    TEST_ASSERT_FALSE(KineticReedSolomon_Decode(3, 2, SIZE, Fragments, Present));
+}
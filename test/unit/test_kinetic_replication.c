@@ -0,0 +1,303 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_replication.h"
+#include "kinetic_fan_out.h"
+#include "kinetic_entry.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include "mock_kinetic_operation.h"
+#include "operation_test_fixture.h"
+#include <stdio.h>
+#include <string.h>
+
+#define REPLICAS (3)
+#define NUM_OPERATIONS (REPLICAS * 2)
+
+static KineticConnection Connections[REPLICAS];
+static KineticConnection* ConnectionList[REPLICAS];
+static KineticOperation Operations[NUM_OPERATIONS];
+static KineticPDU Requests[NUM_OPERATIONS];
+static uint8_t KeyData[] = "replicated key";
+static uint8_t ValueData[64];
+static uint8_t VersionData[KINETIC_MAX_VERSION_LEN];
+static uint8_t NewVersionData[KINETIC_MAX_VERSION_LEN];
+static KineticEntry Entry;
+static KineticStatus CompletedStatus;
+static int Completions;
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    for (int i = 0; i < REPLICAS; i++) {
+        KINETIC_CONNECTION_INIT(&Connections[i]);
+        sprintf(Connections[i].session.host, "drive%d.example.com", i);
+        Connections[i].session.port = KINETIC_PORT;
+        ConnectionList[i] = &Connections[i];
+    }
+    for (int i = 0; i < NUM_OPERATIONS; i++) {
+        KINETIC_OPERATION_INIT(&Operations[i], &Connections[i % REPLICAS]);
+        Operations[i].request = &Requests[i];
+    }
+    memset(ValueData, 0, sizeof(ValueData));
+    Entry = (KineticEntry) {
+        .key = ByteBuffer_Create(KeyData, sizeof(KeyData), sizeof(KeyData)),
+        .value = ByteBuffer_Create(ValueData, sizeof(ValueData), 0),
+        .dbVersion = ByteBuffer_Create(VersionData, sizeof(VersionData), 0),
+        .newVersion = ByteBuffer_Create(NewVersionData, sizeof(NewVersionData), 0),
+    };
+    CompletedStatus = KINETIC_STATUS_INVALID;
+    Completions = 0;
+    SubmitOperations(Operations);
+}
+
+void tearDown(void)
+{
+    VerifySubmissions();
+    KineticLogger_Close();
+}
+
+static void Completed(KineticCompletionData* kinetic_data, void* client_data)
+{
+    TEST_ASSERT_EQUAL_PTR(&Entry, client_data);
+    CompletedStatus = kinetic_data->status;
+    Completions++;
+}
+
+static KineticCompletionClosure Closure = {.callback = Completed, .clientData = &Entry};
+
+// Repairs are issued from the receiver thread, so must not wait for the window
+static void ExpectRepair(int replica)
+{
+    ExpectSubmit(&Connections[replica], false, KINETIC_STATUS_SUCCESS);
+}
+
+static KineticEntry* ReplicaEntry(int index)
+{
+    return &((KineticReplica*)Operations[index].closure.clientData)->member.entry;
+}
+
+// Plays the part of the receiver, completing the operation as the device did
+static void Respond(int index, KineticStatus status)
+{
+    CompleteOperation(&Operations[index], status);
+}
+
+// Completes a GET with the entry a replica holds
+static void RespondEntry(int index, uint8_t version, const char* value)
+{
+    KineticEntry* entry = ReplicaEntry(index);
+    ByteBuffer_Append(&entry->dbVersion, &version, 1);
+    ByteBuffer_AppendCString(&entry->value, value);
+    Respond(index, KINETIC_STATUS_SUCCESS);
+}
+
+void test_KineticReplication_Put_should_reject_an_invalid_quorum(void)
+{
+    LOG_LOCATION;
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticReplication_Put(ConnectionList, REPLICAS, 0, &Entry, &Closure));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticReplication_Put(ConnectionList, REPLICAS, REPLICAS + 1, &Entry, &Closure));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticReplication_Put(ConnectionList, KINETIC_REPLICAS_MAX + 1, 1, &Entry, &Closure));
+    TEST_ASSERT_EQUAL(0, Completions);
+}
+
+void test_KineticReplication_Put_should_complete_once_the_write_quorum_succeeds(void)
+{
+    LOG_LOCATION;
+    ByteBuffer_AppendCString(&Entry.value, "value");
+    ByteBuffer_AppendCString(&Entry.newVersion, "v2");
+    KineticOperation_BuildPut_Ignore();
+    for (int i = 0; i < REPLICAS; i++) {
+        ExpectSubmit(&Connections[i], true, KINETIC_STATUS_SUCCESS);
+    }
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticReplication_Put(ConnectionList, REPLICAS, 2, &Entry, &Closure));
+
+    // Each replica writes its own copy of the versions
+    for (int i = 0; i < REPLICAS; i++) {
+        TEST_ASSERT_TRUE(ReplicaEntry(i)->newVersion.array.data != NewVersionData);
+        TEST_ASSERT_EQUAL(2, ReplicaEntry(i)->newVersion.bytesUsed);
+    }
+
+    Respond(0, KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL(0, Completions);
+    Respond(2, KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, CompletedStatus);
+    TEST_ASSERT_EQUAL(2, Entry.dbVersion.bytesUsed);
+    TEST_ASSERT_EQUAL(0, memcmp("v2", VersionData, 2));
+    TEST_ASSERT_EQUAL(0, Entry.newVersion.bytesUsed);
+
+    // The straggler completes without reporting again
+    Respond(1, KINETIC_STATUS_VERSION_MISMATCH);
+    TEST_ASSERT_EQUAL(1, Completions);
+}
+
+void test_KineticReplication_Put_should_report_the_first_failure_once_the_quorum_is_lost(void)
+{
+    LOG_LOCATION;
+    ByteBuffer_AppendCString(&Entry.value, "value");
+    KineticOperation_BuildPut_Ignore();
+    ExpectSubmit(&Connections[0], true, KINETIC_STATUS_SUCCESS);
+    ExpectSubmit(&Connections[1], true, KINETIC_STATUS_CONNECTION_ERROR);
+    ExpectSubmit(&Connections[2], true, KINETIC_STATUS_SUCCESS);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticReplication_Put(ConnectionList, REPLICAS, 2, &Entry, &Closure));
+    TEST_ASSERT_EQUAL(0, Completions);
+
+    Respond(2, KINETIC_STATUS_VERSION_MISMATCH);
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_CONNECTION_ERROR, CompletedStatus);
+
+    Respond(0, KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL(1, Completions);
+}
+
+void test_KineticReplication_Put_should_complete_a_synchronous_put_once_submitted(void)
+{
+    LOG_LOCATION;
+    ByteBuffer_AppendCString(&Entry.value, "value");
+    KineticOperation_BuildPut_Ignore();
+    for (int i = 0; i < REPLICAS; i++) {
+        ExpectSubmit(&Connections[i], true, KINETIC_STATUS_SOCKET_ERROR);
+    }
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SOCKET_ERROR,
+        KineticReplication_Put(ConnectionList, REPLICAS, 1, &Entry, NULL));
+}
+
+void test_KineticReplication_Get_should_deliver_the_newest_version_and_repair_stale_replicas(void)
+{
+    LOG_LOCATION;
+    KineticOperation_BuildGet_Ignore();
+    KineticOperation_BuildPut_Ignore();
+    for (int i = 0; i < REPLICAS; i++) {
+        ExpectSubmit(&Connections[i], true, KINETIC_STATUS_SUCCESS);
+    }
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticReplication_Get(ConnectionList, REPLICAS, 2, &Entry, &Closure));
+
+    // Each replica retrieves into its own buffers
+    for (int i = 0; i < REPLICAS; i++) {
+        TEST_ASSERT_TRUE(ReplicaEntry(i)->value.array.data != ValueData);
+        TEST_ASSERT_EQUAL(sizeof(ValueData), ReplicaEntry(i)->value.array.len);
+    }
+
+    RespondEntry(0, 1, "old value");
+    TEST_ASSERT_EQUAL(0, Completions);
+    RespondEntry(1, 2, "new value");
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, CompletedStatus);
+    TEST_ASSERT_EQUAL(strlen("new value"), Entry.value.bytesUsed);
+    TEST_ASSERT_EQUAL(0, memcmp("new value", ValueData, Entry.value.bytesUsed));
+    TEST_ASSERT_EQUAL(1, Entry.dbVersion.bytesUsed);
+    TEST_ASSERT_EQUAL(2, VersionData[0]);
+
+    // Once every replica has responded, the stale and missing ones are rewritten
+    ExpectRepair(0);
+    ExpectRepair(2);
+    Respond(2, KINETIC_STATUS_NOT_FOUND);
+    TEST_ASSERT_EQUAL(1, Completions);
+    // Each repair is conditional on the version the replica reported, or on
+    // the entry still being missing
+    TEST_ASSERT_EQUAL(1, ReplicaEntry(REPLICAS + 0)->dbVersion.bytesUsed);
+    TEST_ASSERT_EQUAL(1, ReplicaEntry(REPLICAS + 0)->dbVersion.array.data[0]);
+    TEST_ASSERT_EQUAL(0, ReplicaEntry(REPLICAS + 1)->dbVersion.bytesUsed);
+    for (int i = 0; i < 2; i++) {
+        KineticEntry* repair = ReplicaEntry(REPLICAS + i);
+        TEST_ASSERT_FALSE(repair->force);
+        TEST_ASSERT_EQUAL(1, repair->newVersion.bytesUsed);
+        TEST_ASSERT_EQUAL(2, repair->newVersion.array.data[0]);
+        TEST_ASSERT_EQUAL(0, memcmp("new value", repair->value.array.data, repair->value.bytesUsed));
+    }
+    Respond(REPLICAS + 0, KINETIC_STATUS_SUCCESS);
+    Respond(REPLICAS + 1, KINETIC_STATUS_SUCCESS);
+    TEST_ASSERT_EQUAL(1, Completions);
+}
+
+void test_KineticReplication_Get_should_not_overwrite_a_write_racing_with_a_repair(void)
+{
+    LOG_LOCATION;
+    KineticOperation_BuildGet_Ignore();
+    KineticOperation_BuildPut_Ignore();
+    for (int i = 0; i < REPLICAS; i++) {
+        ExpectSubmit(&Connections[i], true, KINETIC_STATUS_SUCCESS);
+    }
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticReplication_Get(ConnectionList, REPLICAS, 2, &Entry, &Closure));
+    RespondEntry(0, 2, "new value");
+    RespondEntry(1, 2, "new value");
+    TEST_ASSERT_EQUAL(1, Completions);
+
+    // The stale replica is written meanwhile, so rejects the repair
+    ExpectRepair(2);
+    RespondEntry(2, 1, "old value");
+    TEST_ASSERT_FALSE(ReplicaEntry(REPLICAS)->force);
+    TEST_ASSERT_EQUAL(1, ReplicaEntry(REPLICAS)->dbVersion.array.data[0]);
+    Respond(REPLICAS, KINETIC_STATUS_VERSION_MISMATCH);
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, CompletedStatus);
+}
+
+void test_KineticReplication_Get_should_report_an_entry_found_on_no_replica(void)
+{
+    LOG_LOCATION;
+    KineticOperation_BuildGet_Ignore();
+    for (int i = 0; i < REPLICAS; i++) {
+        ExpectSubmit(&Connections[i], true, KINETIC_STATUS_SUCCESS);
+    }
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticReplication_Get(ConnectionList, REPLICAS, 2, &Entry, &Closure));
+    Respond(0, KINETIC_STATUS_NOT_FOUND);
+    Respond(1, KINETIC_STATUS_NOT_FOUND);
+    TEST_ASSERT_EQUAL(1, Completions);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, CompletedStatus);
+
+    // Nothing to repair from
+    Respond(2, KINETIC_STATUS_NOT_FOUND);
+    TEST_ASSERT_EQUAL(1, Completions);
+}
+
+void test_KineticReplication_Get_should_report_a_newest_value_which_does_not_fit(void)
+{
+    LOG_LOCATION;
+    KineticOperation_BuildGet_Ignore();
+    ExpectSubmit(&Connections[0], true, KINETIC_STATUS_SUCCESS);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticReplication_Get(ConnectionList, 1, 1, &Entry, &Closure));
+    Entry.value.array.len = 4;
+    RespondEntry(0, 1, "too long");
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_BUFFER_OVERRUN, CompletedStatus);
+    TEST_ASSERT_EQUAL(strlen("too long"), Entry.value.bytesUsed);
+}
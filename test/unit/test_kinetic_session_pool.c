@@ -0,0 +1,271 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_session_pool.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include "mock_kinetic_connection.h"
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#define POOL_SIZE (3)
+
+static KineticConnection Connections[POOL_SIZE];
+static KineticSessionHandle Handles[POOL_SIZE] = {1, 2, 3};
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    for (int i = 0; i < POOL_SIZE; i++) {
+        KINETIC_CONNECTION_INIT(&Connections[i]);
+        Connections[i].connected = true;
+        Connections[i].connectionID = 1000 + i;
+    }
+    strcpy(Connections[0].session.host, "somehost.com");
+    Connections[0].session.connections = POOL_SIZE;
+}
+
+void tearDown(void)
+{
+    KineticLogger_Close();
+}
+
+static void ConnectPool(KineticPoolPolicy policy)
+{
+    Connections[0].session.poolPolicy = policy;
+    for (int i = 1; i < POOL_SIZE; i++) {
+        KineticConnection_NewConnection_ExpectAndReturn(&Connections[0].session, Handles[i]);
+        KineticConnection_FromHandle_ExpectAndReturn(Handles[i], &Connections[i]);
+        KineticConnection_Connect_ExpectAndReturn(&Connections[i], KINETIC_STATUS_SUCCESS);
+    }
+
+    KineticStatus status = KineticSessionPool_Connect(&Connections[0]);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_NOT_NULL(Connections[0].pool);
+    for (int i = 0; i < POOL_SIZE; i++) {
+        TEST_ASSERT_EQUAL_PTR(Connections[0].pool, Connections[i].memberOf);
+    }
+}
+
+static void DisconnectPool(void)
+{
+    for (int i = 1; i < POOL_SIZE; i++) {
+        KineticConnection_Disconnect_ExpectAndReturn(&Connections[i], KINETIC_STATUS_SUCCESS);
+        KineticConnection_FreeConnection_Expect(&Handles[i]);
+    }
+
+    KineticSessionPool_Disconnect(&Connections[0]);
+
+    TEST_ASSERT_NULL(Connections[0].pool);
+    for (int i = 0; i < POOL_SIZE; i++) {
+        TEST_ASSERT_NULL(Connections[i].memberOf);
+    }
+}
+
+void test_KineticSessionPool_Connect_should_open_the_other_connections_to_the_device(void)
+{
+    ConnectPool(KINETIC_POOL_POLICY_LEAST_OUTSTANDING);
+
+    KineticSessionPool* pool = Connections[0].pool;
+    TEST_ASSERT_EQUAL(POOL_SIZE, pool->count);
+    for (int i = 0; i < POOL_SIZE; i++) {
+        TEST_ASSERT_EQUAL_PTR(&Connections[i], pool->members[i]);
+    }
+    TEST_ASSERT_NULL(Connections[1].pool);
+
+    DisconnectPool();
+}
+
+void test_KineticSessionPool_Connect_should_reject_an_invalid_number_of_connections(void)
+{
+    Connections[0].session.connections = KINETIC_SESSION_CONNECTIONS_MAX + 1;
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticSessionPool_Connect(&Connections[0]));
+    TEST_ASSERT_NULL(Connections[0].pool);
+}
+
+void test_KineticSessionPool_Connect_should_close_the_connections_opened_if_one_fails(void)
+{
+    KineticConnection_NewConnection_ExpectAndReturn(&Connections[0].session, Handles[1]);
+    KineticConnection_FromHandle_ExpectAndReturn(Handles[1], &Connections[1]);
+    KineticConnection_Connect_ExpectAndReturn(&Connections[1], KINETIC_STATUS_SUCCESS);
+    KineticConnection_NewConnection_ExpectAndReturn(&Connections[0].session, Handles[2]);
+    KineticConnection_FromHandle_ExpectAndReturn(Handles[2], &Connections[2]);
+    KineticConnection_Connect_ExpectAndReturn(&Connections[2], KINETIC_STATUS_CONNECTION_ERROR);
+    KineticConnection_FreeConnection_Expect(&Handles[2]);
+    KineticConnection_Disconnect_ExpectAndReturn(&Connections[1], KINETIC_STATUS_SUCCESS);
+    KineticConnection_FreeConnection_Expect(&Handles[1]);
+
+    KineticStatus status = KineticSessionPool_Connect(&Connections[0]);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_CONNECTION_ERROR, status);
+    TEST_ASSERT_NULL(Connections[0].pool);
+}
+
+void test_KineticSessionPool_Select_should_use_each_connection_in_turn_for_round_robin(void)
+{
+    ConnectPool(KINETIC_POOL_POLICY_ROUND_ROBIN);
+    KineticSessionPool* pool = Connections[0].pool;
+    Connections[0].outstanding = 0;
+    Connections[1].outstanding = 10;
+
+    for (int i = 0; i < 2 * POOL_SIZE; i++) {
+        TEST_ASSERT_EQUAL_PTR(&Connections[i % POOL_SIZE], KineticSessionPool_Select(pool));
+    }
+
+    DisconnectPool();
+}
+
+void test_KineticSessionPool_Select_should_use_the_connection_with_fewest_operations_in_flight(void)
+{
+    ConnectPool(KINETIC_POOL_POLICY_LEAST_OUTSTANDING);
+    KineticSessionPool* pool = Connections[0].pool;
+    Connections[0].outstanding = 4;
+    Connections[1].outstanding = 1;
+    Connections[2].outstanding = 3;
+
+    for (int i = 0; i < POOL_SIZE; i++) {
+        TEST_ASSERT_EQUAL_PTR(&Connections[1], KineticSessionPool_Select(pool));
+    }
+
+    // Ties are spread across the connections
+    Connections[0].outstanding = 1;
+    Connections[2].outstanding = 1;
+    TEST_ASSERT_EQUAL_PTR(&Connections[0], KineticSessionPool_Select(pool));
+    TEST_ASSERT_EQUAL_PTR(&Connections[1], KineticSessionPool_Select(pool));
+    TEST_ASSERT_EQUAL_PTR(&Connections[2], KineticSessionPool_Select(pool));
+
+    DisconnectPool();
+}
+
+void test_KineticSessionPool_Select_should_use_the_less_loaded_of_two_connections_for_least_latency(void)
+{
+    ConnectPool(KINETIC_POOL_POLICY_LEAST_LATENCY);
+    KineticSessionPool* pool = Connections[0].pool;
+
+    // The next connection in turn is weighed against another
+    KineticConnection_SelectLeastLoaded_ExpectAndReturn(pool->members, POOL_SIZE, 0, 2);
+    TEST_ASSERT_EQUAL_PTR(&Connections[2], KineticSessionPool_Select(pool));
+    KineticConnection_SelectLeastLoaded_ExpectAndReturn(pool->members, POOL_SIZE, 1, 1);
+    TEST_ASSERT_EQUAL_PTR(&Connections[1], KineticSessionPool_Select(pool));
+
+    // If the connection chosen has failed, the one with fewest in flight is used
+    Connections[2].thread.fatalError = true;
+    Connections[0].outstanding = 3;
+    Connections[1].outstanding = 2;
+    KineticConnection_SelectLeastLoaded_ExpectAndReturn(pool->members, POOL_SIZE, 2, 2);
+    TEST_ASSERT_EQUAL_PTR(&Connections[1], KineticSessionPool_Select(pool));
+
+    DisconnectPool();
+}
+
+void test_KineticSessionPool_Select_should_skip_failed_connections(void)
+{
+    ConnectPool(KINETIC_POOL_POLICY_ROUND_ROBIN);
+    KineticSessionPool* pool = Connections[0].pool;
+    Connections[1].thread.fatalError = true;
+
+    TEST_ASSERT_EQUAL_PTR(&Connections[0], KineticSessionPool_Select(pool));
+    TEST_ASSERT_EQUAL_PTR(&Connections[2], KineticSessionPool_Select(pool));
+    TEST_ASSERT_EQUAL_PTR(&Connections[2], KineticSessionPool_Select(pool));
+
+    DisconnectPool();
+}
+
+static void FillWindows(int outstandingOperationsMax)
+{
+    for (int i = 0; i < POOL_SIZE; i++) {
+        Connections[i].session.outstandingOperationsMax = outstandingOperationsMax;
+        Connections[i].outstanding = outstandingOperationsMax;
+    }
+}
+
+void test_KineticSessionPool_WaitForWindow_should_return_once_any_connection_has_room(void)
+{
+    ConnectPool(KINETIC_POOL_POLICY_ROUND_ROBIN);
+    FillWindows(2);
+    Connections[2].outstanding = 1;
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS,
+        KineticSessionPool_WaitForWindow(Connections[0].pool));
+
+    DisconnectPool();
+}
+
+// Plays the part of KineticConnection_ReleaseWindow on a pooled connection
+static void* ReleaseWindowAfterDelay(void* arg)
+{
+    KineticConnection* connection = (KineticConnection*)arg;
+    nanosleep(&(struct timespec) {.tv_nsec = 50 * 1000 * 1000}, NULL);
+    pthread_mutex_lock(&connection->windowMutex);
+    connection->outstanding--;
+    KineticSessionPool* pool = connection->memberOf;
+    pthread_mutex_lock(&pool->mutex);
+    pool->released++;
+    pthread_cond_broadcast(&pool->windowCond);
+    pthread_mutex_unlock(&pool->mutex);
+    pthread_mutex_unlock(&connection->windowMutex);
+    return NULL;
+}
+
+void test_KineticSessionPool_WaitForWindow_should_block_until_an_operation_leaves_any_window(void)
+{
+    ConnectPool(KINETIC_POOL_POLICY_ROUND_ROBIN);
+    FillWindows(2);
+
+    pthread_t releaser;
+    TEST_ASSERT_EQUAL(0, pthread_create(&releaser, NULL, ReleaseWindowAfterDelay, &Connections[2]));
+    KineticStatus status = KineticSessionPool_WaitForWindow(Connections[0].pool);
+    pthread_join(releaser, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(1, Connections[2].outstanding);
+
+    DisconnectPool();
+}
+
+void test_KineticSessionPool_WaitForWindow_should_report_failure_once_every_connection_has_failed(void)
+{
+    ConnectPool(KINETIC_POOL_POLICY_ROUND_ROBIN);
+    FillWindows(2);
+    Connections[0].outstanding = 0;
+    Connections[0].thread.fatalError = true;
+    for (int i = 1; i < POOL_SIZE; i++) {
+        Connections[i].connected = false;
+    }
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_CONNECTION_ERROR,
+        KineticSessionPool_WaitForWindow(Connections[0].pool));
+
+    DisconnectPool();
+}
+
+void test_KineticSessionPool_Disconnect_should_do_nothing_if_not_pooled(void)
+{
+    KineticSessionPool_Disconnect(&Connections[0]);
+}
@@ -0,0 +1,361 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_stream.h"
+#include "kinetic_batch.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_nbo.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include "mock_kinetic_connection.h"
+#include "mock_kinetic_allocator.h"
+#include "mock_kinetic_operation.h"
+#include "operation_test_fixture.h"
+#include <pthread.h>
+#include <time.h>
+
+#define NUM_OPERATIONS (8)
+
+static KineticConnection Connection;
+static KineticConnection* Connections[] = {&Connection};
+static KineticOperation Operations[NUM_OPERATIONS]; // manifest operations
+static KineticOperation Chunks[NUM_OPERATIONS];     // chunk operations
+static KineticPDU Requests[2 * NUM_OPERATIONS];
+static KineticOperation* Responses[2 * NUM_OPERATIONS];
+static KineticStatus Results[2 * NUM_OPERATIONS];
+static int ResponseCount;
+static int ResultCount;
+static uint8_t ObjectData[20];
+static uint8_t KeyData[] = "my_object";
+static KineticStream Stream;
+static int ProgressCount;
+static KineticStatus ProgressStatus;
+static KineticStreamManifest StoredManifest;
+static uint8_t BuiltKeys[NUM_OPERATIONS][KINETIC_MAX_KEY_LEN];
+static size_t BuiltKeyLens[NUM_OPERATIONS];
+static uint8_t BuiltManifest[KINETIC_STREAM_MANIFEST_LEN];
+
+static void TestProgress(int64_t chunk, int64_t chunkCount, KineticStatus status, void* clientData)
+{
+    TEST_ASSERT_EQUAL_PTR(&ProgressCount, clientData);
+    TEST_ASSERT_TRUE(chunk >= 0 && chunk < chunkCount);
+    ProgressStatus = status;
+    ProgressCount++;
+}
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    KINETIC_CONNECTION_INIT(&Connection);
+    for (int i = 0; i < NUM_OPERATIONS; i++) {
+        KINETIC_OPERATION_INIT(&Operations[i], &Connection);
+        Operations[i].request = &Requests[i];
+        KINETIC_OPERATION_INIT(&Chunks[i], &Connection);
+        Chunks[i].request = &Requests[NUM_OPERATIONS + i];
+    }
+    ResponseCount = 0;
+    ResultCount = 0;
+    ProgressCount = 0;
+    SubmitOperations(Chunks);
+    Stream = (KineticStream) {
+        .key = ByteBuffer_Create(KeyData, sizeof(KeyData) - 1, sizeof(KeyData) - 1),
+        .value = ByteBuffer_Create(ObjectData, sizeof(ObjectData), sizeof(ObjectData)),
+        .chunkSize = 8,
+        .progress = TestProgress,
+        .clientData = &ProgressCount,
+    };
+}
+
+void tearDown(void)
+{
+    KineticLogger_Close();
+}
+
+void test_KineticStream_EncodeManifest_and_DecodeManifest_should_round_trip_a_manifest(void)
+{
+    KineticStreamManifest manifest = {
+        .length = 5ULL * KINETIC_OBJ_SIZE + 3,
+        .chunkSize = KINETIC_OBJ_SIZE,
+        .chunkCount = 6,
+        .generation = 0x0123456789ABCDEFULL,
+    };
+    uint8_t data[KINETIC_STREAM_MANIFEST_LEN];
+    KineticStreamManifest decoded;
+
+    KineticStream_EncodeManifest(&manifest, data);
+
+    TEST_ASSERT_EQUAL_HEX8('K', data[0]);
+    TEST_ASSERT_TRUE(KineticStream_DecodeManifest(&decoded,
+        ByteBuffer_Create(data, sizeof(data), sizeof(data))));
+    TEST_ASSERT_TRUE(manifest.length == decoded.length);
+    TEST_ASSERT_EQUAL(manifest.chunkSize, decoded.chunkSize);
+    TEST_ASSERT_EQUAL(manifest.chunkCount, decoded.chunkCount);
+    TEST_ASSERT_TRUE(manifest.generation == decoded.generation);
+}
+
+void test_KineticStream_DecodeManifest_should_reject_data_which_is_not_a_consistent_manifest(void)
+{
+    KineticStreamManifest manifest = {.length = 100, .chunkSize = 10, .chunkCount = 10};
+    uint8_t data[KINETIC_STREAM_MANIFEST_LEN];
+    KineticStreamManifest decoded;
+
+    KineticStream_EncodeManifest(&manifest, data);
+    TEST_ASSERT_FALSE(KineticStream_DecodeManifest(&decoded,
+        ByteBuffer_Create(data, sizeof(data), sizeof(data) - 1)));
+
+    manifest.chunkCount = 9;
+    KineticStream_EncodeManifest(&manifest, data);
+    TEST_ASSERT_FALSE(KineticStream_DecodeManifest(&decoded,
+        ByteBuffer_Create(data, sizeof(data), sizeof(data))));
+
+    manifest.chunkCount = 10;
+    KineticStream_EncodeManifest(&manifest, data);
+    data[0] = 'X';
+    TEST_ASSERT_FALSE(KineticStream_DecodeManifest(&decoded,
+        ByteBuffer_Create(data, sizeof(data), sizeof(data))));
+}
+
+void test_KineticStream_ChunkKey_should_append_the_generation_and_chunk_index_to_the_object_key(void)
+{
+    uint8_t chunkKeyData[sizeof(KeyData) - 1 + KINETIC_STREAM_CHUNK_SUFFIX_LEN];
+    ByteBuffer chunkKey = ByteBuffer_Create(chunkKeyData, sizeof(chunkKeyData), 0);
+
+    TEST_ASSERT_TRUE(KineticStream_ChunkKey(&chunkKey, Stream.key, 0x0123456789ABCDEFULL, 0x1A2B));
+
+    TEST_ASSERT_EQUAL(sizeof(chunkKeyData), chunkKey.bytesUsed);
+    TEST_ASSERT_EQUAL(0, memcmp("my_object.0123456789ABCDEF.00001A2B",
+        chunkKeyData, sizeof(chunkKeyData)));
+
+    chunkKey.array.len--;
+    TEST_ASSERT_FALSE(KineticStream_ChunkKey(&chunkKey, Stream.key, 0, 0));
+}
+
+// Plays the part of the receiver, completing each operation once submitted
+static void* CompleteOperations(void* arg)
+{
+    (void)arg;
+    for (int i = 0; i < ResponseCount; i++) {
+        volatile KineticCompletionCallback* callback = &Responses[i]->closure.callback;
+        while (*callback == NULL) {
+            nanosleep(&(struct timespec) {.tv_nsec = 1000000}, NULL);
+        }
+        KineticCompletionData completionData = {.status = Results[i]};
+        Responses[i]->closure.callback(&completionData, Responses[i]->closure.clientData);
+        ResultCount++;
+    }
+    return NULL;
+}
+
+static void ExpectResponse(KineticOperation* operation, KineticStatus status)
+{
+    Responses[ResponseCount] = operation;
+    Results[ResponseCount++] = status;
+}
+
+// Manifest operations are executed as a batch of one
+static void ExpectOperation(int index, KineticStatus status)
+{
+    static KineticOperation* expected[NUM_OPERATIONS];
+    expected[index] = &Operations[index];
+    KineticConnection_AcquireWindow_ExpectAndReturn(&Connection, KINETIC_STATUS_SUCCESS);
+    KineticAllocator_NewOperation_ExpectAndReturn(&Connection, &Operations[index]);
+    KineticOperation_SendRequests_ExpectAndReturn(&expected[index], 1, KINETIC_STATUS_SUCCESS);
+    ExpectResponse(&Operations[index], status);
+}
+
+// Chunk operations are submitted in turn, within the window
+static void ExpectChunk(int index, KineticStatus status)
+{
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+    ExpectResponse(&Chunks[index], status);
+}
+
+static KineticStatus ExecuteStream(KineticStatus (*execute)(KineticConnection** const,
+    int, KineticStream* const))
+{
+    pthread_t receiver;
+    TEST_ASSERT_EQUAL(0, pthread_create(&receiver, NULL, CompleteOperations, NULL));
+    KineticStatus status = execute(Connections, 1, &Stream);
+    pthread_join(receiver, NULL);
+    VerifySubmissions();
+    TEST_ASSERT_EQUAL(ResponseCount, ResultCount);
+    return status;
+}
+
+static void RecordKey(KineticEntry* const entry, int index)
+{
+    TEST_ASSERT_TRUE(index < NUM_OPERATIONS);
+    memcpy(BuiltKeys[index], entry->key.array.data, entry->key.bytesUsed);
+    BuiltKeyLens[index] = entry->key.bytesUsed;
+}
+
+static void BuildPut(KineticOperation* const operation, KineticEntry* const entry,
+    int cmock_num_calls)
+{
+    (void)operation;
+    RecordKey(entry, cmock_num_calls);
+    if (entry->value.bytesUsed == KINETIC_STREAM_MANIFEST_LEN) {
+        memcpy(BuiltManifest, entry->value.array.data, sizeof(BuiltManifest));
+    }
+}
+
+static void BuildDelete(KineticOperation* const operation, KineticEntry* const entry,
+    int cmock_num_calls)
+{
+    (void)operation;
+    TEST_ASSERT_TRUE(entry->force);
+    RecordKey(entry, cmock_num_calls);
+}
+
+// Responds to the manifest GET w/StoredManifest
+static void BuildGet(KineticOperation* const operation, KineticEntry* const entry,
+    int cmock_num_calls)
+{
+    (void)operation;
+    (void)cmock_num_calls;
+    TEST_ASSERT_TRUE(entry->value.array.len >= KINETIC_STREAM_MANIFEST_LEN);
+    KineticStream_EncodeManifest(&StoredManifest, entry->value.array.data);
+    entry->value.bytesUsed = KINETIC_STREAM_MANIFEST_LEN;
+}
+
+static void AssertChunkKey(int index, uint64_t generation, uint32_t chunk)
+{
+    uint8_t chunkKeyData[sizeof(KeyData) - 1 + KINETIC_STREAM_CHUNK_SUFFIX_LEN];
+    ByteBuffer chunkKey = ByteBuffer_Create(chunkKeyData, sizeof(chunkKeyData), 0);
+    TEST_ASSERT_TRUE(KineticStream_ChunkKey(&chunkKey, Stream.key, generation, chunk));
+    TEST_ASSERT_EQUAL(chunkKey.bytesUsed, BuiltKeyLens[index]);
+    TEST_ASSERT_EQUAL_MEMORY(chunkKeyData, BuiltKeys[index], chunkKey.bytesUsed);
+}
+
+void test_KineticStream_Put_should_store_each_chunk_under_a_new_generation_and_then_the_manifest(void)
+{
+    LOG_LOCATION;
+    KineticOperation_BuildGet_Ignore();
+    KineticOperation_BuildPut_StubWithCallback(BuildPut);
+    ExpectOperation(0, KINETIC_STATUS_NOT_FOUND);
+    for (int i = 0; i < 3; i++) {
+        ExpectChunk(i, KINETIC_STATUS_SUCCESS);
+    }
+    ExpectOperation(1, KINETIC_STATUS_SUCCESS);
+
+    KineticStatus status = ExecuteStream(KineticStream_Put);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(3, ProgressCount);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, ProgressStatus);
+
+    KineticStreamManifest manifest;
+    TEST_ASSERT_TRUE(KineticStream_DecodeManifest(&manifest,
+        ByteBuffer_Create(BuiltManifest, sizeof(BuiltManifest), sizeof(BuiltManifest))));
+    TEST_ASSERT_TRUE(manifest.length == sizeof(ObjectData));
+    TEST_ASSERT_EQUAL(3, manifest.chunkCount);
+    for (int i = 0; i < 3; i++) {
+        AssertChunkKey(i, manifest.generation, i);
+    }
+    TEST_ASSERT_EQUAL(sizeof(KeyData) - 1, BuiltKeyLens[3]);
+}
+
+void test_KineticStream_Put_should_delete_the_chunks_of_the_object_replaced_once_the_manifest_is_stored(void)
+{
+    LOG_LOCATION;
+    StoredManifest = (KineticStreamManifest) {
+        .length = 12,
+        .chunkSize = 8,
+        .chunkCount = 2,
+        .generation = 0x1234,
+    };
+    KineticOperation_BuildGet_StubWithCallback(BuildGet);
+    KineticOperation_BuildPut_StubWithCallback(BuildPut);
+    KineticOperation_BuildDelete_StubWithCallback(BuildDelete);
+    ExpectOperation(0, KINETIC_STATUS_SUCCESS);
+    for (int i = 0; i < 3; i++) {
+        ExpectChunk(i, KINETIC_STATUS_SUCCESS);
+    }
+    ExpectOperation(1, KINETIC_STATUS_SUCCESS);
+    ExpectChunk(3, KINETIC_STATUS_SUCCESS);
+    ExpectChunk(4, KINETIC_STATUS_NOT_FOUND);
+
+    KineticStatus status = ExecuteStream(KineticStream_Put);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(3, ProgressCount);
+    KineticStreamManifest manifest;
+    TEST_ASSERT_TRUE(KineticStream_DecodeManifest(&manifest,
+        ByteBuffer_Create(BuiltManifest, sizeof(BuiltManifest), sizeof(BuiltManifest))));
+    TEST_ASSERT_TRUE(manifest.generation != StoredManifest.generation);
+    AssertChunkKey(0, StoredManifest.generation, 0);
+    AssertChunkKey(1, StoredManifest.generation, 1);
+}
+
+void test_KineticStream_Put_should_skip_the_manifest_and_delete_the_chunks_if_a_chunk_fails(void)
+{
+    LOG_LOCATION;
+    Stream.chunksInFlight = 1;
+    KineticOperation_BuildGet_Ignore();
+    KineticOperation_BuildPut_Ignore();
+    KineticOperation_BuildDelete_StubWithCallback(BuildDelete);
+    ExpectOperation(0, KINETIC_STATUS_NOT_FOUND);
+    ExpectChunk(0, KINETIC_STATUS_DATA_ERROR);
+    for (int i = 1; i < 4; i++) {
+        ExpectChunk(i, KINETIC_STATUS_NOT_FOUND);
+    }
+
+    KineticStatus status = ExecuteStream(KineticStream_Put);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_DATA_ERROR, status);
+    TEST_ASSERT_EQUAL(1, ProgressCount);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_DATA_ERROR, ProgressStatus);
+    for (int i = 0; i < 3; i++) {
+        char suffix[] = ".0000000X";
+        suffix[sizeof(suffix) - 2] = '0' + i;
+        TEST_ASSERT_EQUAL(sizeof(KeyData) - 1 + KINETIC_STREAM_CHUNK_SUFFIX_LEN, BuiltKeyLens[i]);
+        TEST_ASSERT_EQUAL_MEMORY(BuiltKeys[0], BuiltKeys[i], BuiltKeyLens[i] - 8);
+        TEST_ASSERT_EQUAL_MEMORY(suffix, &BuiltKeys[i][BuiltKeyLens[i] - 9], 9);
+    }
+}
+
+void test_KineticStream_Get_should_report_a_missing_manifest(void)
+{
+    LOG_LOCATION;
+    KineticOperation_BuildGet_Ignore();
+    ExpectOperation(0, KINETIC_STATUS_NOT_FOUND);
+
+    KineticStatus status = ExecuteStream(KineticStream_Get);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_NOT_FOUND, status);
+    TEST_ASSERT_EQUAL(0, ProgressCount);
+}
+
+void test_KineticStream_Put_and_Get_should_reject_a_key_too_long_for_the_chunk_keys(void)
+{
+    LOG_LOCATION;
+    static uint8_t longKey[KINETIC_MAX_KEY_LEN - KINETIC_STREAM_CHUNK_SUFFIX_LEN + 1];
+    Stream.key = ByteBuffer_Create(longKey, sizeof(longKey), sizeof(longKey));
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticStream_Put(Connections, 1, &Stream));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST,
+        KineticStream_Get(Connections, 1, &Stream));
+    TEST_ASSERT_EQUAL(0, ProgressCount);
+}
@@ -101,4 +101,6 @@ void test_Kinetic_GetStatusDescription_should_return_appropriate_descriptions(vo
                              Kinetic_GetStatusDescription(KINETIC_STATUS_SOCKET_TIMEOUT));
     TEST_ASSERT_EQUAL_STRING("SOCKET_ERROR",
                              Kinetic_GetStatusDescription(KINETIC_STATUS_SOCKET_ERROR));
+    TEST_ASSERT_EQUAL_STRING("WOULD_BLOCK",
+                             Kinetic_GetStatusDescription(KINETIC_STATUS_WOULD_BLOCK));
 }
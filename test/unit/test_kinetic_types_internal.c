@@ -161,3 +161,129 @@ void test_Copy_KineticProto_Command_Range_to_ByteBufferArray_should_copy_keys_in
     };
     TEST_ASSERT_TRUE(Copy_KineticProto_Command_Range_to_ByteBufferArray(NULL, &array));
 }
+
+void test_Copy_KineticProto_Command_Range_to_ByteBufferArray_should_report_the_number_of_keys_copied(void)
+{
+    uint8_t keyData[3][8];
+    ByteBuffer buffers[3] = {
+        ByteBuffer_Create(keyData[0], sizeof(keyData[0]), 0),
+        ByteBuffer_Create(keyData[1], sizeof(keyData[1]), 0),
+        ByteBuffer_Create(keyData[2], sizeof(keyData[2]), 0),
+    };
+    ByteBufferArray array = {.buffers = buffers, .count = 3, .used = 3};
+    ProtobufCBinaryData keys[] = {
+        {.data = (uint8_t*)"key_a", .len = 5},
+        {.data = (uint8_t*)"key_b", .len = 5},
+    };
+    KineticProto_Command_Range range = {.n_keys = 2, .keys = keys};
+
+    TEST_ASSERT_TRUE(Copy_KineticProto_Command_Range_to_ByteBufferArray(&range, &array));
+
+    TEST_ASSERT_EQUAL(2, array.used);
+    TEST_ASSERT_EQUAL(5, buffers[1].bytesUsed);
+    TEST_ASSERT_EQUAL(0, memcmp("key_b", keyData[1], 5));
+}
+
+void test_Copy_KineticProto_Command_GetLog_to_KineticDeviceLog_should_populate_only_the_types_received(void)
+{
+    KineticDeviceLog log;
+    memset(&log, 0xFF, sizeof(log));
+
+    KineticProto_Command_GetLog_Utilization hda = {.name = "HDA", .has_value = true, .value = 0.5f};
+    KineticProto_Command_GetLog_Utilization* utilizations[] = {&hda};
+    KineticProto_Command_GetLog_Statistics puts = {
+        .has_messageType = true, .messageType = KINETIC_PROTO_COMMAND_MESSAGE_TYPE_PUT,
+        .has_count = true, .count = 12,
+        .has_bytes = true, .bytes = 3456,
+    };
+    KineticProto_Command_GetLog_Statistics* statistics[] = {&puts};
+    KineticProto_Command_GetLog getLog = {
+        .n_utilizations = 1, .utilizations = utilizations,
+        .n_statistics = 1, .statistics = statistics,
+    };
+
+    Copy_KineticProto_Command_GetLog_to_KineticDeviceLog(&getLog, &log);
+
+    TEST_ASSERT_EQUAL(KINETIC_LOG_TYPE_UTILIZATIONS | KINETIC_LOG_TYPE_STATISTICS, log.types);
+    TEST_ASSERT_EQUAL(1, log.utilizationCount);
+    TEST_ASSERT_EQUAL_STRING("HDA", log.utilizations[0].name);
+    TEST_ASSERT_TRUE(log.utilizations[0].value == 0.5f);
+    TEST_ASSERT_EQUAL(0, log.temperatureCount);
+    TEST_ASSERT_EQUAL(1, log.statisticCount);
+    TEST_ASSERT_EQUAL_STRING("PUT", log.statistics[0].messageType);
+    TEST_ASSERT_EQUAL(12, log.statistics[0].count);
+    TEST_ASSERT_EQUAL(3456, log.statistics[0].bytes);
+}
+
+void test_Copy_KineticProto_Command_GetLog_to_KineticDeviceLog_should_truncate_names_and_drop_excess_entries(void)
+{
+    KineticDeviceLog log;
+    KineticProto_Command_GetLog_Temperature temperature = {
+        .name = "a temperature sensor with a very long name",
+        .has_current = true, .current = 40.0f,
+    };
+    KineticProto_Command_GetLog_Temperature* temperatures[KINETIC_LOG_TEMPERATURES_MAX + 1];
+    for (int i = 0; i < KINETIC_LOG_TEMPERATURES_MAX + 1; i++) {
+        temperatures[i] = &temperature;
+    }
+    KineticProto_Command_GetLog_Limits limits = {.has_maxKeySize = true, .maxKeySize = 4096};
+    KineticProto_Command_GetLog getLog = {
+        .n_temperatures = KINETIC_LOG_TEMPERATURES_MAX + 1, .temperatures = temperatures,
+        .limits = &limits,
+    };
+
+    Copy_KineticProto_Command_GetLog_to_KineticDeviceLog(&getLog, &log);
+
+    TEST_ASSERT_EQUAL(KINETIC_LOG_TYPE_TEMPERATURES | KINETIC_LOG_TYPE_LIMITS, log.types);
+    TEST_ASSERT_EQUAL(KINETIC_LOG_TEMPERATURES_MAX, log.temperatureCount);
+    TEST_ASSERT_EQUAL(KINETIC_LOG_NAME_LEN - 1, strlen(log.temperatures[0].name));
+    TEST_ASSERT_TRUE(log.temperatures[KINETIC_LOG_TEMPERATURES_MAX - 1].current == 40.0f);
+    TEST_ASSERT_EQUAL(4096, log.limits.maxKeySize);
+    TEST_ASSERT_EQUAL(0, log.limits.maxValueSize);
+}
+
+void test_Copy_KineticProto_Command_P2POperation_to_KineticP2P_Operation_should_report_the_status_of_each_entry(void)
+{
+    KineticP2P_OperationData ops[3];
+    memset(ops, 0, sizeof(ops));
+    KineticP2P_Operation p2pOp = {.numOperations = 3, .operations = ops};
+
+    KineticProto_Command_Status succeeded = {
+        .has_code = true, .code = KINETIC_PROTO_COMMAND_STATUS_STATUS_CODE_SUCCESS};
+    KineticProto_Command_Status mismatched = {
+        .has_code = true, .code = KINETIC_PROTO_COMMAND_STATUS_STATUS_CODE_VERSION_MISMATCH};
+    KineticProto_Command_P2POperation_Operation op0 = {.status = &succeeded};
+    KineticProto_Command_P2POperation_Operation op1 = {.status = &mismatched};
+    KineticProto_Command_P2POperation_Operation op2 = {.status = NULL};
+    KineticProto_Command_P2POperation_Operation* operations[] = {&op0, &op1, &op2};
+    KineticProto_Command_P2POperation p2pOperation = {
+        .n_operation = 3, .operation = operations,
+        .has_allChildOperationsSucceeded = true, .allChildOperationsSucceeded = false,
+    };
+
+    TEST_ASSERT_FALSE(Copy_KineticProto_Command_P2POperation_to_KineticP2P_Operation(
+        &p2pOperation, &p2pOp));
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, ops[0].resultStatus);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_VERSION_MISMATCH, ops[1].resultStatus);
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID, ops[2].resultStatus);
+}
+
+void test_Copy_KineticProto_Command_P2POperation_to_KineticP2P_Operation_should_succeed_only_if_all_entries_did(void)
+{
+    KineticP2P_OperationData ops[1];
+    KineticP2P_Operation p2pOp = {.numOperations = 1, .operations = ops};
+    KineticProto_Command_Status succeeded = {
+        .has_code = true, .code = KINETIC_PROTO_COMMAND_STATUS_STATUS_CODE_SUCCESS};
+    KineticProto_Command_P2POperation_Operation op0 = {.status = &succeeded};
+    KineticProto_Command_P2POperation_Operation* operations[] = {&op0};
+    KineticProto_Command_P2POperation p2pOperation = {.n_operation = 1, .operation = operations};
+
+    TEST_ASSERT_TRUE(Copy_KineticProto_Command_P2POperation_to_KineticP2P_Operation(
+        &p2pOperation, &p2pOp));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, ops[0].resultStatus);
+
+    TEST_ASSERT_FALSE(Copy_KineticProto_Command_P2POperation_to_KineticP2P_Operation(
+        NULL, &p2pOp));
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID, ops[0].resultStatus);
+}
@@ -0,0 +1,159 @@
+/*
+* kinetic-c
+* Copyright (C) 2014 Seagate Technology.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*
+*/
+
+#include "unity.h"
+#include "unity_helper.h"
+#include "kinetic_value_scan.h"
+#include "kinetic_key_iterator.h"
+#include "kinetic_cursor.h"
+#include "kinetic_entry.h"
+#include "kinetic_types.h"
+#include "kinetic_types_internal.h"
+#include "kinetic_logger.h"
+#include "kinetic_proto.h"
+#include "protobuf-c/protobuf-c.h"
+#include "mock_kinetic_operation.h"
+#include "operation_test_fixture.h"
+#include <pthread.h>
+
+#define NUM_OPERATIONS (4)
+
+static const char* Keys[] = {"key_a", "key_b", "key_c"};
+static KineticConnection Connection;
+static KineticOperation Operations[NUM_OPERATIONS];
+static KineticPDU Requests[NUM_OPERATIONS];
+static KineticStatus Results[NUM_OPERATIONS];
+static KineticKeyRange Range;
+static char Reported[NUM_OPERATIONS][8];
+static int ReportedCount;
+
+static void TestValueCallback(const KineticEntry* entry, void* clientData)
+{
+    TEST_ASSERT_EQUAL_PTR(&ReportedCount, clientData);
+    TEST_ASSERT_EQUAL(5, entry->key.bytesUsed);
+    TEST_ASSERT_EQUAL(5, entry->value.bytesUsed);
+    TEST_ASSERT_EQUAL(0, memcmp(entry->key.array.data, entry->value.array.data, 5));
+    memcpy(Reported[ReportedCount], entry->key.array.data, 5);
+    Reported[ReportedCount][5] = '\0';
+    ReportedCount++;
+}
+
+void setUp(void)
+{
+    KineticLogger_Init("stdout", 3);
+    KINETIC_CONNECTION_INIT(&Connection);
+    for (int i = 0; i < NUM_OPERATIONS; i++) {
+        KINETIC_OPERATION_INIT(&Operations[i], &Connection);
+        Operations[i].request = &Requests[i];
+        Results[i] = KINETIC_STATUS_SUCCESS;
+    }
+    Range = (KineticKeyRange) {
+        .startKey = ByteBuffer_Create("key_a", 5, 5),
+        .endKey = ByteBuffer_Create("key_z", 5, 5),
+        .startKeyInclusive = true,
+        .endKeyInclusive = true,
+        .maxReturned = 10,
+    };
+    ReportedCount = 0;
+    SubmitOperations(Operations);
+}
+
+void tearDown(void)
+{
+    VerifySubmissions();
+    KineticLogger_Close();
+}
+
+// Plays the part of the receiver, responding to the page request (the first
+// operation) with the keys, and to each GET with the key as the value
+static void* Respond(void* arg)
+{
+    int count = *(int*)arg;
+    for (int i = 0; i < count; i++) {
+        AwaitSubmitted(&Operations[i]);
+        if (i == 0) {
+            KineticKeyPage* page = (KineticKeyPage*)Operations[i].closure.clientData;
+            for (int k = 0; k < 3; k++) {
+                ByteBuffer_Reset(&page->keys.buffers[k]);
+                ByteBuffer_AppendCString(&page->keys.buffers[k], Keys[k]);
+            }
+            page->keys.used = 3;
+        }
+        else {
+            KineticCursorSlot* slot = (KineticCursorSlot*)Operations[i].closure.clientData;
+            TEST_ASSERT_EQUAL(0, memcmp(Keys[i - 1], slot->entry.key.array.data, 5));
+            ByteBuffer_Append(&slot->entry.value, slot->entry.key.array.data, slot->entry.key.bytesUsed);
+        }
+        CompleteOperation(&Operations[i], Results[i]);
+    }
+    return NULL;
+}
+
+void test_KineticValueScan_Execute_should_get_each_key_in_the_range_and_skip_deleted_keys(void)
+{
+    LOG_LOCATION;
+    int count = 4;
+    Results[2] = KINETIC_STATUS_NOT_FOUND;
+    KineticOperation_BuildGetKeyRange_Ignore();
+    KineticOperation_BuildGet_Ignore();
+    for (int i = 0; i < count; i++) {
+        ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+    }
+
+    pthread_t receiver;
+    TEST_ASSERT_EQUAL(0, pthread_create(&receiver, NULL, Respond, &count));
+    KineticStatus status = KineticValueScan_Execute(&Connection, &Range, 2,
+        TestValueCallback, &ReportedCount);
+    pthread_join(receiver, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL(2, ReportedCount);
+    TEST_ASSERT_EQUAL_STRING("key_a", Reported[0]);
+    TEST_ASSERT_EQUAL_STRING("key_c", Reported[1]);
+}
+
+void test_KineticValueScan_Execute_should_stop_at_the_first_failed_GET(void)
+{
+    LOG_LOCATION;
+    int count = 2;
+    Results[1] = KINETIC_STATUS_DATA_ERROR;
+    KineticOperation_BuildGetKeyRange_Ignore();
+    KineticOperation_BuildGet_Ignore();
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+    ExpectSubmit(&Connection, true, KINETIC_STATUS_SUCCESS);
+
+    pthread_t receiver;
+    TEST_ASSERT_EQUAL(0, pthread_create(&receiver, NULL, Respond, &count));
+    KineticStatus status = KineticValueScan_Execute(&Connection, &Range, 1,
+        TestValueCallback, &ReportedCount);
+    pthread_join(receiver, NULL);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_DATA_ERROR, status);
+    TEST_ASSERT_EQUAL(0, ReportedCount);
+}
+
+void test_KineticValueScan_Execute_should_reject_too_many_GETs_in_flight(void)
+{
+    LOG_LOCATION;
+    KineticStatus status = KineticValueScan_Execute(&Connection, &Range,
+        KINETIC_VALUE_SCAN_GETS_MAX + 1, TestValueCallback, &ReportedCount);
+
+    TEST_ASSERT_EQUAL_KineticStatus(KINETIC_STATUS_INVALID_REQUEST, status);
+}